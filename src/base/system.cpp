@@ -20,12 +20,14 @@
 #include <iterator> // std::size
 #include <mutex>
 #include <string_view>
+#include <vector>
 
 #if defined(CONF_WEBSOCKETS)
 #include <engine/shared/websockets.h>
 #endif
 
 #if defined(CONF_FAMILY_UNIX)
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/utsname.h>
@@ -38,6 +40,7 @@
 /* unix net includes */
 #include <arpa/inet.h>
 #include <dirent.h>
+#include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <pthread.h>
@@ -380,24 +383,36 @@ IOHANDLE io_current_exe()
 	return io_open(path, IOFLAG_READ);
 }
 
-#define ASYNC_BUFSIZE (8 * 1024)
-#define ASYNC_LOCAL_BUFSIZE (64 * 1024)
-
 struct ASYNCIO
 {
-	CLock lock;
 	IOHANDLE io;
 	SEMAPHORE sphore;
 	void *thread;
 
-	unsigned char *buffer;
-	unsigned int buffer_size;
-	unsigned int read_pos;
-	unsigned int write_pos;
+	// Signaled by the thread for writers waiting for space in the buffer
+	SEMAPHORE space_sphore;
+	std::atomic<int> space_waiters;
 
-	int error;
-	unsigned char finish;
-	unsigned char refcount;
+	// Positions only ever increase and are wrapped when indexing the buffer.
+	// Writers reserve space by advancing `reserve_pos` and publish it in
+	// reservation order by advancing `commit_pos`. The thread writes
+	// everything up to `commit_pos` to the file and then advances `read_pos`.
+	unsigned char *buffer;
+	unsigned int buffer_size; // power of two
+	std::atomic<uint64_t> reserve_pos;
+	std::atomic<uint64_t> commit_pos;
+	std::atomic<uint64_t> read_pos;
+	std::atomic<bool> sleeping;
+
+	std::atomic<int> error;
+	std::atomic<unsigned char> finish;
+	std::atomic<unsigned char> refcount;
+
+	std::atomic<uint64_t> stat_bytes;
+	std::atomic<uint64_t> stat_writes;
+	std::atomic<uint64_t> stat_flushes;
+	std::atomic<uint64_t> stat_stalls;
+	std::atomic<int64_t> stat_stall_time;
 };
 
 enum
@@ -407,107 +422,89 @@ enum
 	ASYNCIO_EXIT,
 };
 
-struct BUFFERS
-{
-	unsigned char *buf1;
-	unsigned int len1;
-	unsigned char *buf2;
-	unsigned int len2;
-};
+// Writes between `aio_lock` and `aio_unlock` are collected per thread and
+// queued at once, so they end up contiguous in the file.
+static thread_local ASYNCIO *aio_transaction = nullptr;
+static thread_local std::vector<unsigned char> aio_transaction_buffer;
 
-static void buffer_ptrs(ASYNCIO *aio, struct BUFFERS *buffers)
+static void aio_release(ASYNCIO *aio)
 {
-	mem_zero(buffers, sizeof(*buffers));
-	if(aio->read_pos < aio->write_pos)
+	if(aio->refcount.fetch_sub(1) == 1)
 	{
-		buffers->buf1 = aio->buffer + aio->read_pos;
-		buffers->len1 = aio->write_pos - aio->read_pos;
-	}
-	else if(aio->read_pos > aio->write_pos)
-	{
-		buffers->buf1 = aio->buffer + aio->read_pos;
-		buffers->len1 = aio->buffer_size - aio->read_pos;
-		buffers->buf2 = aio->buffer;
-		buffers->len2 = aio->write_pos;
+		free(aio->buffer);
+		sphore_destroy(&aio->sphore);
+		sphore_destroy(&aio->space_sphore);
+		delete aio;
 	}
 }
 
-static void aio_handle_free_and_unlock(ASYNCIO *aio) RELEASE(aio->lock)
+static void aio_wake(ASYNCIO *aio)
 {
-	int do_free;
-	aio->refcount--;
-
-	do_free = aio->refcount == 0;
-	aio->lock.unlock();
-	if(do_free)
+	if(aio->sleeping.exchange(false))
 	{
-		free(aio->buffer);
-		sphore_destroy(&aio->sphore);
-		delete aio;
+		sphore_signal(&aio->sphore);
 	}
 }
 
 static void aio_thread(void *user)
 {
 	ASYNCIO *aio = (ASYNCIO *)user;
+	uint64_t read_pos = aio->read_pos.load(std::memory_order_relaxed);
 
-	aio->lock.lock();
 	while(true)
 	{
-		struct BUFFERS buffers;
-		int result_io_error;
-		unsigned char local_buffer[ASYNC_LOCAL_BUFSIZE];
-		unsigned int local_buffer_len = 0;
-
-		if(aio->read_pos == aio->write_pos)
+		const uint64_t commit_pos = aio->commit_pos.load(std::memory_order_acquire);
+		if(commit_pos == read_pos)
 		{
-			if(aio->finish != ASYNCIO_RUNNING)
+			const unsigned char finish = aio->finish.load();
+			if(finish != ASYNCIO_RUNNING)
 			{
-				if(aio->finish == ASYNCIO_CLOSE)
+				if(finish == ASYNCIO_CLOSE)
 				{
 					io_close(aio->io);
 				}
-				aio_handle_free_and_unlock(aio);
+				aio_release(aio);
 				break;
 			}
-			aio->lock.unlock();
-			sphore_wait(&aio->sphore);
-			aio->lock.lock();
+			// Writers only signal the semaphore if they see this flag, check
+			// again after setting it to not miss data queued in the meantime
+			aio->sleeping.store(true);
+			if(aio->commit_pos.load() == read_pos && aio->finish.load() == ASYNCIO_RUNNING)
+			{
+				sphore_wait(&aio->sphore);
+			}
+			aio->sleeping.store(false);
 			continue;
 		}
 
-		buffer_ptrs(aio, &buffers);
-		if(buffers.buf1)
+		// Write everything queued so far at once, the data stays in place
+		// until `read_pos` is advanced
+		const unsigned int len = commit_pos - read_pos;
+		const unsigned int offset = read_pos & (aio->buffer_size - 1);
+		const unsigned int len1 = std::min(len, aio->buffer_size - offset);
+		unsigned int written = io_write(aio->io, aio->buffer + offset, len1);
+		if(len1 < len)
 		{
-			if(buffers.len1 > sizeof(local_buffer) - local_buffer_len)
-			{
-				buffers.len1 = sizeof(local_buffer) - local_buffer_len;
-			}
-			mem_copy(local_buffer + local_buffer_len, buffers.buf1, buffers.len1);
-			local_buffer_len += buffers.len1;
-			if(buffers.buf2)
-			{
-				if(buffers.len2 > sizeof(local_buffer) - local_buffer_len)
-				{
-					buffers.len2 = sizeof(local_buffer) - local_buffer_len;
-				}
-				mem_copy(local_buffer + local_buffer_len, buffers.buf2, buffers.len2);
-				local_buffer_len += buffers.len2;
-			}
+			written += io_write(aio->io, aio->buffer, len - len1);
 		}
-		aio->read_pos = (aio->read_pos + buffers.len1 + buffers.len2) % aio->buffer_size;
-		aio->lock.unlock();
-
-		io_write(aio->io, local_buffer, local_buffer_len);
-		io_flush(aio->io);
-		result_io_error = io_error(aio->io);
+		const bool flushed = io_flush(aio->io) == 0;
+		// Errors are kept, the data of a failed write is lost
+		if(written != len || !flushed || io_error(aio->io))
+		{
+			aio->error = 1;
+		}
+		aio->stat_flushes.fetch_add(1, std::memory_order_relaxed);
 
-		aio->lock.lock();
-		aio->error = result_io_error;
+		read_pos = commit_pos;
+		aio->read_pos.store(read_pos);
+		for(int waiters = aio->space_waiters.exchange(0); waiters > 0; waiters--)
+		{
+			sphore_signal(&aio->space_sphore);
+		}
 	}
 }
 
-ASYNCIO *aio_new(IOHANDLE io)
+ASYNCIO *aio_new(IOHANDLE io, unsigned buffer_size)
 {
 	ASYNCIO *aio = new ASYNCIO;
 	if(!aio)
@@ -516,122 +513,141 @@ ASYNCIO *aio_new(IOHANDLE io)
 	}
 	aio->io = io;
 	sphore_init(&aio->sphore);
+	sphore_init(&aio->space_sphore);
+	aio->space_waiters = 0;
 	aio->thread = nullptr;
 
-	aio->buffer = (unsigned char *)malloc(ASYNC_BUFSIZE);
+	aio->buffer_size = 64;
+	while(aio->buffer_size < buffer_size)
+	{
+		aio->buffer_size *= 2;
+	}
+	aio->buffer = (unsigned char *)malloc(aio->buffer_size);
 	if(!aio->buffer)
 	{
 		sphore_destroy(&aio->sphore);
+		sphore_destroy(&aio->space_sphore);
 		delete aio;
 		return nullptr;
 	}
-	aio->buffer_size = ASYNC_BUFSIZE;
+	aio->reserve_pos = 0;
+	aio->commit_pos = 0;
 	aio->read_pos = 0;
-	aio->write_pos = 0;
+	aio->sleeping = false;
 	aio->error = 0;
 	aio->finish = ASYNCIO_RUNNING;
 	aio->refcount = 2;
+	aio->stat_bytes = 0;
+	aio->stat_writes = 0;
+	aio->stat_flushes = 0;
+	aio->stat_stalls = 0;
+	aio->stat_stall_time = 0;
 
 	aio->thread = thread_init(aio_thread, aio, "aio");
 	if(!aio->thread)
 	{
 		free(aio->buffer);
 		sphore_destroy(&aio->sphore);
+		sphore_destroy(&aio->space_sphore);
 		delete aio;
 		return nullptr;
 	}
 	return aio;
 }
 
-static unsigned int buffer_len(ASYNCIO *aio)
+static void aio_queue(ASYNCIO *aio, const unsigned char *buffer, unsigned size)
 {
-	if(aio->write_pos >= aio->read_pos)
+	uint64_t start = aio->reserve_pos.load(std::memory_order_relaxed);
+	int64_t stall_start = 0;
+	while(true)
+	{
+		if(start + size - aio->read_pos.load(std::memory_order_acquire) > aio->buffer_size)
+		{
+			// Buffer is full, wait for the thread to write it out. The
+			// thread signals after every write, check again after
+			// registering to not miss a write that happened in the meantime.
+			if(!stall_start)
+			{
+				stall_start = time_get();
+			}
+			aio->space_waiters.fetch_add(1);
+			aio_wake(aio);
+			if(aio->reserve_pos.load() + size - aio->read_pos.load() > aio->buffer_size)
+			{
+				sphore_wait(&aio->space_sphore);
+			}
+			start = aio->reserve_pos.load(std::memory_order_relaxed);
+			continue;
+		}
+		if(aio->reserve_pos.compare_exchange_weak(start, start + size, std::memory_order_relaxed))
+		{
+			break;
+		}
+	}
+	if(stall_start)
 	{
-		return aio->write_pos - aio->read_pos;
+		aio->stat_stalls.fetch_add(1, std::memory_order_relaxed);
+		aio->stat_stall_time.fetch_add(time_get() - stall_start, std::memory_order_relaxed);
 	}
-	else
+
+	const unsigned int offset = start & (aio->buffer_size - 1);
+	const unsigned int len1 = std::min(size, aio->buffer_size - offset);
+	mem_copy(aio->buffer + offset, buffer, len1);
+	if(len1 < size)
 	{
-		return aio->buffer_size + aio->write_pos - aio->read_pos;
+		mem_copy(aio->buffer, buffer + len1, size - len1);
 	}
-}
 
-static unsigned int next_buffer_size(unsigned int cur_size, unsigned int need_size)
-{
-	while(cur_size < need_size)
+	// Publish in reservation order, earlier writers are only copying
+	while(aio->commit_pos.load(std::memory_order_acquire) != start)
 	{
-		cur_size *= 2;
+		thread_yield();
 	}
-	return cur_size;
+	aio->commit_pos.store(start + size);
+	aio_wake(aio);
 }
 
-void aio_lock(ASYNCIO *aio) ACQUIRE(aio->lock)
+void aio_lock(ASYNCIO *aio)
 {
-	aio->lock.lock();
+	dbg_assert(aio_transaction == nullptr, "aio_lock called twice without aio_unlock");
+	aio_transaction = aio;
+	aio_transaction_buffer.clear();
 }
 
-void aio_unlock(ASYNCIO *aio) RELEASE(aio->lock)
+void aio_unlock(ASYNCIO *aio)
 {
-	aio->lock.unlock();
-	sphore_signal(&aio->sphore);
+	dbg_assert(aio_transaction == aio, "aio_unlock called without aio_lock");
+	aio_transaction = nullptr;
+	aio_write(aio, aio_transaction_buffer.data(), aio_transaction_buffer.size());
 }
 
 void aio_write_unlocked(ASYNCIO *aio, const void *buffer, unsigned size)
 {
-	unsigned int remaining;
-	remaining = aio->buffer_size - buffer_len(aio);
+	dbg_assert(aio_transaction == aio, "aio_write_unlocked called without aio_lock");
+	const unsigned char *bytes = (const unsigned char *)buffer;
+	aio_transaction_buffer.insert(aio_transaction_buffer.end(), bytes, bytes + size);
+}
 
-	// Don't allow full queue to distinguish between empty and full queue.
-	if(size < remaining)
+void aio_write(ASYNCIO *aio, const void *buffer, unsigned size)
+{
+	if(size == 0)
 	{
-		unsigned int remaining_contiguous = aio->buffer_size - aio->write_pos;
-		if(size > remaining_contiguous)
-		{
-			mem_copy(aio->buffer + aio->write_pos, buffer, remaining_contiguous);
-			size -= remaining_contiguous;
-			buffer = ((unsigned char *)buffer) + remaining_contiguous;
-			aio->write_pos = 0;
-		}
-		mem_copy(aio->buffer + aio->write_pos, buffer, size);
-		aio->write_pos = (aio->write_pos + size) % aio->buffer_size;
+		return;
 	}
-	else
-	{
-		// Add 1 so the new buffer isn't completely filled.
-		unsigned int new_written = buffer_len(aio) + size + 1;
-		unsigned int next_size = next_buffer_size(aio->buffer_size, new_written);
-		unsigned int next_len = 0;
-		unsigned char *next_buffer = (unsigned char *)malloc(next_size);
+	aio->stat_bytes.fetch_add(size, std::memory_order_relaxed);
+	aio->stat_writes.fetch_add(1, std::memory_order_relaxed);
 
-		struct BUFFERS buffers;
-		buffer_ptrs(aio, &buffers);
-		if(buffers.buf1)
-		{
-			mem_copy(next_buffer + next_len, buffers.buf1, buffers.len1);
-			next_len += buffers.len1;
-			if(buffers.buf2)
-			{
-				mem_copy(next_buffer + next_len, buffers.buf2, buffers.len2);
-				next_len += buffers.len2;
-			}
-		}
-		mem_copy(next_buffer + next_len, buffer, size);
-		next_len += size;
-
-		free(aio->buffer);
-		aio->buffer = next_buffer;
-		aio->buffer_size = next_size;
-		aio->read_pos = 0;
-		aio->write_pos = next_len;
+	// Writes larger than the buffer are split into several parts
+	const unsigned char *bytes = (const unsigned char *)buffer;
+	while(size > 0)
+	{
+		const unsigned int part = std::min(size, aio->buffer_size);
+		aio_queue(aio, bytes, part);
+		bytes += part;
+		size -= part;
 	}
 }
 
-void aio_write(ASYNCIO *aio, const void *buffer, unsigned size)
-{
-	aio_lock(aio);
-	aio_write_unlocked(aio, buffer, size);
-	aio_unlock(aio);
-}
-
 void aio_write_newline_unlocked(ASYNCIO *aio)
 {
 #if defined(CONF_FAMILY_WINDOWS)
@@ -643,51 +659,52 @@ void aio_write_newline_unlocked(ASYNCIO *aio)
 
 void aio_write_newline(ASYNCIO *aio)
 {
-	aio_lock(aio);
-	aio_write_newline_unlocked(aio);
-	aio_unlock(aio);
+#if defined(CONF_FAMILY_WINDOWS)
+	aio_write(aio, "\r\n", 2);
+#else
+	aio_write(aio, "\n", 1);
+#endif
 }
 
 int aio_error(ASYNCIO *aio)
 {
-	CLockScope ls(aio->lock);
-	return aio->error;
+	return aio->error.load();
+}
+
+void aio_stats(ASYNCIO *aio, ASYNCIO_STATS *stats)
+{
+	stats->bytes = aio->stat_bytes.load(std::memory_order_relaxed);
+	stats->writes = aio->stat_writes.load(std::memory_order_relaxed);
+	stats->flushes = aio->stat_flushes.load(std::memory_order_relaxed);
+	stats->stalls = aio->stat_stalls.load(std::memory_order_relaxed);
+	stats->stall_time = aio->stat_stall_time.load(std::memory_order_relaxed);
+	stats->queued = aio->reserve_pos.load(std::memory_order_relaxed) - aio->read_pos.load(std::memory_order_relaxed);
 }
 
 void aio_close(ASYNCIO *aio)
 {
-	{
-		CLockScope ls(aio->lock);
-		aio->finish = ASYNCIO_CLOSE;
-	}
+	aio->finish = ASYNCIO_CLOSE;
 	sphore_signal(&aio->sphore);
 }
 
 void aio_wait(ASYNCIO *aio)
 {
-	void *thread;
-	{
-		CLockScope ls(aio->lock);
-		thread = aio->thread;
-		aio->thread = nullptr;
-		if(aio->finish == ASYNCIO_RUNNING)
-		{
-			aio->finish = ASYNCIO_EXIT;
-		}
-	}
+	void *thread = aio->thread;
+	aio->thread = nullptr;
+	unsigned char running = ASYNCIO_RUNNING;
+	aio->finish.compare_exchange_strong(running, ASYNCIO_EXIT);
 	sphore_signal(&aio->sphore);
 	thread_wait(thread);
 }
 
 void aio_free(ASYNCIO *aio)
 {
-	aio->lock.lock();
 	if(aio->thread)
 	{
 		thread_detach(aio->thread);
 		aio->thread = nullptr;
 	}
-	aio_handle_free_and_unlock(aio);
+	aio_release(aio);
 }
 
 struct THREAD_RUN
@@ -1721,6 +1738,70 @@ int net_udp_send(NETSOCKET sock, const NETADDR *addr, const void *data, int size
 	return d;
 }
 
+int net_udp_send_batch(NETSOCKET sock, const NETADDR *addr, const void *const *datas, const int *sizes, int num)
+{
+#if defined(CONF_PLATFORM_LINUX)
+	if((addr->type == NETTYPE_IPV4 && sock->ipv4sock >= 0) || (addr->type == NETTYPE_IPV6 && sock->ipv6sock >= 0))
+	{
+		sockaddr_in sa4;
+		sockaddr_in6 sa6;
+		sockaddr *sa;
+		socklen_t sa_len;
+		int fd;
+		if(addr->type == NETTYPE_IPV4)
+		{
+			netaddr_to_sockaddr_in(addr, &sa4);
+			sa = (sockaddr *)&sa4;
+			sa_len = sizeof(sa4);
+			fd = sock->ipv4sock;
+		}
+		else
+		{
+			netaddr_to_sockaddr_in6(addr, &sa6);
+			sa = (sockaddr *)&sa6;
+			sa_len = sizeof(sa6);
+			fd = sock->ipv6sock;
+		}
+
+		struct mmsghdr msgs[VLEN];
+		struct iovec iovecs[VLEN];
+		int sent = 0;
+		while(sent < num)
+		{
+			const int batch = num - sent < VLEN ? num - sent : VLEN;
+			mem_zero(msgs, sizeof(msgs[0]) * batch);
+			for(int i = 0; i < batch; i++)
+			{
+				iovecs[i].iov_base = (void *)datas[sent + i];
+				iovecs[i].iov_len = sizes[sent + i];
+				msgs[i].msg_hdr.msg_name = sa;
+				msgs[i].msg_hdr.msg_namelen = sa_len;
+				msgs[i].msg_hdr.msg_iov = &iovecs[i];
+				msgs[i].msg_hdr.msg_iovlen = 1;
+			}
+			const int result = sendmmsg(fd, msgs, batch, 0);
+			if(result <= 0)
+				break;
+			for(int i = 0; i < result; i++)
+			{
+				network_stats.sent_bytes += sizes[sent + i];
+				network_stats.sent_packets++;
+			}
+			sent += result;
+		}
+		return sent;
+	}
+#endif
+
+	int sent = 0;
+	for(int i = 0; i < num; i++)
+	{
+		if(net_udp_send(sock, addr, datas[i], sizes[i]) >= 0)
+			sent++;
+	}
+	return sent;
+}
+
 void net_buffer_init(NETSOCKET_BUFFER *buffer)
 {
 #if defined(CONF_PLATFORM_LINUX)
@@ -2672,6 +2753,72 @@ int fs_file_time(const char *name, time_t *created, time_t *modified)
 	return 0;
 }
 
+void *fs_map_file(const char *name, size_t *size, bool write)
+{
+#if defined(CONF_FAMILY_WINDOWS)
+	const std::wstring wide_name = windows_utf8_to_wide(name);
+	HANDLE file = CreateFileW(wide_name.c_str(), write ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, write ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+		return nullptr;
+	if(!write)
+	{
+		LARGE_INTEGER file_size;
+		if(!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return nullptr;
+		}
+		*size = file_size.QuadPart;
+	}
+	const uint64_t map_size = *size;
+	HANDLE mapping = CreateFileMappingW(file, nullptr, write ? PAGE_READWRITE : PAGE_READONLY, map_size >> 32, map_size & 0xffffffff, nullptr);
+	CloseHandle(file);
+	if(!mapping)
+		return nullptr;
+	void *data = MapViewOfFile(mapping, write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, *size);
+	CloseHandle(mapping);
+	return data;
+#elif defined(CONF_FAMILY_UNIX)
+	const int fd = open(name, write ? O_RDWR | O_CREAT | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+	if(fd < 0)
+		return nullptr;
+	if(write)
+	{
+		if(ftruncate(fd, *size) != 0)
+		{
+			close(fd);
+			return nullptr;
+		}
+	}
+	else
+	{
+		struct stat sb;
+		if(fstat(fd, &sb) != 0 || sb.st_size == 0)
+		{
+			close(fd);
+			return nullptr;
+		}
+		*size = sb.st_size;
+	}
+	void *data = mmap(nullptr, *size, write ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	return data == MAP_FAILED ? nullptr : data;
+#else
+#error not implemented
+#endif
+}
+
+void fs_unmap_file(void *data, size_t size)
+{
+#if defined(CONF_FAMILY_WINDOWS)
+	UnmapViewOfFile(data);
+#elif defined(CONF_FAMILY_UNIX)
+	munmap(data, size);
+#else
+#error not implemented
+#endif
+}
+
 void swap_endian(void *data, unsigned elem_size, unsigned num)
 {
 	char *src = (char *)data;
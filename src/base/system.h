@@ -337,14 +337,18 @@ typedef struct ASYNCIO ASYNCIO;
  * @ingroup File-IO
  *
  * @param io Handle to the file.
+ * @param buffer_size Size of the buffer for queued data, rounded up to a
+ *                    power of two. Writes wait while it is full.
  *
  * @return The handle for asynchronous writing.
  */
-ASYNCIO *aio_new(IOHANDLE io);
+ASYNCIO *aio_new(IOHANDLE io, unsigned buffer_size = 16 * 1024);
 
 /**
- * Locks the `ASYNCIO` structure so it can't be written into by
- * other threads.
+ * Starts a contiguous write. Data queued with
+ * @link aio_write_unlocked @endlink is collected by the calling thread
+ * and queued at once by @link aio_unlock @endlink, so writes of other
+ * threads can't end up in between.
  *
  * @ingroup File-IO
  *
@@ -353,8 +357,7 @@ ASYNCIO *aio_new(IOHANDLE io);
 void aio_lock(ASYNCIO *aio);
 
 /**
- * Unlocks the `ASYNCIO` structure after finishing the contiguous
- * write.
+ * Finishes the contiguous write and queues the collected data.
  *
  * @ingroup File-IO
  *
@@ -365,6 +368,11 @@ void aio_unlock(ASYNCIO *aio);
 /**
  * Queues a chunk of data for writing.
  *
+ * Does not take a lock, multiple threads can write concurrently. If the
+ * buffer is full, the call waits until the writer thread has made room,
+ * see @link aio_stats @endlink. Writes larger than the buffer are split
+ * and may be interleaved with writes of other threads.
+ *
  * @ingroup File-IO
  *
  * @param aio Handle to the file.
@@ -419,6 +427,35 @@ void aio_write_newline_unlocked(ASYNCIO *aio);
  */
 int aio_error(ASYNCIO *aio);
 
+/**
+ * Statistics of an asynchronous file handle.
+ *
+ * @ingroup File-IO
+ */
+typedef struct ASYNCIO_STATS
+{
+	uint64_t bytes;
+	uint64_t writes;
+	// Number of times queued data was written to the file
+	uint64_t flushes;
+	// Writes that had to wait because the buffer was full
+	uint64_t stalls;
+	// Total time spent waiting, see @link time_freq @endlink
+	int64_t stall_time;
+	// Bytes queued but not yet written to the file
+	uint64_t queued;
+} ASYNCIO_STATS;
+
+/**
+ * Gets statistics about the writes so far.
+ *
+ * @ingroup File-IO
+ *
+ * @param aio Handle to the file.
+ * @param stats Pointer to the statistics to fill.
+ */
+void aio_stats(ASYNCIO *aio, ASYNCIO_STATS *stats);
+
 /**
  * Queues file closing.
  *
@@ -783,6 +820,23 @@ NETSOCKET net_udp_create(NETADDR bindaddr);
  */
 int net_udp_send(NETSOCKET sock, const NETADDR *addr, const void *data, int size);
 
+/**
+ * Sends multiple packets to the same address over an UDP socket.
+ *
+ * @ingroup Network-UDP
+ *
+ * @param sock Socket to use.
+ * @param addr Where to send the packets.
+ * @param datas Pointers to the data of each packet.
+ * @param sizes Sizes of each packet.
+ * @param num Number of packets to send.
+ *
+ * @return The number of packets that were sent.
+ *
+ * @remark Uses a single system call for all packets where supported.
+ */
+int net_udp_send_batch(NETSOCKET sock, const NETADDR *addr, const void *const *datas, const int *sizes, int num);
+
 /**
  * Receives a packet over an UDP socket.
  *
@@ -1329,6 +1383,34 @@ int fs_rename(const char *oldname, const char *newname);
  */
 int fs_file_time(const char *name, time_t *created, time_t *modified);
 
+/**
+ * Maps a file into memory, so that it can be shared with other processes.
+ *
+ * @ingroup Filesystem
+ *
+ * @param name Path of the file.
+ * @param size Size of the mapping. When writing, the file is created or
+ *             truncated to this size. When reading, the size of the file is
+ *             stored here.
+ * @param write Whether to map the file writable instead of read-only.
+ *
+ * @return Pointer to the mapped memory, `nullptr` on failure.
+ *
+ * @remark The strings are treated as null-terminated strings.
+ * @remark The mapping must be released with @link fs_unmap_file @endlink.
+ */
+void *fs_map_file(const char *name, size_t *size, bool write);
+
+/**
+ * Releases a mapping created by @link fs_map_file @endlink.
+ *
+ * @ingroup Filesystem
+ *
+ * @param data Pointer to the mapped memory.
+ * @param size Size of the mapping.
+ */
+void fs_unmap_file(void *data, size_t size);
+
 /**
  * Swaps the endianness of data. Each element is swapped individually by reversing its bytes.
  *
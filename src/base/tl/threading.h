@@ -4,6 +4,7 @@
 #include "../system.h"
 
 #include <atomic>
+#include <cstddef>
 
 class CSemaphore
 {
@@ -29,4 +30,49 @@ public:
 	}
 };
 
+/**
+ * Bounded lock-free queue for exactly one producer thread and one consumer
+ * thread. Neither side ever blocks: @link TryPush @endlink fails when the
+ * queue is full and @link TryPop @endlink fails when it is empty.
+ *
+ * @tparam T Trivially copyable element type.
+ * @tparam Capacity Number of slots, must be a power of two.
+ */
+template<typename T, size_t Capacity>
+class CSpscQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	T m_aData[Capacity] = {};
+	// separate cache lines so producer and consumer do not invalidate each other
+	alignas(64) std::atomic<size_t> m_Head{0}; // next slot to read, owned by consumer
+	alignas(64) std::atomic<size_t> m_Tail{0}; // next slot to write, owned by producer
+
+public:
+	bool TryPush(const T &Value)
+	{
+		const size_t Tail = m_Tail.load(std::memory_order_relaxed);
+		if(Tail - m_Head.load(std::memory_order_acquire) == Capacity)
+			return false;
+		m_aData[Tail & (Capacity - 1)] = Value;
+		m_Tail.store(Tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool TryPop(T &Value)
+	{
+		const size_t Head = m_Head.load(std::memory_order_relaxed);
+		if(Head == m_Tail.load(std::memory_order_acquire))
+			return false;
+		Value = m_aData[Head & (Capacity - 1)];
+		m_Head.store(Head + 1, std::memory_order_release);
+		return true;
+	}
+
+	size_t ApproximateSize() const
+	{
+		return m_Tail.load(std::memory_order_relaxed) - m_Head.load(std::memory_order_relaxed);
+	}
+};
+
 #endif // BASE_TL_THREADING_H
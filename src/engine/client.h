@@ -17,6 +17,7 @@
 
 #include <functional>
 #include <optional>
+#include <vector>
 
 #define CONNECTLINK_DOUBLE_SLASH "ddnet://"
 #define CONNECTLINK_NO_SLASH "ddnet:"
@@ -238,6 +239,14 @@ public:
 	virtual int SnapNumItems(int SnapId) const = 0;
 	virtual const void *SnapFindItem(int SnapId, int Type, int Id) const = 0;
 	virtual CSnapItem SnapGetItem(int SnapId, int Index) const = 0;
+	/**
+	 * Returns the items of a type without scanning the whole snapshot.
+	 *
+	 * @param pNum Receives the number of items.
+	 *
+	 * @return Item indices for @link SnapGetItem @endlink, ordered by id.
+	 */
+	virtual const int *SnapItemsOfType(int SnapId, int Type, int *pNum) const = 0;
 
 	virtual void SnapSetStaticsize(int ItemType, int Size) = 0;
 	virtual void SnapSetStaticsize7(int ItemType, int Size) = 0;
@@ -400,6 +409,23 @@ public:
 	virtual void InitializeLanguage() = 0;
 
 	virtual void ForceUpdateConsoleRemoteCompletionSuggestions() = 0;
+
+	class CRenderProfileEntry
+	{
+	public:
+		const char *m_pName;
+		// Total time spent in OnRender, in units of time_freq()
+		int64_t m_Time;
+	};
+	/**
+	 * Starts or stops measuring the time each component spends rendering.
+	 * Starting resets the measured times.
+	 */
+	virtual void SetRenderProfiling(bool Enable) = 0;
+	/**
+	 * @return The measured render times, grouped by component type.
+	 */
+	virtual std::vector<CRenderProfileEntry> RenderProfile() const = 0;
 };
 
 extern IGameClient *CreateGameClient();
@@ -876,22 +876,24 @@ void CClient::LoadDebugFont()
 IClient::CSnapItem CClient::SnapGetItem(int SnapId, int Index) const
 {
 	dbg_assert(SnapId >= 0 && SnapId < NUM_SNAPSHOT_TYPES, "invalid SnapId");
-	const CSnapshot *pSnapshot = m_aapSnapshots[g_Config.m_ClDummy][SnapId]->m_pAltSnap;
-	const CSnapshotItem *pSnapshotItem = pSnapshot->GetItem(Index);
+	const CSnapshotStorage::CHolder *pHolder = m_aapSnapshots[g_Config.m_ClDummy][SnapId];
+	const CSnapshotItem *pSnapshotItem = pHolder->m_pAltSnap->GetItem(Index);
 	CSnapItem Item;
-	Item.m_Type = pSnapshot->GetItemType(Index);
+	Item.m_Type = pHolder->m_pAltIndex->ItemType(Index);
 	Item.m_Id = pSnapshotItem->Id();
 	Item.m_pData = pSnapshotItem->Data();
-	Item.m_DataSize = pSnapshot->GetItemSize(Index);
+	Item.m_DataSize = pHolder->m_pAltSnap->GetItemSize(Index);
 	return Item;
 }
 
 const void *CClient::SnapFindItem(int SnapId, int Type, int Id) const
 {
-	if(!m_aapSnapshots[g_Config.m_ClDummy][SnapId])
+	const CSnapshotStorage::CHolder *pHolder = m_aapSnapshots[g_Config.m_ClDummy][SnapId];
+	if(!pHolder)
 		return nullptr;
 
-	return m_aapSnapshots[g_Config.m_ClDummy][SnapId]->m_pAltSnap->FindItem(Type, Id);
+	const int Index = pHolder->m_pAltIndex->FindItemIndex(Type, Id);
+	return Index < 0 ? nullptr : pHolder->m_pAltSnap->GetItem(Index)->Data();
 }
 
 int CClient::SnapNumItems(int SnapId) const
@@ -902,6 +904,17 @@ int CClient::SnapNumItems(int SnapId) const
 	return m_aapSnapshots[g_Config.m_ClDummy][SnapId]->m_pAltSnap->NumItems();
 }
 
+const int *CClient::SnapItemsOfType(int SnapId, int Type, int *pNum) const
+{
+	dbg_assert(SnapId >= 0 && SnapId < NUM_SNAPSHOT_TYPES, "invalid SnapId");
+	if(!m_aapSnapshots[g_Config.m_ClDummy][SnapId])
+	{
+		*pNum = 0;
+		return nullptr;
+	}
+	return m_aapSnapshots[g_Config.m_ClDummy][SnapId]->m_pAltIndex->ItemsOfType(Type, pNum);
+}
+
 void CClient::SnapSetStaticsize(int ItemType, int Size)
 {
 	m_SnapshotDelta.SetStaticsize(ItemType, Size);
@@ -2656,6 +2669,7 @@ void CClient::OnDemoPlayerSnapshot(void *pData, int Size)
 	std::swap(m_aapSnapshots[0][SNAP_PREV], m_aapSnapshots[0][SNAP_CURRENT]);
 	mem_copy(m_aapSnapshots[0][SNAP_CURRENT]->m_pSnap, pData, Size);
 	mem_copy(m_aapSnapshots[0][SNAP_CURRENT]->m_pAltSnap, pAltSnapBuffer, AltSnapSize);
+	m_aapSnapshots[0][SNAP_CURRENT]->m_pAltIndex->Build(m_aapSnapshots[0][SNAP_CURRENT]->m_pAltSnap);
 
 	GameClient()->OnNewSnapshot();
 }
@@ -2711,6 +2725,12 @@ void CClient::Update()
 #endif
 
 			m_DemoPlayer.Update();
+			// the demo player pauses at the end of the demo
+			if(m_BenchmarkDemo && (!m_DemoPlayer.IsPlaying() || m_DemoPlayer.BaseInfo()->m_Paused))
+			{
+				FinishBenchmarkDemo();
+				return;
+			}
 
 			// update timers
 			const CDemoPlayer::CPlaybackInfo *pInfo = m_DemoPlayer.Info();
@@ -3212,6 +3232,12 @@ void CClient::Run()
 			m_aCmdPlayDemo[0] = 0;
 		}
 
+		// handle pending demo benchmark
+		if(m_aCmdBenchmarkDemo[0] && !m_BenchmarkDemo)
+		{
+			StartBenchmarkDemo();
+		}
+
 		// handle pending map edits
 		if(m_aCmdEditMap[0])
 		{
@@ -3283,7 +3309,7 @@ void CClient::Run()
 			Update();
 			int64_t Now = time_get();
 
-			bool IsRenderActive = (g_Config.m_GfxBackgroundRender || m_pGraphics->WindowOpen());
+			bool IsRenderActive = (g_Config.m_GfxBackgroundRender || m_pGraphics->WindowOpen() || m_BenchmarkDemo);
 
 			bool AsyncRenderOld = g_Config.m_GfxAsyncRenderOld;
 
@@ -3298,6 +3324,13 @@ void CClient::Run()
 			}
 #endif
 
+			// the benchmark renders every frame as fast as possible
+			if(m_BenchmarkDemo)
+			{
+				AsyncRenderOld = false;
+				GfxRefreshRate = 0;
+			}
+
 			if(IsRenderActive &&
 				(!AsyncRenderOld || m_pGraphics->IsIdle()) &&
 				(!GfxRefreshRate || (time_freq() / (int64_t)g_Config.m_GfxRefreshRate) <= Now - LastRenderTime))
@@ -3329,8 +3362,11 @@ void CClient::Run()
 				LastRenderTime = Now - AdditionalTime;
 				m_LastRenderTime = Now;
 
+				const int64_t RenderStartTime = time_get();
 				Render();
 				m_pGraphics->Swap();
+				if(m_BenchmarkDemo)
+					BenchmarkDemoFrame(time_get() - RenderStartTime);
 			}
 			else if(!IsRenderActive)
 			{
@@ -3352,7 +3388,11 @@ void CClient::Run()
 		auto Now = time_get_nanoseconds();
 		decltype(Now) SleepTimeInNanoSeconds{0};
 		bool Slept = false;
-		if(g_Config.m_ClRefreshRateInactive && !m_pGraphics->WindowActive())
+		if(m_BenchmarkDemo)
+		{
+			// never sleep while benchmarking
+		}
+		else if(g_Config.m_ClRefreshRateInactive && !m_pGraphics->WindowActive())
 		{
 			SleepTimeInNanoSeconds = (std::chrono::nanoseconds(1s) / (int64_t)g_Config.m_ClRefreshRateInactive) - (Now - LastTime);
 			std::this_thread::sleep_for(SleepTimeInNanoSeconds);
@@ -3989,6 +4029,8 @@ const char *CClient::DemoPlayer_Play(const char *pFilename, int StorageType)
 		m_aapSnapshots[0][SnapshotType]->m_pAltSnap = (CSnapshot *)&m_aaaDemorecSnapshotData[SnapshotType][1];
 		m_aapSnapshots[0][SnapshotType]->m_SnapSize = 0;
 		m_aapSnapshots[0][SnapshotType]->m_AltSnapSize = 0;
+		m_aapSnapshots[0][SnapshotType]->m_pAltIndex = &m_aDemorecSnapshotIndices[SnapshotType];
+		m_aapSnapshots[0][SnapshotType]->m_pAltIndex->Clear();
 		m_aapSnapshots[0][SnapshotType]->m_Tick = -1;
 	}
 
@@ -4169,6 +4211,114 @@ void CClient::BenchmarkQuit(int Seconds, const char *pFilename)
 	m_BenchmarkStopTime = time_get() + time_freq() * Seconds;
 }
 
+void CClient::Con_BenchmarkDemo(IConsole::IResult *pResult, void *pUserData)
+{
+	CClient *pSelf = (CClient *)pUserData;
+	if(pSelf->m_BenchmarkDemo)
+	{
+		log_error("benchmark", "a demo benchmark is already running");
+		return;
+	}
+	str_copy(pSelf->m_aCmdBenchmarkDemo, pResult->GetString(0));
+	str_copy(pSelf->m_aBenchmarkDemoOutput, pResult->NumArguments() > 1 ? pResult->GetString(1) : "");
+}
+
+void CClient::StartBenchmarkDemo()
+{
+	const char *pError = DemoPlayer_Play(m_aCmdBenchmarkDemo, IStorage::TYPE_ALL_OR_ABSOLUTE);
+	if(pError)
+	{
+		log_error("benchmark", "playing demo '%s' failed: %s", m_aCmdBenchmarkDemo, pError);
+		m_aCmdBenchmarkDemo[0] = '\0';
+		Quit();
+		return;
+	}
+
+	// Sounds are not part of the benchmark, the setting is restored at the end
+	m_BenchmarkDemoSndEnable = g_Config.m_SndEnable;
+	g_Config.m_SndEnable = 0;
+
+	m_DemoPlayer.SetSpeedIndex(DEMO_SPEED_INDEX_DEFAULT);
+	m_DemoPlayer.SetFixedTimeStep(time_freq() / BENCHMARK_DEMO_FRAME_RATE);
+	GameClient()->SetRenderProfiling(true);
+
+	m_BenchmarkDemo = true;
+	m_BenchmarkDemoFrames = 0;
+	m_BenchmarkDemoRenderTime = 0;
+	m_BenchmarkDemoPeakFrameBytes = 0;
+	m_BenchmarkDemoStartStats = m_pGraphics->CommandBufferStats();
+	m_BenchmarkDemoFrameStats = m_BenchmarkDemoStartStats;
+	m_BenchmarkDemoStartTime = time_get();
+}
+
+void CClient::BenchmarkDemoFrame(int64_t RenderTime)
+{
+	m_BenchmarkDemoFrames++;
+	m_BenchmarkDemoRenderTime += RenderTime;
+
+	const IEngineGraphics::CCommandBufferStats &Stats = m_pGraphics->CommandBufferStats();
+	const uint64_t FrameBytes = (Stats.m_CommandBytes - m_BenchmarkDemoFrameStats.m_CommandBytes) + (Stats.m_DataBytes - m_BenchmarkDemoFrameStats.m_DataBytes);
+	m_BenchmarkDemoPeakFrameBytes = std::max(m_BenchmarkDemoPeakFrameBytes, FrameBytes);
+	m_BenchmarkDemoFrameStats = Stats;
+}
+
+void CClient::FinishBenchmarkDemo()
+{
+	const int64_t Freq = time_freq();
+	const double Seconds = (time_get() - m_BenchmarkDemoStartTime) / (double)Freq;
+	const double Frames = std::max(m_BenchmarkDemoFrames, 1);
+
+	IOHANDLE File = nullptr;
+	if(m_aBenchmarkDemoOutput[0] != '\0')
+	{
+		File = Storage()->OpenFile(m_aBenchmarkDemoOutput, IOFLAG_WRITE, IStorage::TYPE_ABSOLUTE);
+		if(!File)
+			log_error("benchmark", "failed to open '%s' for writing", m_aBenchmarkDemoOutput);
+	}
+	auto &&Report = [File](const char *pLine) {
+		log_info("benchmark", "%s", pLine);
+		if(File)
+		{
+			io_write(File, pLine, str_length(pLine));
+			io_write_newline(File);
+		}
+	};
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "demo '%s': %d frames in %.3fs, %.1f fps", m_aCmdBenchmarkDemo, m_BenchmarkDemoFrames, Seconds, m_BenchmarkDemoFrames / std::max(Seconds, 1e-9));
+	Report(aBuf);
+	str_format(aBuf, sizeof(aBuf), "render: %.1f us/frame", m_BenchmarkDemoRenderTime * 1e6 / Freq / Frames);
+	Report(aBuf);
+	for(const IGameClient::CRenderProfileEntry &Entry : GameClient()->RenderProfile())
+	{
+		str_format(aBuf, sizeof(aBuf), "component %s: %.1f us/frame, %.1f%%", Entry.m_pName, Entry.m_Time * 1e6 / Freq / Frames, 100.0 * Entry.m_Time / std::max<int64_t>(m_BenchmarkDemoRenderTime, 1));
+		Report(aBuf);
+	}
+
+	const IEngineGraphics::CCommandBufferStats &Stats = m_pGraphics->CommandBufferStats();
+	const IEngineGraphics::CCommandBufferStats &Start = m_BenchmarkDemoStartStats;
+	str_format(aBuf, sizeof(aBuf), "command buffers: %.2f buffers/frame, %.1f commands/frame, %.1f render calls/frame",
+		(Stats.m_NumBuffers - Start.m_NumBuffers) / Frames,
+		(Stats.m_NumCommands - Start.m_NumCommands) / Frames,
+		(Stats.m_NumRenderCalls - Start.m_NumRenderCalls) / Frames);
+	Report(aBuf);
+	str_format(aBuf, sizeof(aBuf), "command buffer size: %.1f KiB commands/frame, %.1f KiB data/frame, peak %.1f KiB/frame",
+		(Stats.m_CommandBytes - Start.m_CommandBytes) / 1024.0 / Frames,
+		(Stats.m_DataBytes - Start.m_DataBytes) / 1024.0 / Frames,
+		m_BenchmarkDemoPeakFrameBytes / 1024.0);
+	Report(aBuf);
+
+	if(File)
+		io_close(File);
+
+	g_Config.m_SndEnable = m_BenchmarkDemoSndEnable;
+	m_DemoPlayer.SetFixedTimeStep(0);
+	GameClient()->SetRenderProfiling(false);
+	m_BenchmarkDemo = false;
+	m_aCmdBenchmarkDemo[0] = '\0';
+	Quit();
+}
+
 void CClient::UpdateAndSwap()
 {
 	Input()->Update();
@@ -4493,6 +4643,7 @@ void CClient::RegisterCommands()
 
 	m_pConsole->Register("save_replay", "?i[length] ?r[filename]", CFGFLAG_CLIENT, Con_SaveReplay, this, "Save a replay of the last defined amount of seconds");
 	m_pConsole->Register("benchmark_quit", "i[seconds] r[file]", CFGFLAG_CLIENT | CFGFLAG_STORE, Con_BenchmarkQuit, this, "Benchmark frame times for number of seconds to file, then quit");
+	m_pConsole->Register("benchmark_demo", "s[demo] ?r[file]", CFGFLAG_CLIENT, Con_BenchmarkDemo, this, "Render a demo as fast as possible without sound, report the render times to the log and optionally to a file, then quit");
 
 	RustVersionRegister(*m_pConsole);
 
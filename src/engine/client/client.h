@@ -202,6 +202,7 @@ class CClient : public IClient, public CDemoPlayer::IListener
 	int m_aSnapshotIncomingDataSize[NUM_DUMMIES] = {0, 0};
 
 	CSnapshotStorage::CHolder m_aDemorecSnapshotHolders[NUM_SNAPSHOT_TYPES];
+	CSnapshotIndex m_aDemorecSnapshotIndices[NUM_SNAPSHOT_TYPES];
 	char m_aaaDemorecSnapshotData[NUM_SNAPSHOT_TYPES][2][CSnapshot::MAX_SIZE];
 
 	CSnapshotDelta m_SnapshotDelta;
@@ -247,6 +248,23 @@ class CClient : public IClient, public CDemoPlayer::IListener
 	IOHANDLE m_BenchmarkFile = nullptr;
 	int64_t m_BenchmarkStopTime = 0;
 
+	// benchmark_demo
+	enum
+	{
+		// Demo time rendered per frame, independent of how long the frame took
+		BENCHMARK_DEMO_FRAME_RATE = 60,
+	};
+	char m_aCmdBenchmarkDemo[IO_MAX_PATH_LENGTH] = "";
+	char m_aBenchmarkDemoOutput[IO_MAX_PATH_LENGTH] = "";
+	bool m_BenchmarkDemo = false;
+	int m_BenchmarkDemoSndEnable = 0;
+	int m_BenchmarkDemoFrames = 0;
+	int64_t m_BenchmarkDemoStartTime = 0;
+	int64_t m_BenchmarkDemoRenderTime = 0;
+	uint64_t m_BenchmarkDemoPeakFrameBytes = 0;
+	IEngineGraphics::CCommandBufferStats m_BenchmarkDemoStartStats;
+	IEngineGraphics::CCommandBufferStats m_BenchmarkDemoFrameStats;
+
 	CChecksum m_Checksum;
 	int64_t m_OwnExecutableSize = 0;
 	IOHANDLE m_OwnExecutable = nullptr;
@@ -354,6 +372,7 @@ public:
 	int GetPredictionTick() override;
 	const void *SnapFindItem(int SnapId, int Type, int Id) const override;
 	int SnapNumItems(int SnapId) const override;
+	const int *SnapItemsOfType(int SnapId, int Type, int *pNum) const override;
 	void SnapSetStaticsize(int ItemType, int Size) override;
 	void SnapSetStaticsize7(int ItemType, int Size) override;
 
@@ -449,6 +468,7 @@ public:
 	static void Con_StopRecord(IConsole::IResult *pResult, void *pUserData);
 	static void Con_AddDemoMarker(IConsole::IResult *pResult, void *pUserData);
 	static void Con_BenchmarkQuit(IConsole::IResult *pResult, void *pUserData);
+	static void Con_BenchmarkDemo(IConsole::IResult *pResult, void *pUserData);
 	static void ConchainServerBrowserUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainFullscreen(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainWindowBordered(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
@@ -499,6 +519,9 @@ public:
 	void Notify(const char *pTitle, const char *pMessage) override;
 	void OnWindowResize() override;
 	void BenchmarkQuit(int Seconds, const char *pFilename);
+	void StartBenchmarkDemo();
+	void BenchmarkDemoFrame(int64_t RenderTime);
+	void FinishBenchmarkDemo();
 
 	void UpdateAndSwap() override;
 
@@ -0,0 +1,166 @@
+#include "glyph_cache.h"
+
+#include <base/log.h>
+#include <base/system.h>
+
+#include <engine/storage.h>
+
+#include <iterator>
+
+static constexpr char GLYPH_CACHE_MARKER[] = "TWGLYPHC";
+
+size_t CGlyphCache::SKeyHash::operator()(const std::tuple<uint64_t, int, int> &Key) const
+{
+	size_t Hash = 17;
+	Hash = Hash * 31 + std::hash<uint64_t>()(std::get<0>(Key));
+	Hash = Hash * 31 + std::hash<int>()(std::get<1>(Key));
+	Hash = Hash * 31 + std::hash<int>()(std::get<2>(Key));
+	return Hash;
+}
+
+CGlyphCache::ELoadResult CGlyphCache::Load(IStorage *pStorage, const char *pFilename, int FreetypeVersion)
+{
+	m_Glyphs.clear();
+	m_Dirty = false;
+
+	void *pFileData;
+	unsigned FileSize;
+	if(!pStorage->ReadFile(pFilename, IStorage::TYPE_SAVE, &pFileData, &FileSize))
+		return ELoadResult::MISSING;
+
+	const unsigned char *pData = static_cast<const unsigned char *>(pFileData);
+	const unsigned char *pEnd = pData + FileSize;
+	const auto ReadInt = [&](int &Value) {
+		if(pEnd - pData < (ptrdiff_t)sizeof(int32_t))
+			return false;
+		Value = bytes_be_to_uint(pData);
+		pData += sizeof(int32_t);
+		return true;
+	};
+
+	const bool ValidMarker = FileSize >= sizeof(GLYPH_CACHE_MARKER) - 1 && mem_comp(pData, GLYPH_CACHE_MARKER, sizeof(GLYPH_CACHE_MARKER) - 1) == 0;
+	if(ValidMarker)
+		pData += sizeof(GLYPH_CACHE_MARKER) - 1;
+	int Version, CacheFreetypeVersion;
+	if(!ValidMarker ||
+		!ReadInt(Version) || Version != (int)VERSION ||
+		!ReadInt(CacheFreetypeVersion) || CacheFreetypeVersion != FreetypeVersion)
+	{
+		log_info("textrender", "Discarding outdated glyph cache '%s'", pFilename);
+		free(pFileData);
+		return ELoadResult::OUTDATED;
+	}
+
+	int NumGlyphs;
+	bool Valid = ReadInt(NumGlyphs) && NumGlyphs >= 0 && NumGlyphs <= (int)MAX_GLYPHS;
+	for(int i = 0; i < NumGlyphs && Valid; ++i)
+	{
+		SCachedGlyph Glyph;
+		int aFaceHash[2], GlyphIndex;
+		Valid = ReadInt(aFaceHash[0]) && ReadInt(aFaceHash[1]) && ReadInt(Glyph.m_Chr) && ReadInt(Glyph.m_FontSize) && ReadInt(GlyphIndex) &&
+			ReadInt(Glyph.m_Width) && ReadInt(Glyph.m_Height) && ReadInt(Glyph.m_CharWidth) && ReadInt(Glyph.m_CharHeight) &&
+			ReadInt(Glyph.m_OffsetX) && ReadInt(Glyph.m_OffsetY) && ReadInt(Glyph.m_AdvanceX);
+		if(!Valid || Glyph.m_Width < 0 || Glyph.m_Height < 0 || Glyph.m_Width > MAX_GLYPH_DIMENSION || Glyph.m_Height > MAX_GLYPH_DIMENSION)
+		{
+			Valid = false;
+			break;
+		}
+
+		const size_t GlyphDataSize = (size_t)Glyph.m_Width * Glyph.m_Height;
+		if((size_t)(pEnd - pData) < GlyphDataSize * 2)
+		{
+			Valid = false;
+			break;
+		}
+		Glyph.m_vFill.assign(pData, pData + GlyphDataSize);
+		pData += GlyphDataSize;
+		Glyph.m_vOutline.assign(pData, pData + GlyphDataSize);
+		pData += GlyphDataSize;
+
+		Glyph.m_FaceHash = ((uint64_t)(unsigned)aFaceHash[0] << 32) | (unsigned)aFaceHash[1];
+		Glyph.m_GlyphIndex = GlyphIndex;
+		m_Glyphs[std::make_tuple(Glyph.m_FaceHash, Glyph.m_Chr, Glyph.m_FontSize)] = std::move(Glyph);
+	}
+	// trailing data is corruption as well
+	Valid = Valid && pData == pEnd;
+	free(pFileData);
+
+	if(!Valid)
+	{
+		log_error("textrender", "Glyph cache '%s' is corrupted", pFilename);
+		m_Glyphs.clear();
+		return ELoadResult::CORRUPTED;
+	}
+
+	log_debug("textrender", "Loaded %" PRIzu " glyphs from glyph cache '%s'", m_Glyphs.size(), pFilename);
+	return ELoadResult::LOADED;
+}
+
+bool CGlyphCache::Save(IStorage *pStorage, const char *pFilename, int FreetypeVersion)
+{
+	if(!m_Dirty)
+		return true;
+
+	std::vector<unsigned char> vData;
+	const auto WriteInt = [&](int Value) {
+		unsigned char aBuf[sizeof(int32_t)];
+		uint_to_bytes_be(aBuf, Value);
+		vData.insert(vData.end(), std::begin(aBuf), std::end(aBuf));
+	};
+
+	vData.insert(vData.end(), GLYPH_CACHE_MARKER, GLYPH_CACHE_MARKER + sizeof(GLYPH_CACHE_MARKER) - 1);
+	WriteInt(VERSION);
+	WriteInt(FreetypeVersion);
+	WriteInt(m_Glyphs.size());
+	for(const auto &[Key, Glyph] : m_Glyphs)
+	{
+		WriteInt(Glyph.m_FaceHash >> 32);
+		WriteInt(Glyph.m_FaceHash & 0xffffffff);
+		WriteInt(Glyph.m_Chr);
+		WriteInt(Glyph.m_FontSize);
+		WriteInt(Glyph.m_GlyphIndex);
+		WriteInt(Glyph.m_Width);
+		WriteInt(Glyph.m_Height);
+		WriteInt(Glyph.m_CharWidth);
+		WriteInt(Glyph.m_CharHeight);
+		WriteInt(Glyph.m_OffsetX);
+		WriteInt(Glyph.m_OffsetY);
+		WriteInt(Glyph.m_AdvanceX);
+		vData.insert(vData.end(), Glyph.m_vFill.begin(), Glyph.m_vFill.end());
+		vData.insert(vData.end(), Glyph.m_vOutline.begin(), Glyph.m_vOutline.end());
+	}
+
+	IOHANDLE File = pStorage->OpenFile(pFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	if(!File)
+	{
+		log_error("textrender", "Failed to open glyph cache '%s' for writing", pFilename);
+		return false;
+	}
+	const bool Success = io_write(File, vData.data(), vData.size()) == vData.size();
+	if(!Success)
+	{
+		log_error("textrender", "Failed to write glyph cache '%s'", pFilename);
+	}
+	io_close(File);
+	m_Dirty = !Success;
+	return Success;
+}
+
+bool CGlyphCache::Add(SCachedGlyph &&Glyph)
+{
+	if(m_Glyphs.size() >= MAX_GLYPHS ||
+		Glyph.m_Width < 0 || Glyph.m_Height < 0 || Glyph.m_Width > MAX_GLYPH_DIMENSION || Glyph.m_Height > MAX_GLYPH_DIMENSION ||
+		Glyph.m_vFill.size() != (size_t)Glyph.m_Width * Glyph.m_Height || Glyph.m_vOutline.size() != Glyph.m_vFill.size())
+	{
+		return false;
+	}
+	m_Glyphs[std::make_tuple(Glyph.m_FaceHash, Glyph.m_Chr, Glyph.m_FontSize)] = std::move(Glyph);
+	m_Dirty = true;
+	return true;
+}
+
+const SCachedGlyph *CGlyphCache::Find(uint64_t FaceHash, int Chr, int FontSize) const
+{
+	const auto Glyph = m_Glyphs.find(std::make_tuple(FaceHash, Chr, FontSize));
+	return Glyph == m_Glyphs.end() ? nullptr : &Glyph->second;
+}
@@ -0,0 +1,104 @@
+#ifndef ENGINE_CLIENT_GLYPH_CACHE_H
+#define ENGINE_CLIENT_GLYPH_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+class IStorage;
+
+/**
+ * Rasterized glyph as stored in the on-disk glyph cache.
+ * Identified by the hash of the font face instead of the FT_Face handle,
+ * so entries stay valid across restarts as long as the font file is unchanged.
+ */
+struct SCachedGlyph
+{
+	uint64_t m_FaceHash;
+	int m_Chr;
+	int m_FontSize;
+	unsigned m_GlyphIndex;
+
+	int m_Width;
+	int m_Height;
+	int m_CharWidth;
+	int m_CharHeight;
+	int m_OffsetX;
+	int m_OffsetY;
+	int m_AdvanceX;
+
+	// m_Width * m_Height bytes each
+	std::vector<uint8_t> m_vFill;
+	std::vector<uint8_t> m_vOutline;
+};
+
+/**
+ * Rasterized glyphs kept between restarts, keyed by the font face hash,
+ * the character and the font size.
+ */
+class CGlyphCache
+{
+public:
+	/**
+	 * File in the user directory storing the glyph cache.
+	 */
+	static constexpr const char *FILENAME = "cache/glyphs.dat";
+
+	/**
+	 * Increase when the rasterization, the outline generation or the file
+	 * format changes, so existing glyph caches are discarded.
+	 */
+	static constexpr unsigned VERSION = 1;
+
+	/**
+	 * Limits the size of the glyph cache file and its memory usage.
+	 */
+	static constexpr size_t MAX_GLYPHS = 16 * 1024;
+
+	/**
+	 * Glyphs with a larger width or height in the file are treated as corruption.
+	 */
+	static constexpr int MAX_GLYPH_DIMENSION = 1024;
+
+	enum class ELoadResult
+	{
+		LOADED,
+		MISSING,
+		// Written by another version or for another rasterizer
+		OUTDATED,
+		CORRUPTED,
+	};
+
+	/**
+	 * Replaces the glyphs with the ones from the file. Keeps no glyphs
+	 * unless the whole file is valid.
+	 *
+	 * @param FreetypeVersion Version of the rasterizer, glyphs of other versions are discarded.
+	 */
+	ELoadResult Load(IStorage *pStorage, const char *pFilename, int FreetypeVersion);
+	/**
+	 * Writes the glyphs if they changed since loading or saving.
+	 */
+	bool Save(IStorage *pStorage, const char *pFilename, int FreetypeVersion);
+
+	/**
+	 * @return false if the cache is full or the bitmaps don't match the size of the glyph.
+	 */
+	bool Add(SCachedGlyph &&Glyph);
+	const SCachedGlyph *Find(uint64_t FaceHash, int Chr, int FontSize) const;
+	size_t Size() const { return m_Glyphs.size(); }
+	bool IsDirty() const { return m_Dirty; }
+
+private:
+	struct SKeyHash
+	{
+		size_t operator()(const std::tuple<uint64_t, int, int> &Key) const;
+	};
+
+	std::unordered_map<std::tuple<uint64_t, int, int>, SCachedGlyph, SKeyHash> m_Glyphs;
+	bool m_Dirty = false;
+};
+
+#endif
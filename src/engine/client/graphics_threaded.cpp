@@ -649,6 +649,12 @@ bool CGraphics_Threaded::IsImageFormatRgba(const char *pContextName, const CImag
 
 void CGraphics_Threaded::KickCommandBuffer()
 {
+	m_CommandBufferStats.m_NumBuffers++;
+	m_CommandBufferStats.m_NumCommands += m_pCommandBuffer->m_CommandCount;
+	m_CommandBufferStats.m_NumRenderCalls += m_pCommandBuffer->m_RenderCallCount;
+	m_CommandBufferStats.m_CommandBytes += m_pCommandBuffer->m_CmdBuffer.DataUsed();
+	m_CommandBufferStats.m_DataBytes += m_pCommandBuffer->m_DataBuffer.DataUsed();
+
 	m_pBackend->RunBuffer(m_pCommandBuffer);
 
 	std::vector<std::string> WarningStrings;
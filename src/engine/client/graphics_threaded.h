@@ -760,6 +760,7 @@ class CGraphics_Threaded : public IEngineGraphics
 	CCommandBuffer *m_apCommandBuffers[2];
 	CCommandBuffer *m_pCommandBuffer;
 	unsigned m_CurrentCommandBuffer;
+	CCommandBufferStats m_CommandBufferStats;
 
 	//
 	class IStorage *m_pStorage;
@@ -1225,6 +1226,8 @@ public:
 	int WindowActive() override;
 	int WindowOpen() override;
 
+	const CCommandBufferStats &CommandBufferStats() const override { return m_CommandBufferStats; }
+
 	void SetWindowGrab(bool Grab) override;
 	void NotifyWindow() override;
 
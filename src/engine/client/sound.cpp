@@ -25,27 +25,51 @@ extern "C" {
 static constexpr int SAMPLE_INDEX_USED = -2;
 static constexpr int SAMPLE_INDEX_FULL = -1;
 
+// Kept free of loop-carried dependencies so that the compiler can vectorize them
+static void MixMono(int *pOut, const short *pIn, unsigned Frames, int VolumeL, int VolumeR)
+{
+	for(unsigned i = 0; i < Frames; i++)
+	{
+		pOut[i * 2] += pIn[i] * VolumeL;
+		pOut[i * 2 + 1] += pIn[i] * VolumeR;
+	}
+}
+
+static void MixStereo(int *pOut, const short *pIn, unsigned Frames, int VolumeL, int VolumeR)
+{
+	for(unsigned i = 0; i < Frames; i++)
+	{
+		pOut[i * 2] += pIn[i * 2] * VolumeL;
+		pOut[i * 2 + 1] += pIn[i * 2 + 1] * VolumeR;
+	}
+}
+
+static void ClampMix(short *pFinalOut, const int *pMix, unsigned Samples, int MasterVol)
+{
+	for(unsigned i = 0; i < Samples; i++)
+		pFinalOut[i] = std::clamp<int>(((pMix[i] * MasterVol) / 101) >> 8, std::numeric_limits<short>::min(), std::numeric_limits<short>::max());
+}
+
 void CSound::Mix(short *pFinalOut, unsigned Frames)
 {
 	Frames = minimum(Frames, m_MaxFrames);
 	mem_zero(m_pMixBuffer, Frames * 2 * sizeof(int));
 
-	// acquire lock while we are mixing
+	// acquire lock while we are mixing, this only blocks loading and unloading samples
 	m_SoundLock.lock();
 
+	ProcessCommands();
+
 	const int MasterVol = m_SoundVolume.load(std::memory_order_relaxed);
 
-	for(auto &Voice : m_aVoices)
+	for(int VoiceId = 0; VoiceId < NUM_VOICES; VoiceId++)
 	{
+		CVoice &Voice = m_aVoices[VoiceId];
 		if(!Voice.m_pSample)
 			continue;
 
-		// mix voice
-		int *pOut = m_pMixBuffer;
-
-		const int Step = Voice.m_pSample->m_Channels; // setup input sources
-		short *pInL = &Voice.m_pSample->m_pData[Voice.m_Tick * Step];
-		short *pInR = &Voice.m_pSample->m_pData[Voice.m_Tick * Step + 1];
+		// setup input source
+		const short *pIn = &Voice.m_pSample->m_pData[Voice.m_Tick * Voice.m_pSample->m_Channels];
 
 		unsigned End = Voice.m_pSample->m_NumFrames - Voice.m_Tick;
 
@@ -56,10 +80,6 @@ void CSound::Mix(short *pFinalOut, unsigned Frames)
 		if(Frames < End)
 			End = Frames;
 
-		// check if we have a mono sound
-		if(Voice.m_pSample->m_Channels == 1)
-			pInR = pInL;
-
 		// volume calculation
 		if(Voice.m_Flags & ISound::FLAG_POS && Voice.m_pChannel->m_Pan)
 		{
@@ -133,14 +153,11 @@ void CSound::Mix(short *pFinalOut, unsigned Frames)
 		}
 
 		// process all frames
-		for(unsigned s = 0; s < End; s++)
-		{
-			*pOut++ += (*pInL) * VolumeL;
-			*pOut++ += (*pInR) * VolumeR;
-			pInL += Step;
-			pInR += Step;
-			Voice.m_Tick++;
-		}
+		if(Voice.m_pSample->m_Channels == 1)
+			MixMono(m_pMixBuffer, pIn, End, VolumeL, VolumeR);
+		else
+			MixStereo(m_pMixBuffer, pIn, End, VolumeL, VolumeR);
+		Voice.m_Tick += End;
 
 		// free voice if not used any more
 		if(Voice.m_Tick == Voice.m_pSample->m_NumFrames)
@@ -150,7 +167,7 @@ void CSound::Mix(short *pFinalOut, unsigned Frames)
 			else
 			{
 				Voice.m_pSample = nullptr;
-				Voice.m_Age++;
+				m_aVoiceFinishedAge[VoiceId].store(Voice.m_Age, std::memory_order_release);
 			}
 		}
 	}
@@ -158,8 +175,7 @@ void CSound::Mix(short *pFinalOut, unsigned Frames)
 	m_SoundLock.unlock();
 
 	// clamp accumulated values
-	for(unsigned i = 0; i < Frames * 2; i++)
-		pFinalOut[i] = std::clamp<int>(((m_pMixBuffer[i] * MasterVol) / 101) >> 8, std::numeric_limits<short>::min(), std::numeric_limits<short>::max());
+	ClampMix(pFinalOut, m_pMixBuffer, Frames * 2, MasterVol);
 
 #if defined(CONF_ARCH_ENDIAN_BIG)
 	swap_endian(pFinalOut, sizeof(short), Frames * 2);
@@ -202,6 +218,8 @@ int CSound::Init()
 	}
 	m_aSamples[std::size(m_aSamples) - 1].m_Index = std::size(m_aSamples) - 1;
 	m_aSamples[std::size(m_aSamples) - 1].m_NextFreeSampleIndex = SAMPLE_INDEX_FULL;
+	for(auto &FinishedAge : m_aVoiceFinishedAge)
+		FinishedAge.store(-1, std::memory_order_relaxed);
 
 	if(!g_Config.m_SndEnable)
 		return 0;
@@ -268,6 +286,7 @@ void CSound::Shutdown()
 	m_Device = 0;
 
 	const CLockScope LockScope(m_SoundLock);
+	ProcessCommands();
 	for(auto &Sample : m_aSamples)
 	{
 		free(Sample.m_pData);
@@ -640,7 +659,15 @@ void CSound::UnloadSample(int SampleId)
 		return;
 
 	dbg_assert(SampleId >= 0 && SampleId < NUM_SAMPLES, "SampleId invalid");
+	for(int VoiceId = 0; VoiceId < NUM_VOICES; VoiceId++)
+	{
+		if(m_aVoiceSlots[VoiceId].m_SampleId == SampleId)
+			ReleaseVoiceSlot(VoiceId);
+	}
+
 	const CLockScope LockScope(m_SoundLock);
+	// queued commands may still refer to this sample
+	ProcessCommands();
 	CSample &Sample = m_aSamples[SampleId];
 
 	if(Sample.IsLoaded())
@@ -681,6 +708,7 @@ float CSound::GetSampleCurrentTime(int SampleId)
 	dbg_assert(SampleId >= 0 && SampleId < NUM_SAMPLES, "SampleId invalid");
 
 	const CLockScope LockScope(m_SoundLock);
+	ProcessCommands();
 	dbg_assert(m_aSamples[SampleId].IsLoaded(), "Sample not loaded");
 	CSample *pSample = &m_aSamples[SampleId];
 	for(auto &Voice : m_aVoices)
@@ -697,29 +725,25 @@ float CSound::GetSampleCurrentTime(int SampleId)
 void CSound::SetSampleCurrentTime(int SampleId, float Time)
 {
 	dbg_assert(SampleId >= 0 && SampleId < NUM_SAMPLES, "SampleId invalid");
-
-	const CLockScope LockScope(m_SoundLock);
 	dbg_assert(m_aSamples[SampleId].IsLoaded(), "Sample not loaded");
-	CSample *pSample = &m_aSamples[SampleId];
-	for(auto &Voice : m_aVoices)
-	{
-		if(Voice.m_pSample == pSample)
-		{
-			Voice.m_Tick = pSample->m_NumFrames * Time;
-			return;
-		}
-	}
 
-	pSample->m_PausedAt = pSample->m_NumFrames * Time;
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::SET_SAMPLE_TIME;
+	Command.m_SampleId = SampleId;
+	Command.m_Value = Time;
+	PushCommand(Command);
 }
 
 void CSound::SetChannel(int ChannelId, float Vol, float Pan)
 {
 	dbg_assert(ChannelId >= 0 && ChannelId < NUM_CHANNELS, "ChannelId invalid");
 
-	const CLockScope LockScope(m_SoundLock);
-	m_aChannels[ChannelId].m_Vol = (int)(Vol * 255.0f);
-	m_aChannels[ChannelId].m_Pan = (int)(Pan * 255.0f); // TODO: this is only on and off right now
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::SET_CHANNEL;
+	Command.m_ChannelId = ChannelId;
+	Command.m_Vol = (int)(Vol * 255.0f);
+	Command.m_Pan = (int)(Pan * 255.0f); // TODO: this is only on and off right now
+	PushCommand(Command);
 }
 
 void CSound::SetListenerPosition(vec2 Position)
@@ -728,125 +752,295 @@ void CSound::SetListenerPosition(vec2 Position)
 	m_ListenerPositionY.store(Position.y, std::memory_order_relaxed);
 }
 
-void CSound::SetVoiceVolume(CVoiceHandle Voice, float Volume)
+bool CSound::IsVoiceSlotFree(int VoiceId)
 {
-	if(!Voice.IsValid())
-		return;
-
-	int VoiceId = Voice.Id();
-
-	const CLockScope LockScope(m_SoundLock);
-	if(m_aVoices[VoiceId].m_Age != Voice.Age())
-		return;
+	CVoiceSlot &Slot = m_aVoiceSlots[VoiceId];
+	if(Slot.m_SampleId != -1 && m_aVoiceFinishedAge[VoiceId].load(std::memory_order_acquire) == Slot.m_Age)
+		ReleaseVoiceSlot(VoiceId);
+	return Slot.m_SampleId == -1;
+}
 
-	Volume = std::clamp(Volume, 0.0f, 1.0f);
-	m_aVoices[VoiceId].m_Vol = (int)(Volume * 255.0f);
+void CSound::ReleaseVoiceSlot(int VoiceId)
+{
+	m_aVoiceSlots[VoiceId].m_SampleId = -1;
+	m_aVoiceSlots[VoiceId].m_Age++;
 }
 
-void CSound::SetVoiceFalloff(CVoiceHandle Voice, float Falloff)
+int CSound::FindVoice(CVoiceHandle Voice)
 {
 	if(!Voice.IsValid())
-		return;
+		return -1;
 
-	int VoiceId = Voice.Id();
+	const int VoiceId = Voice.Id();
+	if(IsVoiceSlotFree(VoiceId) || m_aVoiceSlots[VoiceId].m_Age != Voice.Age())
+		return -1;
+	return VoiceId;
+}
 
-	const CLockScope LockScope(m_SoundLock);
-	if(m_aVoices[VoiceId].m_Age != Voice.Age())
-		return;
+void CSound::PushCommand(const CSoundCommand &Command)
+{
+	while(!m_Commands.TryPush(Command))
+	{
+		// The mixer is not keeping up or not running at all, e.g. because
+		// sound is disabled or the device is paused. Drain the queue here.
+		const CLockScope LockScope(m_SoundLock);
+		ProcessCommands();
+	}
+}
 
-	Falloff = std::clamp(Falloff, 0.0f, 1.0f);
-	m_aVoices[VoiceId].m_Falloff = Falloff;
+void CSound::ProcessCommands()
+{
+	CSoundCommand Command;
+	while(m_Commands.TryPop(Command))
+		ExecuteCommand(Command);
 }
 
-void CSound::SetVoicePosition(CVoiceHandle Voice, vec2 Position)
+void CSound::ExecuteCommand(const CSoundCommand &Command)
 {
-	if(!Voice.IsValid())
+	switch(Command.m_Type)
+	{
+	case CSoundCommand::PLAY:
+		ExecutePlay(Command);
 		return;
+	case CSoundCommand::SET_CHANNEL:
+		m_aChannels[Command.m_ChannelId].m_Vol = Command.m_Vol;
+		m_aChannels[Command.m_ChannelId].m_Pan = Command.m_Pan;
+		return;
+	case CSoundCommand::SET_SAMPLE_TIME:
+	{
+		CSample *pSample = &m_aSamples[Command.m_SampleId];
+		if(!pSample->IsLoaded())
+			return;
+		for(auto &Voice : m_aVoices)
+		{
+			if(Voice.m_pSample == pSample)
+			{
+				Voice.m_Tick = pSample->m_NumFrames * Command.m_Value;
+				return;
+			}
+		}
+		pSample->m_PausedAt = pSample->m_NumFrames * Command.m_Value;
+		return;
+	}
+	case CSoundCommand::PAUSE_SAMPLE:
+	case CSoundCommand::STOP_SAMPLE:
+	{
+		// TODO: a nice fade out
+		CSample *pSample = &m_aSamples[Command.m_SampleId];
+		for(auto &Voice : m_aVoices)
+		{
+			if(Voice.m_pSample == pSample)
+			{
+				if(Command.m_Type == CSoundCommand::PAUSE_SAMPLE || Voice.m_Flags & FLAG_LOOP)
+					Voice.m_pSample->m_PausedAt = Voice.m_Tick;
+				else
+					Voice.m_pSample->m_PausedAt = 0;
+				Voice.m_pSample = nullptr;
+			}
+		}
+		return;
+	}
+	case CSoundCommand::STOP_ALL:
+		// TODO: a nice fade out
+		for(auto &Voice : m_aVoices)
+		{
+			if(Voice.m_pSample)
+			{
+				if(Voice.m_Flags & FLAG_LOOP)
+					Voice.m_pSample->m_PausedAt = Voice.m_Tick;
+				else
+					Voice.m_pSample->m_PausedAt = 0;
+			}
+			Voice.m_pSample = nullptr;
+		}
+		return;
+	}
 
-	int VoiceId = Voice.Id();
-
-	const CLockScope LockScope(m_SoundLock);
-	if(m_aVoices[VoiceId].m_Age != Voice.Age())
+	// all remaining commands operate on a voice that may have finished in the meantime
+	CVoice &Voice = m_aVoices[Command.m_VoiceId];
+	if(!Voice.m_pSample || Voice.m_Age != Command.m_Age)
 		return;
 
-	m_aVoices[VoiceId].m_Position = Position;
+	switch(Command.m_Type)
+	{
+	case CSoundCommand::STOP_VOICE:
+		Voice.m_pSample = nullptr;
+		break;
+	case CSoundCommand::SET_VOICE_VOLUME:
+		Voice.m_Vol = Command.m_Vol;
+		break;
+	case CSoundCommand::SET_VOICE_FALLOFF:
+		Voice.m_Falloff = Command.m_Value;
+		break;
+	case CSoundCommand::SET_VOICE_POSITION:
+		Voice.m_Position = Command.m_Position;
+		break;
+	case CSoundCommand::SET_VOICE_TIME_OFFSET:
+		ExecuteSetVoiceTimeOffset(Voice, Command.m_Value);
+		break;
+	case CSoundCommand::SET_VOICE_CIRCLE:
+		Voice.m_Shape = ISound::SHAPE_CIRCLE;
+		Voice.m_Circle.m_Radius = Command.m_Size.x;
+		break;
+	case CSoundCommand::SET_VOICE_RECTANGLE:
+		Voice.m_Shape = ISound::SHAPE_RECTANGLE;
+		Voice.m_Rectangle.m_Width = Command.m_Size.x;
+		Voice.m_Rectangle.m_Height = Command.m_Size.y;
+		break;
+	default:
+		dbg_assert(false, "invalid sound command type %d", Command.m_Type);
+	}
 }
 
-void CSound::SetVoiceTimeOffset(CVoiceHandle Voice, float TimeOffset)
+void CSound::ExecutePlay(const CSoundCommand &Command)
 {
-	if(!Voice.IsValid())
-		return;
-
-	int VoiceId = Voice.Id();
-
-	const CLockScope LockScope(m_SoundLock);
-	if(m_aVoices[VoiceId].m_Age != Voice.Age())
+	CSample &Sample = m_aSamples[Command.m_SampleId];
+	if(!Sample.IsLoaded())
+	{
+		// nothing to play, release the voice like a finished one
+		m_aVoiceFinishedAge[Command.m_VoiceId].store(Command.m_Age, std::memory_order_release);
 		return;
+	}
 
-	if(!m_aVoices[VoiceId].m_pSample)
-		return;
+	CVoice &Voice = m_aVoices[Command.m_VoiceId];
+	Voice.m_pSample = &Sample;
+	Voice.m_pChannel = &m_aChannels[Command.m_ChannelId];
+	Voice.m_Age = Command.m_Age;
+	if(Command.m_Flags & FLAG_LOOP)
+	{
+		Voice.m_Tick = Sample.m_PausedAt;
+	}
+	else if(Command.m_Flags & FLAG_PREVIEW)
+	{
+		Voice.m_Tick = Sample.m_PausedAt;
+		Sample.m_PausedAt = 0;
+	}
+	else
+	{
+		Voice.m_Tick = 0;
+	}
+	Voice.m_Vol = Command.m_Vol;
+	Voice.m_Flags = Command.m_Flags;
+	Voice.m_Position = Command.m_Position;
+	Voice.m_Falloff = 0.0f;
+	Voice.m_Shape = ISound::SHAPE_CIRCLE;
+	Voice.m_Circle.m_Radius = 1500;
+}
 
+void CSound::ExecuteSetVoiceTimeOffset(CVoice &Voice, float TimeOffset)
+{
 	int Tick = 0;
-	bool IsLooping = m_aVoices[VoiceId].m_Flags & ISound::FLAG_LOOP;
-	uint64_t TickOffset = m_aVoices[VoiceId].m_pSample->m_Rate * TimeOffset;
-	if(m_aVoices[VoiceId].m_pSample->m_NumFrames > 0 && IsLooping)
-		Tick = TickOffset % m_aVoices[VoiceId].m_pSample->m_NumFrames;
+	bool IsLooping = Voice.m_Flags & ISound::FLAG_LOOP;
+	uint64_t TickOffset = Voice.m_pSample->m_Rate * TimeOffset;
+	if(Voice.m_pSample->m_NumFrames > 0 && IsLooping)
+		Tick = TickOffset % Voice.m_pSample->m_NumFrames;
 	else
-		Tick = std::clamp(TickOffset, (uint64_t)0, (uint64_t)m_aVoices[VoiceId].m_pSample->m_NumFrames);
+		Tick = std::clamp(TickOffset, (uint64_t)0, (uint64_t)Voice.m_pSample->m_NumFrames);
 
 	// at least 200msec off, else depend on buffer size
-	float Threshold = maximum(0.2f * m_aVoices[VoiceId].m_pSample->m_Rate, (float)m_MaxFrames);
-	if(absolute(m_aVoices[VoiceId].m_Tick - Tick) > Threshold)
+	float Threshold = maximum(0.2f * Voice.m_pSample->m_Rate, (float)m_MaxFrames);
+	if(absolute(Voice.m_Tick - Tick) > Threshold)
 	{
 		// take care of looping (modulo!)
-		if(!(IsLooping && (minimum(m_aVoices[VoiceId].m_Tick, Tick) + m_aVoices[VoiceId].m_pSample->m_NumFrames - maximum(m_aVoices[VoiceId].m_Tick, Tick)) <= Threshold))
+		if(!(IsLooping && (minimum(Voice.m_Tick, Tick) + Voice.m_pSample->m_NumFrames - maximum(Voice.m_Tick, Tick)) <= Threshold))
 		{
-			m_aVoices[VoiceId].m_Tick = Tick;
+			Voice.m_Tick = Tick;
 		}
 	}
 }
 
-void CSound::SetVoiceCircle(CVoiceHandle Voice, float Radius)
+void CSound::SetVoiceVolume(CVoiceHandle Voice, float Volume)
 {
-	if(!Voice.IsValid())
+	const int VoiceId = FindVoice(Voice);
+	if(VoiceId == -1)
 		return;
 
-	int VoiceId = Voice.Id();
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::SET_VOICE_VOLUME;
+	Command.m_VoiceId = VoiceId;
+	Command.m_Age = Voice.Age();
+	Command.m_Vol = (int)(std::clamp(Volume, 0.0f, 1.0f) * 255.0f);
+	PushCommand(Command);
+}
 
-	const CLockScope LockScope(m_SoundLock);
-	if(m_aVoices[VoiceId].m_Age != Voice.Age())
+void CSound::SetVoiceFalloff(CVoiceHandle Voice, float Falloff)
+{
+	const int VoiceId = FindVoice(Voice);
+	if(VoiceId == -1)
 		return;
 
-	m_aVoices[VoiceId].m_Shape = ISound::SHAPE_CIRCLE;
-	m_aVoices[VoiceId].m_Circle.m_Radius = maximum(0.0f, Radius);
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::SET_VOICE_FALLOFF;
+	Command.m_VoiceId = VoiceId;
+	Command.m_Age = Voice.Age();
+	Command.m_Value = std::clamp(Falloff, 0.0f, 1.0f);
+	PushCommand(Command);
 }
 
-void CSound::SetVoiceRectangle(CVoiceHandle Voice, float Width, float Height)
+void CSound::SetVoicePosition(CVoiceHandle Voice, vec2 Position)
 {
-	if(!Voice.IsValid())
+	const int VoiceId = FindVoice(Voice);
+	if(VoiceId == -1)
 		return;
 
-	int VoiceId = Voice.Id();
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::SET_VOICE_POSITION;
+	Command.m_VoiceId = VoiceId;
+	Command.m_Age = Voice.Age();
+	Command.m_Position = Position;
+	PushCommand(Command);
+}
 
-	const CLockScope LockScope(m_SoundLock);
-	if(m_aVoices[VoiceId].m_Age != Voice.Age())
+void CSound::SetVoiceTimeOffset(CVoiceHandle Voice, float TimeOffset)
+{
+	const int VoiceId = FindVoice(Voice);
+	if(VoiceId == -1)
 		return;
 
-	m_aVoices[VoiceId].m_Shape = ISound::SHAPE_RECTANGLE;
-	m_aVoices[VoiceId].m_Rectangle.m_Width = maximum(0.0f, Width);
-	m_aVoices[VoiceId].m_Rectangle.m_Height = maximum(0.0f, Height);
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::SET_VOICE_TIME_OFFSET;
+	Command.m_VoiceId = VoiceId;
+	Command.m_Age = Voice.Age();
+	Command.m_Value = TimeOffset;
+	PushCommand(Command);
 }
 
-ISound::CVoiceHandle CSound::Play(int ChannelId, int SampleId, int Flags, float Volume, vec2 Position)
+void CSound::SetVoiceCircle(CVoiceHandle Voice, float Radius)
 {
-	const CLockScope LockScope(m_SoundLock);
+	const int VoiceId = FindVoice(Voice);
+	if(VoiceId == -1)
+		return;
 
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::SET_VOICE_CIRCLE;
+	Command.m_VoiceId = VoiceId;
+	Command.m_Age = Voice.Age();
+	Command.m_Size = vec2(maximum(0.0f, Radius), 0.0f);
+	PushCommand(Command);
+}
+
+void CSound::SetVoiceRectangle(CVoiceHandle Voice, float Width, float Height)
+{
+	const int VoiceId = FindVoice(Voice);
+	if(VoiceId == -1)
+		return;
+
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::SET_VOICE_RECTANGLE;
+	Command.m_VoiceId = VoiceId;
+	Command.m_Age = Voice.Age();
+	Command.m_Size = vec2(maximum(0.0f, Width), maximum(0.0f, Height));
+	PushCommand(Command);
+}
+
+ISound::CVoiceHandle CSound::Play(int ChannelId, int SampleId, int Flags, float Volume, vec2 Position)
+{
 	// search for voice
 	int VoiceId = -1;
 	for(int i = 0; i < NUM_VOICES; i++)
 	{
 		int NextId = (m_NextVoice + i) % NUM_VOICES;
-		if(!m_aVoices[NextId].m_pSample)
+		if(IsVoiceSlotFree(NextId))
 		{
 			VoiceId = NextId;
 			m_NextVoice = NextId + 1;
@@ -859,28 +1053,19 @@ ISound::CVoiceHandle CSound::Play(int ChannelId, int SampleId, int Flags, float
 	}
 
 	// voice found, use it
-	m_aVoices[VoiceId].m_pSample = &m_aSamples[SampleId];
-	m_aVoices[VoiceId].m_pChannel = &m_aChannels[ChannelId];
-	if(Flags & FLAG_LOOP)
-	{
-		m_aVoices[VoiceId].m_Tick = m_aSamples[SampleId].m_PausedAt;
-	}
-	else if(Flags & FLAG_PREVIEW)
-	{
-		m_aVoices[VoiceId].m_Tick = m_aSamples[SampleId].m_PausedAt;
-		m_aSamples[SampleId].m_PausedAt = 0;
-	}
-	else
-	{
-		m_aVoices[VoiceId].m_Tick = 0;
-	}
-	m_aVoices[VoiceId].m_Vol = (int)(std::clamp(Volume, 0.0f, 1.0f) * 255.0f);
-	m_aVoices[VoiceId].m_Flags = Flags;
-	m_aVoices[VoiceId].m_Position = Position;
-	m_aVoices[VoiceId].m_Falloff = 0.0f;
-	m_aVoices[VoiceId].m_Shape = ISound::SHAPE_CIRCLE;
-	m_aVoices[VoiceId].m_Circle.m_Radius = 1500;
-	return CreateVoiceHandle(VoiceId, m_aVoices[VoiceId].m_Age);
+	m_aVoiceSlots[VoiceId].m_SampleId = SampleId;
+
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::PLAY;
+	Command.m_VoiceId = VoiceId;
+	Command.m_Age = m_aVoiceSlots[VoiceId].m_Age;
+	Command.m_ChannelId = ChannelId;
+	Command.m_SampleId = SampleId;
+	Command.m_Flags = Flags;
+	Command.m_Vol = (int)(std::clamp(Volume, 0.0f, 1.0f) * 255.0f);
+	Command.m_Position = Position;
+	PushCommand(Command);
+	return CreateVoiceHandle(VoiceId, m_aVoiceSlots[VoiceId].m_Age);
 }
 
 ISound::CVoiceHandle CSound::PlayAt(int ChannelId, int SampleId, int Flags, float Volume, vec2 Position)
@@ -896,81 +1081,75 @@ ISound::CVoiceHandle CSound::Play(int ChannelId, int SampleId, int Flags, float
 void CSound::Pause(int SampleId)
 {
 	dbg_assert(SampleId >= 0 && SampleId < NUM_SAMPLES, "SampleId invalid");
-
-	// TODO: a nice fade out
-	const CLockScope LockScope(m_SoundLock);
-	CSample *pSample = &m_aSamples[SampleId];
 	dbg_assert(m_aSamples[SampleId].IsLoaded(), "Sample not loaded");
-	for(auto &Voice : m_aVoices)
+
+	for(int VoiceId = 0; VoiceId < NUM_VOICES; VoiceId++)
 	{
-		if(Voice.m_pSample == pSample)
-		{
-			Voice.m_pSample->m_PausedAt = Voice.m_Tick;
-			Voice.m_pSample = nullptr;
-		}
+		if(m_aVoiceSlots[VoiceId].m_SampleId == SampleId)
+			ReleaseVoiceSlot(VoiceId);
 	}
+
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::PAUSE_SAMPLE;
+	Command.m_SampleId = SampleId;
+	PushCommand(Command);
 }
 
 void CSound::Stop(int SampleId)
 {
 	dbg_assert(SampleId >= 0 && SampleId < NUM_SAMPLES, "SampleId invalid");
-
-	// TODO: a nice fade out
-	const CLockScope LockScope(m_SoundLock);
-	CSample *pSample = &m_aSamples[SampleId];
 	dbg_assert(m_aSamples[SampleId].IsLoaded(), "Sample not loaded");
-	for(auto &Voice : m_aVoices)
+
+	for(int VoiceId = 0; VoiceId < NUM_VOICES; VoiceId++)
 	{
-		if(Voice.m_pSample == pSample)
-		{
-			if(Voice.m_Flags & FLAG_LOOP)
-				Voice.m_pSample->m_PausedAt = Voice.m_Tick;
-			else
-				Voice.m_pSample->m_PausedAt = 0;
-			Voice.m_pSample = nullptr;
-		}
+		if(m_aVoiceSlots[VoiceId].m_SampleId == SampleId)
+			ReleaseVoiceSlot(VoiceId);
 	}
+
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::STOP_SAMPLE;
+	Command.m_SampleId = SampleId;
+	PushCommand(Command);
 }
 
 void CSound::StopAll()
 {
-	// TODO: a nice fade out
-	const CLockScope LockScope(m_SoundLock);
-	for(auto &Voice : m_aVoices)
+	for(int VoiceId = 0; VoiceId < NUM_VOICES; VoiceId++)
 	{
-		if(Voice.m_pSample)
-		{
-			if(Voice.m_Flags & FLAG_LOOP)
-				Voice.m_pSample->m_PausedAt = Voice.m_Tick;
-			else
-				Voice.m_pSample->m_PausedAt = 0;
-		}
-		Voice.m_pSample = nullptr;
+		if(m_aVoiceSlots[VoiceId].m_SampleId != -1)
+			ReleaseVoiceSlot(VoiceId);
 	}
+
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::STOP_ALL;
+	PushCommand(Command);
 }
 
 void CSound::StopVoice(CVoiceHandle Voice)
 {
-	if(!Voice.IsValid())
+	const int VoiceId = FindVoice(Voice);
+	if(VoiceId == -1)
 		return;
 
-	int VoiceId = Voice.Id();
+	ReleaseVoiceSlot(VoiceId);
 
-	const CLockScope LockScope(m_SoundLock);
-	if(m_aVoices[VoiceId].m_Age != Voice.Age())
-		return;
-
-	m_aVoices[VoiceId].m_pSample = nullptr;
-	m_aVoices[VoiceId].m_Age++;
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::STOP_VOICE;
+	Command.m_VoiceId = VoiceId;
+	Command.m_Age = Voice.Age();
+	PushCommand(Command);
 }
 
 bool CSound::IsPlaying(int SampleId)
 {
 	dbg_assert(SampleId >= 0 && SampleId < NUM_SAMPLES, "SampleId invalid");
-	const CLockScope LockScope(m_SoundLock);
-	const CSample *pSample = &m_aSamples[SampleId];
 	dbg_assert(m_aSamples[SampleId].IsLoaded(), "Sample not loaded");
-	return std::any_of(std::begin(m_aVoices), std::end(m_aVoices), [pSample](const auto &Voice) { return Voice.m_pSample == pSample; });
+	for(int VoiceId = 0; VoiceId < NUM_VOICES; VoiceId++)
+	{
+		if(m_aVoiceSlots[VoiceId].m_SampleId == SampleId && !IsVoiceSlotFree(VoiceId))
+			return true;
+	}
+	return false;
 }
 
 void CSound::PauseAudioDevice()
@@ -4,6 +4,7 @@
 #define ENGINE_CLIENT_SOUND_H
 
 #include <base/lock.h>
+#include <base/tl/threading.h>
 
 #include <engine/sound.h>
 
@@ -45,7 +46,7 @@ struct CVoice
 {
 	CSample *m_pSample;
 	CChannel *m_pChannel;
-	int m_Age; // increases when reused
+	int m_Age; // age of the voice handle that started this voice
 	int m_Tick;
 	int m_Vol; // 0 - 255
 	int m_Flags;
@@ -60,6 +61,39 @@ struct CVoice
 	};
 };
 
+// Voice operation queued by the game thread and executed by the mixer
+struct CSoundCommand
+{
+	enum
+	{
+		PLAY,
+		STOP_VOICE,
+		SET_VOICE_VOLUME,
+		SET_VOICE_FALLOFF,
+		SET_VOICE_POSITION,
+		SET_VOICE_TIME_OFFSET,
+		SET_VOICE_CIRCLE,
+		SET_VOICE_RECTANGLE,
+		SET_CHANNEL,
+		SET_SAMPLE_TIME,
+		PAUSE_SAMPLE,
+		STOP_SAMPLE,
+		STOP_ALL,
+	};
+
+	int m_Type;
+	int m_VoiceId;
+	int m_Age;
+	int m_SampleId;
+	int m_ChannelId;
+	int m_Flags;
+	int m_Vol;
+	int m_Pan;
+	float m_Value;
+	vec2 m_Position;
+	vec2 m_Size;
+};
+
 class CSound : public IEngineSound
 {
 	enum
@@ -67,6 +101,15 @@ class CSound : public IEngineSound
 		NUM_SAMPLES = 512,
 		NUM_VOICES = 256,
 		NUM_CHANNELS = 16,
+		COMMAND_QUEUE_SIZE = 1024,
+	};
+
+	// Game thread view of a voice. Voices are allocated on the game thread so
+	// that Play can return a handle without waiting for the mixer.
+	struct CVoiceSlot
+	{
+		int m_SampleId = -1; // -1 if the slot is free
+		int m_Age = 0; // increases when reused
 	};
 
 	bool m_SoundEnabled = false;
@@ -78,9 +121,18 @@ class CSound : public IEngineSound
 
 	CVoice m_aVoices[NUM_VOICES] GUARDED_BY(m_SoundLock) = {{nullptr}};
 	CChannel m_aChannels[NUM_CHANNELS] GUARDED_BY(m_SoundLock) = {{255, 0}};
-	int m_NextVoice GUARDED_BY(m_SoundLock) = 0;
 	uint32_t m_MaxFrames = 0;
 
+	// Voice operations from the game thread are passed to the mixer through
+	// this queue, so neither side has to wait for the other. The mixer only
+	// pops while holding m_SoundLock, which allows other threads to drain the
+	// queue when the mixer is not running.
+	CSpscQueue<CSoundCommand, COMMAND_QUEUE_SIZE> m_Commands;
+	CVoiceSlot m_aVoiceSlots[NUM_VOICES];
+	int m_NextVoice = 0;
+	// written by the mixer when a voice finished playing on its own
+	std::atomic<int> m_aVoiceFinishedAge[NUM_VOICES];
+
 	// This is not an std::atomic<vec2> as this would require linking with
 	// libatomic with clang x86 as there is no native support for this.
 	std::atomic<float> m_ListenerPositionX = 0.0f;
@@ -102,6 +154,15 @@ class CSound : public IEngineSound
 
 	void UpdateVolume();
 
+	bool IsVoiceSlotFree(int VoiceId);
+	void ReleaseVoiceSlot(int VoiceId);
+	int FindVoice(CVoiceHandle Voice);
+	void PushCommand(const CSoundCommand &Command) REQUIRES(!m_SoundLock);
+	void ProcessCommands() REQUIRES(m_SoundLock);
+	void ExecuteCommand(const CSoundCommand &Command) REQUIRES(m_SoundLock);
+	void ExecutePlay(const CSoundCommand &Command) REQUIRES(m_SoundLock);
+	void ExecuteSetVoiceTimeOffset(CVoice &Voice, float TimeOffset) REQUIRES(m_SoundLock);
+
 public:
 	int Init() override REQUIRES(!m_SoundLock);
 	int Update() override;
@@ -122,6 +183,7 @@ public:
 	void SetChannel(int ChannelId, float Vol, float Pan) override REQUIRES(!m_SoundLock);
 	void SetListenerPosition(vec2 Position) override;
 
+	// Voice operations must only be called from one thread, usually the game thread
 	void SetVoiceVolume(CVoiceHandle Voice, float Volume) override REQUIRES(!m_SoundLock);
 	void SetVoiceFalloff(CVoiceHandle Voice, float Falloff) override REQUIRES(!m_SoundLock);
 	void SetVoicePosition(CVoiceHandle Voice, vec2 Position) override REQUIRES(!m_SoundLock);
@@ -1,5 +1,8 @@
 /* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include "glyph_cache.h"
+
+#include <base/hash.h>
 #include <base/log.h>
 #include <base/math.h>
 #include <base/system.h>
@@ -321,6 +324,10 @@ private:
 	CAtlas m_TextureAtlas;
 	std::unordered_map<std::tuple<FT_Face, int, int>, SGlyph, SGlyphKeyHash, SGlyphKeyEquals> m_Glyphs;
 
+	// Rasterized glyphs kept between restarts, placed into the atlas when first used
+	std::unordered_map<FT_Face, uint64_t> m_FaceHashes;
+	CGlyphCache m_GlyphCache;
+
 	// Font faces
 	FT_Face m_DefaultFace = nullptr;
 	FT_Face m_IconFace = nullptr;
@@ -532,6 +539,7 @@ private:
 
 		int X = 0;
 		int Y = 0;
+		SCachedGlyph CachedGlyph;
 
 		if(Width > 0 && Height > 0)
 		{
@@ -556,6 +564,10 @@ private:
 			}
 			Grow(pGlyphDataFill, pGlyphDataOutline, Width, Height, OutlineThickness);
 
+			// keep a copy for the glyph cache, uploading takes ownership of the data
+			CachedGlyph.m_vFill.assign(pGlyphDataFill, pGlyphDataFill + GlyphDataSize);
+			CachedGlyph.m_vOutline.assign(pGlyphDataOutline, pGlyphDataOutline + GlyphDataSize);
+
 			// upload the glyph
 			UploadGlyph(FONT_TEXTURE_FILL, X, Y, Width, Height, pGlyphDataFill);
 			UploadGlyph(FONT_TEXTURE_OUTLINE, X, Y, Width, Height, pGlyphDataOutline);
@@ -578,6 +590,80 @@ private:
 
 			Glyph.m_State = SGlyph::EState::RENDERED;
 		}
+
+		AddCachedGlyph(Glyph, std::move(CachedGlyph));
+		return true;
+	}
+
+	void AddCachedGlyph(const SGlyph &Glyph, SCachedGlyph &&CachedGlyph)
+	{
+		const auto FaceHash = m_FaceHashes.find(Glyph.m_Face);
+		if(FaceHash == m_FaceHashes.end())
+			return;
+
+		CachedGlyph.m_FaceHash = FaceHash->second;
+		CachedGlyph.m_Chr = Glyph.m_Chr;
+		CachedGlyph.m_FontSize = Glyph.m_FontSize;
+		CachedGlyph.m_GlyphIndex = Glyph.m_GlyphIndex;
+		CachedGlyph.m_Width = Glyph.m_Width;
+		CachedGlyph.m_Height = Glyph.m_Height;
+		CachedGlyph.m_CharWidth = Glyph.m_CharWidth;
+		CachedGlyph.m_CharHeight = Glyph.m_CharHeight;
+		CachedGlyph.m_OffsetX = Glyph.m_OffsetX;
+		CachedGlyph.m_OffsetY = Glyph.m_OffsetY;
+		CachedGlyph.m_AdvanceX = Glyph.m_AdvanceX;
+		m_GlyphCache.Add(std::move(CachedGlyph));
+	}
+
+	/**
+	 * Places the glyph into the atlas from the glyph cache instead of rasterizing it.
+	 *
+	 * @return false if the glyph is not cached for this font face.
+	 */
+	bool PlaceCachedGlyph(SGlyph &Glyph)
+	{
+		const auto FaceHash = m_FaceHashes.find(Glyph.m_Face);
+		if(FaceHash == m_FaceHashes.end())
+			return false;
+		const SCachedGlyph *pCachedGlyph = m_GlyphCache.Find(FaceHash->second, Glyph.m_Chr, Glyph.m_FontSize);
+		if(pCachedGlyph == nullptr || pCachedGlyph->m_GlyphIndex != Glyph.m_GlyphIndex)
+			return false;
+
+		int X = 0;
+		int Y = 0;
+		if(pCachedGlyph->m_Width > 0 && pCachedGlyph->m_Height > 0)
+		{
+			while(!FitGlyph(pCachedGlyph->m_Width, pCachedGlyph->m_Height, X, Y))
+			{
+				if(!IncreaseGlyphMapSize())
+				{
+					log_debug("textrender", "Cannot fit cached glyph into atlas, which is already at maximum size. Chr=%d GlyphIndex=%u", Glyph.m_Chr, Glyph.m_GlyphIndex);
+					return false;
+				}
+			}
+
+			// uploading takes ownership of the data
+			const size_t GlyphDataSize = pCachedGlyph->m_vFill.size();
+			uint8_t *pGlyphDataFill = static_cast<uint8_t *>(malloc(GlyphDataSize));
+			uint8_t *pGlyphDataOutline = static_cast<uint8_t *>(malloc(GlyphDataSize));
+			mem_copy(pGlyphDataFill, pCachedGlyph->m_vFill.data(), GlyphDataSize);
+			mem_copy(pGlyphDataOutline, pCachedGlyph->m_vOutline.data(), GlyphDataSize);
+			UploadGlyph(FONT_TEXTURE_FILL, X, Y, pCachedGlyph->m_Width, pCachedGlyph->m_Height, pGlyphDataFill);
+			UploadGlyph(FONT_TEXTURE_OUTLINE, X, Y, pCachedGlyph->m_Width, pCachedGlyph->m_Height, pGlyphDataOutline);
+		}
+
+		Glyph.m_Width = pCachedGlyph->m_Width;
+		Glyph.m_Height = pCachedGlyph->m_Height;
+		Glyph.m_CharWidth = pCachedGlyph->m_CharWidth;
+		Glyph.m_CharHeight = pCachedGlyph->m_CharHeight;
+		Glyph.m_OffsetX = pCachedGlyph->m_OffsetX;
+		Glyph.m_OffsetY = pCachedGlyph->m_OffsetY;
+		Glyph.m_AdvanceX = pCachedGlyph->m_AdvanceX;
+		Glyph.m_aUVs[0] = X;
+		Glyph.m_aUVs[1] = Y;
+		Glyph.m_aUVs[2] = Glyph.m_aUVs[0] + pCachedGlyph->m_Width;
+		Glyph.m_aUVs[3] = Glyph.m_aUVs[1] + pCachedGlyph->m_Height;
+		Glyph.m_State = SGlyph::EState::RENDERED;
 		return true;
 	}
 
@@ -614,9 +700,10 @@ public:
 		return m_IconFace;
 	}
 
-	void AddFace(FT_Face Face)
+	void AddFace(FT_Face Face, uint64_t FontHash)
 	{
 		m_vFtFaces.push_back(Face);
+		m_FaceHashes[Face] = FontHash + Face->face_index;
 	}
 
 	bool SetDefaultFaceByName(const char *pFamilyName)
@@ -703,6 +790,16 @@ public:
 		m_Glyphs.clear();
 	}
 
+	void LoadGlyphCache(IStorage *pStorage, int FreetypeVersion)
+	{
+		m_GlyphCache.Load(pStorage, CGlyphCache::FILENAME, FreetypeVersion);
+	}
+
+	void SaveGlyphCache(IStorage *pStorage, int FreetypeVersion)
+	{
+		m_GlyphCache.Save(pStorage, CGlyphCache::FILENAME, FreetypeVersion);
+	}
+
 	const SGlyph *GetGlyph(int Chr, int FontSize)
 	{
 		FontSize = std::clamp(FontSize, MIN_FONT_SIZE, MAX_FONT_SIZE);
@@ -724,12 +821,12 @@ public:
 		else if(Glyph.m_State == SGlyph::EState::ERROR)
 			return nullptr;
 
-		// Else, render it.
+		// Else, take it from the glyph cache or render it.
 		Glyph.m_FontSize = FontSize;
 		Glyph.m_Face = Face;
 		Glyph.m_Chr = Chr;
 		Glyph.m_GlyphIndex = GlyphIndex;
-		if(RenderGlyph(Glyph))
+		if(PlaceCachedGlyph(Glyph) || RenderGlyph(Glyph))
 			return &Glyph;
 
 		// Use replacement character if the glyph could not be rendered,
@@ -1036,8 +1133,19 @@ class CTextRender : public IEngineTextRender
 		}
 	}
 
+	int FreetypeVersion() const
+	{
+		int LMajor, LMinor, LPatch;
+		FT_Library_Version(m_FTLibrary, &LMajor, &LMinor, &LPatch);
+		return (LMajor << 16) | (LMinor << 8) | LPatch;
+	}
+
 	bool LoadFontCollection(const char *pFontName, const FT_Byte *pFontData, FT_Long FontDataSize)
 	{
+		// identifies the faces of this font file in the glyph cache
+		const SHA256_DIGEST FontDigest = sha256(pFontData, FontDataSize);
+		const uint64_t FontHash = ((uint64_t)bytes_be_to_uint(FontDigest.data) << 32) | bytes_be_to_uint(FontDigest.data + sizeof(int32_t));
+
 		FT_Face FtFace;
 		FT_Error CollectionLoadError = FT_New_Memory_Face(m_FTLibrary, pFontData, FontDataSize, -1, &FtFace);
 		if(CollectionLoadError)
@@ -1060,7 +1168,7 @@ class CTextRender : public IEngineTextRender
 				continue;
 			}
 
-			m_pGlyphMap->AddFace(FtFace);
+			m_pGlyphMap->AddFace(FtFace, FontHash);
 
 			log_debug("textrender", "Loaded font face %ld '%s %s' from font file '%s'", FaceIndex, FtFace->family_name, FtFace->style_name, pFontName);
 			LoadedAny = true;
@@ -1154,6 +1262,8 @@ public:
 			delete pTextCont;
 		m_vpTextContainers.clear();
 
+		if(m_pGlyphMap != nullptr)
+			m_pGlyphMap->SaveGlyphCache(Storage(), FreetypeVersion());
 		delete m_pGlyphMap;
 		m_pGlyphMap = nullptr;
 
@@ -1325,6 +1435,8 @@ public:
 		}
 
 		json_value_free(pJsonData);
+
+		m_pGlyphMap->LoadGlyphCache(Storage(), FreetypeVersion());
 		return Success;
 	}
 
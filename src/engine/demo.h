@@ -101,6 +101,9 @@ public:
 	virtual const CInfo *BaseInfo() const = 0;
 	virtual void GetDemoName(char *pBuffer, size_t BufferSize) const = 0;
 	virtual bool GetDemoInfo(class IStorage *pStorage, class IConsole *pConsole, const char *pFilename, int StorageType, CDemoHeader *pDemoHeader, CTimelineMarkers *pTimelineMarkers, CMapInfo *pMapInfo, IOHANDLE *pFile = nullptr, char *pErrorMessage = nullptr, size_t ErrorMessageSize = 0) const = 0;
+
+	// filename of the keyframe index which is stored next to a demo, must be moved and removed together with the demo
+	static void IndexFilename(const char *pDemoFilename, char *pBuffer, size_t BufferSize);
 };
 
 class IDemoRecorder : public IInterface
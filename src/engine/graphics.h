@@ -624,6 +624,20 @@ public:
 
 	virtual int WindowActive() = 0;
 	virtual int WindowOpen() = 0;
+
+	/**
+	 * Totals of all command buffers passed to the backend so far.
+	 */
+	class CCommandBufferStats
+	{
+	public:
+		uint64_t m_NumBuffers = 0;
+		uint64_t m_NumCommands = 0;
+		uint64_t m_NumRenderCalls = 0;
+		uint64_t m_CommandBytes = 0;
+		uint64_t m_DataBytes = 0;
+	};
+	virtual const CCommandBufferStats &CommandBufferStats() const = 0;
 };
 
 extern IEngineGraphics *CreateEngineGraphicsThreaded();
@@ -234,7 +234,11 @@ public:
 	virtual void SetClientFlags(int ClientId, int Flags) = 0;
 
 	virtual int SnapNewId() = 0;
+	// Allocates up to Num ids at once, returns how many were allocated
+	virtual int SnapNewIds(int *pIds, int Num) = 0;
 	virtual void SnapFreeId(int Id) = 0;
+	// Number of snap ids in use and of freed ids that can't be reused yet
+	virtual void SnapIdUsage(int *pNumAllocated, int *pNumTimed) const = 0;
 	virtual void *SnapNewItem(int Type, int Id, int Size) = 0;
 
 	template<typename T>
@@ -287,6 +291,8 @@ public:
 
 	virtual void SetErrorShutdown(const char *pReason) = 0;
 	virtual void ExpireServerInfo() = 0;
+	// Like ExpireServerInfo, but only the name, clan, country or score of clients changed
+	virtual void ExpireServerInfoClients() = 0;
 
 	virtual void FillAntibot(CAntibotRoundData *pData) = 0;
 
@@ -326,6 +332,12 @@ public:
 	// this will not be called when only sending snapshots to these clients.
 	virtual void OnPostGlobalSnap() = 0;
 
+	// Distance of a snapshot item to the camera of the client, used to
+	// send far items later if the snapshot exceeds sv_snapshot_budget.
+	//
+	// Negative for items without a position, they are always sent.
+	virtual float SnapItemDistance(int ClientId, int Type, const void *pData, int Size) = 0;
+
 	virtual void OnMessage(int MsgId, CUnpacker *pUnpacker, int ClientId) = 0;
 
 	// Called before map reload, for any data that the game wants to
@@ -383,6 +395,10 @@ public:
 	virtual void TeehistorianRecordPlayerFinish(int ClientId, int TimeTicks) = 0;
 	virtual void TeehistorianRecordTeamFinish(int TeamId, int TimeTicks) = 0;
 	virtual void TeehistorianRecordAuthLogin(int ClientId, int Level, const char *pAuthName) = 0;
+	/**
+	 * @return Bytes of teehistorian data waiting to be written to the file.
+	 */
+	virtual uint64_t TeehistorianQueuedBytes() = 0;
 
 	virtual void FillAntibot(CAntibotRoundData *pData) = 0;
 
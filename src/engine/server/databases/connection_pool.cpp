@@ -181,6 +181,12 @@ void CDbConnectionPool::OnShutdown()
 	}
 }
 
+int CDbConnectionPool::NumQueuedQueries() const
+{
+	// queries wait for the backup thread first, then for the worker thread
+	return m_pShared->m_NumBackup.GetApproximateValue() + m_pShared->m_NumWorker.GetApproximateValue();
+}
+
 // The backup worker thread looks at write queries and stores them
 // in the sqlite database (WRITE_BACKUP). It skips over read queries.
 // After processing the query, it gets passed on to the Worker thread.
@@ -95,6 +95,11 @@ public:
 
 	void OnShutdown();
 
+	/**
+	 * @return Approximate number of queries waiting to be executed.
+	 */
+	int NumQueuedQueries() const;
+
 	friend class CWorker;
 	friend class CBackup;
 
@@ -44,6 +44,7 @@
 
 #include <zlib.h>
 
+#include <algorithm>
 #include <chrono>
 #include <vector>
 
@@ -218,8 +219,10 @@ void CServer::CClient::Reset()
 	mem_zero(&m_LatestInput, sizeof(m_LatestInput));
 
 	m_Snapshots.PurgeAll();
+	m_SnapshotBudget.Reset();
 	m_LastAckedSnapshot = -1;
 	m_LastInputTick = -1;
+	m_LastSnapshotSize = 0;
 	m_SnapRate = CClient::SNAPRATE_INIT;
 	m_Score = -1;
 	m_NextMapChunk = 0;
@@ -227,13 +230,22 @@ void CServer::CClient::Reset()
 	m_RedirectDropTime = 0;
 }
 
+void CServer::CClient::ResetSnapshotStats()
+{
+	m_SnapFullBytes = 0;
+	m_SnapDeltaBytes = 0;
+	m_SnapPackedBytes = 0;
+	m_SnapDeferredItems = 0;
+	std::fill(std::begin(m_aSnapItemBytes), std::end(m_aSnapItemBytes), 0);
+}
+
 CServer::CServer()
 {
 	m_pConfig = &g_Config;
 	for(int i = 0; i < MAX_CLIENTS; i++)
-		m_aDemoRecorder[i] = CDemoRecorder(&m_SnapshotDelta, true);
-	m_aDemoRecorder[RECORDER_MANUAL] = CDemoRecorder(&m_SnapshotDelta, false);
-	m_aDemoRecorder[RECORDER_AUTO] = CDemoRecorder(&m_SnapshotDelta, false);
+		m_aDemoRecorder[i] = CDemoRecorder(&m_SnapshotDelta, true, &m_DemoEncoder);
+	m_aDemoRecorder[RECORDER_MANUAL] = CDemoRecorder(&m_SnapshotDelta, false, &m_DemoEncoder);
+	m_aDemoRecorder[RECORDER_AUTO] = CDemoRecorder(&m_SnapshotDelta, false, &m_DemoEncoder);
 
 	m_pGameServer = nullptr;
 
@@ -260,7 +272,7 @@ CServer::CServer()
 
 	m_ServerInfoFirstRequest = 0;
 	m_ServerInfoNumRequests = 0;
-	m_ServerInfoNeedsUpdate = false;
+	m_ServerInfoDirty = 0;
 
 #ifdef CONF_FAMILY_UNIX
 	m_ConnLoggingSocketCreated = false;
@@ -482,7 +494,7 @@ void CServer::SetClientScore(int ClientId, std::optional<int> Score)
 		return;
 
 	if(m_aClients[ClientId].m_Score != Score)
-		ExpireServerInfo();
+		ExpireServerInfoClients();
 
 	m_aClients[ClientId].m_Score = Score;
 }
@@ -596,6 +608,8 @@ int CServer::Init()
 		Client.m_Latency = 0;
 		Client.m_Sixup = false;
 		Client.m_RedirectDropTime = 0;
+		Client.m_LastSnapshotSize = 0;
+		Client.ResetSnapshotStats();
 	}
 
 	m_CurrentGameTick = MIN_TICK;
@@ -1057,15 +1071,10 @@ void CServer::DoSnapshot()
 				m_aDemoRecorder[i].RecordSnapshot(Tick(), aData, SnapshotSize);
 			}
 
-			int Crc = pData->Crc();
-
 			// remove old snapshots
 			// keep 3 seconds worth of snapshots
 			m_aClients[i].m_Snapshots.PurgeUntil(m_CurrentGameTick - TickSpeed() * 3);
 
-			// save the snapshot
-			m_aClients[i].m_Snapshots.Add(m_CurrentGameTick, time_get(), SnapshotSize, pData, 0, nullptr);
-
 			// find snapshot that we can perform delta against
 			int DeltaTick = -1;
 			const CSnapshot *pDeltashot = CSnapshot::EmptySnapshot();
@@ -1081,19 +1090,46 @@ void CServer::DoSnapshot()
 				}
 			}
 
-			// create delta
 			m_SnapshotDelta.SetStaticsize(protocol7::NETEVENTTYPE_SOUNDWORLD, m_aClients[i].m_Sixup);
 			m_SnapshotDelta.SetStaticsize(protocol7::NETEVENTTYPE_DAMAGE, m_aClients[i].m_Sixup);
+
+			// the demo keeps the complete snapshot, the client gets what fits
+			if(Config()->m_SvSnapshotBudget > 0)
+			{
+				const int NumDeferred = m_aClients[i].m_SnapshotBudget.Apply(&m_SnapshotBuilder, m_SnapshotDelta, pDeltashot, pData, Config()->m_SvSnapshotBudget, m_CurrentGameTick, TickSpeed(), [&](int Index) {
+					return GameServer()->SnapItemDistance(i, pData->GetItemType(Index), pData->GetItem(Index)->Data(), pData->GetItemSize(Index));
+				});
+				if(NumDeferred > 0)
+				{
+					m_aClients[i].m_SnapDeferredItems += NumDeferred;
+					SnapshotSize = m_SnapshotBuilder.Finish(pData);
+				}
+			}
+			else
+				m_aClients[i].m_SnapshotBudget.Reset();
+
+			int Crc = pData->Crc();
+
+			// save the snapshot
+			m_aClients[i].m_Snapshots.Add(m_CurrentGameTick, time_get(), SnapshotSize, pData, 0, nullptr);
+
+			// create delta
 			char aDeltaData[CSnapshot::MAX_SIZE];
 			int DeltaSize = m_SnapshotDelta.CreateDelta(pDeltashot, pData, aDeltaData);
+			m_aClients[i].m_SnapFullBytes += SnapshotSize;
 
 			if(DeltaSize)
 			{
+				m_aClients[i].m_SnapDeltaBytes += DeltaSize;
+				m_SnapshotDelta.CountItemBytes(aDeltaData, DeltaSize, m_aClients[i].m_aSnapItemBytes, std::size(m_aClients[i].m_aSnapItemBytes));
+
 				// compress it
 				const int MaxSize = MAX_SNAPSHOT_PACKSIZE;
 
 				char aCompData[CSnapshot::MAX_SIZE];
 				SnapshotSize = CVariableInt::Compress(aDeltaData, DeltaSize, aCompData, sizeof(aCompData));
+				m_aClients[i].m_LastSnapshotSize = SnapshotSize;
+				m_aClients[i].m_SnapPackedBytes += SnapshotSize;
 				int NumPackets = (SnapshotSize + MaxSize - 1) / MaxSize;
 
 				for(int n = 0, Left = SnapshotSize; Left > 0; n++)
@@ -1127,6 +1163,7 @@ void CServer::DoSnapshot()
 			}
 			else
 			{
+				m_aClients[i].m_LastSnapshotSize = 0;
 				CMsgPacker Msg(NETMSG_SNAPEMPTY, true);
 				Msg.AddInt(m_CurrentGameTick);
 				Msg.AddInt(m_CurrentGameTick - DeltaTick);
@@ -1141,6 +1178,92 @@ void CServer::DoSnapshot()
 	}
 }
 
+void CServer::OpenStatsFile()
+{
+	m_StatsWriter.Close();
+	m_NumTickTimes = 0;
+	if(!Config()->m_SvStatsFile[0])
+		return;
+
+	char aFullPath[IO_MAX_PATH_LENGTH];
+	Storage()->GetCompletePath(IStorage::TYPE_SAVE_OR_ABSOLUTE, Config()->m_SvStatsFile, aFullPath, sizeof(aFullPath));
+	if(!m_StatsWriter.Open(aFullPath))
+		log_error("server", "failed to map stats file '%s'", aFullPath);
+}
+
+static_assert((int)CServerStats::NUM_ACK_LATENCY_BUCKETS == (int)CNetConnectionStats::NUM_ACK_LATENCY_BUCKETS);
+static_assert((int)CServerStats::NUM_PACKET_SIZE_BUCKETS == (int)CNetConnectionStats::NUM_PACKET_SIZE_BUCKETS);
+
+void CServer::RecordTickTime(int64_t TickTime)
+{
+	m_aTickTimes[m_NumTickTimes % CServerStats::TICK_TIME_WINDOW] = (int)(TickTime * 1000000 / time_freq());
+	m_NumTickTimes++;
+}
+
+void CServer::PublishStats()
+{
+	CServerStats Stats = {};
+	Stats.m_UpdateTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	Stats.m_Tick = Tick();
+	Stats.m_TickSpeed = TickSpeed();
+
+	// percentiles of a copy, the ring buffer keeps its order
+	const int NumTickTimes = minimum<int>(m_NumTickTimes, CServerStats::TICK_TIME_WINDOW);
+	int aTickTimes[CServerStats::TICK_TIME_WINDOW];
+	mem_copy(aTickTimes, m_aTickTimes, sizeof(aTickTimes[0]) * NumTickTimes);
+	const auto &&Percentile = [&](int Percent) {
+		int *pNth = aTickTimes + (NumTickTimes - 1) * Percent / 100;
+		std::nth_element(aTickTimes, pNth, aTickTimes + NumTickTimes);
+		return *pNth;
+	};
+	Stats.m_TickTimeP50 = Percentile(50);
+	Stats.m_TickTimeP90 = Percentile(90);
+	Stats.m_TickTimeP99 = Percentile(99);
+	Stats.m_TickTimeMax = Percentile(100);
+
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		const CClient &Client = m_aClients[i];
+		if(Client.m_State == CClient::STATE_EMPTY || Client.m_DebugDummy)
+			continue;
+		Stats.m_NumClients++;
+		if(Client.m_State == CClient::STATE_INGAME)
+			Stats.m_NumPlayers++;
+
+		CServerStats::CClient &ClientStats = Stats.m_aClients[i];
+		const NETSTATS &NetStats = m_NetServer.ClientStats(i);
+		ClientStats.m_State = Client.m_State;
+		ClientStats.m_Latency = Client.m_Latency;
+		ClientStats.m_SentPackets = NetStats.sent_packets;
+		ClientStats.m_SentBytes = NetStats.sent_bytes;
+		ClientStats.m_RecvPackets = NetStats.recv_packets;
+		ClientStats.m_RecvBytes = NetStats.recv_bytes;
+		ClientStats.m_SnapshotSize = Client.m_LastSnapshotSize;
+
+		const CNetConnectionStats &DetailedStats = m_NetServer.ClientDetailedStats(i);
+		ClientStats.m_ResentChunks = DetailedStats.m_ResentChunks;
+		ClientStats.m_ResendRequests = DetailedStats.m_ResendRequests;
+		mem_copy(ClientStats.m_aAckLatency, DetailedStats.m_aAckLatency, sizeof(ClientStats.m_aAckLatency));
+		mem_copy(ClientStats.m_aSentPacketSizes, DetailedStats.m_aSentPacketSizes, sizeof(ClientStats.m_aSentPacketSizes));
+		ClientStats.m_SnapFullBytes = Client.m_SnapFullBytes;
+		ClientStats.m_SnapDeltaBytes = Client.m_SnapDeltaBytes;
+		ClientStats.m_SnapPackedBytes = Client.m_SnapPackedBytes;
+		mem_copy(ClientStats.m_aSnapItemBytes, Client.m_aSnapItemBytes, sizeof(ClientStats.m_aSnapItemBytes));
+	}
+	Stats.m_MaxClients = MaxClients();
+	Stats.m_DbQueuedQueries = DbPool()->NumQueuedQueries();
+	Stats.m_AioQueuedBytes = GameServer()->TeehistorianQueuedBytes();
+
+	NETSTATS NetStats;
+	net_stats(&NetStats);
+	Stats.m_SentPackets = NetStats.sent_packets;
+	Stats.m_SentBytes = NetStats.sent_bytes;
+	Stats.m_RecvPackets = NetStats.recv_packets;
+	Stats.m_RecvBytes = NetStats.recv_bytes;
+
+	m_StatsWriter.Publish(Stats);
+}
+
 int CServer::ClientRejoinCallback(int ClientId, void *pUser)
 {
 	CServer *pThis = (CServer *)pUser;
@@ -1185,6 +1308,7 @@ int CServer::NewClientNoAuthCallback(int ClientId, void *pUser)
 	pThis->m_aClients[ClientId].m_GotDDNetVersionPacket = false;
 	pThis->m_aClients[ClientId].m_DDNetVersionSettled = false;
 	pThis->m_aClients[ClientId].Reset();
+	pThis->m_aClients[ClientId].ResetSnapshotStats();
 
 	pThis->GameServer()->TeehistorianRecordPlayerJoin(ClientId, false);
 	pThis->Antibot()->OnEngineClientJoin(ClientId);
@@ -1219,6 +1343,7 @@ int CServer::NewClientCallback(int ClientId, void *pUser, bool Sixup)
 	pThis->m_aClients[ClientId].m_GotDDNetVersionPacket = false;
 	pThis->m_aClients[ClientId].m_DDNetVersionSettled = false;
 	pThis->m_aClients[ClientId].Reset();
+	pThis->m_aClients[ClientId].ResetSnapshotStats();
 	pThis->m_aClients[ClientId].m_Sixup = Sixup;
 
 	pThis->GameServer()->TeehistorianRecordPlayerJoin(ClientId, Sixup);
@@ -2180,9 +2305,49 @@ void CServer::CCache::AddChunk(const void *pData, int Size)
 	m_vCache.emplace_back(pData, Size);
 }
 
+void CServer::CCache::AddDatagram(const unsigned char *pType, const void *pData, int Size)
+{
+	m_vDatagrams.emplace_back(pType, pData, Size);
+}
+
 void CServer::CCache::Clear()
 {
 	m_vCache.clear();
+	m_vDatagrams.clear();
+}
+
+// connless header, info type and the largest token including null termination
+static constexpr int SERVERINFO_TOKEN_SLOT_SIZE = NET_CONNLESS_HEADER_SIZE + SERVERBROWSE_SIZE + 12;
+
+CServer::CCache::CDatagram::CDatagram(const unsigned char *pType, const void *pData, int Size) :
+	m_pType(pType)
+{
+	m_vData.resize(SERVERINFO_TOKEN_SLOT_SIZE + Size);
+	mem_copy(m_vData.data() + SERVERINFO_TOKEN_SLOT_SIZE, pData, Size);
+}
+
+const unsigned char *CServer::CCache::CDatagram::Prepare(int Token, int *pSize)
+{
+	char aToken[16];
+	const int TokenSize = str_format(aToken, sizeof(aToken), "%d", Token) + 1;
+	dbg_assert(TokenSize <= SERVERINFO_TOKEN_SLOT_SIZE - NET_CONNLESS_HEADER_SIZE - SERVERBROWSE_SIZE, "Token too long for serverinfo datagram");
+	unsigned char *pStart = m_vData.data() + SERVERINFO_TOKEN_SLOT_SIZE - TokenSize - SERVERBROWSE_SIZE - NET_CONNLESS_HEADER_SIZE;
+	std::fill(pStart, pStart + NET_CONNLESS_HEADER_SIZE, 0xFF);
+	mem_copy(pStart + NET_CONNLESS_HEADER_SIZE, m_pType, SERVERBROWSE_SIZE);
+	mem_copy(pStart + NET_CONNLESS_HEADER_SIZE + SERVERBROWSE_SIZE, aToken, TokenSize);
+	*pSize = m_vData.data() + m_vData.size() - pStart;
+	return pStart;
+}
+
+const unsigned char *CServer::ServerInfoChunkType(int Type, int Chunk)
+{
+	switch(Type)
+	{
+	case SERVERINFO_EXTENDED: return Chunk == 0 ? SERVERBROWSE_INFO_EXTENDED : SERVERBROWSE_INFO_EXTENDED_MORE;
+	case SERVERINFO_64_LEGACY: return SERVERBROWSE_INFO_64_LEGACY;
+	case SERVERINFO_VANILLA: return SERVERBROWSE_INFO;
+	default: dbg_assert_failed("Invalid serverinfo Type: %d", Type);
+	}
 }
 
 void CServer::CacheServerInfo(CCache *pCache, int Type, bool SendClients)
@@ -2284,7 +2449,7 @@ void CServer::CacheServerInfo(CCache *pCache, int Type, bool SendClients)
 #define SAVE(size) \
 	do \
 	{ \
-		pCache->AddChunk(q.Data(), size); \
+		pCache->AddDatagram(ServerInfoChunkType(Type, ChunksStored), q.Data(), size); \
 		ChunksStored++; \
 	} while(0)
 
@@ -2493,56 +2658,26 @@ void CServer::CacheServerInfoSixup(CCache *pCache, bool SendClients, int MaxCons
 
 void CServer::SendServerInfo(const NETADDR *pAddr, int Token, int Type, bool SendClients)
 {
-	CPacker p;
-	char aBuf[128];
-	p.Reset();
-
+	dbg_assert(Type == SERVERINFO_EXTENDED || Type == SERVERINFO_64_LEGACY || Type == SERVERINFO_VANILLA || Type == SERVERINFO_INGAME, "Invalid serverinfo Type: %d", Type);
 	CCache *pCache = &m_aServerInfoCache[GetCacheIndex(Type, SendClients)];
 
-#define ADD_RAW(p, x) (p).AddRaw(x, sizeof(x))
-#define ADD_INT(p, x) \
-	do \
-	{ \
-		str_format(aBuf, sizeof(aBuf), "%d", x); \
-		(p).AddString(aBuf, 0); \
-	} while(0)
-
-	CNetChunk Packet;
-	Packet.m_ClientId = -1;
-	Packet.m_Address = *pAddr;
-	Packet.m_Flags = NETSENDFLAG_CONNLESS;
-
-	for(const auto &Chunk : pCache->m_vCache)
+	// send multi-chunk responses as a burst
+	static constexpr int MAX_BURST = 16;
+	const void *apData[MAX_BURST];
+	int aSizes[MAX_BURST];
+	int NumData = 0;
+	for(auto &Datagram : pCache->m_vDatagrams)
 	{
-		p.Reset();
-		if(Type == SERVERINFO_EXTENDED)
-		{
-			if(&Chunk == &pCache->m_vCache.front())
-				p.AddRaw(SERVERBROWSE_INFO_EXTENDED, sizeof(SERVERBROWSE_INFO_EXTENDED));
-			else
-				p.AddRaw(SERVERBROWSE_INFO_EXTENDED_MORE, sizeof(SERVERBROWSE_INFO_EXTENDED_MORE));
-			ADD_INT(p, Token);
-		}
-		else if(Type == SERVERINFO_64_LEGACY)
+		apData[NumData] = Datagram.Prepare(Token, &aSizes[NumData]);
+		NumData++;
+		if(NumData == MAX_BURST)
 		{
-			ADD_RAW(p, SERVERBROWSE_INFO_64_LEGACY);
-			ADD_INT(p, Token);
+			net_udp_send_batch(m_NetServer.Socket(), pAddr, apData, aSizes, NumData);
+			NumData = 0;
 		}
-		else if(Type == SERVERINFO_VANILLA || Type == SERVERINFO_INGAME)
-		{
-			ADD_RAW(p, SERVERBROWSE_INFO);
-			ADD_INT(p, Token);
-		}
-		else
-		{
-			dbg_assert_failed("Invalid serverinfo Type: %d", Type);
-		}
-
-		p.AddRaw(Chunk.m_vData.data(), Chunk.m_vData.size());
-		Packet.m_pData = p.Data();
-		Packet.m_DataSize = p.Size();
-		m_NetServer.Send(&Packet);
 	}
+	if(NumData > 0)
+		net_udp_send_batch(m_NetServer.Socket(), pAddr, apData, aSizes, NumData);
 }
 
 void CServer::GetServerInfoSixup(CPacker *pPacker, bool SendClients)
@@ -2578,7 +2713,12 @@ void CServer::FillAntibot(CAntibotRoundData *pData)
 
 void CServer::ExpireServerInfo()
 {
-	m_ServerInfoNeedsUpdate = true;
+	m_ServerInfoDirty |= SERVERINFO_DIRTY_ALL;
+}
+
+void CServer::ExpireServerInfoClients()
+{
+	m_ServerInfoDirty |= SERVERINFO_DIRTY_CLIENTS;
 }
 
 void CServer::UpdateRegisterServerInfo()
@@ -2718,18 +2858,21 @@ void CServer::UpdateRegisterServerInfo()
 	m_pRegister->OnNewInfo(JsonWriter.GetOutputString().c_str());
 }
 
-void CServer::UpdateServerInfo(bool Resend)
+void CServer::UpdateServerInfo(bool Resend, int Dirty)
 {
 	if(m_RunServer == UNINITIALIZED)
 		return;
 
 	UpdateRegisterServerInfo();
 
+	// the variants without clients only need to be rebuilt if more than the client details changed
+	const bool RebuildWithoutClients = (Dirty & ~SERVERINFO_DIRTY_CLIENTS) != 0;
+
 	for(int i = 0; i < 3; i++)
-		for(int j = 0; j < 2; j++)
+		for(int j = RebuildWithoutClients ? 0 : 1; j < 2; j++)
 			CacheServerInfo(&m_aServerInfoCache[i * 2 + j], i, j);
 
-	for(int i = 0; i < 2; i++)
+	for(int i = RebuildWithoutClients ? 0 : 1; i < 2; i++)
 		CacheServerInfoSixup(&m_aSixupServerInfoCache[i], i, MAX_CLIENTS);
 
 	if(Resend)
@@ -2750,7 +2893,7 @@ void CServer::UpdateServerInfo(bool Resend)
 		}
 	}
 
-	m_ServerInfoNeedsUpdate = false;
+	m_ServerInfoDirty = 0;
 }
 
 void CServer::PumpNetwork(bool PacketWaiting)
@@ -3026,6 +3169,66 @@ void CServer::UpdateDebugDummies(bool ForceDisconnect)
 }
 #endif
 
+void CServer::SimulateClientJoin(int ClientId, bool Sixup)
+{
+	NewClientCallback(ClientId, this, Sixup);
+	m_aClients[ClientId].m_State = CClient::STATE_READY;
+	GameServer()->OnClientConnected(ClientId, nullptr);
+}
+
+void CServer::SimulateClientEnter(int ClientId)
+{
+	if(m_aClients[ClientId].m_State != CClient::STATE_READY)
+		return;
+	m_aClients[ClientId].m_State = CClient::STATE_INGAME;
+	GameServer()->OnClientEnter(ClientId);
+}
+
+void CServer::SimulateClientDrop(int ClientId, const char *pReason)
+{
+	if(m_aClients[ClientId].m_State == CClient::STATE_EMPTY)
+		return;
+	DelClientCallback(ClientId, pReason, this);
+}
+
+void CServer::SimulateClientMessage(int ClientId, const void *pData, int DataSize)
+{
+	CUnpacker Unpacker;
+	Unpacker.Reset(pData, DataSize);
+	CMsgPacker Packer(NETMSG_EX, true);
+
+	int Msg;
+	bool Sys;
+	CUuid Uuid;
+	if(UnpackMessageId(&Msg, &Sys, &Uuid, &Unpacker, &Packer) != UNPACKMESSAGE_OK)
+		return;
+	if(m_aClients[ClientId].m_Sixup && (Msg = MsgFromSixup(Msg, Sys)) < 0)
+		return;
+
+	// System messages are handled by the network engine and not recorded
+	if(!Sys && m_aClients[ClientId].m_State >= CClient::STATE_READY)
+		GameServer()->OnMessage(Msg, &Unpacker, ClientId);
+}
+
+void CServer::SimulateTick(const void *const *ppInputs)
+{
+	GameServer()->OnPreTickTeehistorian();
+	for(int c = 0; c < MAX_CLIENTS; c++)
+	{
+		if(m_aClients[c].m_State == CClient::STATE_INGAME)
+			GameServer()->OnClientPredictedEarlyInput(c, ppInputs[c]);
+	}
+
+	m_CurrentGameTick++;
+
+	for(int c = 0; c < MAX_CLIENTS; c++)
+	{
+		if(m_aClients[c].m_State == CClient::STATE_INGAME)
+			GameServer()->OnClientPredictedInput(c, ppInputs[c]);
+	}
+	GameServer()->OnTick();
+}
+
 int CServer::Run()
 {
 	if(m_RunServer == UNINITIALIZED)
@@ -3115,6 +3318,7 @@ int CServer::Run()
 	m_Econ.Init(Config(), Console(), &m_ServerBan);
 
 	m_Fifo.Init(Console(), Config()->m_SvInputFifo, CFGFLAG_SERVER);
+	OpenStatsFile();
 
 	char aBuf[256];
 	str_format(aBuf, sizeof(aBuf), "server name is '%s'", Config()->m_SvName);
@@ -3244,8 +3448,18 @@ int CServer::Run()
 				}
 			}
 
+			// time_get() is cached until the next set_new_tick()
+			int64_t TickStart = LastTime;
 			while(LastTime > TickStartTime(m_CurrentGameTick + 1))
 			{
+				if(m_StatsWriter.IsOpen())
+				{
+					const int64_t Now = time_get_impl();
+					if(NewTicks)
+						RecordTickTime(Now - TickStart);
+					TickStart = Now;
+				}
+
 				GameServer()->OnPreTickTeehistorian();
 
 #ifdef CONF_DEBUG
@@ -3321,8 +3535,8 @@ int CServer::Run()
 				// master server stuff
 				m_pRegister->Update();
 
-				if(m_ServerInfoNeedsUpdate)
-					UpdateServerInfo();
+				if(m_ServerInfoDirty)
+					UpdateServerInfo(false, m_ServerInfoDirty);
 
 				Antibot()->OnEngineTick();
 
@@ -3376,6 +3590,12 @@ int CServer::Run()
 						}
 					}
 				}
+
+				if(m_StatsWriter.IsOpen())
+				{
+					RecordTickTime(time_get_impl() - TickStart);
+					PublishStats();
+				}
 			}
 
 			if(!NonActive)
@@ -3453,9 +3673,11 @@ int CServer::Run()
 	m_pRegister->OnShutdown();
 	m_Econ.Shutdown();
 	m_Fifo.Shutdown();
+	m_StatsWriter.Close();
 	Engine()->ShutdownJobs();
 
 	GameServer()->OnShutdown(nullptr);
+	m_DemoEncoder.Shutdown();
 	m_pMap->Unload();
 	DbPool()->OnShutdown();
 
@@ -3788,6 +4010,103 @@ void CServer::ConAuthList(IConsole::IResult *pResult, void *pUser)
 	pManager->ListKeys(ListKeysCallback, pThis);
 }
 
+void CServer::ConNetStatus(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	const int ClientId = pResult->GetInteger(0);
+	if(ClientId < 0 || ClientId >= MAX_CLIENTS || pThis->m_aClients[ClientId].m_State == CClient::STATE_EMPTY || pThis->m_aClients[ClientId].m_DebugDummy)
+	{
+		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", "client is not connected");
+		return;
+	}
+	const CClient &Client = pThis->m_aClients[ClientId];
+	const NETSTATS &NetStats = pThis->m_NetServer.ClientStats(ClientId);
+	const CNetConnectionStats &DetailedStats = pThis->m_NetServer.ClientDetailedStats(ClientId);
+
+	char aBuf[512];
+	str_format(aBuf, sizeof(aBuf), "id=%d sent=%" PRIu64 " packets/%" PRIu64 " KiB recv=%" PRIu64 " packets/%" PRIu64 " KiB resent_chunks=%" PRIu64 " resend_requests=%" PRIu64,
+		ClientId, NetStats.sent_packets, NetStats.sent_bytes / 1024, NetStats.recv_packets, NetStats.recv_bytes / 1024,
+		DetailedStats.m_ResentChunks, DetailedStats.m_ResendRequests);
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+
+	str_copy(aBuf, "ack_latency");
+	for(int i = 0; i < CNetConnectionStats::NUM_ACK_LATENCY_BUCKETS; i++)
+	{
+		char aBucket[64];
+		if(i < CNetConnectionStats::NUM_ACK_LATENCY_BUCKETS - 1)
+			str_format(aBucket, sizeof(aBucket), " <%dms=%" PRIu64, 1 << i, DetailedStats.m_aAckLatency[i]);
+		else
+			str_format(aBucket, sizeof(aBucket), " >=%dms=%" PRIu64, 1 << (i - 1), DetailedStats.m_aAckLatency[i]);
+		str_append(aBuf, aBucket);
+	}
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+
+	str_copy(aBuf, "sent_packet_sizes");
+	for(int i = 0; i < CNetConnectionStats::NUM_PACKET_SIZE_BUCKETS; i++)
+	{
+		char aBucket[64];
+		str_format(aBucket, sizeof(aBucket), " <%d=%" PRIu64, (i + 1) * CNetConnectionStats::PACKET_SIZE_BUCKET_WIDTH, DetailedStats.m_aSentPacketSizes[i]);
+		str_append(aBuf, aBucket);
+	}
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+
+	str_format(aBuf, sizeof(aBuf), "snapshots full=%" PRIu64 " KiB delta=%" PRIu64 " KiB packed=%" PRIu64 " KiB (%.1f%% of full) deferred_items=%" PRIu64,
+		Client.m_SnapFullBytes / 1024, Client.m_SnapDeltaBytes / 1024, Client.m_SnapPackedBytes / 1024,
+		Client.m_SnapFullBytes ? 100.0 * Client.m_SnapPackedBytes / Client.m_SnapFullBytes : 0.0,
+		Client.m_SnapDeferredItems);
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+
+	// item types by packed bytes, biggest first
+	int aTypes[CServerStats::NUM_SNAP_ITEM_TYPES];
+	int NumTypes = 0;
+	for(int Type = 0; Type < CServerStats::NUM_SNAP_ITEM_TYPES; Type++)
+	{
+		if(Client.m_aSnapItemBytes[Type])
+			aTypes[NumTypes++] = Type;
+	}
+	std::sort(aTypes, aTypes + NumTypes, [&](int A, int B) { return Client.m_aSnapItemBytes[A] > Client.m_aSnapItemBytes[B]; });
+	for(int i = 0; i < NumTypes; i++)
+	{
+		const int Type = aTypes[i];
+		const char *pName;
+		if(Type == CServerStats::NUM_SNAP_ITEM_TYPES - 1)
+			pName = "other";
+		else if(Client.m_Sixup)
+			pName = pThis->GameServer()->GetNetObjHandler7()->GetObjName(Type);
+		else
+			pName = pThis->GameServer()->GetNetObjHandler()->GetObjName(Type);
+		str_format(aBuf, sizeof(aBuf), "  type=%d name=%s packed=%" PRIu64 " KiB (%.1f%%)",
+			Type, pName, Client.m_aSnapItemBytes[Type] / 1024, 100.0 * Client.m_aSnapItemBytes[Type] / Client.m_SnapPackedBytes);
+		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+	}
+}
+
+void CServer::ConPreFilterStatus(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	const CNetPreFilter &PreFilter = pThis->m_NetServer.PreFilter();
+
+	char aBuf[256] = "";
+	for(int Result = 0; Result < CNetPreFilter::NUM_RESULTS; Result++)
+	{
+		char aCount[64];
+		str_format(aCount, sizeof(aCount), "%s%s=%" PRIu64, Result == 0 ? "" : " ", CNetPreFilter::ResultName(Result), PreFilter.Count(Result));
+		str_append(aBuf, aCount);
+	}
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+}
+
+void CServer::ConDemoEncoderStatus(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = static_cast<CServer *>(pUser);
+	const CDemoEncoder::CStats Stats = pThis->m_DemoEncoder.Stats();
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "encoded=%" PRId64 " dropped=%" PRId64 " queued=%" PRIzu " KiB peak=%" PRIzu " KiB",
+		Stats.m_NumEncoded, Stats.m_NumDropped, Stats.m_QueuedBytes / 1024, Stats.m_PeakQueuedBytes / 1024);
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+}
+
 void CServer::ConShutdown(IConsole::IResult *pResult, void *pUser)
 {
 	CServer *pThis = static_cast<CServer *>(pUser);
@@ -4107,6 +4426,16 @@ void CServer::ConchainMaxclientsperipUpdate(IConsole::IResult *pResult, void *pU
 		((CServer *)pUserData)->m_NetServer.SetMaxClientsPerIp(pResult->GetInteger(0));
 }
 
+void CServer::ConchainDemoQueueSizeUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
+{
+	pfnCallback(pResult, pCallbackUserData);
+	if(pResult->NumArguments())
+	{
+		CServer *pThis = static_cast<CServer *>(pUserData);
+		pThis->m_DemoEncoder.SetMaxQueueSize((size_t)pThis->Config()->m_SvDemoQueueSize * 1024);
+	}
+}
+
 void CServer::ConchainCommandAccessUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
 {
 	if(pResult->NumArguments() == 2)
@@ -4320,6 +4649,14 @@ void CServer::ConchainInputFifo(IConsole::IResult *pResult, void *pUserData, ICo
 	}
 }
 
+void CServer::ConchainStatsFile(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
+{
+	CServer *pSelf = (CServer *)pUserData;
+	pfnCallback(pResult, pCallbackUserData);
+	if(pResult->NumArguments() && pSelf->m_RunServer == RUNNING)
+		pSelf->OpenStatsFile();
+}
+
 #if defined(CONF_FAMILY_UNIX)
 void CServer::ConchainConnLoggingServerChange(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
 {
@@ -4369,6 +4706,7 @@ void CServer::RegisterCommands()
 
 	Console()->Register("record", "?s[file]", CFGFLAG_SERVER | CFGFLAG_STORE, ConRecord, this, "Record to a file");
 	Console()->Register("stoprecord", "", CFGFLAG_SERVER, ConStopRecord, this, "Stop recording");
+	Console()->Register("demo_encoder_status", "", CFGFLAG_SERVER, ConDemoEncoderStatus, this, "Show how much demo data was encoded, dropped and is waiting to be written");
 
 	Console()->Register("reload", "", CFGFLAG_SERVER, ConMapReload, this, "Reload the map");
 
@@ -4382,6 +4720,9 @@ void CServer::RegisterCommands()
 	Console()->Register("auth_remove", "s[ident]", CFGFLAG_SERVER | CFGFLAG_NONTEEHISTORIC, ConAuthRemove, this, "Remove a rcon key");
 	Console()->Register("auth_list", "", CFGFLAG_SERVER, ConAuthList, this, "List all rcon keys");
 
+	Console()->Register("net_status", "i[id]", CFGFLAG_SERVER, ConNetStatus, this, "Show traffic, resends, ack latencies and snapshot bytes per item type of a client");
+	Console()->Register("prefilter_status", "", CFGFLAG_SERVER, ConPreFilterStatus, this, "Show how many packets from addresses without a connection were accepted or dropped");
+
 	Console()->Register("reload_announcement", "", CFGFLAG_SERVER, ConReloadAnnouncement, this, "Reload the announcements");
 	Console()->Register("reload_maplist", "", CFGFLAG_SERVER, ConReloadMaplist, this, "Reload the maplist");
 
@@ -4393,6 +4734,7 @@ void CServer::RegisterCommands()
 	Console()->Chain("sv_spectator_slots", ConchainSpecialInfoupdate, this);
 
 	Console()->Chain("sv_max_clients_per_ip", ConchainMaxclientsperipUpdate, this);
+	Console()->Chain("sv_demo_queue_size", ConchainDemoQueueSizeUpdate, this);
 	Console()->Chain("access_level", ConchainCommandAccessUpdate, this);
 
 	Console()->Chain("sv_rcon_password", ConchainRconPasswordChange, this);
@@ -4408,6 +4750,7 @@ void CServer::RegisterCommands()
 	Console()->Chain("sv_announcement_filename", ConchainAnnouncementFilename, this);
 
 	Console()->Chain("sv_input_fifo", ConchainInputFifo, this);
+	Console()->Chain("sv_stats_file", ConchainStatsFile, this);
 
 #if defined(CONF_FAMILY_UNIX)
 	Console()->Chain("sv_conn_logging_server", ConchainConnLoggingServerChange, this);
@@ -4425,11 +4768,22 @@ int CServer::SnapNewId()
 	return m_IdPool.NewId();
 }
 
+int CServer::SnapNewIds(int *pIds, int Num)
+{
+	return m_IdPool.NewIds(pIds, Num);
+}
+
 void CServer::SnapFreeId(int Id)
 {
 	m_IdPool.FreeId(Id);
 }
 
+void CServer::SnapIdUsage(int *pNumAllocated, int *pNumTimed) const
+{
+	*pNumAllocated = m_IdPool.NumAllocated();
+	*pNumTimed = m_IdPool.NumTimed();
+}
+
 void *CServer::SnapNewItem(int Type, int Id, int Size)
 {
 	dbg_assert(Id >= -1 && Id <= 0xffff, "Invalid snap item Id: %d", Id);
@@ -7,6 +7,7 @@
 #include "authmanager.h"
 #include "name_ban.h"
 #include "snap_id_pool.h"
+#include "snapshot_budget.h"
 
 #include <base/hash.h>
 
@@ -19,6 +20,7 @@
 #include <engine/shared/netban.h>
 #include <engine/shared/network.h>
 #include <engine/shared/protocol.h>
+#include <engine/shared/server_stats.h>
 #include <engine/shared/snapshot.h>
 #include <engine/shared/uuid_manager.h>
 
@@ -151,6 +153,15 @@ public:
 
 		int m_LastAckedSnapshot;
 		int m_LastInputTick;
+		// compressed size of the last snapshot delta sent
+		int m_LastSnapshotSize;
+		// totals since the client connected, see CServerStats::CClient
+		uint64_t m_SnapFullBytes;
+		uint64_t m_SnapDeltaBytes;
+		uint64_t m_SnapPackedBytes;
+		uint64_t m_aSnapItemBytes[CServerStats::NUM_SNAP_ITEM_TYPES];
+		uint64_t m_SnapDeferredItems;
+		CSnapshotBudget m_SnapshotBudget;
 		CSnapshotStorage m_Snapshots;
 
 		CNetMsg_Sv_PreInput m_LastPreInput = {};
@@ -187,6 +198,7 @@ public:
 		void *m_pPersistentData;
 
 		void Reset();
+		void ResetSnapshotStats();
 
 		// DDRace
 
@@ -220,6 +232,7 @@ public:
 	CNetServer m_NetServer;
 	CEcon m_Econ;
 	CFifo m_Fifo;
+	CServerStatsWriter m_StatsWriter;
 	CServerBan m_ServerBan;
 	CHttp m_Http;
 
@@ -236,6 +249,10 @@ public:
 
 	int m_RunServer;
 
+	// ring buffer of the time spent on the last ticks, in microseconds
+	int m_aTickTimes[CServerStats::TICK_TIME_WINDOW] = {};
+	int m_NumTickTimes = 0;
+
 	bool m_MapReload;
 	bool m_SameMapReload;
 	bool m_ReloadedWhenEmpty;
@@ -267,6 +284,7 @@ public:
 	unsigned int m_aCurrentMapSize[NUM_MAP_TYPES];
 	char m_aMapDownloadUrl[256];
 
+	CDemoEncoder m_DemoEncoder;
 	CDemoRecorder m_aDemoRecorder[NUM_RECORDERS];
 	CAuthManager m_AuthManager;
 
@@ -336,6 +354,9 @@ public:
 	int SendMsg(CMsgPacker *pMsg, int Flags, int ClientId) override;
 
 	void DoSnapshot();
+	void OpenStatsFile();
+	void RecordTickTime(int64_t TickTime);
+	void PublishStats();
 
 	static int NewClientCallback(int ClientId, void *pUser, bool Sixup);
 	static int NewClientNoAuthCallback(int ClientId, void *pUser);
@@ -390,21 +411,53 @@ public:
 			std::vector<uint8_t> m_vData;
 		};
 
+		/**
+		 * Prebuilt connless datagram for a server info chunk. The data is
+		 * preceded by reserved space, into which the connless header, the
+		 * info type and the request token are written right before sending.
+		 * The result is the same datagram as packing the info type, the
+		 * token and the chunk for each request.
+		 */
+		class CDatagram
+		{
+		public:
+			CDatagram(const unsigned char *pType, const void *pData, int Size);
+			CDatagram(const CDatagram &) = delete;
+			CDatagram(CDatagram &&) = default;
+
+			const unsigned char *Prepare(int Token, int *pSize);
+
+			const unsigned char *m_pType;
+			std::vector<uint8_t> m_vData;
+		};
+
 		std::vector<CCacheChunk> m_vCache;
+		std::vector<CDatagram> m_vDatagrams;
 
 		CCache();
 		~CCache();
 
 		void AddChunk(const void *pData, int Size);
+		void AddDatagram(const unsigned char *pType, const void *pData, int Size);
 		void Clear();
 	};
 	CCache m_aServerInfoCache[3 * 2];
 	CCache m_aSixupServerInfoCache[2];
-	bool m_ServerInfoNeedsUpdate;
+
+	enum
+	{
+		// names, clans, countries and scores of the clients
+		SERVERINFO_DIRTY_CLIENTS = 1 << 0,
+		// player counts, server name, map and everything else
+		SERVERINFO_DIRTY_ALL = SERVERINFO_DIRTY_CLIENTS | (1 << 1),
+	};
+	int m_ServerInfoDirty;
 
 	void FillAntibot(CAntibotRoundData *pData) override;
 
 	void ExpireServerInfo() override;
+	void ExpireServerInfoClients() override;
+	static const unsigned char *ServerInfoChunkType(int Type, int Chunk);
 	void CacheServerInfo(CCache *pCache, int Type, bool SendClients);
 	void CacheServerInfoSixup(CCache *pCache, bool SendClients, int MaxConsideredClients);
 	void SendServerInfo(const NETADDR *pAddr, int Token, int Type, bool SendClients);
@@ -412,7 +465,7 @@ public:
 	bool RateLimitServerInfoConnless();
 	void SendServerInfoConnless(const NETADDR *pAddr, int Token, int Type);
 	void UpdateRegisterServerInfo();
-	void UpdateServerInfo(bool Resend = false);
+	void UpdateServerInfo(bool Resend = false, int Dirty = SERVERINFO_DIRTY_ALL);
 
 	void PumpNetwork(bool PacketWaiting);
 
@@ -429,6 +482,15 @@ public:
 
 	int Run();
 
+	// Drive the game without networking, used to replay recorded games
+	void SimulateClientJoin(int ClientId, bool Sixup);
+	void SimulateClientEnter(int ClientId);
+	void SimulateClientDrop(int ClientId, const char *pReason);
+	void SimulateClientMessage(int ClientId, const void *pData, int DataSize);
+	// Advances the game by one tick like `Run`, `ppInputs` holds the input
+	// of every client, `nullptr` to repeat the previous one
+	void SimulateTick(const void *const *ppInputs);
+
 	static void ConKick(IConsole::IResult *pResult, void *pUser);
 	static void ConStatus(IConsole::IResult *pResult, void *pUser);
 	static void ConShutdown(IConsole::IResult *pResult, void *pUser);
@@ -446,6 +508,9 @@ public:
 	static void ConAuthUpdateHashed(IConsole::IResult *pResult, void *pUser);
 	static void ConAuthRemove(IConsole::IResult *pResult, void *pUser);
 	static void ConAuthList(IConsole::IResult *pResult, void *pUser);
+	static void ConNetStatus(IConsole::IResult *pResult, void *pUser);
+	static void ConPreFilterStatus(IConsole::IResult *pResult, void *pUser);
+	static void ConDemoEncoderStatus(IConsole::IResult *pResult, void *pUser);
 
 	// console commands for sqlmasters
 	static void ConAddSqlServer(IConsole::IResult *pResult, void *pUserData);
@@ -456,6 +521,7 @@ public:
 
 	static void ConchainSpecialInfoupdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainMaxclientsperipUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
+	static void ConchainDemoQueueSizeUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainCommandAccessUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 
 	void LogoutClient(int ClientId, const char *pReason);
@@ -472,6 +538,7 @@ public:
 	static void ConchainStdoutOutputLevel(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainAnnouncementFilename(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainInputFifo(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
+	static void ConchainStatsFile(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 
 #if defined(CONF_FAMILY_UNIX)
 	static void ConchainConnLoggingServerChange(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
@@ -480,7 +547,9 @@ public:
 	void RegisterCommands();
 
 	int SnapNewId() override;
+	int SnapNewIds(int *pIds, int Num) override;
 	void SnapFreeId(int Id) override;
+	void SnapIdUsage(int *pNumAllocated, int *pNumTimed) const override;
 	void *SnapNewItem(int Type, int Id, int Size) override;
 	void SnapSetStaticsize(int ItemType, int Size) override;
 
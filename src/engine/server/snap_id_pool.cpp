@@ -44,6 +44,14 @@ void CSnapIdPool::RemoveFirstTimeout()
 }
 
 int CSnapIdPool::NewId()
+{
+	int Id;
+	if(NewIds(&Id, 1) != 1)
+		return -1;
+	return Id;
+}
+
+int CSnapIdPool::NewIds(int *pIds, int Num)
 {
 	int64_t Now = time_get();
 
@@ -51,17 +59,20 @@ int CSnapIdPool::NewId()
 	while(m_FirstTimed != -1 && m_aIds[m_FirstTimed].m_Timeout < Now)
 		RemoveFirstTimeout();
 
-	int Id = m_FirstFree;
-	if(Id == -1)
+	int NumIds = 0;
+	while(NumIds < Num && m_FirstFree != -1)
 	{
-		dbg_msg("server", "invalid id");
-		return Id;
+		int Id = m_FirstFree;
+		m_FirstFree = m_aIds[m_FirstFree].m_Next;
+		m_aIds[Id].m_State = ID_ALLOCATED;
+		pIds[NumIds] = Id;
+		NumIds++;
 	}
-	m_FirstFree = m_aIds[m_FirstFree].m_Next;
-	m_aIds[Id].m_State = ID_ALLOCATED;
-	m_Usage++;
-	m_InUsage++;
-	return Id;
+	if(NumIds < Num)
+		dbg_msg("server", "invalid id");
+	m_Usage += NumIds;
+	m_InUsage += NumIds;
+	return NumIds;
 }
 
 void CSnapIdPool::TimeoutIds()
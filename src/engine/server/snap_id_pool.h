@@ -4,6 +4,8 @@
 #ifndef ENGINE_SERVER_SNAP_ID_POOL_H
 #define ENGINE_SERVER_SNAP_ID_POOL_H
 
+#include <cstdint>
+
 class CSnapIdPool
 {
 	enum
@@ -24,7 +26,7 @@ class CSnapIdPool
 	public:
 		short m_Next;
 		short m_State; // 0 = free, 1 = allocated, 2 = timed
-		int m_Timeout;
+		int64_t m_Timeout;
 	};
 
 	CID m_aIds[MAX_IDS];
@@ -41,8 +43,18 @@ public:
 	void Reset();
 	void RemoveFirstTimeout();
 	int NewId();
+	/**
+	 * Allocates up to `Num` ids at once.
+	 *
+	 * @return Number of ids written to `pIds`, less than `Num` if the pool ran out.
+	 */
+	int NewIds(int *pIds, int Num);
 	void TimeoutIds();
 	void FreeId(int Id);
+
+	int NumAllocated() const { return m_InUsage; }
+	// Freed ids that cannot be reused yet, clients may still know them
+	int NumTimed() const { return m_Usage - m_InUsage; }
 };
 
 #endif
@@ -0,0 +1,135 @@
+#include "snapshot_budget.h"
+
+#include <base/system.h>
+
+#include <engine/shared/compression.h>
+#include <engine/shared/snapshot.h>
+
+#include <algorithm>
+
+int CSnapshotBudget::Apply(CSnapshotBuilder *pBuilder, const CSnapshotDelta &Delta, const CSnapshot *pDeltashot, const CSnapshot *pSnapshot, int Budget, int Tick, int MaxWaitTicks, const FDistance &Distance)
+{
+	m_vPastKeys.clear();
+	for(int i = 0; i < pDeltashot->NumItems(); i++)
+		m_vPastKeys.emplace_back(pDeltashot->GetItem(i)->Key(), i);
+	std::sort(m_vPastKeys.begin(), m_vPastKeys.end());
+	auto FindPast = [&](int Key) {
+		auto It = std::lower_bound(m_vPastKeys.begin(), m_vPastKeys.end(), std::pair<int, int>(Key, -1));
+		return It != m_vPastKeys.end() && It->first == Key ? It->second : -1;
+	};
+
+	// Estimate the packed size of the delta like CSnapshotDelta::CreateDelta
+	// writes it, the header with the largest item counts possible.
+	bool aPastMatched[CSnapshot::MAX_ITEMS] = {};
+	int aPastIndices[CSnapshot::MAX_ITEMS];
+	int Fixed = CVariableInt::PackedSize(pDeltashot->NumItems()) + CVariableInt::PackedSize(pSnapshot->NumItems()) + CVariableInt::PackedSize(0);
+	int Total = 0;
+	m_vItems.clear();
+	for(int i = 0; i < pSnapshot->NumItems(); i++)
+	{
+		const CSnapshotItem *pItem = pSnapshot->GetItem(i);
+		const int Size = pSnapshot->GetItemSize(i);
+		const int NumInts = Size / sizeof(int32_t);
+		const int *pData = pItem->Data();
+		const int PastIndex = FindPast(pItem->Key());
+		aPastIndices[i] = PastIndex;
+		if(PastIndex >= 0)
+			aPastMatched[PastIndex] = true;
+
+		int Cost = 0;
+		bool Deferrable = true;
+		if(PastIndex >= 0 && pDeltashot->GetItemSize(PastIndex) == Size)
+		{
+			// like CSnapshotDelta::DiffItem, the item is updated if any int changed
+			const int *pPastData = pDeltashot->GetItem(PastIndex)->Data();
+			bool Changed = false;
+			for(int b = 0; b < NumInts; b++)
+			{
+				const int Diff = (unsigned)pData[b] - (unsigned)pPastData[b];
+				Changed = Changed || Diff != 0;
+				Cost += CVariableInt::PackedSize(Diff);
+			}
+			if(!Changed)
+				continue;
+		}
+		else if(PastIndex >= 0)
+		{
+			// the client cannot keep the old data of an item that changed its size
+			Cost = NumInts * CVariableInt::MAX_BYTES_PACKED;
+			Deferrable = false;
+		}
+		else
+		{
+			for(int b = 0; b < NumInts; b++)
+				Cost += CVariableInt::PackedSize(pData[b]);
+		}
+		Cost += CVariableInt::PackedSize(pItem->Type()) + CVariableInt::PackedSize(pItem->Id());
+		if(Delta.IncludesItemSize(pItem->Type()))
+			Cost += CVariableInt::PackedSize(NumInts);
+
+		const auto Deferred = m_DeferredItems.find(pItem->Key());
+		const int Waited = Deferred == m_DeferredItems.end() ? 0 : Tick - Deferred->second;
+		const float ItemDistance = Deferrable && Waited < MaxWaitTicks ? Distance(i) : -1.0f;
+		if(ItemDistance < 0.0f)
+		{
+			Fixed += Cost;
+			continue;
+		}
+		Total += Cost;
+
+		// the longer an item waited, the more important it gets
+		m_vItems.push_back({i, Cost, ItemDistance / (1 + Waited)});
+	}
+	for(int i = 0; i < pDeltashot->NumItems(); i++)
+	{
+		if(!aPastMatched[i])
+			Fixed += CVariableInt::PackedSize(pDeltashot->GetItem(i)->Key());
+	}
+
+	if(Fixed + Total <= Budget)
+	{
+		m_DeferredItems.clear();
+		return 0;
+	}
+
+	std::stable_sort(m_vItems.begin(), m_vItems.end(), [](const CItem &A, const CItem &B) {
+		return A.m_Priority < B.m_Priority;
+	});
+
+	bool aRemove[CSnapshot::MAX_ITEMS] = {};
+	bool Removed = false;
+	int NumDeferred = 0;
+	int Left = Budget - Fixed;
+	m_NextDeferredItems.clear();
+	for(const CItem &Item : m_vItems)
+	{
+		if(Item.m_Cost <= Left)
+		{
+			Left -= Item.m_Cost;
+			continue;
+		}
+
+		const int Key = pSnapshot->GetItem(Item.m_Index)->Key();
+		const int PastIndex = aPastIndices[Item.m_Index];
+		if(PastIndex >= 0)
+			mem_copy(pBuilder->GetItemData(Key), pDeltashot->GetItem(PastIndex)->Data(), pDeltashot->GetItemSize(PastIndex));
+		else
+		{
+			aRemove[Item.m_Index] = true;
+			Removed = true;
+		}
+
+		const auto Deferred = m_DeferredItems.find(Key);
+		m_NextDeferredItems[Key] = Deferred == m_DeferredItems.end() ? Tick : Deferred->second;
+		NumDeferred++;
+	}
+	if(Removed)
+		pBuilder->RemoveItems(aRemove);
+	std::swap(m_DeferredItems, m_NextDeferredItems);
+	return NumDeferred;
+}
+
+void CSnapshotBudget::Reset()
+{
+	m_DeferredItems.clear();
+}
@@ -0,0 +1,67 @@
+#ifndef ENGINE_SERVER_SNAPSHOT_BUDGET_H
+#define ENGINE_SERVER_SNAPSHOT_BUDGET_H
+
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class CSnapshot;
+class CSnapshotBuilder;
+class CSnapshotDelta;
+
+/**
+ * Keeps the snapshot deltas sent to one client within a byte budget, see
+ * `sv_snapshot_budget`.
+ *
+ * If the estimated packed size of a delta exceeds the budget, changed and
+ * new items far from the camera are held back: changed items keep the data
+ * the client already has, new items are left out of the snapshot. Items
+ * that waited longer are preferred, items that waited `MaxWaitTicks` are
+ * sent even if that exceeds the budget, so every item arrives eventually.
+ */
+class CSnapshotBudget
+{
+public:
+	/**
+	 * Distance of the item with the index to the camera of the client,
+	 * negative for items that must always be sent.
+	 */
+	typedef std::function<float(int Index)> FDistance;
+
+	/**
+	 * @param pBuilder Builder `pSnapshot` was finished from, the held back
+	 * items are changed in it.
+	 * @param Delta Delta the snapshot will be created with, for the static
+	 * item sizes.
+	 * @param pDeltashot Snapshot the delta will be created against.
+	 * @param pSnapshot Snapshot that will be sent.
+	 * @param Budget Maximum packed size of the delta in bytes.
+	 * @param Tick Current tick.
+	 * @param MaxWaitTicks Ticks after which held back items are always sent.
+	 * @param Distance See @link FDistance @endlink.
+	 *
+	 * @return Number of held back items. If it is not 0, `pBuilder` has
+	 * to be finished again.
+	 */
+	int Apply(CSnapshotBuilder *pBuilder, const CSnapshotDelta &Delta, const CSnapshot *pDeltashot, const CSnapshot *pSnapshot, int Budget, int Tick, int MaxWaitTicks, const FDistance &Distance);
+	void Reset();
+
+private:
+	class CItem
+	{
+	public:
+		int m_Index;
+		int m_Cost;
+		float m_Priority;
+	};
+
+	// held back items, key -> tick they were first held back
+	std::unordered_map<int, int> m_DeferredItems;
+	std::unordered_map<int, int> m_NextDeferredItems;
+
+	std::vector<std::pair<int, int>> m_vPastKeys;
+	std::vector<CItem> m_vItems;
+};
+
+#endif
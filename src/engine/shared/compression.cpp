@@ -37,6 +37,21 @@ unsigned char *CVariableInt::Pack(unsigned char *pDst, int i, int DstSize)
 	return pDst;
 }
 
+int CVariableInt::PackedSize(int i)
+{
+	if(i < 0)
+		i = ~i;
+
+	int Size = 1;
+	i >>= 6; // first byte holds 6bit
+	while(i)
+	{
+		Size++;
+		i >>= 7; // following bytes hold 7bit
+	}
+	return Size;
+}
+
 const unsigned char *CVariableInt::Unpack(const unsigned char *pSrc, int *pInOut, int SrcSize)
 {
 	if(SrcSize <= 0)
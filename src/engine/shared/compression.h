@@ -14,6 +14,7 @@ public:
 
 	static unsigned char *Pack(unsigned char *pDst, int i, int DstSize);
 	static const unsigned char *Unpack(const unsigned char *pSrc, int *pInOut, int SrcSize);
+	static int PackedSize(int i);
 
 	static long Compress(const void *pSrc, int SrcSize, void *pDst, int DstSize);
 	static long Decompress(const void *pSrc, int SrcSize, void *pDst, int DstSize);
@@ -90,6 +90,26 @@ void CConsole::CCommand::SetAccessLevel(EAccessLevel AccessLevel)
 	m_AccessLevel = AccessLevel;
 }
 
+void CConsole::CCommand::CompileParams()
+{
+	m_ParamTypesCompiled = false;
+
+	// a leading description is not skipped by NextParam
+	const char *pFormat = m_pParams;
+	if(*pFormat == '[')
+		return;
+
+	size_t Length = 0;
+	for(char Command = *pFormat; Command != '\0'; Command = NextParam(pFormat))
+	{
+		if(Length + 1 >= sizeof(m_aParamTypes))
+			return;
+		m_aParamTypes[Length++] = Command;
+	}
+	m_aParamTypes[Length] = '\0';
+	m_ParamTypesCompiled = true;
+}
+
 const IConsole::ICommandInfo *CConsole::FirstCommandInfo(int ClientId, int FlagMask) const
 {
 	for(const CCommand *pCommand = m_pFirstCommand; pCommand; pCommand = pCommand->Next())
@@ -448,7 +468,7 @@ bool CConsole::LineIsValid(const char *pStr)
 			return false;
 
 		CCommand *pCommand = FindCommand(Result.m_pCommand, m_FlagMask);
-		if(!pCommand || ParseArgs(&Result, pCommand->m_pParams))
+		if(!pCommand || ParseArgs(&Result, pCommand->ParamTypes()))
 			return false;
 
 		pStr = pNextPart;
@@ -548,7 +568,7 @@ void CConsole::ExecuteLineStroked(int Stroke, const char *pStr, int ClientId, bo
 
 				if(Stroke || IsStrokeCommand)
 				{
-					if(int Error = ParseArgs(&Result, pCommand->m_pParams))
+					if(int Error = ParseArgs(&Result, pCommand->ParamTypes()))
 					{
 						char aBuf[CMDLINE_LENGTH + 64];
 						if(Error == PARSEARGS_INVALID_INTEGER)
@@ -650,20 +670,77 @@ int CConsole::PossibleCommands(const char *pStr, int FlagMask, bool Temp, FPossi
 	return Index;
 }
 
-CConsole::CCommand *CConsole::FindCommand(const char *pName, int FlagMask)
+unsigned CConsole::HashCommandName(const char *pName)
+{
+	// FNV-1a of the lowercase name, matching str_comp_nocase
+	unsigned Hash = 2166136261u;
+	for(; *pName; pName++)
+	{
+		unsigned char c = *pName;
+		if(c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+		Hash = (Hash ^ c) * 16777619u;
+	}
+	return Hash;
+}
+
+bool CConsole::InsertCommandTable(CCommand *pCommand)
+{
+	// keep the load factor at or below one half
+	if((m_NumCommandTableEntries + 1) * 2 > m_vpCommandTable.size())
+		return false;
+
+	const size_t Mask = m_vpCommandTable.size() - 1;
+	size_t Slot = HashCommandName(pCommand->m_pName) & Mask;
+	while(m_vpCommandTable[Slot])
+		Slot = (Slot + 1) & Mask;
+	m_vpCommandTable[Slot] = pCommand;
+	m_NumCommandTableEntries++;
+	return true;
+}
+
+void CConsole::RebuildCommandTable()
 {
+	size_t NumCommands = 0;
+	for(const CCommand *pCommand = m_pFirstCommand; pCommand; pCommand = pCommand->Next())
+		NumCommands++;
+
+	size_t Size = 64;
+	while(Size < (NumCommands + 1) * 4)
+		Size *= 2;
+	m_vpCommandTable.assign(Size, nullptr);
+	m_NumCommandTableEntries = 0;
+
+	// insert in list order, so commands with the same name are probed in that order
 	for(CCommand *pCommand = m_pFirstCommand; pCommand; pCommand = pCommand->Next())
+		InsertCommandTable(pCommand);
+	m_CommandTableDirty = false;
+}
+
+template<typename F>
+CConsole::CCommand *CConsole::LookupCommand(const char *pName, F &&Match)
+{
+	if(m_CommandTableDirty)
+		RebuildCommandTable();
+
+	const size_t Mask = m_vpCommandTable.size() - 1;
+	for(size_t Slot = HashCommandName(pName) & Mask; m_vpCommandTable[Slot]; Slot = (Slot + 1) & Mask)
 	{
-		if(pCommand->m_Flags & FlagMask)
-		{
-			if(str_comp_nocase(pCommand->m_pName, pName) == 0)
-				return pCommand;
-		}
+		CCommand *pCommand = m_vpCommandTable[Slot];
+		if(str_comp_nocase(pCommand->m_pName, pName) == 0 && Match(pCommand))
+			return pCommand;
 	}
 
 	return nullptr;
 }
 
+CConsole::CCommand *CConsole::FindCommand(const char *pName, int FlagMask)
+{
+	return LookupCommand(pName, [FlagMask](const CCommand *pCommand) {
+		return (pCommand->m_Flags & FlagMask) != 0;
+	});
+}
+
 void CConsole::ExecuteLine(const char *pStr, int ClientId, bool InterpretSemicolons)
 {
 	CConsole::ExecuteLineStroked(1, pStr, ClientId, InterpretSemicolons); // press it
@@ -915,6 +992,15 @@ void CConsole::ParseArguments(int NumArgs, const char **ppArguments)
 
 void CConsole::AddCommandSorted(CCommand *pCommand)
 {
+	// a new command can only be appended to the hash table if it does not
+	// have to be probed before a command with the same name
+	if(!m_CommandTableDirty)
+	{
+		const bool SameName = LookupCommand(pCommand->m_pName, [](const CCommand *) { return true; }) != nullptr;
+		if(SameName || !InsertCommandTable(pCommand))
+			m_CommandTableDirty = true;
+	}
+
 	if(!m_pFirstCommand || str_comp(pCommand->m_pName, m_pFirstCommand->m_pName) <= 0)
 	{
 		if(m_pFirstCommand && m_pFirstCommand->Next())
@@ -956,6 +1042,7 @@ void CConsole::Register(const char *pName, const char *pParams,
 
 	pCommand->m_Flags = Flags;
 	pCommand->m_Temp = false;
+	pCommand->CompileParams();
 
 	if(DoAdd)
 		AddCommandSorted(pCommand);
@@ -994,6 +1081,7 @@ void CConsole::RegisterTemp(const char *pName, const char *pParams, int Flags, c
 	pCommand->m_pUserData = nullptr;
 	pCommand->m_Flags = Flags;
 	pCommand->m_Temp = true;
+	pCommand->CompileParams();
 
 	AddCommandSorted(pCommand);
 }
@@ -1025,6 +1113,7 @@ void CConsole::DeregisterTemp(const char *pName)
 	// add to recycle list
 	if(pRemoved)
 	{
+		m_CommandTableDirty = true;
 		pRemoved->SetNext(m_pRecycleList);
 		m_pRecycleList = pRemoved;
 	}
@@ -1050,6 +1139,7 @@ void CConsole::DeregisterTempAll()
 
 	m_TempCommands.Reset();
 	m_pRecycleList = nullptr;
+	m_CommandTableDirty = true;
 }
 
 void CConsole::Con_Chain(IResult *pResult, void *pUserData)
@@ -1098,16 +1188,9 @@ void CConsole::StoreCommands(bool Store)
 
 const IConsole::ICommandInfo *CConsole::GetCommandInfo(const char *pName, int FlagMask, bool Temp)
 {
-	for(CCommand *pCommand = m_pFirstCommand; pCommand; pCommand = pCommand->Next())
-	{
-		if(pCommand->m_Flags & FlagMask && pCommand->m_Temp == Temp)
-		{
-			if(str_comp_nocase(pCommand->Name(), pName) == 0)
-				return pCommand;
-		}
-	}
-
-	return nullptr;
+	return LookupCommand(pName, [FlagMask, Temp](const CCommand *pCommand) {
+		return (pCommand->m_Flags & FlagMask) != 0 && pCommand->m_Temp == Temp;
+	});
 }
 
 std::unique_ptr<IConsole> CreateConsole(int FlagMask) { return std::make_unique<CConsole>(FlagMask); }
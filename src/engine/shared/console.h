@@ -37,6 +37,21 @@ class CConsole : public IConsole
 		int Flags() const override { return m_Flags; }
 		EAccessLevel GetAccessLevel() const override { return m_AccessLevel; }
 		void SetAccessLevel(EAccessLevel AccessLevel);
+
+		/**
+		 * Stores the parameter types of @link m_pParams @endlink without the
+		 * descriptions, so they don't have to be skipped for every execution.
+		 * Must be called after changing the parameters.
+		 */
+		void CompileParams();
+		/**
+		 * @return The parameter format to pass to @link ParseArgs @endlink.
+		 */
+		const char *ParamTypes() const { return m_ParamTypesCompiled ? m_aParamTypes : m_pParams; }
+
+	private:
+		char m_aParamTypes[32];
+		bool m_ParamTypesCompiled = false;
 	};
 
 	class CChain
@@ -149,7 +164,7 @@ class CConsole : public IConsole
 	returns '\0' if there is no next parameter; expects pFormat to point at a
 	parameter
 	*/
-	char NextParam(const char *&pFormat);
+	static char NextParam(const char *&pFormat);
 
 	class CExecutionQueueEntry
 	{
@@ -165,6 +180,21 @@ class CConsole : public IConsole
 	void AddCommandSorted(CCommand *pCommand);
 	CCommand *FindCommand(const char *pName, int FlagMask);
 
+	/*
+	Open addressing hash table of all commands, keyed by the case-insensitive
+	name. Commands with the same name are stored in list order, so lookups
+	return the same command as walking the sorted list.
+	*/
+	std::vector<CCommand *> m_vpCommandTable;
+	bool m_CommandTableDirty = true;
+	size_t m_NumCommandTableEntries = 0;
+
+	static unsigned HashCommandName(const char *pName);
+	void RebuildCommandTable();
+	bool InsertCommandTable(CCommand *pCommand);
+	template<typename F>
+	CCommand *LookupCommand(const char *pName, F &&Match);
+
 	bool m_Cheated;
 
 public:
@@ -26,6 +26,10 @@ static const unsigned char gs_OldVersion = 3;
 static const unsigned char gs_Sha256Version = 6;
 static const unsigned char gs_VersionTickCompression = 5; // demo files with this version or higher will use `CHUNKTICKFLAG_TICK_COMPRESSED`
 
+static const unsigned char gs_aIndexMarker[8] = {'T', 'W', 'D', 'E', 'M', 'I', 'D', 'X'};
+static const unsigned char gs_IndexVersion = 1;
+static constexpr int INDEX_FINGERPRINT_SIZE = 4096; // number of bytes at the end of the demo that the index is validated against
+
 // TODO: rewrite all logs in this file using log_log_color, and remove gs_DemoPrintColor and m_pConsole
 static constexpr ColorRGBA gs_DemoPrintColor{0.75f, 0.7f, 0.7f, 1.0f};
 static constexpr LOG_COLOR DEMO_PRINT_COLOR = {191, 178, 178};
@@ -40,7 +44,112 @@ bool CDemoHeader::Valid() const
 	       mem_has_null(m_aTimestamp, sizeof(m_aTimestamp)) && str_utf8_check(m_aTimestamp);
 }
 
-CDemoRecorder::CDemoRecorder(class CSnapshotDelta *pSnapshotDelta, bool NoMapData)
+CDemoEncoder::~CDemoEncoder()
+{
+	Shutdown();
+}
+
+void CDemoEncoder::Start(const CSnapshotDelta *pSnapshotDelta)
+{
+	if(m_pThread)
+		return;
+	m_pSnapshotDelta = std::make_unique<CSnapshotDelta>(*pSnapshotDelta);
+	m_Shutdown = false;
+	m_pThread = thread_init(Thread, this, "demo encoder");
+}
+
+void CDemoEncoder::Shutdown()
+{
+	if(!m_pThread)
+		return;
+	{
+		const std::unique_lock<std::mutex> Lock(m_Lock);
+		m_Shutdown = true;
+	}
+	m_Cv.notify_all();
+	thread_wait(m_pThread);
+	m_pThread = nullptr;
+}
+
+void CDemoEncoder::SetMaxQueueSize(size_t Bytes)
+{
+	const std::unique_lock<std::mutex> Lock(m_Lock);
+	m_MaxQueuedBytes = Bytes;
+}
+
+CDemoEncoder::CStats CDemoEncoder::Stats()
+{
+	const std::unique_lock<std::mutex> Lock(m_Lock);
+	return m_Stats;
+}
+
+bool CDemoEncoder::Submit(CDemoRecorder *pRecorder, int Type, int Tick, const void *pData, int Size, bool Droppable)
+{
+	std::unique_lock<std::mutex> Lock(m_Lock);
+	if(Droppable && m_Stats.m_QueuedBytes + Size > m_MaxQueuedBytes)
+	{
+		m_Stats.m_NumDropped++;
+		return false;
+	}
+	m_Cv.wait(Lock, [&]() { return m_Stats.m_QueuedBytes + Size <= 2 * m_MaxQueuedBytes || m_Queue.empty(); });
+
+	SJob Job;
+	Job.m_pRecorder = pRecorder;
+	Job.m_Type = Type;
+	Job.m_Tick = Tick;
+	if(!m_vFreeBuffers.empty())
+	{
+		Job.m_vData = std::move(m_vFreeBuffers.back());
+		m_vFreeBuffers.pop_back();
+	}
+	const unsigned char *pBytes = static_cast<const unsigned char *>(pData);
+	Job.m_vData.assign(pBytes, pBytes + Size);
+	m_Queue.push_back(std::move(Job));
+
+	pRecorder->m_PendingJobs++;
+	m_Stats.m_QueuedBytes += Size;
+	m_Stats.m_PeakQueuedBytes = maximum(m_Stats.m_PeakQueuedBytes, m_Stats.m_QueuedBytes);
+	Lock.unlock();
+	m_Cv.notify_all();
+	return true;
+}
+
+void CDemoEncoder::Wait(const CDemoRecorder *pRecorder)
+{
+	std::unique_lock<std::mutex> Lock(m_Lock);
+	m_Cv.wait(Lock, [&]() { return pRecorder->m_PendingJobs == 0; });
+}
+
+void CDemoEncoder::Thread(void *pUser)
+{
+	static_cast<CDemoEncoder *>(pUser)->RunLoop();
+}
+
+void CDemoEncoder::RunLoop()
+{
+	std::unique_lock<std::mutex> Lock(m_Lock);
+	while(true)
+	{
+		m_Cv.wait(Lock, [&]() { return !m_Queue.empty() || m_Shutdown; });
+		if(m_Queue.empty())
+			break;
+
+		SJob Job = std::move(m_Queue.front());
+		m_Queue.pop_front();
+		Lock.unlock();
+
+		Job.m_pRecorder->Encode(Job.m_Type, Job.m_Tick, Job.m_vData.data(), Job.m_vData.size(), m_pSnapshotDelta.get());
+
+		Lock.lock();
+		Job.m_pRecorder->m_PendingJobs--;
+		m_Stats.m_NumEncoded++;
+		m_Stats.m_QueuedBytes -= Job.m_vData.size();
+		m_vFreeBuffers.push_back(std::move(Job.m_vData));
+		m_Cv.notify_all();
+	}
+}
+
+CDemoRecorder::CDemoRecorder(class CSnapshotDelta *pSnapshotDelta, bool NoMapData, CDemoEncoder *pEncoder)
 {
 	m_File = nullptr;
 	m_aCurrentFilename[0] = '\0';
@@ -48,6 +157,8 @@ CDemoRecorder::CDemoRecorder(class CSnapshotDelta *pSnapshotDelta, bool NoMapDat
 	m_pUser = nullptr;
 	m_LastTickMarker = -1;
 	m_pSnapshotDelta = pSnapshotDelta;
+	m_pEncoder = pEncoder;
+	m_PendingJobs = 0;
 	m_NoMapData = NoMapData;
 }
 
@@ -200,7 +311,10 @@ int CDemoRecorder::Start(class IStorage *pStorage, class IConsole *pConsole, con
 
 	m_LastKeyFrame = -1;
 	m_LastTickMarker = -1;
+	m_WrittenTickMarker = -1;
 	m_FirstTick = -1;
+	m_NumDroppedSnapshots = 0;
+	m_vKeyFrames.clear();
 	m_NumTimelineMarkers = 0;
 
 	if(m_pConsole)
@@ -216,6 +330,9 @@ int CDemoRecorder::Start(class IStorage *pStorage, class IConsole *pConsole, con
 	m_File = DemoFile;
 	str_copy(m_aCurrentFilename, pFilename);
 
+	if(m_pEncoder)
+		m_pEncoder->Start(m_pSnapshotDelta);
+
 	return 0;
 }
 
@@ -249,7 +366,7 @@ enum
 
 void CDemoRecorder::WriteTickMarker(int Tick, bool Keyframe)
 {
-	if(m_LastTickMarker == -1 || Tick - m_LastTickMarker > CHUNKMASK_TICK || Keyframe)
+	if(m_WrittenTickMarker == -1 || Tick - m_WrittenTickMarker > CHUNKMASK_TICK || Keyframe)
 	{
 		unsigned char aChunk[sizeof(int32_t) + 1];
 		aChunk[0] = CHUNKTYPEFLAG_TICKMARKER;
@@ -263,13 +380,11 @@ void CDemoRecorder::WriteTickMarker(int Tick, bool Keyframe)
 	else
 	{
 		unsigned char aChunk[1];
-		aChunk[0] = CHUNKTYPEFLAG_TICKMARKER | CHUNKTICKFLAG_TICK_COMPRESSED | (Tick - m_LastTickMarker);
+		aChunk[0] = CHUNKTYPEFLAG_TICKMARKER | CHUNKTICKFLAG_TICK_COMPRESSED | (Tick - m_WrittenTickMarker);
 		io_write(m_File, aChunk, sizeof(aChunk));
 	}
 
-	m_LastTickMarker = Tick;
-	if(m_FirstTick < 0)
-		m_FirstTick = Tick;
+	m_WrittenTickMarker = Tick;
 }
 
 void CDemoRecorder::Write(int Type, const void *pData, int Size)
@@ -324,8 +439,56 @@ void CDemoRecorder::Write(int Type, const void *pData, int Size)
 
 void CDemoRecorder::RecordSnapshot(int Tick, const void *pData, int Size)
 {
-	if(m_LastKeyFrame == -1 || (Tick - m_LastKeyFrame) > SERVER_TICK_SPEED * 5)
+	if(m_pEncoder)
+	{
+		if(!m_pEncoder->Submit(this, CHUNKTYPE_SNAPSHOT, Tick, pData, Size, true))
+		{
+			m_NumDroppedSnapshots++;
+			return;
+		}
+	}
+	else
+	{
+		EncodeSnapshot(Tick, pData, Size, m_pSnapshotDelta);
+	}
+
+	m_LastTickMarker = Tick;
+	if(m_FirstTick < 0)
+		m_FirstTick = Tick;
+}
+
+void CDemoRecorder::RecordMessage(const void *pData, int Size)
+{
+	if(m_pfnFilter)
 	{
+		if(m_pfnFilter(pData, Size, m_pUser))
+		{
+			return;
+		}
+	}
+	if(m_pEncoder)
+		m_pEncoder->Submit(this, CHUNKTYPE_MESSAGE, -1, pData, Size, false);
+	else
+		Write(CHUNKTYPE_MESSAGE, pData, Size);
+}
+
+void CDemoRecorder::Encode(int Type, int Tick, const void *pData, int Size, CSnapshotDelta *pSnapshotDelta)
+{
+	if(Type == CHUNKTYPE_SNAPSHOT)
+		EncodeSnapshot(Tick, pData, Size, pSnapshotDelta);
+	else
+		Write(Type, pData, Size);
+}
+
+void CDemoRecorder::EncodeSnapshot(int Tick, const void *pData, int Size, CSnapshotDelta *pSnapshotDelta)
+{
+	if(m_LastKeyFrame == -1 || (Tick - m_LastKeyFrame) > SERVER_TICK_SPEED * g_Config.m_DemoKeyframeInterval)
+	{
+		// remember keyframe position for the index
+		const int64_t Filepos = io_tell(m_File);
+		if(Filepos >= 0)
+			m_vKeyFrames.emplace_back(Filepos, Tick);
+
 		// write full tickmarker
 		WriteTickMarker(Tick, true);
 
@@ -342,9 +505,9 @@ void CDemoRecorder::RecordSnapshot(int Tick, const void *pData, int Size)
 
 		// create delta
 		char aDeltaData[CSnapshot::MAX_SIZE + sizeof(int)];
-		m_pSnapshotDelta->SetStaticsize(protocol7::NETEVENTTYPE_SOUNDWORLD, true);
-		m_pSnapshotDelta->SetStaticsize(protocol7::NETEVENTTYPE_DAMAGE, true);
-		const int DeltaSize = m_pSnapshotDelta->CreateDelta((CSnapshot *)m_aLastSnapshotData, (CSnapshot *)pData, &aDeltaData);
+		pSnapshotDelta->SetStaticsize(protocol7::NETEVENTTYPE_SOUNDWORLD, true);
+		pSnapshotDelta->SetStaticsize(protocol7::NETEVENTTYPE_DAMAGE, true);
+		const int DeltaSize = pSnapshotDelta->CreateDelta((CSnapshot *)m_aLastSnapshotData, (CSnapshot *)pData, &aDeltaData);
 		if(DeltaSize)
 		{
 			// record delta
@@ -354,23 +517,14 @@ void CDemoRecorder::RecordSnapshot(int Tick, const void *pData, int Size)
 	}
 }
 
-void CDemoRecorder::RecordMessage(const void *pData, int Size)
-{
-	if(m_pfnFilter)
-	{
-		if(m_pfnFilter(pData, Size, m_pUser))
-		{
-			return;
-		}
-	}
-	Write(CHUNKTYPE_MESSAGE, pData, Size);
-}
-
 int CDemoRecorder::Stop(IDemoRecorder::EStopMode Mode, const char *pTargetFilename)
 {
 	if(!m_File)
 		return -1;
 
+	if(m_pEncoder)
+		m_pEncoder->Wait(this);
+
 	if(Mode == IDemoRecorder::EStopMode::KEEP_FILE)
 	{
 		// add the demo length to the header
@@ -422,12 +576,31 @@ int CDemoRecorder::Stop(IDemoRecorder::EStopMode Mode, const char *pTargetFilena
 		}
 	}
 
+	if(Mode == IDemoRecorder::EStopMode::KEEP_FILE && !m_vKeyFrames.empty())
+	{
+		const char *pFilename = pTargetFilename[0] != '\0' ? pTargetFilename : m_aCurrentFilename;
+		IOHANDLE DemoFile = m_pStorage->OpenFile(pFilename, IOFLAG_READ, IStorage::TYPE_SAVE);
+		if(DemoFile)
+		{
+			CDemoKeyFrameIndex Index;
+			Index.m_vKeyFrames = m_vKeyFrames;
+			Index.m_FirstTick = m_FirstTick;
+			Index.m_LastTick = m_LastTickMarker;
+			if(!Index.Save(m_pStorage, pFilename, DemoFile))
+				log_warn("demo_recorder", "Could not write keyframe index for demo '%s'", pFilename);
+			io_close(DemoFile);
+		}
+	}
+	m_vKeyFrames.clear();
+
 	if(m_pConsole)
 	{
 		char aBuf[64 + IO_MAX_PATH_LENGTH];
 		str_format(aBuf, sizeof(aBuf), "Stopped recording to '%s'", m_aCurrentFilename);
 		m_pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "demo_recorder", aBuf, gs_DemoPrintColor);
 	}
+	if(m_NumDroppedSnapshots > 0)
+		log_warn("demo_recorder", "Dropped %d snapshots of '%s' because the demo encoder could not keep up", m_NumDroppedSnapshots, m_aCurrentFilename);
 
 	return 0;
 }
@@ -473,6 +646,146 @@ void CDemoRecorder::AddDemoMarker(int Tick)
 	}
 }
 
+void IDemoPlayer::IndexFilename(const char *pDemoFilename, char *pBuffer, size_t BufferSize)
+{
+	str_format(pBuffer, BufferSize, "%s.idx", pDemoFilename);
+}
+
+static bool DemoFingerprint(IOHANDLE DemoFile, int64_t *pSize, SHA256_DIGEST *pDigest)
+{
+	const int64_t StartPos = io_tell(DemoFile);
+	const int64_t Size = io_length(DemoFile);
+	if(StartPos < 0 || Size < 0)
+		return false;
+
+	unsigned char aTail[INDEX_FINGERPRINT_SIZE];
+	const unsigned TailSize = minimum<int64_t>(Size, sizeof(aTail));
+	const bool Success = io_seek(DemoFile, Size - TailSize, IOSEEK_START) == 0 &&
+			     io_read(DemoFile, aTail, TailSize) == TailSize;
+	if(io_seek(DemoFile, StartPos, IOSEEK_START) != 0 || !Success)
+		return false;
+
+	*pSize = Size;
+	*pDigest = sha256(aTail, TailSize);
+	return true;
+}
+
+static void Int64ToBytesBe(unsigned char *pBytes, int64_t Value)
+{
+	uint_to_bytes_be(pBytes, (uint64_t)Value >> 32);
+	uint_to_bytes_be(pBytes + sizeof(int32_t), (uint64_t)Value & 0xffffffff);
+}
+
+static int64_t BytesBeToInt64(const unsigned char *pBytes)
+{
+	return (int64_t)(((uint64_t)bytes_be_to_uint(pBytes) << 32) | bytes_be_to_uint(pBytes + sizeof(int32_t)));
+}
+
+/*
+	Index file layout, all integers big endian:
+		marker (8), version (1)
+		demo size (8), SHA256 of the last INDEX_FINGERPRINT_SIZE bytes of the demo (32)
+		first tick (4), last tick (4), number of keyframes (4)
+		per keyframe: file position (8), tick (4)
+*/
+
+bool CDemoKeyFrameIndex::Load(IStorage *pStorage, const char *pDemoFilename, IOHANDLE DemoFile)
+{
+	m_vKeyFrames.clear();
+
+	char aIndexFilename[IO_MAX_PATH_LENGTH];
+	IDemoPlayer::IndexFilename(pDemoFilename, aIndexFilename, sizeof(aIndexFilename));
+	IOHANDLE File = pStorage->OpenFile(aIndexFilename, IOFLAG_READ, IStorage::TYPE_ALL_OR_ABSOLUTE);
+	if(!File)
+		return false;
+
+	unsigned char aHeader[sizeof(gs_aIndexMarker) + 1 + 8 + sizeof(SHA256_DIGEST) + 3 * sizeof(int32_t)];
+	int64_t DemoSize;
+	SHA256_DIGEST DemoDigest;
+	bool Valid = io_read(File, aHeader, sizeof(aHeader)) == sizeof(aHeader) &&
+		     mem_comp(aHeader, gs_aIndexMarker, sizeof(gs_aIndexMarker)) == 0 &&
+		     aHeader[sizeof(gs_aIndexMarker)] == gs_IndexVersion &&
+		     DemoFingerprint(DemoFile, &DemoSize, &DemoDigest);
+	if(Valid)
+	{
+		const unsigned char *pData = aHeader + sizeof(gs_aIndexMarker) + 1;
+		Valid = BytesBeToInt64(pData) == DemoSize && mem_comp(pData + 8, &DemoDigest, sizeof(DemoDigest)) == 0;
+		pData += 8 + sizeof(SHA256_DIGEST);
+		m_FirstTick = bytes_be_to_uint(pData);
+		m_LastTick = bytes_be_to_uint(pData + sizeof(int32_t));
+		const int NumKeyFrames = bytes_be_to_uint(pData + 2 * sizeof(int32_t));
+		Valid = Valid && NumKeyFrames > 0 && NumKeyFrames <= (DemoSize / 2) && m_FirstTick <= m_LastTick;
+		if(Valid)
+		{
+			m_vKeyFrames.reserve(NumKeyFrames);
+			for(int i = 0; i < NumKeyFrames; i++)
+			{
+				unsigned char aKeyFrame[8 + sizeof(int32_t)];
+				if(io_read(File, aKeyFrame, sizeof(aKeyFrame)) != sizeof(aKeyFrame))
+				{
+					Valid = false;
+					break;
+				}
+				const int64_t Filepos = BytesBeToInt64(aKeyFrame);
+				const int Tick = bytes_be_to_uint(aKeyFrame + 8);
+				if(Filepos < 0 || Filepos >= DemoSize || Tick < m_FirstTick || Tick > m_LastTick ||
+					(!m_vKeyFrames.empty() && (Filepos <= m_vKeyFrames.back().m_Filepos || Tick < m_vKeyFrames.back().m_Tick)))
+				{
+					Valid = false;
+					break;
+				}
+				m_vKeyFrames.emplace_back(Filepos, Tick);
+			}
+		}
+	}
+	io_close(File);
+
+	if(!Valid)
+		m_vKeyFrames.clear();
+	return Valid;
+}
+
+bool CDemoKeyFrameIndex::Save(IStorage *pStorage, const char *pDemoFilename, IOHANDLE DemoFile) const
+{
+	int64_t DemoSize;
+	SHA256_DIGEST DemoDigest;
+	if(m_vKeyFrames.empty() || !DemoFingerprint(DemoFile, &DemoSize, &DemoDigest))
+		return false;
+
+	char aIndexFilename[IO_MAX_PATH_LENGTH];
+	IDemoPlayer::IndexFilename(pDemoFilename, aIndexFilename, sizeof(aIndexFilename));
+	IOHANDLE File = pStorage->OpenFile(aIndexFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE_OR_ABSOLUTE);
+	if(!File)
+		return false;
+
+	unsigned char aHeader[sizeof(gs_aIndexMarker) + 1 + 8 + sizeof(SHA256_DIGEST) + 3 * sizeof(int32_t)];
+	unsigned char *pData = aHeader;
+	mem_copy(pData, gs_aIndexMarker, sizeof(gs_aIndexMarker));
+	pData += sizeof(gs_aIndexMarker);
+	*pData++ = gs_IndexVersion;
+	Int64ToBytesBe(pData, DemoSize);
+	pData += 8;
+	mem_copy(pData, &DemoDigest, sizeof(DemoDigest));
+	pData += sizeof(DemoDigest);
+	uint_to_bytes_be(pData, m_FirstTick);
+	uint_to_bytes_be(pData + sizeof(int32_t), m_LastTick);
+	uint_to_bytes_be(pData + 2 * sizeof(int32_t), m_vKeyFrames.size());
+	bool Success = io_write(File, aHeader, sizeof(aHeader)) == sizeof(aHeader);
+
+	for(const CDemoKeyFrame &KeyFrame : m_vKeyFrames)
+	{
+		unsigned char aKeyFrame[8 + sizeof(int32_t)];
+		Int64ToBytesBe(aKeyFrame, KeyFrame.m_Filepos);
+		uint_to_bytes_be(aKeyFrame + 8, KeyFrame.m_Tick);
+		Success &= io_write(File, aKeyFrame, sizeof(aKeyFrame)) == sizeof(aKeyFrame);
+	}
+	Success &= io_close(File) == 0;
+
+	if(!Success)
+		pStorage->RemoveFile(aIndexFilename, IStorage::TYPE_SAVE_OR_ABSOLUTE);
+	return Success;
+}
+
 CDemoPlayer::CDemoPlayer(class CSnapshotDelta *pSnapshotDelta, bool UseVideo, TUpdateIntraTimesFunc &&UpdateIntraTimesFunc)
 {
 	Construct(pSnapshotDelta, UseVideo);
@@ -651,6 +964,31 @@ CDemoPlayer::EScanFileResult CDemoPlayer::ScanFile()
 	return ResetToStartPosition(m_vKeyFrames.empty() ? EScanFileResult::ERROR_UNRECOVERABLE : EScanFileResult::SUCCESS);
 }
 
+bool CDemoPlayer::LoadKeyFrameIndex(IStorage *pStorage)
+{
+	CDemoKeyFrameIndex Index;
+	if(!Index.Load(pStorage, m_aFilename, m_File))
+		return false;
+
+	m_vKeyFrames = std::move(Index.m_vKeyFrames);
+	m_Info.m_Info.m_FirstTick = Index.m_FirstTick;
+	m_Info.m_Info.m_LastTick = Index.m_LastTick;
+	return true;
+}
+
+void CDemoPlayer::SaveKeyFrameIndex(IStorage *pStorage)
+{
+	// demos that are still being recorded have no length yet and would invalidate the index right away
+	if(bytes_be_to_uint(m_Info.m_Header.m_aLength) == 0)
+		return;
+
+	CDemoKeyFrameIndex Index;
+	Index.m_vKeyFrames = m_vKeyFrames;
+	Index.m_FirstTick = m_Info.m_Info.m_FirstTick;
+	Index.m_LastTick = m_Info.m_Info.m_LastTick;
+	Index.Save(pStorage, m_aFilename, m_File);
+}
+
 void CDemoPlayer::DoTick()
 {
 	// update ticks
@@ -864,11 +1202,15 @@ int CDemoPlayer::Load(class IStorage *pStorage, class IConsole *pConsole, const
 		}
 	}
 
-	// Scan the file for interesting points
-	if(ScanFile() == EScanFileResult::ERROR_UNRECOVERABLE)
+	// Use the keyframe index if available, otherwise scan the file for interesting points
+	if(!LoadKeyFrameIndex(pStorage))
 	{
-		Stop("Error scanning demo file");
-		return -1;
+		if(ScanFile() == EScanFileResult::ERROR_UNRECOVERABLE)
+		{
+			Stop("Error scanning demo file");
+			return -1;
+		}
+		SaveKeyFrameIndex(pStorage);
 	}
 	m_Info.m_LiveStateUpdating = true;
 
@@ -940,6 +1282,9 @@ bool CDemoPlayer::ExtractMap(class IStorage *pStorage)
 
 int64_t CDemoPlayer::Time()
 {
+	if(m_FixedTimeStep)
+		return m_FixedTime;
+
 #if defined(CONF_VIDEORECORDER)
 	if(m_UseVideo && IVideo::Current())
 	{
@@ -1115,8 +1460,17 @@ void CDemoPlayer::AdjustSpeedIndex(int Offset)
 	SetSpeedIndex(std::clamp(m_SpeedIndex + Offset, 0, (int)(std::size(DEMO_SPEEDS) - 1)));
 }
 
+void CDemoPlayer::SetFixedTimeStep(int64_t Step)
+{
+	m_FixedTimeStep = Step;
+	m_FixedTime = m_Info.m_LastUpdate;
+	if(!Step)
+		m_Info.m_LastUpdate = Time();
+}
+
 void CDemoPlayer::Update(bool RealTime)
 {
+	m_FixedTime += m_FixedTimeStep;
 	const int64_t Now = Time();
 	const int64_t Freq = time_freq();
 	const int64_t DeltaTime = Now - m_Info.m_LastUpdate;
@@ -10,24 +10,135 @@
 #include <engine/demo.h>
 #include <engine/shared/protocol.h>
 
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 typedef std::function<void()> TUpdateIntraTimesFunc;
 
+class CDemoKeyFrame
+{
+public:
+	int64_t m_Filepos;
+	int m_Tick;
+
+	CDemoKeyFrame(int64_t Filepos, int Tick) :
+		m_Filepos(Filepos), m_Tick(Tick)
+	{
+	}
+};
+
+// Keyframe positions of a demo, stored in a file next to the demo so that the
+// player does not need to scan the whole demo before playback and seeking.
+// The index is only used if the size and the end of the demo file match.
+class CDemoKeyFrameIndex
+{
+public:
+	std::vector<CDemoKeyFrame> m_vKeyFrames;
+	int m_FirstTick = -1;
+	int m_LastTick = -1;
+
+	bool Load(class IStorage *pStorage, const char *pDemoFilename, IOHANDLE DemoFile);
+	bool Save(class IStorage *pStorage, const char *pDemoFilename, IOHANDLE DemoFile) const;
+};
+
+/**
+ * Encodes and writes the snapshots and messages of demo recorders on a
+ * background thread, shared by all recorders using it.
+ *
+ * The amount of queued data is limited. When the queue is full, snapshots
+ * are dropped, which only causes a gap in the demo. Messages are always
+ * queued, the recording thread waits if the queue grows to twice the
+ * limit.
+ */
+class CDemoEncoder
+{
+public:
+	class CStats
+	{
+	public:
+		int64_t m_NumEncoded = 0;
+		int64_t m_NumDropped = 0;
+		size_t m_QueuedBytes = 0;
+		size_t m_PeakQueuedBytes = 0;
+	};
+
+	CDemoEncoder() = default;
+	~CDemoEncoder();
+	CDemoEncoder(const CDemoEncoder &Other) = delete;
+	CDemoEncoder &operator=(const CDemoEncoder &Other) = delete;
+
+	/**
+	 * Starts the thread if it's not running yet.
+	 *
+	 * @param pSnapshotDelta Copied, so the delta can be used by the caller
+	 *        while the encoder is running.
+	 */
+	void Start(const class CSnapshotDelta *pSnapshotDelta);
+	/**
+	 * Finishes all queued work and stops the thread.
+	 */
+	void Shutdown();
+
+	void SetMaxQueueSize(size_t Bytes);
+	CStats Stats();
+
+private:
+	friend class CDemoRecorder;
+
+	struct SJob
+	{
+		class CDemoRecorder *m_pRecorder;
+		int m_Type;
+		int m_Tick;
+		std::vector<unsigned char> m_vData;
+	};
+
+	bool Submit(class CDemoRecorder *pRecorder, int Type, int Tick, const void *pData, int Size, bool Droppable);
+	void Wait(const class CDemoRecorder *pRecorder);
+
+	static void Thread(void *pUser);
+	void RunLoop();
+
+	void *m_pThread = nullptr;
+	std::unique_ptr<class CSnapshotDelta> m_pSnapshotDelta;
+
+	std::mutex m_Lock;
+	std::condition_variable m_Cv;
+	std::deque<SJob> m_Queue;
+	std::vector<std::vector<unsigned char>> m_vFreeBuffers;
+	bool m_Shutdown = false;
+	size_t m_MaxQueuedBytes = 16 * 1024 * 1024;
+	CStats m_Stats;
+};
+
 class CDemoRecorder : public IDemoRecorder
 {
+	friend class CDemoEncoder;
+
 	class IConsole *m_pConsole;
 	class IStorage *m_pStorage;
 
 	IOHANDLE m_File;
 	char m_aCurrentFilename[IO_MAX_PATH_LENGTH];
 	int m_LastTickMarker;
-	int m_LastKeyFrame;
 	int m_FirstTick;
+	int m_NumDroppedSnapshots;
 
+	// Only accessed while encoding, which happens on the encoder thread if
+	// there is one
+	int m_WrittenTickMarker;
+	int m_LastKeyFrame;
+	std::vector<CDemoKeyFrame> m_vKeyFrames;
 	unsigned char m_aLastSnapshotData[CSnapshot::MAX_SIZE];
+
 	class CSnapshotDelta *m_pSnapshotDelta;
+	CDemoEncoder *m_pEncoder;
+	// Guarded by the lock of the encoder
+	int m_PendingJobs;
 
 	int m_NumTimelineMarkers;
 	int m_aTimelineMarkers[MAX_TIMELINE_MARKERS];
@@ -37,11 +148,17 @@ class CDemoRecorder : public IDemoRecorder
 	DEMOFUNC_FILTER m_pfnFilter;
 	void *m_pUser;
 
+	void Encode(int Type, int Tick, const void *pData, int Size, class CSnapshotDelta *pSnapshotDelta);
+	void EncodeSnapshot(int Tick, const void *pData, int Size, class CSnapshotDelta *pSnapshotDelta);
 	void WriteTickMarker(int Tick, bool Keyframe);
 	void Write(int Type, const void *pData, int Size);
 
 public:
-	CDemoRecorder(class CSnapshotDelta *pSnapshotDelta, bool NoMapData = false);
+	/**
+	 * @param pEncoder Encodes on a background thread if set, otherwise the
+	 *        recording thread encodes and writes the demo itself.
+	 */
+	CDemoRecorder(class CSnapshotDelta *pSnapshotDelta, bool NoMapData = false, CDemoEncoder *pEncoder = nullptr);
 	CDemoRecorder() = default;
 	~CDemoRecorder() override;
 
@@ -101,24 +218,12 @@ private:
 	TUpdateIntraTimesFunc m_UpdateIntraTimesFunc;
 
 	// Playback
-	class CKeyFrame
-	{
-	public:
-		int64_t m_Filepos;
-		int m_Tick;
-
-		CKeyFrame(int64_t Filepos, int Tick) :
-			m_Filepos(Filepos), m_Tick(Tick)
-		{
-		}
-	};
-
 	class IConsole *m_pConsole;
 	IOHANDLE m_File;
 	int64_t m_MapOffset;
 	char m_aFilename[IO_MAX_PATH_LENGTH];
 	char m_aErrorMessage[256];
-	std::vector<CKeyFrame> m_vKeyFrames;
+	std::vector<CDemoKeyFrame> m_vKeyFrames;
 	CMapInfo m_MapInfo;
 	int m_SpeedIndex;
 
@@ -140,6 +245,8 @@ private:
 #if defined(CONF_VIDEORECORDER)
 	bool m_WasRecording = false;
 #endif
+	int64_t m_FixedTimeStep = 0;
+	int64_t m_FixedTime = 0;
 
 	enum EReadChunkHeaderResult
 	{
@@ -156,6 +263,8 @@ private:
 		ERROR_UNRECOVERABLE,
 	};
 	EScanFileResult ScanFile();
+	bool LoadKeyFrameIndex(class IStorage *pStorage);
+	void SaveKeyFrameIndex(class IStorage *pStorage);
 	void UpdateTimes();
 
 	int64_t Time();
@@ -191,6 +300,13 @@ public:
 	const char *ErrorMessage() const override { return m_aErrorMessage; }
 
 	void Update(bool RealTime = true);
+	/**
+	 * Advances the playback by a fixed time on every update instead of by
+	 * the real time passed, used to render demos as fast as possible.
+	 *
+	 * @param Step Time per update in units of @link time_freq @endlink, `0` to use the real time.
+	 */
+	void SetFixedTimeStep(int64_t Step);
 	bool IsSixup() const { return m_Sixup; }
 
 	const CPlaybackInfo *Info() const { return &m_Info; }
@@ -0,0 +1,129 @@
+#include "directory_index.h"
+
+#include <base/log.h>
+#include <base/system.h>
+
+#if defined(CONF_PLATFORM_LINUX)
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+CDirectoryIndex::~CDirectoryIndex()
+{
+#if defined(CONF_PLATFORM_LINUX)
+	if(m_NotifyFd >= 0)
+		close(m_NotifyFd);
+#endif
+}
+
+bool CDirectoryIndex::Init()
+{
+#if defined(CONF_PLATFORM_LINUX)
+	m_NotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(m_NotifyFd < 0)
+	{
+		log_warn("storage", "directory index disabled, failed to initialize inotify (%d)", errno);
+		return false;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+CDirectoryIndex::CListing CDirectoryIndex::List(const char *pPath)
+{
+#if defined(CONF_PLATFORM_LINUX)
+	if(m_NotifyFd < 0 || pPath[0] == '\0')
+		return nullptr;
+
+	const CLockScope LockScope(m_Lock);
+	ProcessEvents();
+
+	auto Directory = m_Directories.find(pPath);
+	if(Directory != m_Directories.end() && Directory->second.m_pListing)
+		return Directory->second.m_pListing;
+
+	if(Directory == m_Directories.end())
+	{
+		// Watch before scanning, so changes made during the scan are not missed
+		const int Watch = inotify_add_watch(m_NotifyFd, pPath,
+			IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+		if(Watch < 0)
+			return nullptr;
+
+		// The same directory may be reachable by different paths, only the last one is tracked
+		const auto WatchPath = m_WatchPaths.find(Watch);
+		if(WatchPath != m_WatchPaths.end())
+			m_Directories.erase(WatchPath->second);
+		m_WatchPaths[Watch] = pPath;
+		Directory = m_Directories.emplace(pPath, SDirectory{Watch, nullptr}).first;
+	}
+
+	Directory->second.m_pListing = Scan(pPath);
+	return Directory->second.m_pListing;
+#else
+	return nullptr;
+#endif
+}
+
+void CDirectoryIndex::ProcessEvents()
+{
+#if defined(CONF_PLATFORM_LINUX)
+	alignas(struct inotify_event) char aBuffer[4096];
+	while(true)
+	{
+		const ssize_t Length = read(m_NotifyFd, aBuffer, sizeof(aBuffer));
+		if(Length <= 0)
+			break;
+
+		for(const char *pEvent = aBuffer; pEvent < aBuffer + Length;)
+		{
+			const struct inotify_event *pNotifyEvent = reinterpret_cast<const struct inotify_event *>(pEvent);
+			pEvent += sizeof(struct inotify_event) + pNotifyEvent->len;
+
+			if(pNotifyEvent->mask & IN_Q_OVERFLOW)
+			{
+				InvalidateAll();
+				continue;
+			}
+
+			const auto WatchPath = m_WatchPaths.find(pNotifyEvent->wd);
+			if(WatchPath == m_WatchPaths.end())
+				continue;
+
+			if(pNotifyEvent->mask & IN_IGNORED)
+			{
+				// Watch was removed because the directory was deleted or unmounted
+				m_Directories.erase(WatchPath->second);
+				m_WatchPaths.erase(WatchPath);
+				continue;
+			}
+
+			const auto Directory = m_Directories.find(WatchPath->second);
+			if(Directory != m_Directories.end())
+				Directory->second.m_pListing = nullptr;
+		}
+	}
+#endif
+}
+
+void CDirectoryIndex::InvalidateAll()
+{
+	for(auto &[Path, Directory] : m_Directories)
+		Directory.m_pListing = nullptr;
+}
+
+CDirectoryIndex::CListing CDirectoryIndex::Scan(const char *pPath)
+{
+	std::shared_ptr<std::vector<SEntry>> pListing = std::make_shared<std::vector<SEntry>>();
+	fs_listdir_fileinfo(
+		pPath, [](const CFsFileInfo *pInfo, int IsDir, int Type, void *pUser) {
+			static_cast<std::vector<SEntry> *>(pUser)->push_back({pInfo->m_pName, IsDir != 0, pInfo->m_TimeCreated, pInfo->m_TimeModified});
+			return 0;
+		},
+		0, pListing.get());
+	return pListing;
+}
@@ -0,0 +1,70 @@
+#ifndef ENGINE_SHARED_DIRECTORY_INDEX_H
+#define ENGINE_SHARED_DIRECTORY_INDEX_H
+
+#include <base/detect.h>
+#include <base/lock.h>
+
+#include <ctime>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * In-memory cache of directory listings.
+ *
+ * Listings are invalidated by filesystem change notifications, so changes
+ * made by other processes are picked up as well. The index is only usable
+ * on platforms where such notifications are available (inotify on Linux),
+ * otherwise @link Init @endlink fails and directories must be listed directly.
+ */
+class CDirectoryIndex
+{
+public:
+	struct SEntry
+	{
+		std::string m_Name;
+		bool m_IsDir;
+		time_t m_TimeCreated;
+		time_t m_TimeModified;
+	};
+	using CListing = std::shared_ptr<const std::vector<SEntry>>;
+
+	CDirectoryIndex() = default;
+	~CDirectoryIndex();
+	CDirectoryIndex(const CDirectoryIndex &Other) = delete;
+	CDirectoryIndex &operator=(const CDirectoryIndex &Other) = delete;
+
+	bool Init();
+	bool IsInit() const { return m_NotifyFd >= 0; }
+
+	/**
+	 * Returns the entries of the directory at the given path, including
+	 * `.` and `..`, in the order they are returned by the filesystem.
+	 *
+	 * @param pPath Path of the directory as passed to @link fs_listdir @endlink.
+	 *
+	 * @return The cached or newly scanned listing, `nullptr` if the directory
+	 *         cannot be watched and must be listed directly.
+	 */
+	CListing List(const char *pPath) EXCLUDES(m_Lock);
+
+private:
+	struct SDirectory
+	{
+		int m_Watch;
+		// nullptr if the directory changed since it was last scanned
+		CListing m_pListing;
+	};
+
+	void ProcessEvents() REQUIRES(m_Lock);
+	void InvalidateAll() REQUIRES(m_Lock);
+	static CListing Scan(const char *pPath);
+
+	CLock m_Lock;
+	int m_NotifyFd = -1;
+	std::unordered_map<std::string, SDirectory> m_Directories GUARDED_BY(m_Lock);
+	std::unordered_map<int, std::string> m_WatchPaths GUARDED_BY(m_Lock);
+};
+
+#endif
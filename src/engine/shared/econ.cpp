@@ -23,6 +23,8 @@ int CEcon::NewClientCallback(int ClientId, void *pUser)
 	pThis->m_aClients[ClientId].m_State = CClient::STATE_CONNECTED;
 	pThis->m_aClients[ClientId].m_TimeConnected = time_get();
 	pThis->m_aClients[ClientId].m_AuthTries = 0;
+	pThis->m_aClients[ClientId].m_Batch = false;
+	pThis->m_aClients[ClientId].m_BatchSequence = 0;
 
 	pThis->m_NetConsole.Send(ClientId, "Enter password:");
 	return 0;
@@ -50,6 +52,18 @@ void CEcon::ConLogout(IConsole::IResult *pResult, void *pUserData)
 		pThis->m_NetConsole.Drop(pThis->m_UserClientId, "Logout");
 }
 
+void CEcon::ConBatch(IConsole::IResult *pResult, void *pUserData)
+{
+	CEcon *pThis = static_cast<CEcon *>(pUserData);
+
+	if(pThis->m_UserClientId < 0 || pThis->m_UserClientId >= NET_MAX_CONSOLE_CLIENTS)
+		return;
+
+	CClient *pClient = &pThis->m_aClients[pThis->m_UserClientId];
+	pClient->m_Batch = pResult->NumArguments() == 0 || pResult->GetInteger(0) != 0;
+	pClient->m_BatchSequence = 0;
+}
+
 void CEcon::Init(CConfig *pConfig, IConsole *pConsole, CNetBan *pNetBan)
 {
 	m_pConfig = pConfig;
@@ -92,6 +106,7 @@ void CEcon::Init(CConfig *pConfig, IConsole *pConsole, CNetBan *pNetBan)
 		str_format(aBuf, sizeof(aBuf), "bound to %s:%d", g_Config.m_EcBindaddr, g_Config.m_EcPort);
 		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "econ", aBuf);
 		Console()->Register("logout", "", CFGFLAG_ECON, ConLogout, this, "Logout of econ");
+		Console()->Register("batch", "?i['0'|'1']", CFGFLAG_ECON, ConBatch, this, "Follow the output of every command with a line '@end <number>', counting commands from 0");
 	}
 	else
 		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "econ", "couldn't open socket. port might already be in use");
@@ -102,13 +117,35 @@ void CEcon::Update()
 	if(!m_Ready)
 		return;
 
-	m_NetConsole.Update();
+	// read again while clients send lines, so automation sending many
+	// commands at once is not limited to one read per update
+	for(int Round = 0; Round < MAX_UPDATE_ROUNDS; Round++)
+	{
+		m_NetConsole.Update();
+		if(!ProcessLines())
+			break;
+	}
 
+	for(int i = 0; i < NET_MAX_CONSOLE_CLIENTS; ++i)
+	{
+		if(m_aClients[i].m_State == CClient::STATE_CONNECTED &&
+			time_get() > m_aClients[i].m_TimeConnected + g_Config.m_EcAuthTimeout * time_freq())
+			m_NetConsole.Drop(i, "authentication timeout");
+	}
+
+	// send the output of all commands of this update at once
+	m_NetConsole.Flush();
+}
+
+bool CEcon::ProcessLines()
+{
 	char aBuf[NET_MAX_PACKETSIZE];
 	int ClientId;
+	bool Received = false;
 
 	while(m_NetConsole.Recv(aBuf, (int)(sizeof(aBuf)) - 1, &ClientId))
 	{
+		Received = true;
 		dbg_assert(m_aClients[ClientId].m_State != CClient::STATE_EMPTY, "got message from empty slot");
 		if(m_aClients[ClientId].m_State == CClient::STATE_CONNECTED)
 		{
@@ -143,15 +180,15 @@ void CEcon::Update()
 			m_UserClientId = ClientId;
 			Console()->ExecuteLine(aBuf, IConsole::CLIENT_ID_UNSPECIFIED);
 			m_UserClientId = -1;
-		}
-	}
 
-	for(int i = 0; i < NET_MAX_CONSOLE_CLIENTS; ++i)
-	{
-		if(m_aClients[i].m_State == CClient::STATE_CONNECTED &&
-			time_get() > m_aClients[i].m_TimeConnected + g_Config.m_EcAuthTimeout * time_freq())
-			m_NetConsole.Drop(i, "authentication timeout");
+			if(m_aClients[ClientId].m_State == CClient::STATE_AUTHED && m_aClients[ClientId].m_Batch)
+			{
+				str_format(aFormatted, sizeof(aFormatted), "@end %d", m_aClients[ClientId].m_BatchSequence++);
+				m_NetConsole.Send(ClientId, aFormatted);
+			}
+		}
 	}
+	return Received;
 }
 
 void CEcon::Send(int ClientId, const char *pLine)
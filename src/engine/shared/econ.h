@@ -14,6 +14,8 @@ class CEcon
 	enum
 	{
 		MAX_AUTH_TRIES = 3,
+		// Times the sockets are read per update while clients send lines
+		MAX_UPDATE_ROUNDS = 16,
 	};
 
 	class CClient
@@ -29,6 +31,10 @@ class CEcon
 		int m_State;
 		int64_t m_TimeConnected;
 		int m_AuthTries;
+
+		// Output of every command is followed by "@end <sequence>"
+		bool m_Batch;
+		int m_BatchSequence;
 	};
 	CClient m_aClients[NET_MAX_CONSOLE_CLIENTS];
 
@@ -42,10 +48,18 @@ class CEcon
 
 	static void SendLineCB(const char *pLine, void *pUserData, ColorRGBA PrintColor = {1, 1, 1, 1});
 	static void ConLogout(IConsole::IResult *pResult, void *pUserData);
+	static void ConBatch(IConsole::IResult *pResult, void *pUserData);
 
 	static int NewClientCallback(int ClientId, void *pUser);
 	static int DelClientCallback(int ClientId, const char *pReason, void *pUser);
 
+	/**
+	 * Handles all complete lines received from the clients.
+	 *
+	 * @return Whether any line was received.
+	 */
+	bool ProcessLines();
+
 public:
 	CEcon();
 	IConsole *Console() { return m_pConsole; }
@@ -5,6 +5,7 @@
 
 #include <base/math.h>
 
+#include <engine/demo.h>
 #include <engine/storage.h>
 
 #include <algorithm>
@@ -41,6 +42,13 @@ void CFileCollection::Init(IStorage *pStorage, const char *pPath, const char *pF
 		}
 
 		m_pStorage->RemoveFile(aBuf, IStorage::TYPE_SAVE);
+		if(str_comp(m_aFileExt, ".demo") == 0)
+		{
+			// also remove the keyframe index written by the demo recorder
+			char aIndexFilename[IO_MAX_PATH_LENGTH];
+			IDemoPlayer::IndexFilename(aBuf, aIndexFilename, sizeof(aIndexFilename));
+			m_pStorage->RemoveFile(aIndexFilename, IStorage::TYPE_SAVE);
+		}
 		FilesDeleted++;
 	}
 }
@@ -4,6 +4,7 @@
 
 #include <engine/console.h>
 #include <engine/shared/config.h>
+#include <engine/shared/linereader.h>
 #include <engine/storage.h>
 
 CNetBan::CNetHash::CNetHash(const NETADDR *pAddr)
@@ -29,18 +30,149 @@ CNetBan::CNetHash::CNetHash(const CNetRange *pRange)
 	m_Hash &= 0xFF;
 }
 
-int CNetBan::CNetHash::MakeHashArray(const NETADDR *pAddr, CNetHash aHash[17])
+static int GetBit(const unsigned char *pKey, int Bit)
 {
-	int Length = pAddr->type == NETTYPE_IPV4 ? 4 : 16;
-	aHash[0].m_Hash = 0;
-	aHash[0].m_HashIndex = 0;
-	for(int i = 1, Sum = 0; i <= Length; ++i)
+	return (pKey[Bit / 8] >> (7 - Bit % 8)) & 1;
+}
+
+// Number of leading bits that are equal in both keys, given that the first
+// `Start` bits are equal
+static int CommonPrefixLength(const unsigned char *pKey1, const unsigned char *pKey2, int Start, int MaxBits)
+{
+	int Bit = Start;
+	while(Bit < MaxBits)
+	{
+		if(Bit % 8 == 0 && Bit + 8 <= MaxBits && pKey1[Bit / 8] == pKey2[Bit / 8])
+		{
+			Bit += 8;
+			continue;
+		}
+		if(GetBit(pKey1, Bit) != GetBit(pKey2, Bit))
+			break;
+		Bit++;
+	}
+	return Bit;
+}
+
+void CNetPrefixTrie::Clear()
+{
+	m_vNodes.clear();
+	const unsigned char aZero[16] = {0};
+	NewNode(aZero, 0, -1); // IPv4
+	NewNode(aZero, 0, -1); // IPv6
+	m_NumPrefixes = 0;
+}
+
+int CNetPrefixTrie::NewNode(const unsigned char *pKey, int Length, int Value)
+{
+	SNode Node;
+	mem_copy(Node.m_aKey, pKey, sizeof(Node.m_aKey));
+	Node.m_Length = Length;
+	Node.m_aChildren[0] = -1;
+	Node.m_aChildren[1] = -1;
+	Node.m_Value = Value;
+	m_vNodes.push_back(Node);
+	return m_vNodes.size() - 1;
+}
+
+void CNetPrefixTrie::Insert(int Root, const unsigned char *pKey, int Length, int Value)
+{
+	int Node = Root;
+	while(true)
+	{
+		if(m_vNodes[Node].m_Length == Length)
+		{
+			if(m_vNodes[Node].m_Value < 0)
+			{
+				m_vNodes[Node].m_Value = Value;
+				m_NumPrefixes++;
+			}
+			return;
+		}
+
+		const int Bit = GetBit(pKey, m_vNodes[Node].m_Length);
+		const int Child = m_vNodes[Node].m_aChildren[Bit];
+		if(Child < 0)
+		{
+			const int Leaf = NewNode(pKey, Length, Value);
+			m_vNodes[Node].m_aChildren[Bit] = Leaf;
+			m_NumPrefixes++;
+			return;
+		}
+
+		const int ChildLength = m_vNodes[Child].m_Length;
+		const int Common = CommonPrefixLength(pKey, m_vNodes[Child].m_aKey, m_vNodes[Node].m_Length, minimum(Length, ChildLength));
+		if(Common == ChildLength)
+		{
+			Node = Child;
+			continue;
+		}
+
+		// split the edge, the new prefix is either the split node itself
+		// or its other child
+		const int Split = NewNode(pKey, Common, -1);
+		m_vNodes[Split].m_aChildren[GetBit(m_vNodes[Child].m_aKey, Common)] = Child;
+		m_vNodes[Node].m_aChildren[Bit] = Split;
+		Node = Split;
+	}
+}
+
+void CNetPrefixTrie::AddPrefix(const NETADDR *pAddr, int PrefixLength, int Value)
+{
+	Insert(Root(pAddr), pAddr->ip, std::clamp(PrefixLength, 0, AddrBits(pAddr)), Value);
+}
+
+void CNetPrefixTrie::InsertRange(int Root, unsigned char *pPrefix, int Length, int Bits, const unsigned char *pLB, const unsigned char *pUB, int Value)
+{
+	// the prefix covers the addresses from pPrefix to aLast
+	unsigned char aLast[16];
+	mem_copy(aLast, pPrefix, sizeof(aLast));
+	for(int Bit = Length; Bit < Bits; Bit++)
+		aLast[Bit / 8] |= 0x80 >> (Bit % 8);
+
+	const int Bytes = Bits / 8;
+	if(mem_comp(pPrefix, pUB, Bytes) > 0 || mem_comp(aLast, pLB, Bytes) < 0)
+		return;
+	if(mem_comp(pPrefix, pLB, Bytes) >= 0 && mem_comp(aLast, pUB, Bytes) <= 0)
 	{
-		Sum += pAddr->ip[i - 1];
-		aHash[i].m_Hash = Sum & 0xFF;
-		aHash[i].m_HashIndex = i % Length;
+		Insert(Root, pPrefix, Length, Value);
+		return;
 	}
-	return Length;
+
+	// partially covered, which is impossible for a single address
+	InsertRange(Root, pPrefix, Length + 1, Bits, pLB, pUB, Value);
+	pPrefix[Length / 8] |= 0x80 >> (Length % 8);
+	InsertRange(Root, pPrefix, Length + 1, Bits, pLB, pUB, Value);
+	pPrefix[Length / 8] &= ~(0x80 >> (Length % 8));
+}
+
+void CNetPrefixTrie::AddRange(const CNetRange *pRange, int Value)
+{
+	unsigned char aPrefix[16] = {0};
+	InsertRange(Root(&pRange->m_LB), aPrefix, 0, AddrBits(&pRange->m_LB), pRange->m_LB.ip, pRange->m_UB.ip, Value);
+}
+
+int CNetPrefixTrie::Find(const NETADDR *pAddr) const
+{
+	const int Bits = AddrBits(pAddr);
+	int Value = -1;
+	for(int Node = Root(pAddr);;)
+	{
+		const SNode &Current = m_vNodes[Node];
+		if(Current.m_Value >= 0)
+			Value = Current.m_Value;
+		if(Current.m_Length >= Bits)
+			break;
+
+		const int Child = Current.m_aChildren[GetBit(pAddr->ip, Current.m_Length)];
+		if(Child < 0)
+			break;
+		const SNode &Next = m_vNodes[Child];
+		if(CommonPrefixLength(pAddr->ip, Next.m_aKey, Current.m_Length, Next.m_Length) < Next.m_Length)
+			break;
+		Node = Child;
+	}
+	return Value;
 }
 
 template<class T, int HashCount>
@@ -110,6 +242,7 @@ typename CNetBan::CBan<T> *CNetBan::CBanPool<T, HashCount>::Add(const T *pData,
 
 	// update ban count
 	++m_CountUsed;
+	++m_Generation;
 
 	return pBan;
 }
@@ -146,6 +279,7 @@ int CNetBan::CBanPool<T, HashCount>::Remove(CBan<T> *pBan)
 
 	// update ban count
 	--m_CountUsed;
+	++m_Generation;
 
 	return 0;
 }
@@ -180,6 +314,7 @@ void CNetBan::CBanPool<T, HashCount>::Reset()
 	mem_zero(m_aBans, sizeof(m_aBans));
 	m_pFirstUsed = 0;
 	m_CountUsed = 0;
+	++m_Generation;
 
 	for(int i = 1; i < MAX_BANS - 1; ++i)
 	{
@@ -276,6 +411,7 @@ void CNetBan::Init(IConsole *pConsole, IStorage *pStorage)
 	m_pStorage = pStorage;
 	m_BanAddrPool.Reset();
 	m_BanRangePool.Reset();
+	ClearImportedBans();
 
 	net_host_lookup("localhost", &m_LocalhostIpV4, NETTYPE_IPV4);
 	net_host_lookup("localhost", &m_LocalhostIpV6, NETTYPE_IPV6);
@@ -288,6 +424,8 @@ void CNetBan::Init(IConsole *pConsole, IStorage *pStorage)
 	Console()->Register("bans", "?i[page]", CFGFLAG_SERVER | CFGFLAG_MASTER, ConBans, this, "Show banlist (page 1 by default, 20 entries per page)");
 	Console()->Register("bans_find", "s[ip]", CFGFLAG_SERVER | CFGFLAG_MASTER, ConBansFind, this, "Find all ban records for the specified IP address");
 	Console()->Register("bans_save", "s[file]", CFGFLAG_SERVER | CFGFLAG_MASTER | CFGFLAG_STORE, ConBansSave, this, "Save banlist in a file");
+	Console()->Register("bans_import", "s[file] ?r[reason]", CFGFLAG_SERVER | CFGFLAG_MASTER | CFGFLAG_STORE, ConBansImport, this, "Permanently ban all addresses, prefixes and ranges listed in a file");
+	Console()->Register("bans_import_clear", "", CFGFLAG_SERVER | CFGFLAG_MASTER | CFGFLAG_STORE, ConBansImportClear, this, "Remove all imported bans");
 }
 
 void CNetBan::Update()
@@ -385,11 +523,9 @@ bool CNetBan::IsBanned(const NETADDR *pOrigAddr, char *pBuf, unsigned BufferSize
 		pAddr = &Addr;
 		Addr.type = NETTYPE_IPV6;
 	}
-	CNetHash aHash[17];
-	int Length = CNetHash::MakeHashArray(pAddr, aHash);
-
 	// check ban addresses
-	CBanAddr *pBan = m_BanAddrPool.Find(pAddr, &aHash[Length]);
+	CNetHash NetHash(pAddr);
+	CBanAddr *pBan = m_BanAddrPool.Find(pAddr, &NetHash);
 	if(pBan)
 	{
 		MakeBanInfo(pBan, pBuf, BufferSize, MSGTYPE_PLAYER);
@@ -397,19 +533,136 @@ bool CNetBan::IsBanned(const NETADDR *pOrigAddr, char *pBuf, unsigned BufferSize
 	}
 
 	// check ban ranges
-	for(int i = Length - 1; i >= 0; --i)
+	UpdateRangeTrie();
+	const int RangeIndex = m_RangeTrie.Find(pAddr);
+	if(RangeIndex >= 0)
 	{
-		for(CBanRange *pBanRange = m_BanRangePool.First(&aHash[i]); pBanRange; pBanRange = pBanRange->m_pHashNext)
+		MakeBanInfo(m_vpRangeTrieBans[RangeIndex], pBuf, BufferSize, MSGTYPE_PLAYER);
+		return true;
+	}
+
+	// check imported ranges
+	const int ImportedIndex = m_ImportedTrie.Find(pAddr);
+	if(ImportedIndex >= 0)
+	{
+		if(pBuf != nullptr && BufferSize > 0)
+			str_format(pBuf, BufferSize, "You have been banned (%s)", m_vImportedReasons[ImportedIndex].c_str());
+		return true;
+	}
+
+	return false;
+}
+
+void CNetBan::UpdateRangeTrie() const
+{
+	if(m_RangeTrieGeneration == m_BanRangePool.Generation())
+		return;
+
+	m_RangeTrie.Clear();
+	m_vpRangeTrieBans.clear();
+	for(const CBanRange *pBan = m_BanRangePool.First(); pBan; pBan = pBan->m_pNext)
+	{
+		m_RangeTrie.AddRange(&pBan->m_Data, m_vpRangeTrieBans.size());
+		m_vpRangeTrieBans.push_back(pBan);
+	}
+	m_RangeTrieGeneration = m_BanRangePool.Generation();
+}
+
+// Block lists contain IPv6 addresses without brackets
+static bool ParseImportedAddr(NETADDR *pAddr, const char *pStr)
+{
+	if(pStr[0] != '[' && str_find(pStr, ":"))
+	{
+		char aBuf[NETADDR_MAXSTRSIZE];
+		str_format(aBuf, sizeof(aBuf), "[%s]", pStr);
+		return net_addr_from_str(pAddr, aBuf) == 0;
+	}
+	return net_addr_from_str(pAddr, pStr) == 0;
+}
+
+int CNetBan::ImportBans(const char *pFilename, const char *pReason)
+{
+	CLineReader LineReader;
+	if(!Storage() || !LineReader.OpenFile(Storage()->OpenFile(pFilename, IOFLAG_READ, IStorage::TYPE_ALL)))
+		return -1;
+
+	const int ReasonIndex = m_vImportedReasons.size();
+	m_vImportedReasons.emplace_back(pReason);
+
+	int NumImported = 0;
+	int NumInvalid = 0;
+	int NumLocalhost = 0;
+	while(const char *pLine = LineReader.Get())
+	{
+		char aLine[256];
+		str_copy(aLine, pLine);
+		if(const char *pComment = str_find(aLine, "#"))
+			aLine[pComment - aLine] = '\0';
+		str_clean_whitespaces(aLine);
+		if(aLine[0] == '\0')
+			continue;
+
+		CNetRange Range;
+		bool Valid;
+		if(const char *pSlash = str_find(aLine, "/"))
 		{
-			if(NetMatch(&pBanRange->m_Data, pAddr, i, Length))
+			aLine[pSlash - aLine] = '\0';
+			int PrefixLength;
+			Valid = ParseImportedAddr(&Range.m_LB, aLine) && str_toint(pSlash + 1, &PrefixLength) &&
+				PrefixLength >= 0 && PrefixLength <= (Range.m_LB.type == NETTYPE_IPV4 ? 32 : 128);
+			if(Valid)
 			{
-				MakeBanInfo(pBanRange, pBuf, BufferSize, MSGTYPE_PLAYER);
-				return true;
+				// first and last address of the prefix
+				Range.m_UB = Range.m_LB;
+				for(int Bit = PrefixLength; Bit < (Range.m_LB.type == NETTYPE_IPV4 ? 32 : 128); Bit++)
+				{
+					Range.m_LB.ip[Bit / 8] &= ~(0x80 >> (Bit % 8));
+					Range.m_UB.ip[Bit / 8] |= 0x80 >> (Bit % 8);
+				}
 			}
 		}
+		else if(const char *pDash = str_find(aLine, "-"))
+		{
+			aLine[pDash - aLine] = '\0';
+			str_clean_whitespaces(aLine);
+			Valid = ParseImportedAddr(&Range.m_LB, aLine) && ParseImportedAddr(&Range.m_UB, str_skip_whitespaces_const(pDash + 1)) &&
+				Range.m_LB.type == Range.m_UB.type && NetComp(&Range.m_LB, &Range.m_UB) <= 0;
+		}
+		else
+		{
+			Valid = ParseImportedAddr(&Range.m_LB, aLine);
+			Range.m_UB = Range.m_LB;
+		}
+
+		if(!Valid || (Range.m_LB.type != NETTYPE_IPV4 && Range.m_LB.type != NETTYPE_IPV6))
+		{
+			NumInvalid++;
+			continue;
+		}
+		// do not ban localhost
+		if(NetMatch(&Range, &m_LocalhostIpV4) || NetMatch(&Range, &m_LocalhostIpV6))
+		{
+			NumLocalhost++;
+			continue;
+		}
+
+		m_ImportedTrie.AddRange(&Range, ReasonIndex);
+		NumImported++;
 	}
 
-	return false;
+	if(NumInvalid > 0 || NumLocalhost > 0)
+	{
+		char aBuf[256];
+		str_format(aBuf, sizeof(aBuf), "skipped %d invalid entries and %d entries containing localhost in '%s'", NumInvalid, NumLocalhost, pFilename);
+		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aBuf);
+	}
+	return NumImported;
+}
+
+void CNetBan::ClearImportedBans()
+{
+	m_ImportedTrie.Clear();
+	m_vImportedReasons.clear();
 }
 
 void CNetBan::ConBan(IConsole::IResult *pResult, void *pUser)
@@ -581,6 +834,16 @@ void CNetBan::ConBansFind(IConsole::IResult *pResult, void *pUser)
 		}
 	}
 
+	// check imported ranges
+	const int ImportedIndex = pThis->m_ImportedTrie.Find(&Addr);
+	if(ImportedIndex >= 0)
+	{
+		str_format(aMsg, sizeof(aMsg), "%s is in an imported ban list (%s)", pStr, pThis->m_vImportedReasons[ImportedIndex].c_str());
+		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aMsg);
+
+		Found++;
+	}
+
 	if(Found)
 		str_format(aMsg, sizeof(aMsg), "%i ban records found.", Found);
 	else
@@ -626,3 +889,27 @@ void CNetBan::ConBansSave(IConsole::IResult *pResult, void *pUser)
 	str_format(aBuf, sizeof(aBuf), "saved banlist to '%s'", pResult->GetString(0));
 	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aBuf);
 }
+
+void CNetBan::ConBansImport(IConsole::IResult *pResult, void *pUser)
+{
+	CNetBan *pThis = static_cast<CNetBan *>(pUser);
+
+	const char *pFilename = pResult->GetString(0);
+	const char *pReason = pResult->NumArguments() > 1 ? pResult->GetString(1) : "No reason given";
+
+	char aBuf[256];
+	const int NumImported = pThis->ImportBans(pFilename, pReason);
+	if(NumImported < 0)
+		str_format(aBuf, sizeof(aBuf), "failed to import bans from '%s'", pFilename);
+	else
+		str_format(aBuf, sizeof(aBuf), "imported %d bans from '%s' (%d prefixes in total)", NumImported, pFilename, pThis->NumImportedBans());
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", aBuf);
+}
+
+void CNetBan::ConBansImportClear(IConsole::IResult *pResult, void *pUser)
+{
+	CNetBan *pThis = static_cast<CNetBan *>(pUser);
+
+	pThis->ClearImportedBans();
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "net_ban", "removed all imported bans");
+}
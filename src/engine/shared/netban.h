@@ -5,6 +5,9 @@
 
 #include <engine/console.h>
 
+#include <string>
+#include <vector>
+
 inline int NetComp(const NETADDR *pAddr1, const NETADDR *pAddr2)
 {
 	return mem_comp(pAddr1, pAddr2, pAddr1->type == NETTYPE_IPV4 ? 8 : 20);
@@ -24,6 +27,55 @@ inline int NetComp(const CNetRange *pRange1, const CNetRange *pRange2)
 	return NetComp(&pRange1->m_LB, &pRange2->m_LB) || NetComp(&pRange1->m_UB, &pRange2->m_UB);
 }
 
+/**
+ * Path-compressed binary trie of IPv4 and IPv6 prefixes.
+ *
+ * Lookups take time proportional to the address length, independent of the
+ * number of prefixes. Arbitrary ranges are split into the smallest set of
+ * prefixes covering them.
+ */
+class CNetPrefixTrie
+{
+public:
+	CNetPrefixTrie() { Clear(); }
+
+	void Clear();
+
+	/**
+	 * Adds all addresses starting with the first `PrefixLength` bits of the
+	 * address. A value which was already added for the same prefix is kept.
+	 */
+	void AddPrefix(const NETADDR *pAddr, int PrefixLength, int Value);
+	void AddRange(const CNetRange *pRange, int Value);
+
+	/**
+	 * @return The value of the longest prefix containing the address, `-1`
+	 *         if there is none.
+	 */
+	int Find(const NETADDR *pAddr) const;
+
+	int NumPrefixes() const { return m_NumPrefixes; }
+
+private:
+	struct SNode
+	{
+		unsigned char m_aKey[16];
+		int m_Length;
+		int m_aChildren[2];
+		int m_Value;
+	};
+
+	static int Root(const NETADDR *pAddr) { return pAddr->type == NETTYPE_IPV4 ? 0 : 1; }
+	static int AddrBits(const NETADDR *pAddr) { return pAddr->type == NETTYPE_IPV4 ? 32 : 128; }
+
+	int NewNode(const unsigned char *pKey, int Length, int Value);
+	void Insert(int Root, const unsigned char *pKey, int Length, int Value);
+	void InsertRange(int Root, unsigned char *pPrefix, int Length, int Bits, const unsigned char *pLB, const unsigned char *pUB, int Value);
+
+	std::vector<SNode> m_vNodes;
+	int m_NumPrefixes;
+};
+
 class CNetBan
 {
 protected:
@@ -69,8 +121,6 @@ protected:
 		CNetHash() = default;
 		CNetHash(const NETADDR *pAddr);
 		CNetHash(const CNetRange *pRange);
-
-		static int MakeHashArray(const NETADDR *pAddr, CNetHash aHash[17]);
 	};
 
 	struct CBanInfo
@@ -114,6 +164,8 @@ protected:
 
 		int Num() const { return m_CountUsed; }
 		bool IsFull() const { return m_CountUsed == MAX_BANS; }
+		// Changes whenever a ban is added or removed
+		int Generation() const { return m_Generation; }
 
 		CBan<CDataType> *First() const { return m_pFirstUsed; }
 		CBan<CDataType> *First(const CNetHash *pNetHash) const { return m_aapHashList[pNetHash->m_HashIndex][pNetHash->m_Hash]; }
@@ -140,6 +192,7 @@ protected:
 		CBan<CDataType> *m_pFirstFree;
 		CBan<CDataType> *m_pFirstUsed;
 		int m_CountUsed;
+		int m_Generation = 0;
 
 		void InsertUsed(CBan<CDataType> *pBan);
 	};
@@ -162,6 +215,16 @@ protected:
 	CBanRangePool m_BanRangePool;
 	NETADDR m_LocalhostIpV4, m_LocalhostIpV6;
 
+	// Index of the range bans, rebuilt when the range pool changed
+	mutable CNetPrefixTrie m_RangeTrie;
+	mutable std::vector<const CBanRange *> m_vpRangeTrieBans;
+	mutable int m_RangeTrieGeneration = -1;
+	void UpdateRangeTrie() const;
+
+	// Ranges imported with bans_import, the values index the reasons
+	CNetPrefixTrie m_ImportedTrie;
+	std::vector<std::string> m_vImportedReasons;
+
 public:
 	enum
 	{
@@ -186,6 +249,17 @@ public:
 	void UnbanAll();
 	bool IsBanned(const NETADDR *pOrigAddr, char *pBuf, unsigned BufferSize) const;
 
+	/**
+	 * Bans all ranges listed in the file, which never expire. Every line
+	 * contains an address, a CIDR prefix like `192.0.2.0/24` or a range
+	 * like `192.0.2.0-192.0.2.127`, `#` starts a comment.
+	 *
+	 * @return Number of ranges imported, `-1` if the file can't be read.
+	 */
+	int ImportBans(const char *pFilename, const char *pReason);
+	void ClearImportedBans();
+	int NumImportedBans() const { return m_ImportedTrie.NumPrefixes(); }
+
 	static void ConBan(class IConsole::IResult *pResult, void *pUser);
 	static void ConBanRange(class IConsole::IResult *pResult, void *pUser);
 	static void ConUnban(class IConsole::IResult *pResult, void *pUser);
@@ -194,6 +268,8 @@ public:
 	static void ConBans(class IConsole::IResult *pResult, void *pUser);
 	static void ConBansFind(class IConsole::IResult *pResult, void *pUser);
 	static void ConBansSave(class IConsole::IResult *pResult, void *pUser);
+	static void ConBansImport(class IConsole::IResult *pResult, void *pUser);
+	static void ConBansImportClear(class IConsole::IResult *pResult, void *pUser);
 };
 
 template<class T>
@@ -10,6 +10,7 @@
 
 #include <array>
 #include <optional>
+#include <vector>
 
 class CHuffman;
 class CNetBan;
@@ -69,6 +70,7 @@ enum
 	NET_MAX_CHUNKHEADERSIZE = 3,
 	NET_PACKETHEADERSIZE = 3,
 	NET_CONNLESS_EXTRA_SIZE = 4,
+	NET_CONNLESS_HEADER_SIZE = 2 + NET_CONNLESS_EXTRA_SIZE,
 	NET_MAX_CLIENTS = 64,
 	NET_MAX_CONSOLE_CLIENTS = 4,
 	NET_MAX_SEQUENCE = 1 << 10,
@@ -218,6 +220,29 @@ public:
 	CONNECTIVITY GetConnectivity(int NetType, NETADDR *pGlobalAddr);
 };
 
+class CNetConnectionStats
+{
+public:
+	enum
+	{
+		// bucket i counts acks that took less than 2^i ms, the last one all slower acks
+		NUM_ACK_LATENCY_BUCKETS = 12,
+		PACKET_SIZE_BUCKET_WIDTH = 128,
+		NUM_PACKET_SIZE_BUCKETS = (NET_MAX_PACKETSIZE + PACKET_SIZE_BUCKET_WIDTH - 1) / PACKET_SIZE_BUCKET_WIDTH,
+	};
+
+	// vital chunks sent again, because they were not acked in time or the peer asked for it
+	uint64_t m_ResentChunks;
+	// packets of the peer that asked for a resend
+	uint64_t m_ResendRequests;
+	// time from first sending a vital chunk until it was acked
+	uint64_t m_aAckLatency[NUM_ACK_LATENCY_BUCKETS];
+	uint64_t m_aSentPacketSizes[NUM_PACKET_SIZE_BUCKETS];
+
+	void AddAckLatency(int64_t Milliseconds);
+	void AddSentPacket(int Size);
+};
+
 class CNetConnection
 {
 	// TODO: is this needed because this needs to be aware of
@@ -262,6 +287,7 @@ private:
 	NETADDR m_PeerAddr;
 	NETSOCKET m_Socket;
 	NETSTATS m_Stats;
+	CNetConnectionStats m_DetailedStats;
 
 	std::array<char, NETADDR_MAXSTRSIZE> m_aPeerAddrStr;
 	std::array<char, NETADDR_MAXSTRSIZE> m_aPeerAddrStrNoPort;
@@ -274,6 +300,7 @@ private:
 	void SetPeerAddr(const NETADDR *pAddr);
 	void ClearPeerAddr();
 	void ResetStats();
+	void CountSentPacket(int Size);
 	void SetError(const char *pString);
 	void AckChunks(int Ack);
 
@@ -323,6 +350,14 @@ public:
 	int64_t LastRecvTime() const { return m_LastRecvTime; }
 	int64_t ConnectTime() const { return m_LastUpdateTime; }
 
+	const NETSTATS &Stats() const { return m_Stats; }
+	const CNetConnectionStats &DetailedStats() const { return m_DetailedStats; }
+	void CountReceivedPacket(int Size)
+	{
+		m_Stats.recv_packets++;
+		m_Stats.recv_bytes += Size;
+	}
+
 	int AckSequence() const { return m_Ack; }
 	int SeqSequence() const { return m_Sequence; }
 	int SecurityToken() const { return m_SecurityToken; }
@@ -349,6 +384,14 @@ public:
 		ERROR,
 	};
 
+	enum
+	{
+		// Lines are not received anymore while more output is pending
+		SEND_BUFFER_BACKPRESSURE_SIZE = 256 * 1024,
+		// The connection is dropped when more output is pending
+		MAX_SEND_BUFFER_SIZE = 4 * 1024 * 1024,
+	};
+
 private:
 	EState m_State;
 
@@ -358,6 +401,11 @@ private:
 	char m_aBuffer[NET_MAX_PACKETSIZE];
 	int m_BufferOffset;
 
+	// Lines are collected and written by Flush, so output of many commands
+	// is sent with few writes
+	std::vector<char> m_vSendBuffer;
+	size_t m_SendOffset;
+
 	char m_aErrorString[256];
 
 	bool m_LineEndingDetected;
@@ -370,10 +418,15 @@ public:
 	EState State() const { return m_State; }
 	const NETADDR *PeerAddress() const { return &m_PeerAddr; }
 	const char *ErrorString() const { return m_aErrorString; }
+	size_t PendingSendSize() const { return m_vSendBuffer.size() - m_SendOffset; }
 
 	void Reset();
 	int Update();
 	int Send(const char *pLine);
+	/**
+	 * Writes as much of the pending output as possible without blocking.
+	 */
+	int Flush();
 	int Recv(char *pLine, int MaxLength);
 };
 
@@ -398,6 +451,70 @@ private:
 	CNetPacketConstruct m_Data;
 };
 
+/**
+ * Cheap checks for packets from addresses without a connection, done before
+ * the packets are unpacked or decompressed.
+ *
+ * Packets whose header can't be valid are dropped, as well as data packets
+ * that would be ignored by the server anyway. The remaining packets are
+ * rate limited per source address, IPv6 addresses are grouped by their /64
+ * prefix. Sources share a fixed number of buckets, so memory usage does
+ * not depend on the number of sources.
+ */
+class CNetPreFilter
+{
+public:
+	enum
+	{
+		RESULT_ACCEPTED = 0,
+		RESULT_MALFORMED,
+		RESULT_UNEXPECTED,
+		RESULT_RATELIMITED,
+		NUM_RESULTS,
+	};
+
+	void Init();
+	/**
+	 * @param PacketsPerSecond Sustained rate allowed per source, `0` to disable rate limiting.
+	 * @param Burst Number of packets a source may send at once.
+	 */
+	void SetRateLimit(int PacketsPerSecond, int Burst);
+
+	/**
+	 * @param AllowData Whether connection-oriented packets other than
+	 *        control messages are expected from unknown addresses.
+	 *
+	 * @return One of the `RESULT_*` values, the packet should be dropped
+	 *         unless it is `RESULT_ACCEPTED`.
+	 */
+	int Check(const NETADDR &Addr, const unsigned char *pData, int Size, bool AllowData, int64_t Now);
+	static int Classify(const unsigned char *pData, int Size, bool AllowData);
+	/**
+	 * @return Whether the packet is a connless server info request, these
+	 *         are not rate limited per address.
+	 */
+	static bool IsInfoRequest(const unsigned char *pData, int Size);
+
+	uint64_t Count(int Result) const { return m_aCounts[Result]; }
+	static const char *ResultName(int Result);
+
+private:
+	enum
+	{
+		NUM_BUCKETS = 4096,
+	};
+
+	uint32_t SourceKey(const NETADDR &Addr) const;
+	bool Consume(const NETADDR &Addr, int64_t Now);
+
+	uint32_t m_Seed = 0;
+	int64_t m_Interval = 0;
+	int64_t m_Tolerance = 0;
+	// Theoretical arrival time of the next packet per bucket
+	int64_t m_aBucketTat[NUM_BUCKETS] = {};
+	uint64_t m_aCounts[NUM_RESULTS] = {};
+};
+
 // server side
 class CNetServer
 {
@@ -437,6 +554,7 @@ class CNetServer
 
 	CPacketChunkUnpacker m_PacketChunkUnpacker;
 	CNetPacketConstruct m_RecvBuffer;
+	CNetPreFilter m_PreFilter;
 
 	void OnTokenCtrlMsg(NETADDR &Addr, int ControlMsg, const CNetPacketConstruct &Packet);
 	int OnSixupCtrlMsg(NETADDR &Addr, CNetChunk *pChunk, int ControlMsg, const CNetPacketConstruct &Packet, SECURITY_TOKEN &ResponseToken, SECURITY_TOKEN Token);
@@ -471,11 +589,14 @@ public:
 	const NETADDR *ClientAddr(int ClientId) const { return m_aSlots[ClientId].m_Connection.PeerAddress(); }
 	const std::array<char, NETADDR_MAXSTRSIZE> &ClientAddrString(int ClientId, bool IncludePort) const { return m_aSlots[ClientId].m_Connection.PeerAddressString(IncludePort); }
 	bool HasSecurityToken(int ClientId) const { return m_aSlots[ClientId].m_Connection.SecurityToken() != NET_SECURITY_TOKEN_UNSUPPORTED; }
+	const NETSTATS &ClientStats(int ClientId) const { return m_aSlots[ClientId].m_Connection.Stats(); }
+	const CNetConnectionStats &ClientDetailedStats(int ClientId) const { return m_aSlots[ClientId].m_Connection.DetailedStats(); }
 	NETADDR Address() const { return m_Address; }
 	NETSOCKET Socket() const { return m_Socket; }
 	CNetBan *NetBan() const { return m_pNetBan; }
 	int NetType() const { return net_socket_type(m_Socket); }
 	int MaxClients() const { return m_MaxClients; }
+	const CNetPreFilter &PreFilter() const { return m_PreFilter; }
 
 	void SendTokenSixup(NETADDR &Addr, SECURITY_TOKEN Token);
 
@@ -519,6 +640,7 @@ public:
 	//
 	int Recv(char *pLine, int MaxLength, int *pClientId = nullptr);
 	int Send(int ClientId, const char *pLine);
+	void Flush();
 	void Update();
 
 	//
@@ -625,11 +747,12 @@ public:
 
 	static bool IsValidConnectionOrientedPacket(const CNetPacketConstruct *pPacket);
 
-	static void SendControlMsg(NETSOCKET Socket, NETADDR *pAddr, int Ack, int ControlMsg, const void *pExtra, int ExtraSize, SECURITY_TOKEN SecurityToken, bool Sixup = false);
+	static int SendControlMsg(NETSOCKET Socket, NETADDR *pAddr, int Ack, int ControlMsg, const void *pExtra, int ExtraSize, SECURITY_TOKEN SecurityToken, bool Sixup = false);
 	static void SendControlMsgWithToken7(NETSOCKET Socket, NETADDR *pAddr, TOKEN Token, int Ack, int ControlMsg, TOKEN MyToken, bool Extended);
 	static void SendPacketConnless(NETSOCKET Socket, NETADDR *pAddr, const void *pData, int DataSize, bool Extended, unsigned char aExtra[NET_CONNLESS_EXTRA_SIZE]);
 	static void SendPacketConnlessWithToken7(NETSOCKET Socket, NETADDR *pAddr, const void *pData, int DataSize, SECURITY_TOKEN Token, SECURITY_TOKEN ResponseToken);
-	static void SendPacket(NETSOCKET Socket, NETADDR *pAddr, CNetPacketConstruct *pPacket, SECURITY_TOKEN SecurityToken, bool Sixup = false);
+	// returns the number of bytes sent, -1 if the packet could not be built
+	static int SendPacket(NETSOCKET Socket, NETADDR *pAddr, CNetPacketConstruct *pPacket, SECURITY_TOKEN SecurityToken, bool Sixup = false);
 
 	static std::optional<int> UnpackPacketFlags(unsigned char *pBuffer, int Size);
 	static int UnpackPacket(unsigned char *pBuffer, int Size, CNetPacketConstruct *pPacket, bool &Sixup, SECURITY_TOKEN *pSecurityToken = nullptr, SECURITY_TOKEN *pResponseToken = nullptr);
@@ -20,13 +20,36 @@ void CNetConnection::ClearPeerAddr()
 	m_aPeerAddrStrNoPort[0] = '\0';
 }
 
+void CNetConnectionStats::AddAckLatency(int64_t Milliseconds)
+{
+	int Bucket = 0;
+	while(Bucket < NUM_ACK_LATENCY_BUCKETS - 1 && Milliseconds >= (int64_t)1 << Bucket)
+		Bucket++;
+	m_aAckLatency[Bucket]++;
+}
+
+void CNetConnectionStats::AddSentPacket(int Size)
+{
+	m_aSentPacketSizes[minimum(Size / PACKET_SIZE_BUCKET_WIDTH, (int)NUM_PACKET_SIZE_BUCKETS - 1)]++;
+}
+
 void CNetConnection::ResetStats()
 {
 	m_Stats = {};
+	m_DetailedStats = {};
 	ClearPeerAddr();
 	m_LastUpdateTime = 0;
 }
 
+void CNetConnection::CountSentPacket(int Size)
+{
+	if(Size <= 0)
+		return;
+	m_Stats.sent_packets++;
+	m_Stats.sent_bytes += Size;
+	m_DetailedStats.AddSentPacket(Size);
+}
+
 void CNetConnection::Reset(bool Rejoin)
 {
 	m_Sequence = 0;
@@ -79,6 +102,7 @@ void CNetConnection::Init(NETSOCKET Socket, bool BlockCloseMsg)
 
 void CNetConnection::AckChunks(int Ack)
 {
+	int64_t Now = -1;
 	while(true)
 	{
 		CNetChunkResend *pResend = m_Buffer.First();
@@ -86,7 +110,13 @@ void CNetConnection::AckChunks(int Ack)
 			break;
 
 		if(CNetBase::IsSeqInBackroom(pResend->m_Sequence, Ack))
+		{
+			// time_get() is only updated once per server loop
+			if(Now < 0)
+				Now = time_get_impl();
+			m_DetailedStats.AddAckLatency((Now - pResend->m_FirstSendTime) * 1000 / time_freq());
 			m_Buffer.PopFirst();
+		}
 		else
 			break;
 	}
@@ -109,7 +139,7 @@ int CNetConnection::Flush()
 
 	// send of the packets
 	m_Construct.m_Ack = m_Ack;
-	CNetBase::SendPacket(m_Socket, &m_PeerAddr, &m_Construct, m_SecurityToken, m_Sixup);
+	CountSentPacket(CNetBase::SendPacket(m_Socket, &m_PeerAddr, &m_Construct, m_SecurityToken, m_Sixup));
 
 	// update send times
 	m_LastSendTime = time_get();
@@ -194,11 +224,12 @@ void CNetConnection::SendControl(int ControlMsg, const void *pExtra, int ExtraSi
 {
 	// send the control message
 	m_LastSendTime = time_get();
-	CNetBase::SendControlMsg(m_Socket, &m_PeerAddr, m_Ack, ControlMsg, pExtra, ExtraSize, m_SecurityToken, m_Sixup);
+	CountSentPacket(CNetBase::SendControlMsg(m_Socket, &m_PeerAddr, m_Ack, ControlMsg, pExtra, ExtraSize, m_SecurityToken, m_Sixup));
 }
 
 void CNetConnection::ResendChunk(CNetChunkResend *pResend)
 {
+	m_DetailedStats.m_ResentChunks++;
 	QueueChunkEx(pResend->m_Flags | NET_CHUNKFLAG_RESEND, pResend->m_DataSize, pResend->m_pData, pResend->m_Sequence);
 	pResend->m_LastSendTime = time_get();
 }
@@ -302,6 +333,7 @@ void CNetConnection::Disconnect(const char *pReason)
 void CNetConnection::DirectInit(const NETADDR &Addr, SECURITY_TOKEN SecurityToken, SECURITY_TOKEN Token, bool Sixup)
 {
 	Reset();
+	ResetStats();
 
 	m_State = EState::ONLINE;
 
@@ -360,7 +392,10 @@ int CNetConnection::Feed(CNetPacketConstruct *pPacket, NETADDR *pAddr, SECURITY_
 
 	// check if resend is requested
 	if(pPacket->m_Flags & NET_PACKETFLAG_RESEND)
+	{
+		m_DetailedStats.m_ResendRequests++;
 		Resend();
+	}
 
 	//
 	if(pPacket->m_Flags & NET_PACKETFLAG_CONTROL)
@@ -145,6 +145,14 @@ int CNetConsole::Recv(char *pLine, int MaxLength, int *pClientId)
 	return 0;
 }
 
+void CNetConsole::Flush()
+{
+	for(auto &Slot : m_aSlots)
+	{
+		Slot.m_Connection.Flush();
+	}
+}
+
 int CNetConsole::Send(int ClientId, const char *pLine)
 {
 	if(m_aSlots[ClientId].m_Connection.State() == CConsoleNetConnection::EState::ONLINE)
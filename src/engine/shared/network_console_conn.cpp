@@ -13,6 +13,8 @@ void CConsoleNetConnection::Reset()
 	m_Socket = nullptr;
 	m_aBuffer[0] = 0;
 	m_BufferOffset = 0;
+	m_vSendBuffer.clear();
+	m_SendOffset = 0;
 
 	m_LineEndingDetected = false;
 #if defined(CONF_FAMILY_WINDOWS)
@@ -48,6 +50,7 @@ void CConsoleNetConnection::Disconnect(const char *pReason)
 
 	if(pReason && pReason[0])
 		Send(pReason);
+	Flush();
 
 	net_tcp_close(m_Socket);
 
@@ -56,6 +59,14 @@ void CConsoleNetConnection::Disconnect(const char *pReason)
 
 int CConsoleNetConnection::Update()
 {
+	if(Flush() != 0)
+		return -1;
+
+	// leave the input of clients which don't read their output in the
+	// socket, so they are slowed down by TCP flow control
+	if(PendingSendSize() >= SEND_BUFFER_BACKPRESSURE_SIZE)
+		return 0;
+
 	if(State() == EState::ONLINE)
 	{
 		if((int)(sizeof(m_aBuffer)) <= m_BufferOffset)
@@ -159,6 +170,13 @@ int CConsoleNetConnection::Send(const char *pLine)
 	if(State() != EState::ONLINE)
 		return -1;
 
+	if(PendingSendSize() >= MAX_SEND_BUFFER_SIZE)
+	{
+		m_State = EState::ERROR;
+		str_copy(m_aErrorString, "too weak connection (out of send buffer)");
+		return -1;
+	}
+
 	char aBuf[1024];
 	str_copy(aBuf, pLine, (int)(sizeof(aBuf)) - 2);
 	int Length = str_length(aBuf);
@@ -166,24 +184,40 @@ int CConsoleNetConnection::Send(const char *pLine)
 	aBuf[Length + 1] = m_aLineEnding[1];
 	aBuf[Length + 2] = m_aLineEnding[2];
 	Length += 3;
-	const char *pData = aBuf;
 
-	while(true)
+	m_vSendBuffer.insert(m_vSendBuffer.end(), aBuf, aBuf + Length);
+	return 0;
+}
+
+int CConsoleNetConnection::Flush()
+{
+	if(State() != EState::ONLINE)
+		return State() == EState::ERROR ? -1 : 0;
+
+	while(m_SendOffset < m_vSendBuffer.size())
 	{
-		int Send = net_tcp_send(m_Socket, pData, Length);
+		int Send = net_tcp_send(m_Socket, m_vSendBuffer.data() + m_SendOffset, m_vSendBuffer.size() - m_SendOffset);
 		if(Send < 0)
 		{
+			if(net_would_block())
+				break;
+
 			m_State = EState::ERROR;
 			str_copy(m_aErrorString, "failed to send packet");
 			return -1;
 		}
-
-		if(Send >= Length)
-			break;
-
-		pData += Send;
-		Length -= Send;
+		m_SendOffset += Send;
 	}
 
+	if(m_SendOffset == m_vSendBuffer.size())
+	{
+		m_vSendBuffer.clear();
+		m_SendOffset = 0;
+	}
+	else if(m_SendOffset >= m_vSendBuffer.size() / 2)
+	{
+		m_vSendBuffer.erase(m_vSendBuffer.begin(), m_vSendBuffer.begin() + m_SendOffset);
+		m_SendOffset = 0;
+	}
 	return 0;
 }
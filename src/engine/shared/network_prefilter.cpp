@@ -0,0 +1,118 @@
+#include "network.h"
+#include "masterserver.h"
+#include "protocolglue.h"
+
+#include <base/math.h>
+#include <base/system.h>
+
+void CNetPreFilter::Init()
+{
+	secure_random_fill(&m_Seed, sizeof(m_Seed));
+	mem_zero(m_aBucketTat, sizeof(m_aBucketTat));
+	mem_zero(m_aCounts, sizeof(m_aCounts));
+}
+
+void CNetPreFilter::SetRateLimit(int PacketsPerSecond, int Burst)
+{
+	if(PacketsPerSecond <= 0)
+	{
+		m_Interval = 0;
+		return;
+	}
+	m_Interval = time_freq() / PacketsPerSecond;
+	m_Tolerance = m_Interval * maximum(Burst - 1, 0);
+}
+
+// Same checks as in CNetBase::UnpackPacket, without touching the payload
+int CNetPreFilter::Classify(const unsigned char *pData, int Size, bool AllowData)
+{
+	if(Size < NET_PACKETHEADERSIZE || Size > NET_MAX_PACKETSIZE)
+		return RESULT_MALFORMED;
+
+	int Flags = pData[0] >> 2;
+	if(Flags & NET_PACKETFLAG_CONNLESS)
+	{
+		const bool Sixup = (pData[0] & 0x3) == 1;
+		return Size < (Sixup ? 9 : 6) ? RESULT_MALFORMED : RESULT_ACCEPTED;
+	}
+
+	const bool Sixup = (Flags & NET_PACKETFLAG_UNUSED) != 0;
+	if(Sixup)
+		Flags = PacketFlags_SevenToSix(Flags);
+	const int DataSize = Size - (Sixup ? 7 : NET_PACKETHEADERSIZE);
+	if(DataSize < 0 || (Flags & ~(NET_PACKETFLAG_CONTROL | NET_PACKETFLAG_RESEND | NET_PACKETFLAG_COMPRESSION)) != 0)
+		return RESULT_MALFORMED;
+
+	const int NumChunks = pData[2];
+	if(Flags & NET_PACKETFLAG_CONTROL)
+	{
+		if(NumChunks != 0 || DataSize == 0 || (Flags & NET_PACKETFLAG_COMPRESSION))
+			return RESULT_MALFORMED;
+		return RESULT_ACCEPTED;
+	}
+	if(NumChunks < ((Flags & NET_PACKETFLAG_RESEND) ? 0 : 1) || NumChunks > NET_MAX_PACKET_CHUNKS)
+		return RESULT_MALFORMED;
+
+	// only the vanilla anti-spoof handshake expects data before a
+	// connection exists, 0.7 clients always start with control messages
+	if(Sixup || !AllowData)
+		return RESULT_UNEXPECTED;
+	return RESULT_ACCEPTED;
+}
+
+bool CNetPreFilter::IsInfoRequest(const unsigned char *pData, int Size)
+{
+	if(Size < NET_PACKETHEADERSIZE || !((pData[0] >> 2) & NET_PACKETFLAG_CONNLESS))
+		return false;
+	const int Offset = (pData[0] & 0x3) == 1 ? 9 : 6;
+	if(Size < Offset + SERVERBROWSE_SIZE + 1)
+		return false;
+	return mem_comp(pData + Offset, SERVERBROWSE_GETINFO, SERVERBROWSE_SIZE) == 0 ||
+	       mem_comp(pData + Offset, SERVERBROWSE_GETINFO_64_LEGACY, SERVERBROWSE_SIZE) == 0;
+}
+
+uint32_t CNetPreFilter::SourceKey(const NETADDR &Addr) const
+{
+	// FNV-1a, seeded so that collisions can't be chosen from outside
+	const int Bytes = Addr.type == NETTYPE_IPV4 ? 4 : 8;
+	uint32_t Hash = 2166136261u ^ m_Seed;
+	Hash = (Hash ^ Addr.type) * 16777619u;
+	for(int i = 0; i < Bytes; i++)
+		Hash = (Hash ^ Addr.ip[i]) * 16777619u;
+	return Hash;
+}
+
+bool CNetPreFilter::Consume(const NETADDR &Addr, int64_t Now)
+{
+	// generic cell rate algorithm, equivalent to a token bucket. Sources
+	// hashing to the same bucket share their limit.
+	int64_t &BucketTat = m_aBucketTat[SourceKey(Addr) % NUM_BUCKETS];
+	const int64_t Tat = maximum(BucketTat, Now);
+	if(Tat - Now > m_Tolerance)
+		return false;
+	BucketTat = Tat + m_Interval;
+	return true;
+}
+
+int CNetPreFilter::Check(const NETADDR &Addr, const unsigned char *pData, int Size, bool AllowData, int64_t Now)
+{
+	int Result = Classify(pData, Size, AllowData);
+	// server info requests have their own global limit in the server,
+	// browsers behind a shared address must not starve each other here
+	if(Result == RESULT_ACCEPTED && m_Interval > 0 && !IsInfoRequest(pData, Size) && !Consume(Addr, Now))
+		Result = RESULT_RATELIMITED;
+	m_aCounts[Result]++;
+	return Result;
+}
+
+const char *CNetPreFilter::ResultName(int Result)
+{
+	switch(Result)
+	{
+	case RESULT_ACCEPTED: return "accepted";
+	case RESULT_MALFORMED: return "malformed";
+	case RESULT_UNEXPECTED: return "unexpected";
+	case RESULT_RATELIMITED: return "ratelimited";
+	}
+	dbg_assert_failed("invalid prefilter result %d", Result);
+}
@@ -59,6 +59,7 @@ bool CNetServer::Open(NETADDR BindAddr, CNetBan *pNetBan, int MaxClients, int Ma
 	m_VConnFirst = 0;
 
 	secure_random_fill(m_aSecurityTokenSeed, sizeof(m_aSecurityTokenSeed));
+	m_PreFilter.Init();
 
 	for(auto &Slot : m_aSlots)
 		Slot.m_Connection.Init(m_Socket, true);
@@ -585,6 +586,10 @@ static bool IsDDNetControlMsg(const CNetPacketConstruct *pPacket)
 */
 int CNetServer::Recv(CNetChunk *pChunk, SECURITY_TOKEN *pResponseToken)
 {
+	const int64_t Now = time_get();
+	const bool AllowPreConnData = g_Config.m_SvVanillaAntiSpoof && g_Config.m_Password[0] == '\0';
+	m_PreFilter.SetRateLimit(g_Config.m_SvPreFilterRate, g_Config.m_SvPreFilterBurst);
+
 	while(true)
 	{
 		// Unpack next chunk from stored packet if available
@@ -600,6 +605,22 @@ int CNetServer::Recv(CNetChunk *pChunk, SECURITY_TOKEN *pResponseToken)
 		if(Bytes <= 0)
 			break;
 
+		// Check size and unpack packet flags early so we can determine the sixup
+		// state correctly for connection-oriented packets before unpacking them.
+		std::optional<int> Flags = CNetBase::UnpackPacketFlags(pData, Bytes);
+		int Slot = Flags && (*Flags & NET_PACKETFLAG_CONNLESS) == 0 ? GetClientSlot(Addr) : -1;
+
+		// drop garbage and floods from unknown addresses before doing
+		// anything expensive with them
+		if(Slot == -1 && m_PreFilter.Check(Addr, pData, Bytes, AllowPreConnData, Now) != CNetPreFilter::RESULT_ACCEPTED)
+		{
+			continue;
+		}
+		if(!Flags)
+		{
+			continue;
+		}
+
 		// check if we just should drop the packet
 		char aBuf[128];
 		if(NetBan() && NetBan()->IsBanned(&Addr, aBuf, sizeof(aBuf)))
@@ -609,16 +630,7 @@ int CNetServer::Recv(CNetChunk *pChunk, SECURITY_TOKEN *pResponseToken)
 			continue;
 		}
 
-		// Check size and unpack packet flags early so we can determine the sixup
-		// state correctly for connection-oriented packets before unpacking them.
-		std::optional<int> Flags = CNetBase::UnpackPacketFlags(pData, Bytes);
-		if(!Flags)
-		{
-			continue;
-		}
-
 		SECURITY_TOKEN Token;
-		int Slot = (*Flags & NET_PACKETFLAG_CONNLESS) == 0 ? GetClientSlot(Addr) : -1;
 		bool Sixup = Slot != -1 && m_aSlots[Slot].m_Connection.m_Sixup;
 		if(CNetBase::UnpackPacket(pData, Bytes, &m_RecvBuffer, Sixup, &Token, pResponseToken) == 0)
 		{
@@ -653,6 +665,7 @@ int CNetServer::Recv(CNetChunk *pChunk, SECURITY_TOKEN *pResponseToken)
 
 					if(m_aSlots[Slot].m_Connection.Feed(&m_RecvBuffer, &Addr, Token, *pResponseToken))
 					{
+						m_aSlots[Slot].m_Connection.CountReceivedPacket(Bytes);
 						if(!Control &&
 							m_RecvBuffer.m_DataSize > 0 &&
 							m_RecvBuffer.m_NumChunks > 0)
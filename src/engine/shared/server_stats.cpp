@@ -0,0 +1,101 @@
+#include "server_stats.h"
+
+#include <base/system.h>
+
+CServerStatsWriter::~CServerStatsWriter()
+{
+	Close();
+}
+
+bool CServerStatsWriter::Open(const char *pFilename)
+{
+	Close();
+
+	size_t Size = sizeof(CServerStatsBlock);
+	void *pData = fs_map_file(pFilename, &Size, true);
+	if(!pData)
+		return false;
+
+	m_pBlock = static_cast<CServerStatsBlock *>(pData);
+	m_pBlock->m_Sequence.store(0, std::memory_order_relaxed);
+	mem_zero(&m_pBlock->m_Stats, sizeof(m_pBlock->m_Stats));
+	m_pBlock->m_Magic = CServerStatsBlock::MAGIC;
+	m_pBlock->m_Version = CServerStatsBlock::VERSION;
+	m_pBlock->m_Size = sizeof(CServerStatsBlock);
+	return true;
+}
+
+void CServerStatsWriter::Close()
+{
+	if(!m_pBlock)
+		return;
+	fs_unmap_file(m_pBlock, sizeof(CServerStatsBlock));
+	m_pBlock = nullptr;
+}
+
+void CServerStatsWriter::Publish(const CServerStats &Stats)
+{
+	const uint32_t Sequence = m_pBlock->m_Sequence.load(std::memory_order_relaxed);
+	m_pBlock->m_Sequence.store(Sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	mem_copy(&m_pBlock->m_Stats, &Stats, sizeof(Stats));
+	m_pBlock->m_Sequence.store(Sequence + 2, std::memory_order_release);
+}
+
+CServerStatsReader::~CServerStatsReader()
+{
+	Close();
+}
+
+bool CServerStatsReader::Open(const char *pFilename)
+{
+	Close();
+
+	size_t Size;
+	void *pData = fs_map_file(pFilename, &Size, false);
+	if(!pData)
+		return false;
+
+	const CServerStatsBlock *pBlock = static_cast<const CServerStatsBlock *>(pData);
+	if(Size < sizeof(CServerStatsBlock) ||
+		pBlock->m_Magic != CServerStatsBlock::MAGIC ||
+		pBlock->m_Version != CServerStatsBlock::VERSION ||
+		pBlock->m_Size != sizeof(CServerStatsBlock))
+	{
+		fs_unmap_file(pData, Size);
+		return false;
+	}
+
+	m_pBlock = pBlock;
+	m_Size = Size;
+	return true;
+}
+
+void CServerStatsReader::Close()
+{
+	if(!m_pBlock)
+		return;
+	fs_unmap_file(const_cast<CServerStatsBlock *>(m_pBlock), m_Size);
+	m_pBlock = nullptr;
+	m_Size = 0;
+}
+
+bool CServerStatsReader::Read(CServerStats *pStats) const
+{
+	for(int i = 0; i < MAX_READ_TRIES; i++)
+	{
+		const uint32_t Before = m_pBlock->m_Sequence.load(std::memory_order_acquire);
+		if(Before % 2 != 0)
+			continue;
+		mem_copy(pStats, &m_pBlock->m_Stats, sizeof(*pStats));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(m_pBlock->m_Sequence.load(std::memory_order_relaxed) == Before)
+			return true;
+	}
+	return false;
+}
+
+uint32_t CServerStatsReader::NumUpdates() const
+{
+	return m_pBlock->m_Sequence.load(std::memory_order_acquire) / 2;
+}
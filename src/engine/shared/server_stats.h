@@ -0,0 +1,180 @@
+#ifndef ENGINE_SHARED_SERVER_STATS_H
+#define ENGINE_SHARED_SERVER_STATS_H
+
+#include "protocol.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Statistics the server publishes once per tick, see @link CServerStatsWriter @endlink.
+ *
+ * Only fixed-size types are used, because the layout is read by other
+ * processes. Changing it requires increasing @link CServerStatsBlock::VERSION @endlink.
+ */
+class CServerStats
+{
+public:
+	enum
+	{
+		TICK_TIME_WINDOW = 250,
+		// see CNetConnectionStats
+		NUM_ACK_LATENCY_BUCKETS = 12,
+		NUM_PACKET_SIZE_BUCKETS = 11,
+		// one counter per net object type, the last one for all others
+		NUM_SNAP_ITEM_TYPES = 65,
+	};
+
+	class CClient
+	{
+	public:
+		// State of the client on the server, 0 for empty slots
+		int32_t m_State;
+		int32_t m_Latency;
+		uint64_t m_SentPackets;
+		uint64_t m_SentBytes;
+		uint64_t m_RecvPackets;
+		uint64_t m_RecvBytes;
+		// Size of the last snapshot sent to the client, in bytes
+		int32_t m_SnapshotSize;
+		int32_t m_Padding;
+
+		uint64_t m_ResentChunks;
+		uint64_t m_ResendRequests;
+		// Bucket i counts acks that took less than 2^i ms
+		uint64_t m_aAckLatency[NUM_ACK_LATENCY_BUCKETS];
+		// Bucket i counts packets of 128 * i to 128 * (i + 1) - 1 bytes
+		uint64_t m_aSentPacketSizes[NUM_PACKET_SIZE_BUCKETS];
+
+		// Snapshots sent to the client: full size, size of the deltas
+		// and size after variable int packing
+		uint64_t m_SnapFullBytes;
+		uint64_t m_SnapDeltaBytes;
+		uint64_t m_SnapPackedBytes;
+		// Packed bytes of updated items by type, the remaining bytes
+		// are headers and deleted items
+		uint64_t m_aSnapItemBytes[NUM_SNAP_ITEM_TYPES];
+	};
+
+	// Unix time in milliseconds
+	int64_t m_UpdateTime;
+	int32_t m_Tick;
+	int32_t m_TickSpeed;
+
+	// Time spent on each of the last TICK_TIME_WINDOW ticks, in
+	// microseconds. When the server catches up several ticks at once, the
+	// snapshot and network work after them counts towards the last one.
+	int32_t m_TickTimeP50;
+	int32_t m_TickTimeP90;
+	int32_t m_TickTimeP99;
+	int32_t m_TickTimeMax;
+
+	int32_t m_NumClients;
+	int32_t m_NumPlayers;
+	int32_t m_MaxClients;
+	// Database queries waiting to be executed
+	int32_t m_DbQueuedQueries;
+	// Bytes queued by asynchronous file writers
+	uint64_t m_AioQueuedBytes;
+
+	// Totals of all sockets, including connectionless packets
+	uint64_t m_SentPackets;
+	uint64_t m_SentBytes;
+	uint64_t m_RecvPackets;
+	uint64_t m_RecvBytes;
+
+	CClient m_aClients[MAX_CLIENTS];
+};
+
+/*
+	Memory layout of the stats file
+
+	The file is mapped by the server and readers, the block is updated
+	with seqlock semantics: the writer makes `m_Sequence` odd before and
+	even again after changing `m_Stats`. Readers copy the stats and retry
+	if the sequence was odd or changed in the meantime, so neither side
+	ever waits for the other.
+*/
+class CServerStatsBlock
+{
+public:
+	enum
+	{
+		MAGIC = 0x54535344, // "DSST"
+		VERSION = 2,
+	};
+
+	uint32_t m_Magic;
+	uint32_t m_Version;
+	uint32_t m_Size;
+	std::atomic<uint32_t> m_Sequence;
+	CServerStats m_Stats;
+};
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "the sequence must be usable across processes");
+
+/**
+ * Publishes @link CServerStats @endlink to a memory-mapped file.
+ */
+class CServerStatsWriter
+{
+public:
+	CServerStatsWriter() = default;
+	~CServerStatsWriter();
+	CServerStatsWriter(const CServerStatsWriter &Other) = delete;
+	CServerStatsWriter &operator=(const CServerStatsWriter &Other) = delete;
+
+	/**
+	 * @param pFilename Absolute path or path relative to the working directory.
+	 *
+	 * @return `false` if the file could not be mapped.
+	 */
+	bool Open(const char *pFilename);
+	void Close();
+	bool IsOpen() const { return m_pBlock != nullptr; }
+
+	void Publish(const CServerStats &Stats);
+
+private:
+	CServerStatsBlock *m_pBlock = nullptr;
+};
+
+/**
+ * Reads the statistics published by @link CServerStatsWriter @endlink.
+ */
+class CServerStatsReader
+{
+public:
+	CServerStatsReader() = default;
+	~CServerStatsReader();
+	CServerStatsReader(const CServerStatsReader &Other) = delete;
+	CServerStatsReader &operator=(const CServerStatsReader &Other) = delete;
+
+	/**
+	 * @return `false` if the file could not be mapped or has an incompatible layout.
+	 */
+	bool Open(const char *pFilename);
+	void Close();
+
+	/**
+	 * Copies a consistent version of the stats.
+	 *
+	 * @return `false` if the writer kept changing the stats while reading.
+	 */
+	bool Read(CServerStats *pStats) const;
+	/**
+	 * @return Number of updates published so far.
+	 */
+	uint32_t NumUpdates() const;
+
+private:
+	enum
+	{
+		MAX_READ_TRIES = 1000,
+	};
+
+	const CServerStatsBlock *m_pBlock = nullptr;
+	size_t m_Size = 0;
+};
+
+#endif
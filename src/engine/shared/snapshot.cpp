@@ -11,6 +11,7 @@
 #include <generated/protocol7.h>
 #include <generated/protocolglue.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <limits>
 
@@ -160,6 +161,116 @@ bool CSnapshot::IsValid(size_t ActualSize) const
 	return true;
 }
 
+// CSnapshotIndex
+
+const int CSnapshotIndex::ms_aClientItemTypes[NUM_CLIENT_ITEM_TYPES] = {
+	NETOBJTYPE_CHARACTER,
+	NETOBJTYPE_PLAYERINFO,
+	NETOBJTYPE_DDNETCHARACTER,
+	NETOBJTYPE_DDNETPLAYER,
+};
+
+void CSnapshotIndex::Build(const CSnapshot *pSnapshot)
+{
+	const int NumItems = pSnapshot->NumItems();
+
+	// resolve the extended item types once instead of looking up the type item for every item
+	std::vector<std::pair<int, int>> vExtendedTypes;
+	for(int i = 0; i < NumItems; i++)
+	{
+		const CSnapshotItem *pItem = pSnapshot->GetItem(i);
+		if(pItem->Type() == 0 && pItem->Id() >= CSnapshot::OFFSET_UUID_TYPE) // NETOBJTYPE_EX
+		{
+			if(std::any_of(vExtendedTypes.begin(), vExtendedTypes.end(), [&](const std::pair<int, int> &Type) { return Type.first == pItem->Id(); }))
+				continue;
+			vExtendedTypes.emplace_back(pItem->Id(), pSnapshot->GetExternalItemType(pItem->Id()));
+		}
+	}
+
+	m_vItemTypes.resize(NumItems);
+	m_vItemIds.resize(NumItems);
+	m_vSortedIndices.resize(NumItems);
+	for(int i = 0; i < NumItems; i++)
+	{
+		const CSnapshotItem *pItem = pSnapshot->GetItem(i);
+		int Type = pItem->Type();
+		if(Type >= CSnapshot::OFFSET_UUID_TYPE)
+		{
+			for(const auto &[InternalType, ExternalType] : vExtendedTypes)
+			{
+				if(InternalType == Type)
+				{
+					Type = ExternalType;
+					break;
+				}
+			}
+		}
+		m_vItemTypes[i] = Type;
+		m_vItemIds[i] = pItem->Id();
+		m_vSortedIndices[i] = i;
+	}
+
+	// stable to find the first of duplicate items like CSnapshot::FindItem
+	std::stable_sort(m_vSortedIndices.begin(), m_vSortedIndices.end(), [&](int Lhs, int Rhs) {
+		if(m_vItemTypes[Lhs] != m_vItemTypes[Rhs])
+			return m_vItemTypes[Lhs] < m_vItemTypes[Rhs];
+		return m_vItemIds[Lhs] < m_vItemIds[Rhs];
+	});
+
+	for(auto &aClientItems : m_aaClientItems)
+		std::fill(std::begin(aClientItems), std::end(aClientItems), -1);
+	for(int i = NumItems - 1; i >= 0; i--)
+	{
+		const int TypeIndex = ClientItemTypeIndex(m_vItemTypes[i]);
+		if(TypeIndex >= 0 && m_vItemIds[i] < MAX_CLIENTS)
+			m_aaClientItems[TypeIndex][m_vItemIds[i]] = i;
+	}
+}
+
+void CSnapshotIndex::Clear()
+{
+	m_vItemTypes.clear();
+	m_vItemIds.clear();
+	m_vSortedIndices.clear();
+	for(auto &aClientItems : m_aaClientItems)
+		std::fill(std::begin(aClientItems), std::end(aClientItems), -1);
+}
+
+int CSnapshotIndex::ClientItemTypeIndex(int Type) const
+{
+	for(int i = 0; i < NUM_CLIENT_ITEM_TYPES; i++)
+	{
+		if(ms_aClientItemTypes[i] == Type)
+			return i;
+	}
+	return -1;
+}
+
+int CSnapshotIndex::FindItemIndex(int Type, int Id) const
+{
+	const int TypeIndex = ClientItemTypeIndex(Type);
+	if(TypeIndex >= 0 && Id >= 0 && Id < MAX_CLIENTS)
+		return m_aaClientItems[TypeIndex][Id];
+
+	const auto It = std::lower_bound(m_vSortedIndices.begin(), m_vSortedIndices.end(), std::pair(Type, Id), [&](int Index, const std::pair<int, int> &Key) {
+		return std::pair(m_vItemTypes[Index], m_vItemIds[Index]) < Key;
+	});
+	if(It == m_vSortedIndices.end() || m_vItemTypes[*It] != Type || m_vItemIds[*It] != Id)
+		return -1;
+	return *It;
+}
+
+const int *CSnapshotIndex::ItemsOfType(int Type, int *pNum) const
+{
+	const auto Compare = [&](int Index, int Key) { return m_vItemTypes[Index] < Key; };
+	const auto Begin = std::lower_bound(m_vSortedIndices.begin(), m_vSortedIndices.end(), Type, Compare);
+	auto End = Begin;
+	while(End != m_vSortedIndices.end() && m_vItemTypes[*End] == Type)
+		End++;
+	*pNum = End - Begin;
+	return m_vSortedIndices.data() + (Begin - m_vSortedIndices.begin());
+}
+
 // CSnapshotDelta
 
 enum
@@ -375,6 +486,29 @@ int CSnapshotDelta::CreateDelta(const CSnapshot *pFrom, const CSnapshot *pTo, vo
 	return (int)((char *)pData - (char *)pDstData);
 }
 
+void CSnapshotDelta::CountItemBytes(const void *pDeltaData, int DataSize, uint64_t *pTypeBytes, int NumTypes) const
+{
+	const CData *pDelta = (const CData *)pDeltaData;
+	const int *pData = pDelta->m_aData + pDelta->m_NumDeletedItems;
+	const int *pEnd = (const int *)((const char *)pDeltaData + DataSize);
+
+	for(int i = 0; i < pDelta->m_NumUpdateItems && pData + 2 <= pEnd; i++)
+	{
+		const int *pItem = pData;
+		const int Type = pData[0];
+		pData += 2;
+		if(Type >= 0 && Type < MAX_NETOBJSIZES && m_aItemSizes[Type])
+			pData += m_aItemSizes[Type] / sizeof(int32_t);
+		else
+			pData += 1 + pData[0];
+
+		int Bytes = 0;
+		for(const int *pInt = pItem; pInt < pData && pInt < pEnd; pInt++)
+			Bytes += CVariableInt::PackedSize(*pInt);
+		pTypeBytes[Type >= 0 && Type < NumTypes - 1 ? Type : NumTypes - 1] += Bytes;
+	}
+}
+
 int CSnapshotDelta::DebugDumpDelta(const void *pSrcData, int DataSize)
 {
 	CData *pDelta = (CData *)pSrcData;
@@ -612,20 +746,34 @@ int CSnapshotDelta::UnpackDelta(const CSnapshot *pFrom, CSnapshot *pTo, const vo
 
 // CSnapshotStorage
 
+CSnapshotStorage::~CSnapshotStorage()
+{
+	PurgeAll();
+	for(CSnapshotIndex *pIndex : m_vpFreeIndices)
+		delete pIndex;
+}
+
 void CSnapshotStorage::Init()
 {
 	m_pFirst = nullptr;
 	m_pLast = nullptr;
 }
 
+void CSnapshotStorage::FreeHolder(CHolder *pHolder)
+{
+	free(pHolder->m_pSnap);
+	free(pHolder->m_pAltSnap);
+	if(pHolder->m_pAltIndex)
+		m_vpFreeIndices.push_back(pHolder->m_pAltIndex);
+	free(pHolder);
+}
+
 void CSnapshotStorage::PurgeAll()
 {
 	while(m_pFirst)
 	{
 		CHolder *pNext = m_pFirst->m_pNext;
-		free(m_pFirst->m_pSnap);
-		free(m_pFirst->m_pAltSnap);
-		free(m_pFirst);
+		FreeHolder(m_pFirst);
 		m_pFirst = pNext;
 	}
 	m_pLast = nullptr;
@@ -640,9 +788,7 @@ void CSnapshotStorage::PurgeUntil(int Tick)
 		CHolder *pNext = pHolder->m_pNext;
 		if(pHolder->m_Tick >= Tick)
 			return; // no more to remove
-		free(pHolder->m_pSnap);
-		free(pHolder->m_pAltSnap);
-		free(pHolder);
+		FreeHolder(pHolder);
 
 		// did we come to the end of the list?
 		if(!pNext)
@@ -676,11 +822,22 @@ void CSnapshotStorage::Add(int Tick, int64_t Tagtime, size_t DataSize, const voi
 		pHolder->m_pAltSnap = static_cast<CSnapshot *>(malloc(AltDataSize));
 		mem_copy(pHolder->m_pAltSnap, pAltData, AltDataSize);
 		pHolder->m_AltSnapSize = AltDataSize;
+		if(m_vpFreeIndices.empty())
+		{
+			pHolder->m_pAltIndex = new CSnapshotIndex();
+		}
+		else
+		{
+			pHolder->m_pAltIndex = m_vpFreeIndices.back();
+			m_vpFreeIndices.pop_back();
+		}
+		pHolder->m_pAltIndex->Build(pHolder->m_pAltSnap);
 	}
 	else
 	{
 		pHolder->m_pAltSnap = nullptr;
 		pHolder->m_AltSnapSize = 0;
+		pHolder->m_pAltIndex = nullptr;
 	}
 
 	// link
@@ -752,6 +909,27 @@ int *CSnapshotBuilder::GetItemData(int Key)
 	return nullptr;
 }
 
+void CSnapshotBuilder::RemoveItems(const bool *pRemove)
+{
+	int NumItems = 0;
+	int DataSize = 0;
+	for(int i = 0; i < m_NumItems; i++)
+	{
+		const int Offset = m_aOffsets[i];
+		const int ItemSize = (i + 1 < m_NumItems ? m_aOffsets[i + 1] : m_DataSize) - Offset;
+		if(pRemove[i])
+			continue;
+
+		if(DataSize != Offset)
+			mem_move(m_aData + DataSize, m_aData + Offset, ItemSize);
+		m_aOffsets[NumItems] = DataSize;
+		NumItems++;
+		DataSize += ItemSize;
+	}
+	m_NumItems = NumItems;
+	m_DataSize = DataSize;
+}
+
 int CSnapshotBuilder::Finish(void *pSnapData)
 {
 	// flatten and make the snapshot
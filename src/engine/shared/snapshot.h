@@ -3,11 +3,14 @@
 #ifndef ENGINE_SHARED_SNAPSHOT_H
 #define ENGINE_SHARED_SNAPSHOT_H
 
+#include "protocol.h"
+
 #include <generated/protocol.h>
 #include <generated/protocol7.h>
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 // CSnapshot
 
@@ -72,6 +75,55 @@ public:
 	static const CSnapshot *EmptySnapshot() { return &ms_EmptySnapshot; }
 };
 
+// CSnapshotIndex
+
+/**
+ * Lookup tables for the items of a snapshot.
+ *
+ * Built once when a snapshot is received, so that consumers do not have to
+ * resolve extended item types or scan all items for every lookup. Items are
+ * grouped by type and ordered by id, items of the per-client types
+ * (characters and players) can be looked up by client id directly.
+ */
+class CSnapshotIndex
+{
+public:
+	void Build(const CSnapshot *pSnapshot);
+	void Clear();
+
+	int NumItems() const { return m_vItemTypes.size(); }
+	/**
+	 * @return The external type of the item, see @link CSnapshot::GetItemType @endlink.
+	 */
+	int ItemType(int Index) const { return m_vItemTypes[Index]; }
+	/**
+	 * @return The index of the item, `-1` if it does not exist.
+	 */
+	int FindItemIndex(int Type, int Id) const;
+	/**
+	 * @param pNum Receives the number of items of the type.
+	 *
+	 * @return The indices of the items of the type, ordered by id.
+	 */
+	const int *ItemsOfType(int Type, int *pNum) const;
+
+private:
+	int ClientItemTypeIndex(int Type) const;
+
+	enum
+	{
+		NUM_CLIENT_ITEM_TYPES = 4,
+	};
+	static const int ms_aClientItemTypes[NUM_CLIENT_ITEM_TYPES];
+
+	// Per item, in snapshot order
+	std::vector<int> m_vItemTypes;
+	std::vector<int> m_vItemIds;
+	// Item indices ordered by type, then id
+	std::vector<int> m_vSortedIndices;
+	int m_aaClientItems[NUM_CLIENT_ITEM_TYPES][MAX_CLIENTS];
+};
+
 // CSnapshotDelta
 
 class CSnapshotDelta
@@ -109,6 +161,18 @@ public:
 	void SetStaticsize7(int ItemType, size_t Size);
 	const CData *EmptyDelta() const;
 	int CreateDelta(const CSnapshot *pFrom, const CSnapshot *pTo, void *pDstData);
+	/**
+	 * Adds the size of every updated item of a delta created by
+	 * @link CreateDelta @endlink, after variable int packing, to the counter
+	 * of its type. Types that don't fit into `NumTypes - 1` counters are
+	 * added to the last one.
+	 */
+	void CountItemBytes(const void *pDeltaData, int DataSize, uint64_t *pTypeBytes, int NumTypes) const;
+	/**
+	 * @return Whether deltas contain the size of items of the type, which
+	 * is the case for types without a static size.
+	 */
+	bool IncludesItemSize(int Type) const { return Type >= MAX_NETOBJSIZES || !m_aItemSizes[Type]; }
 	int UnpackDelta(const CSnapshot *pFrom, CSnapshot *pTo, const void *pSrcData, int DataSize, bool Sixup);
 	int DebugDumpDelta(const void *pSrcData, int DataSize);
 };
@@ -132,18 +196,25 @@ public:
 
 		CSnapshot *m_pSnap;
 		CSnapshot *m_pAltSnap;
+		CSnapshotIndex *m_pAltIndex;
 	};
 
 	CHolder *m_pFirst;
 	CHolder *m_pLast;
 
 	CSnapshotStorage() { Init(); }
-	~CSnapshotStorage() { PurgeAll(); }
+	~CSnapshotStorage();
 	void Init();
 	void PurgeAll();
 	void PurgeUntil(int Tick);
 	void Add(int Tick, int64_t Tagtime, size_t DataSize, const void *pData, size_t AltDataSize, const void *pAltData);
 	int Get(int Tick, int64_t *pTagtime, const CSnapshot **ppData, const CSnapshot **ppAltData) const;
+
+private:
+	void FreeHolder(CHolder *pHolder);
+
+	// Indices of purged snapshots, reused with their buffers
+	std::vector<CSnapshotIndex *> m_vpFreeIndices;
 };
 
 class CSnapshotBuilder
@@ -178,6 +249,11 @@ public:
 
 	CSnapshotItem *GetItem(int Index);
 	int *GetItemData(int Key);
+	/**
+	 * Removes the items for which `pRemove` is `true`, the order of the
+	 * remaining items is kept.
+	 */
+	void RemoveItems(const bool *pRemove);
 
 	int Finish(void *pSnapdata);
 };
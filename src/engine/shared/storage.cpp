@@ -6,6 +6,7 @@
 #include <base/system.h>
 
 #include <engine/client/updater.h>
+#include <engine/shared/directory_index.h>
 #include <engine/shared/linereader.h>
 #include <engine/storage.h>
 
@@ -25,6 +26,7 @@ class CStorage : public IStorage
 	char m_aDatadir[IO_MAX_PATH_LENGTH] = "";
 	char m_aCurrentdir[IO_MAX_PATH_LENGTH] = "";
 	char m_aBinarydir[IO_MAX_PATH_LENGTH] = "";
+	CDirectoryIndex m_DirectoryIndex;
 
 public:
 	bool Init(EInitializationType InitializationType, int NumArgs, const char **ppArguments)
@@ -55,6 +57,9 @@ public:
 			return true;
 		}
 
+		// long-running processes list the same directories repeatedly
+		InitDirectoryIndex();
+
 		if(m_aaStoragePaths[TYPE_SAVE][0] != '\0')
 		{
 			if(fs_makedir_rec_for(m_aaStoragePaths[TYPE_SAVE]) != 0 ||
@@ -77,6 +82,7 @@ public:
 				"assets/hud",
 				"assets/particles",
 				"audio",
+				"cache",
 				"communityicons",
 				"downloadedmaps",
 				"downloadedskins",
@@ -397,11 +403,50 @@ public:
 		m_aBinarydir[0] = '\0';
 	}
 
+	bool InitDirectoryIndex()
+	{
+		return m_DirectoryIndex.Init();
+	}
+
 	int NumPaths() const override
 	{
 		return m_NumPaths;
 	}
 
+	void ListPath(const char *pPath, FS_LISTDIR_CALLBACK pfnCallback, int Type, void *pUser)
+	{
+		const CDirectoryIndex::CListing pListing = m_DirectoryIndex.List(pPath);
+		if(!pListing)
+		{
+			fs_listdir(pPath, pfnCallback, Type, pUser);
+			return;
+		}
+		for(const CDirectoryIndex::SEntry &Entry : *pListing)
+		{
+			if(pfnCallback(Entry.m_Name.c_str(), Entry.m_IsDir, Type, pUser))
+				break;
+		}
+	}
+
+	void ListPathInfo(const char *pPath, FS_LISTDIR_CALLBACK_FILEINFO pfnCallback, int Type, void *pUser)
+	{
+		const CDirectoryIndex::CListing pListing = m_DirectoryIndex.List(pPath);
+		if(!pListing)
+		{
+			fs_listdir_fileinfo(pPath, pfnCallback, Type, pUser);
+			return;
+		}
+		for(const CDirectoryIndex::SEntry &Entry : *pListing)
+		{
+			CFsFileInfo Info;
+			Info.m_pName = Entry.m_Name.c_str();
+			Info.m_TimeCreated = Entry.m_TimeCreated;
+			Info.m_TimeModified = Entry.m_TimeModified;
+			if(pfnCallback(&Info, Entry.m_IsDir, Type, pUser))
+				break;
+		}
+	}
+
 	struct SListDirectoryInfoUniqueCallbackData
 	{
 		FS_LISTDIR_CALLBACK_FILEINFO m_pfnDelegate;
@@ -428,12 +473,12 @@ public:
 			Data.m_pDelegateUser = pUser;
 			// list all available directories
 			for(int i = TYPE_SAVE; i < m_NumPaths; ++i)
-				fs_listdir_fileinfo(GetPath(i, pPath, aBuffer, sizeof(aBuffer)), ListDirectoryInfoUniqueCallback, i, &Data);
+				ListPathInfo(GetPath(i, pPath, aBuffer, sizeof(aBuffer)), ListDirectoryInfoUniqueCallback, i, &Data);
 		}
 		else if(Type >= TYPE_SAVE && Type < m_NumPaths)
 		{
 			// list wanted directory
-			fs_listdir_fileinfo(GetPath(Type, pPath, aBuffer, sizeof(aBuffer)), pfnCallback, Type, pUser);
+			ListPathInfo(GetPath(Type, pPath, aBuffer, sizeof(aBuffer)), pfnCallback, Type, pUser);
 		}
 		else
 		{
@@ -467,12 +512,12 @@ public:
 			Data.m_pDelegateUser = pUser;
 			// list all available directories
 			for(int i = TYPE_SAVE; i < m_NumPaths; ++i)
-				fs_listdir(GetPath(i, pPath, aBuffer, sizeof(aBuffer)), ListDirectoryUniqueCallback, i, &Data);
+				ListPath(GetPath(i, pPath, aBuffer, sizeof(aBuffer)), ListDirectoryUniqueCallback, i, &Data);
 		}
 		else if(Type >= TYPE_SAVE && Type < m_NumPaths)
 		{
 			// list wanted directory
-			fs_listdir(GetPath(Type, pPath, aBuffer, sizeof(aBuffer)), pfnCallback, Type, pUser);
+			ListPath(GetPath(Type, pPath, aBuffer, sizeof(aBuffer)), pfnCallback, Type, pUser);
 		}
 		else
 		{
@@ -685,7 +730,7 @@ public:
 			char aPath[IO_MAX_PATH_LENGTH];
 			str_format(aPath, sizeof(aPath), "%s/%s", Data.m_pPath, pName);
 			Data.m_pPath = aPath;
-			fs_listdir(Data.m_pStorage->GetPath(Type, aPath, aBuf, sizeof(aBuf)), FindFileCallback, Type, &Data);
+			Data.m_pStorage->ListPath(Data.m_pStorage->GetPath(Type, aPath, aBuf, sizeof(aBuf)), FindFileCallback, Type, &Data);
 			if(Data.m_pBuffer[0])
 				return 1;
 		}
@@ -718,7 +763,7 @@ public:
 			// search within all available directories
 			for(int i = TYPE_SAVE; i < m_NumPaths; ++i)
 			{
-				fs_listdir(GetPath(i, pPath, aBuf, sizeof(aBuf)), FindFileCallback, i, &Data);
+				ListPath(GetPath(i, pPath, aBuf, sizeof(aBuf)), FindFileCallback, i, &Data);
 				if(pBuffer[0])
 					return true;
 			}
@@ -726,7 +771,7 @@ public:
 		else if(Type >= TYPE_SAVE && Type < m_NumPaths)
 		{
 			// search within wanted directory
-			fs_listdir(GetPath(Type, pPath, aBuf, sizeof(aBuf)), FindFileCallback, Type, &Data);
+			ListPath(GetPath(Type, pPath, aBuf, sizeof(aBuf)), FindFileCallback, Type, &Data);
 		}
 		else
 		{
@@ -757,7 +802,7 @@ public:
 			char aPath[IO_MAX_PATH_LENGTH];
 			str_format(aPath, sizeof(aPath), "%s/%s", Data.m_pPath, pName);
 			Data.m_pPath = aPath;
-			fs_listdir(Data.m_pStorage->GetPath(Type, aPath, aBuf, sizeof(aBuf)), FindFilesCallback, Type, &Data);
+			Data.m_pStorage->ListPath(Data.m_pStorage->GetPath(Type, aPath, aBuf, sizeof(aBuf)), FindFilesCallback, Type, &Data);
 		}
 		else if(!str_comp(pName, Data.m_pFilename))
 		{
@@ -783,13 +828,13 @@ public:
 			// search within all available directories
 			for(int i = TYPE_SAVE; i < m_NumPaths; ++i)
 			{
-				fs_listdir(GetPath(i, pPath, aBuf, sizeof(aBuf)), FindFilesCallback, i, &Data);
+				ListPath(GetPath(i, pPath, aBuf, sizeof(aBuf)), FindFilesCallback, i, &Data);
 			}
 		}
 		else if(Type >= TYPE_SAVE && Type < m_NumPaths)
 		{
 			// search within wanted directory
-			fs_listdir(GetPath(Type, pPath, aBuf, sizeof(aBuf)), FindFilesCallback, Type, &Data);
+			ListPath(GetPath(Type, pPath, aBuf, sizeof(aBuf)), FindFilesCallback, Type, &Data);
 		}
 		else
 		{
@@ -868,7 +913,7 @@ public:
 	void GetCompletePath(int Type, const char *pDir, char *pBuffer, unsigned BufferSize) override
 	{
 		TranslateType(Type, pDir);
-		dbg_assert(Type >= TYPE_SAVE && Type < m_NumPaths, "Type invalid");
+		dbg_assert(Type == TYPE_ABSOLUTE || (Type >= TYPE_SAVE && Type < m_NumPaths), "Type invalid");
 		GetPath(Type, pDir, pBuffer, BufferSize);
 	}
 
@@ -955,6 +1000,7 @@ std::unique_ptr<IStorage> CreateTempStorage(const char *pDirectory, int NumArgs,
 {
 	dbg_assert(NumArgs > 0, "Expected at least one argument");
 	std::unique_ptr<CStorage> pStorage = std::make_unique<CStorage>();
+	pStorage->InitDirectoryIndex();
 	pStorage->FindDataDirectory(ppArguments[0]);
 	if(!pStorage->FindCurrentDirectory() ||
 		!pStorage->AddPath(pDirectory) ||
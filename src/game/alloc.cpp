@@ -0,0 +1,90 @@
+#include "alloc.h"
+
+#include <cinttypes>
+#include <cstdlib>
+
+CPoolAllocator *CPoolAllocator::ms_pFirst = nullptr;
+
+CPoolAllocator::CPoolAllocator(const char *pName, size_t ObjectSize, int SlabSize) :
+	m_pName(pName),
+	// keep the objects aligned and make them cover whole asan granules
+	m_ObjectSize((ObjectSize + 7) & ~(size_t)7),
+	m_SlabSize(SlabSize)
+{
+	dbg_assert(m_ObjectSize >= sizeof(void *), "object too small for the free list");
+	dbg_assert(m_SlabSize > 0, "slab size must be positive");
+	m_pNext = ms_pFirst;
+	ms_pFirst = this;
+}
+
+CPoolAllocator::~CPoolAllocator()
+{
+	for(CPoolAllocator **ppAllocator = &ms_pFirst; *ppAllocator; ppAllocator = &(*ppAllocator)->m_pNext)
+	{
+		if(*ppAllocator == this)
+		{
+			*ppAllocator = m_pNext;
+			break;
+		}
+	}
+
+	for(int i = 0; i < m_NumSlabs; i++)
+	{
+		ASAN_UNPOISON_MEMORY_REGION(m_ppSlabs[i], m_ObjectSize * m_SlabSize);
+		free(m_ppSlabs[i]);
+	}
+	free(m_ppSlabs);
+}
+
+void CPoolAllocator::AddSlab()
+{
+	void **ppSlabs = static_cast<void **>(realloc(m_ppSlabs, sizeof(void *) * (m_NumSlabs + 1)));
+	dbg_assert(ppSlabs != nullptr, "out of memory");
+	m_ppSlabs = ppSlabs;
+	char *pSlab = static_cast<char *>(malloc(m_ObjectSize * m_SlabSize));
+	dbg_assert(pSlab != nullptr, "out of memory");
+	m_ppSlabs[m_NumSlabs] = pSlab;
+	m_NumSlabs++;
+
+	// link the objects in address order, so they are handed out in it
+	for(int i = m_SlabSize - 1; i >= 0; i--)
+	{
+		void *pObj = pSlab + i * m_ObjectSize;
+		*(void **)pObj = m_pFreeList;
+		m_pFreeList = pObj;
+		ASAN_POISON_MEMORY_REGION((char *)pObj + sizeof(void *), m_ObjectSize - sizeof(void *));
+	}
+}
+
+void *CPoolAllocator::Allocate()
+{
+	if(!m_pFreeList)
+		AddSlab();
+
+	void *pObj = m_pFreeList;
+	ASAN_UNPOISON_MEMORY_REGION(pObj, m_ObjectSize);
+	m_pFreeList = *(void **)pObj;
+
+	m_NumUsed++;
+	if(m_NumUsed > m_PeakUsed)
+		m_PeakUsed = m_NumUsed;
+	m_NumAllocations++;
+	return pObj;
+}
+
+void CPoolAllocator::Free(void *pObj)
+{
+	if(!pObj)
+		return;
+
+	*(void **)pObj = m_pFreeList;
+	m_pFreeList = pObj;
+	ASAN_POISON_MEMORY_REGION((char *)pObj + sizeof(void *), m_ObjectSize - sizeof(void *));
+	m_NumUsed--;
+}
+
+void CPoolAllocator::Describe(char *pBuffer, size_t BufferSize) const
+{
+	str_format(pBuffer, BufferSize, "%s: used=%d peak=%d capacity=%d (%d KiB) allocations=%" PRIu64,
+		m_pName, m_NumUsed, m_PeakUsed, Capacity(), (int)(Capacity() * m_ObjectSize / 1024), m_NumAllocations);
+}
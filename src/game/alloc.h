@@ -5,6 +5,7 @@
 
 #include <base/system.h>
 
+#include <cstdint>
 #include <new>
 
 #ifndef __has_feature
@@ -34,6 +35,15 @@ public: \
 \
 private:
 
+// Allocates the objects of a type from a CPoolAllocator instead of the heap,
+// for types that are allocated and freed frequently. Not thread-safe.
+#define MACRO_ALLOC_POOL() \
+public: \
+	void *operator new(size_t Size); \
+	void operator delete(void *pObj); \
+\
+private:
+
 #define MACRO_ALLOC_POOL_ID() \
 public: \
 	void *operator new(size_t Size, int Id); \
@@ -48,6 +58,78 @@ private:
 #define MACRO_ALLOC_GET_SIZE(POOLTYPE) (sizeof(POOLTYPE))
 #endif
 
+/**
+ * Hands out memory for objects of one size from slabs of consecutive
+ * objects instead of allocating each object separately. Freed objects
+ * are reused, the slabs are only released on exit.
+ * Not thread-safe.
+ *
+ * @see MACRO_ALLOC_POOL_IMPL
+ */
+class CPoolAllocator
+{
+public:
+	CPoolAllocator(const char *pName, size_t ObjectSize, int SlabSize);
+	~CPoolAllocator();
+	CPoolAllocator(const CPoolAllocator &Other) = delete;
+	CPoolAllocator &operator=(const CPoolAllocator &Other) = delete;
+
+	void *Allocate();
+	void Free(void *pObj);
+
+	const char *Name() const { return m_pName; }
+	size_t ObjectSize() const { return m_ObjectSize; }
+	int NumUsed() const { return m_NumUsed; }
+	int PeakUsed() const { return m_PeakUsed; }
+	int Capacity() const { return m_NumSlabs * m_SlabSize; }
+	uint64_t NumAllocations() const { return m_NumAllocations; }
+
+	/**
+	 * Formats the name and the usage statistics for the console.
+	 */
+	void Describe(char *pBuffer, size_t BufferSize) const;
+
+	/**
+	 * All allocators of the program, in no particular order.
+	 */
+	static CPoolAllocator *First() { return ms_pFirst; }
+	CPoolAllocator *Next() const { return m_pNext; }
+
+private:
+	void AddSlab();
+
+	const char *m_pName;
+	size_t m_ObjectSize;
+	int m_SlabSize;
+
+	void *m_pFreeList = nullptr;
+	void **m_ppSlabs = nullptr;
+	int m_NumSlabs = 0;
+
+	int m_NumUsed = 0;
+	int m_PeakUsed = 0;
+	uint64_t m_NumAllocations = 0;
+
+	CPoolAllocator *m_pNext;
+	static CPoolAllocator *ms_pFirst;
+};
+
+// Objects are allocated from slabs of SlabSize objects, see CPoolAllocator.
+// Declared with MACRO_ALLOC_POOL().
+#define MACRO_ALLOC_POOL_IMPL(POOLTYPE, SlabSize) \
+	static CPoolAllocator gs_Pool##POOLTYPE(#POOLTYPE, sizeof(POOLTYPE), SlabSize); \
+	void *POOLTYPE::operator new(size_t Size) \
+	{ \
+		dbg_assert(sizeof(POOLTYPE) == Size, "size error"); \
+		void *pObj = gs_Pool##POOLTYPE.Allocate(); \
+		mem_zero(pObj, sizeof(POOLTYPE)); \
+		return pObj; \
+	} \
+	void POOLTYPE::operator delete(void *pObj) \
+	{ \
+		gs_Pool##POOLTYPE.Free(pObj); \
+	}
+
 #define MACRO_ALLOC_POOL_ID_IMPL(POOLTYPE, PoolSize) \
 	static char gs_PoolData##POOLTYPE[PoolSize][MACRO_ALLOC_GET_SIZE(POOLTYPE)] = {{0}}; \
 	static int gs_PoolUsed##POOLTYPE[PoolSize] = {0}; \
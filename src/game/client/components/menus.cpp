@@ -12,6 +12,7 @@
 #include <engine/client.h>
 #include <engine/client/updater.h>
 #include <engine/config.h>
+#include <engine/demo.h>
 #include <engine/editor.h>
 #include <engine/friends.h>
 #include <engine/gfx/image_manipulation.h>
@@ -1562,6 +1563,15 @@ void CMenus::RenderPopupFullscreen(CUIRect Screen)
 			}
 			else if(Storage()->RenameFile(aBufOld, aBufNew, m_vpFilteredDemos[m_DemolistSelectedIndex]->m_StorageType))
 			{
+				if(!m_vpFilteredDemos[m_DemolistSelectedIndex]->m_IsDir)
+				{
+					char aIndexOld[IO_MAX_PATH_LENGTH];
+					char aIndexNew[IO_MAX_PATH_LENGTH];
+					IDemoPlayer::IndexFilename(aBufOld, aIndexOld, sizeof(aIndexOld));
+					IDemoPlayer::IndexFilename(aBufNew, aIndexNew, sizeof(aIndexNew));
+					if(Storage()->FileExists(aIndexOld, m_vpFilteredDemos[m_DemolistSelectedIndex]->m_StorageType))
+						Storage()->RenameFile(aIndexOld, aIndexNew, m_vpFilteredDemos[m_DemolistSelectedIndex]->m_StorageType);
+				}
 				str_copy(m_aCurrentDemoSelectionName, m_DemoRenameInput.GetString());
 				if(!m_vpFilteredDemos[m_DemolistSelectedIndex]->m_IsDir)
 					fs_split_file_extension(m_DemoRenameInput.GetString(), m_aCurrentDemoSelectionName, sizeof(m_aCurrentDemoSelectionName));
@@ -1670,6 +1670,9 @@ void CMenus::PopupConfirmDeleteDemo()
 	str_format(aBuf, sizeof(aBuf), "%s/%s", m_aCurrentDemoFolder, m_vpFilteredDemos[m_DemolistSelectedIndex]->m_aFilename);
 	if(Storage()->RemoveFile(aBuf, m_vpFilteredDemos[m_DemolistSelectedIndex]->m_StorageType))
 	{
+		char aIndexFilename[IO_MAX_PATH_LENGTH];
+		IDemoPlayer::IndexFilename(aBuf, aIndexFilename, sizeof(aIndexFilename));
+		Storage()->RemoveFile(aIndexFilename, m_vpFilteredDemos[m_DemolistSelectedIndex]->m_StorageType);
 		DemolistPopulate();
 		DemolistOnUpdate(false);
 	}
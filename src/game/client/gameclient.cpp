@@ -72,11 +72,13 @@
 #include <generated/protocol7.h>
 #include <generated/protocolglue.h>
 
+#include <game/alloc.h>
 #include <game/client/projectile_data.h>
 #include <game/localization.h>
 #include <game/mapitems.h>
 #include <game/version.h>
 
+#include <algorithm>
 #include <chrono>
 #include <limits>
 
@@ -188,6 +190,7 @@ void CGameClient::OnConsoleInit()
 	Console()->Register("team", "i[team-id]", CFGFLAG_CLIENT, ConTeam, this, "Switch team");
 	Console()->Register("kill", "", CFGFLAG_CLIENT, ConKill, this, "Kill yourself to restart");
 	Console()->Register("ready_change", "", CFGFLAG_CLIENT, ConReadyChange7, this, "Change ready state (0.7 only)");
+	Console()->Register("entity_pools", "", CFGFLAG_CLIENT, ConEntityPools, this, "Shows the usage of the prediction entity allocators");
 
 	// register game commands to allow the client prediction to load settings from the map
 	Console()->Register("tune", "s[tuning] ?f[value]", CFGFLAG_GAME, ConTuneParam, this, "Tune variable to value");
@@ -302,6 +305,65 @@ void CGameClient::ForceUpdateConsoleRemoteCompletionSuggestions()
 	m_GameConsole.ForceUpdateRemoteCompletionSuggestions();
 }
 
+void CGameClient::SetRenderProfiling(bool Enable)
+{
+	m_vComponentRenderTime.clear();
+	if(Enable)
+		m_vComponentRenderTime.resize(m_vpAll.size(), 0);
+}
+
+std::vector<IGameClient::CRenderProfileEntry> CGameClient::RenderProfile() const
+{
+	// Components which are split into several parts are reported once
+	const std::pair<const CComponent *, const char *> aNames[] = {
+		{&m_Background, "background"},
+		{&m_MapLayersBackground, "maplayers"},
+		{&m_MapLayersForeground, "maplayers"},
+		{&m_Effects, "particles"},
+		{&m_Particles, "particles"},
+		{&m_Particles.m_RenderTrail, "particles"},
+		{&m_Particles.m_RenderTrailExtra, "particles"},
+		{&m_Particles.m_RenderExplosions, "particles"},
+		{&m_Particles.m_RenderExtra, "particles"},
+		{&m_Particles.m_RenderGeneral, "particles"},
+		{&m_Items, "items"},
+		{&m_Ghost, "ghost"},
+		{&m_Players, "players"},
+		{&m_NamePlates, "nameplates"},
+		{&m_FreezeBars, "freezebars"},
+		{&m_DamageInd, "damageind"},
+		{&m_Hud, "hud"},
+		{&m_InfoMessages, "infomessages"},
+		{&m_Chat, "chat"},
+		{&m_Broadcast, "broadcast"},
+		{&m_Scoreboard, "scoreboard"},
+		{&m_Statboard, "statboard"},
+		{&m_Menus, "menus"},
+		{&m_GameConsole, "console"},
+		{&m_MenuBackground, "menubackground"},
+	};
+
+	std::vector<CRenderProfileEntry> vEntries;
+	for(size_t i = 0; i < m_vComponentRenderTime.size(); i++)
+	{
+		const char *pName = "other";
+		for(const auto &[pComponent, pComponentName] : aNames)
+		{
+			if(pComponent == m_vpAll[i])
+			{
+				pName = pComponentName;
+				break;
+			}
+		}
+		auto Entry = std::find_if(vEntries.begin(), vEntries.end(), [pName](const CRenderProfileEntry &Other) { return str_comp(Other.m_pName, pName) == 0; });
+		if(Entry == vEntries.end())
+			vEntries.push_back({pName, m_vComponentRenderTime[i]});
+		else
+			Entry->m_Time += m_vComponentRenderTime[i];
+	}
+	return vEntries;
+}
+
 void CGameClient::OnInit()
 {
 	const int64_t OnInitStart = time_get();
@@ -831,8 +893,20 @@ void CGameClient::OnRender()
 	UpdateSpectatorCursor();
 
 	// render all systems
-	for(auto &pComponent : m_vpAll)
-		pComponent->OnRender();
+	if(m_vComponentRenderTime.empty())
+	{
+		for(auto &pComponent : m_vpAll)
+			pComponent->OnRender();
+	}
+	else
+	{
+		for(size_t i = 0; i < m_vpAll.size(); i++)
+		{
+			const int64_t StartTime = time_get();
+			m_vpAll[i]->OnRender();
+			m_vComponentRenderTime[i] += time_get() - StartTime;
+		}
+	}
 
 	// clear all events/input for this frame
 	Input()->Clear();
@@ -1372,9 +1446,10 @@ void CGameClient::ProcessEvents()
 	if(m_SuppressEvents)
 		return;
 
+	static const int s_aEventTypes[] = {NETEVENTTYPE_DAMAGEIND, NETEVENTTYPE_EXPLOSION, NETEVENTTYPE_HAMMERHIT, NETEVENTTYPE_BIRTHDAY, NETEVENTTYPE_FINISH, NETEVENTTYPE_SPAWN, NETEVENTTYPE_DEATH, NETEVENTTYPE_SOUNDWORLD, NETEVENTTYPE_MAPSOUNDWORLD};
+
 	int SnapType = IClient::SNAP_CURRENT;
-	int Num = Client()->SnapNumItems(SnapType);
-	for(int Index = 0; Index < Num; Index++)
+	for(int Index : SnapCollectItems(s_aEventTypes, std::size(s_aEventTypes)))
 	{
 		const IClient::CSnapItem Item = Client()->SnapGetItem(SnapType, Index);
 
@@ -1679,10 +1754,28 @@ void CGameClient::OnNewSnapshot()
 	{
 		m_Snap.m_aTeamSize[TEAM_RED] = m_Snap.m_aTeamSize[TEAM_BLUE] = 0;
 
-		int Num = Client()->SnapNumItems(IClient::SNAP_CURRENT);
-		for(int i = 0; i < Num; i++)
+		// Only the item types handled below
+		static const int s_aSnapTypes[] = {
+			NETOBJTYPE_GAMEINFO,
+			NETOBJTYPE_GAMEINFOEX,
+			NETOBJTYPE_MAPBESTTIME,
+			NETOBJTYPE_SWITCHSTATE,
+			NETOBJTYPE_GAMEDATA,
+			NETOBJTYPE_CLIENTINFO,
+			NETOBJTYPE_PLAYERINFO,
+			NETOBJTYPE_SPECTATORINFO,
+			NETOBJTYPE_DDNETSPECTATORINFO,
+			NETOBJTYPE_SPECTATORCOUNT,
+			NETOBJTYPE_DDNETPLAYER,
+			NETOBJTYPE_CHARACTER,
+			NETOBJTYPE_DDNETCHARACTER,
+			NETOBJTYPE_SPECCHAR,
+			NETOBJTYPE_FLAG,
+		};
+
+		for(int Index : SnapCollectItems(s_aSnapTypes, std::size(s_aSnapTypes)))
 		{
-			const IClient::CSnapItem Item = Client()->SnapGetItem(IClient::SNAP_CURRENT, i);
+			const IClient::CSnapItem Item = Client()->SnapGetItem(IClient::SNAP_CURRENT, Index);
 
 			if(Item.m_Type == NETOBJTYPE_CLIENTINFO)
 			{
@@ -3197,6 +3290,17 @@ void CGameClient::ConReadyChange7(IConsole::IResult *pResult, void *pUserData)
 		pClient->SendReadyChange7();
 }
 
+void CGameClient::ConEntityPools(IConsole::IResult *pResult, void *pUserData)
+{
+	CGameClient *pSelf = static_cast<CGameClient *>(pUserData);
+	char aBuf[256];
+	for(const CPoolAllocator *pPool = CPoolAllocator::First(); pPool; pPool = pPool->Next())
+	{
+		pPool->Describe(aBuf, sizeof(aBuf));
+		pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "pools", aBuf);
+	}
+}
+
 void CGameClient::ConchainLanguageUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
 {
 	CGameClient *pThis = static_cast<CGameClient *>(pUserData);
@@ -3729,12 +3833,12 @@ void CGameClient::DetectStrongHook()
 		{
 			CCharacterCore ToChar = pFromCharWorld->GetCore();
 			ToChar.Init(&World, Collision(), &m_Teams);
-			World.m_apCharacters[ToPlayer] = &ToChar;
+			World.SetCharacter(ToPlayer, &ToChar);
 			ToChar.Read(&m_Snap.m_aCharacters[ToPlayer].m_Prev);
 
 			CCharacterCore FromChar = pFromCharWorld->GetCore();
 			FromChar.Init(&World, Collision(), &m_Teams);
-			World.m_apCharacters[FromPlayer] = &FromChar;
+			World.SetCharacter(FromPlayer, &FromChar);
 			FromChar.Read(&m_Snap.m_aCharacters[FromPlayer].m_Prev);
 
 			for(int Tick = Client()->PrevGameTick(g_Config.m_ClDummy); Tick < Client()->GameTick(g_Config.m_ClDummy); Tick++)
@@ -4697,23 +4801,42 @@ protocol7::CNetObjHandler *CGameClient::GetNetObjHandler7()
 	return &m_NetObjHandler7;
 }
 
+const std::vector<int> &CGameClient::SnapCollectItems(const int *pTypes, int NumTypes)
+{
+	m_vSnapItemIndices.clear();
+	for(int i = 0; i < NumTypes; i++)
+	{
+		int Num;
+		const int *pIndices = Client()->SnapItemsOfType(IClient::SNAP_CURRENT, pTypes[i], &Num);
+		m_vSnapItemIndices.insert(m_vSnapItemIndices.end(), pIndices, pIndices + Num);
+	}
+	// handle the items in the order of the snapshot like a full scan would,
+	// e.g. events must not be reordered by type
+	std::sort(m_vSnapItemIndices.begin(), m_vSnapItemIndices.end());
+	return m_vSnapItemIndices;
+}
+
 void CGameClient::SnapCollectEntities()
 {
-	int NumSnapItems = Client()->SnapNumItems(IClient::SNAP_CURRENT);
+	static const int s_aEntityTypes[] = {NETOBJTYPE_PICKUP, NETOBJTYPE_DDNETPICKUP, NETOBJTYPE_LASER, NETOBJTYPE_DDNETLASER, NETOBJTYPE_PROJECTILE, NETOBJTYPE_DDRACEPROJECTILE, NETOBJTYPE_DDNETPROJECTILE};
 
 	std::vector<CSnapEntities> vItemData;
 	std::vector<CSnapEntities> vItemEx;
 
-	for(int Index = 0; Index < NumSnapItems; Index++)
+	for(int Type : s_aEntityTypes)
 	{
-		const IClient::CSnapItem Item = Client()->SnapGetItem(IClient::SNAP_CURRENT, Index);
-		if(Item.m_Type == NETOBJTYPE_ENTITYEX)
-			vItemEx.push_back({Item, nullptr});
-		else if(Item.m_Type == NETOBJTYPE_PICKUP || Item.m_Type == NETOBJTYPE_DDNETPICKUP || Item.m_Type == NETOBJTYPE_LASER || Item.m_Type == NETOBJTYPE_DDNETLASER || Item.m_Type == NETOBJTYPE_PROJECTILE || Item.m_Type == NETOBJTYPE_DDRACEPROJECTILE || Item.m_Type == NETOBJTYPE_DDNETPROJECTILE)
-			vItemData.push_back({Item, nullptr});
+		int Num;
+		const int *pIndices = Client()->SnapItemsOfType(IClient::SNAP_CURRENT, Type, &Num);
+		for(int i = 0; i < Num; i++)
+			vItemData.push_back({Client()->SnapGetItem(IClient::SNAP_CURRENT, pIndices[i]), nullptr});
 	}
 
-	// sort by id
+	int NumEx;
+	const int *pIndicesEx = Client()->SnapItemsOfType(IClient::SNAP_CURRENT, NETOBJTYPE_ENTITYEX, &NumEx);
+	for(int i = 0; i < NumEx; i++)
+		vItemEx.push_back({Client()->SnapGetItem(IClient::SNAP_CURRENT, pIndicesEx[i]), nullptr});
+
+	// sort by id, the items of one type are already ordered
 	class CEntComparer
 	{
 	public:
@@ -4724,7 +4847,6 @@ void CGameClient::SnapCollectEntities()
 	};
 
 	std::sort(vItemData.begin(), vItemData.end(), CEntComparer());
-	std::sort(vItemEx.begin(), vItemEx.end(), CEntComparer());
 
 	// merge extended items with items they belong to
 	m_vSnapEntities.clear();
@@ -189,6 +189,8 @@ public:
 private:
 	std::vector<class CComponent *> m_vpAll;
 	std::vector<class CComponent *> m_vpInput;
+	// Render time of each component in m_vpAll, empty if not profiling
+	std::vector<int64_t> m_vComponentRenderTime;
 	CNetObjHandler m_NetObjHandler;
 	protocol7::CNetObjHandler m_NetObjHandler7;
 
@@ -241,6 +243,7 @@ private:
 	static void ConTeam(IConsole::IResult *pResult, void *pUserData);
 	static void ConKill(IConsole::IResult *pResult, void *pUserData);
 	static void ConReadyChange7(IConsole::IResult *pResult, void *pUserData);
+	static void ConEntityPools(IConsole::IResult *pResult, void *pUserData);
 
 	static void ConchainLanguageUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainSpecialInfoupdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
@@ -622,6 +625,9 @@ public:
 
 	void ForceUpdateConsoleRemoteCompletionSuggestions() override;
 
+	void SetRenderProfiling(bool Enable) override;
+	std::vector<CRenderProfileEntry> RenderProfile() const override;
+
 	void RefreshSkin(const std::shared_ptr<CManagedTeeRenderInfo> &pManagedTeeRenderInfo);
 	void RefreshSkins(int SkinDescriptorFlags);
 	void OnSkinUpdate(const char *pSkinName);
@@ -888,6 +894,10 @@ public:
 private:
 	std::vector<CSnapEntities> m_vSnapEntities;
 	void SnapCollectEntities();
+	// Indices of the items of the current snapshot with one of the types,
+	// in snapshot order
+	std::vector<int> m_vSnapItemIndices;
+	const std::vector<int> &SnapCollectItems(const int *pTypes, int NumTypes);
 
 	bool m_aDDRaceMsgSent[NUM_DUMMIES];
 	int m_aShowOthers[NUM_DUMMIES];
@@ -7,6 +7,8 @@
 #include <game/collision.h>
 #include <game/mapitems.h>
 
+MACRO_ALLOC_POOL_IMPL(CDoor, 64)
+
 CDoor::CDoor(CGameWorld *pGameWorld, int Id, const CLaserData *pData) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_DOOR)
 {
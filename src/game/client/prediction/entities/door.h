@@ -8,6 +8,8 @@ class CLaserData;
 
 class CDoor : public CEntity
 {
+	MACRO_ALLOC_POOL()
+
 	vec2 m_To;
 	vec2 m_Direction;
 	int m_Length;
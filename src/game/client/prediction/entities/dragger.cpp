@@ -11,6 +11,8 @@
 #include <game/collision.h>
 #include <game/mapitems.h>
 
+MACRO_ALLOC_POOL_IMPL(CDragger, 32)
+
 void CDragger::Tick()
 {
 	if(GameWorld()->GameTick() % (int)(GameWorld()->GameTickSpeed() * 0.15f) == 0)
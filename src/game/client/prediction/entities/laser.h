@@ -9,6 +9,8 @@ class CLaserData;
 
 class CLaser : public CEntity
 {
+	MACRO_ALLOC_POOL()
+
 	friend class CGameWorld;
 
 public:
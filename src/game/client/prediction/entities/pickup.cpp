@@ -10,6 +10,8 @@
 #include <game/collision.h>
 #include <game/mapitems.h>
 
+MACRO_ALLOC_POOL_IMPL(CPickup, 64)
+
 static constexpr int gs_PickupPhysSize = 14;
 
 void CPickup::Tick()
@@ -7,6 +7,8 @@
 #include <game/collision.h>
 #include <game/mapitems.h>
 
+MACRO_ALLOC_POOL_IMPL(CPlasma, 32)
+
 const float PLASMA_ACCEL = 1.1f;
 
 CPlasma::CPlasma(CGameWorld *pGameWorld, int Id, const CLaserData *pData) :
@@ -8,6 +8,8 @@ class CLaserData;
 
 class CPlasma : public CEntity
 {
+	MACRO_ALLOC_POOL()
+
 	vec2 m_Core;
 	bool m_Freeze;
 	bool m_Explosive;
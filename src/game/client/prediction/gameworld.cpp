@@ -130,7 +130,7 @@ void CGameWorld::InsertEntity(CEntity *pEnt, bool Last)
 		if(Id >= 0 && Id < MAX_CLIENTS)
 		{
 			m_apCharacters[Id] = pChar;
-			m_Core.m_apCharacters[Id] = &pChar->m_Core;
+			m_Core.SetCharacter(Id, &pChar->m_Core);
 		}
 		pChar->SetCoreWorld(this);
 	}
@@ -157,6 +157,11 @@ void CGameWorld::RemoveEntity(CEntity *pEnt)
 	pEnt->m_pNextTypeEntity = nullptr;
 	pEnt->m_pPrevTypeEntity = nullptr;
 
+	UnlinkRelatives(pEnt);
+}
+
+void CGameWorld::UnlinkRelatives(CEntity *pEnt)
+{
 	if(pEnt->m_pParent)
 	{
 		if(m_IsValidCopy && m_pParent && m_pParent->m_pChild == this)
@@ -174,10 +179,10 @@ void CGameWorld::RemoveEntity(CEntity *pEnt)
 void CGameWorld::RemoveCharacter(CCharacter *pChar)
 {
 	int Id = pChar->GetCid();
-	if(Id >= 0 && Id < MAX_CLIENTS)
+	if(Id >= 0 && Id < MAX_CLIENTS && m_apCharacters[Id] == pChar)
 	{
 		m_apCharacters[Id] = nullptr;
-		m_Core.m_apCharacters[Id] = nullptr;
+		m_Core.SetCharacter(Id, nullptr);
 	}
 }
 
@@ -607,7 +612,7 @@ void CGameWorld::NetObjEnd()
 	for(int i = 0; i < MAX_CLIENTS; i++)
 	{
 		m_apCharacters[i] = nullptr;
-		m_Core.m_apCharacters[i] = nullptr;
+		m_Core.SetCharacter(i, nullptr);
 	}
 	for(CCharacter *pChar = (CCharacter *)FindFirst(ENTTYPE_CHARACTER); pChar; pChar = (CCharacter *)pChar->TypeNext())
 	{
@@ -615,11 +620,22 @@ void CGameWorld::NetObjEnd()
 		if(Id >= 0 && Id < MAX_CLIENTS)
 		{
 			m_apCharacters[Id] = pChar;
-			m_Core.m_apCharacters[Id] = &pChar->m_Core;
+			m_Core.SetCharacter(Id, &pChar->m_Core);
 		}
 	}
 }
 
+template<typename T>
+static CEntity *CloneEntity(CEntity *pFrom, CEntity *pReuse)
+{
+	if(pReuse)
+	{
+		*static_cast<T *>(pReuse) = *static_cast<T *>(pFrom);
+		return pReuse;
+	}
+	return new T(*static_cast<T *>(pFrom));
+}
+
 void CGameWorld::CopyWorld(CGameWorld *pFrom)
 {
 	if(pFrom == this || !pFrom)
@@ -637,37 +653,67 @@ void CGameWorld::CopyWorld(CGameWorld *pFrom)
 	m_pMapBugs = pFrom->m_pMapBugs;
 	m_Teams = pFrom->m_Teams;
 	m_Core.m_vSwitchers = pFrom->m_Core.m_vSwitchers;
-	// delete the previous entities
-	Clear();
 	for(int i = 0; i < MAX_CLIENTS; i++)
 	{
 		m_apCharacters[i] = nullptr;
-		m_Core.m_apCharacters[i] = nullptr;
+		m_Core.SetCharacter(i, nullptr);
+	}
+	// Take the previous entities out of the world. They are overwritten with
+	// the copies instead of deleting and reallocating them, as this runs
+	// several times per predicted frame.
+	CEntity *apReuse[NUM_ENTTYPES];
+	for(int Type = 0; Type < NUM_ENTTYPES; Type++)
+	{
+		for(CEntity *pEnt = m_apFirstEntityTypes[Type]; pEnt; pEnt = pEnt->m_pNextTypeEntity)
+			UnlinkRelatives(pEnt);
+		apReuse[Type] = m_apFirstEntityTypes[Type];
+		m_apFirstEntityTypes[Type] = nullptr;
 	}
 	// copy and add the new entities
 	for(int Type = 0; Type < NUM_ENTTYPES; Type++)
 	{
 		for(CEntity *pEnt = pFrom->FindLast(Type); pEnt; pEnt = pEnt->TypePrev())
 		{
+			CEntity *pReuse = apReuse[Type];
+			if(pReuse)
+				apReuse[Type] = pReuse->m_pNextTypeEntity;
+
 			CEntity *pCopy = nullptr;
 			if(Type == ENTTYPE_PROJECTILE)
-				pCopy = new CProjectile(*((CProjectile *)pEnt));
+				pCopy = CloneEntity<CProjectile>(pEnt, pReuse);
 			else if(Type == ENTTYPE_LASER)
-				pCopy = new CLaser(*((CLaser *)pEnt));
+				pCopy = CloneEntity<CLaser>(pEnt, pReuse);
 			else if(Type == ENTTYPE_DRAGGER)
-				pCopy = new CDragger(*((CDragger *)pEnt));
+				pCopy = CloneEntity<CDragger>(pEnt, pReuse);
 			else if(Type == ENTTYPE_CHARACTER)
-				pCopy = new CCharacter(*((CCharacter *)pEnt));
+				pCopy = CloneEntity<CCharacter>(pEnt, pReuse);
 			else if(Type == ENTTYPE_PICKUP)
-				pCopy = new CPickup(*((CPickup *)pEnt));
+				pCopy = CloneEntity<CPickup>(pEnt, pReuse);
 			else if(Type == ENTTYPE_PLASMA)
-				pCopy = new CPlasma(*((CPlasma *)pEnt));
+				pCopy = CloneEntity<CPlasma>(pEnt, pReuse);
 			if(pCopy)
 			{
 				pCopy->m_pParent = pEnt;
 				pEnt->m_pChild = pCopy;
 				this->InsertEntity(pCopy);
 			}
+			else if(pReuse)
+			{
+				apReuse[Type] = pReuse;
+				break;
+			}
+		}
+	}
+	// delete the previous entities that were not reused
+	for(auto *pEnt : apReuse)
+	{
+		while(pEnt)
+		{
+			CEntity *pNext = pEnt->m_pNextTypeEntity;
+			pEnt->m_pNextTypeEntity = nullptr;
+			pEnt->m_pPrevTypeEntity = nullptr;
+			delete pEnt;
+			pEnt = pNext;
 		}
 	}
 	m_IsValidCopy = true;
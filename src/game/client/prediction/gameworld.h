@@ -112,6 +112,7 @@ public:
 
 private:
 	void RemoveEntities();
+	void UnlinkRelatives(CEntity *pEnt);
 
 	CEntity *m_pNextTraverseEntity = nullptr;
 	CEntity *m_apFirstEntityTypes[NUM_ENTTYPES];
@@ -36,6 +36,8 @@ vec2 ClampVel(int MoveRestriction, vec2 Vel)
 	return Vel;
 }
 
+const CTileFeatures CCollision::ms_EmptyTileFeatures = {};
+
 CCollision::CCollision()
 {
 	m_pDoor = nullptr;
@@ -119,6 +121,8 @@ void CCollision::Init(class CLayers *pLayers)
 		}
 	}
 
+	CompileTileFeatures();
+
 	if(m_pTele)
 	{
 		for(int i = 0; i < m_Width * m_Height; i++)
@@ -148,6 +152,46 @@ void CCollision::Init(class CLayers *pLayers)
 	}
 }
 
+void CCollision::CompileTileFeatures()
+{
+	if(!m_pTele && !m_pSpeedup && !m_pSwitch && !m_pTune)
+		return;
+
+	m_vTileFeatures.resize((size_t)m_Width * m_Height);
+	for(int i = 0; i < m_Width * m_Height; i++)
+	{
+		CTileFeatures &Features = m_vTileFeatures[i];
+		if(m_pTele)
+		{
+			Features.m_TeleType = m_pTele[i].m_Type;
+			Features.m_TeleNumber = m_pTele[i].m_Number;
+			if(Features.m_TeleType == TILE_TELEIN || Features.m_TeleType == TILE_TELEINEVIL || Features.m_TeleType == TILE_TELECHECKINEVIL || Features.m_TeleType == TILE_TELECHECK || Features.m_TeleType == TILE_TELECHECKIN)
+				Features.m_Flags |= CTileFeatures::FLAG_EXISTS;
+		}
+		if(m_pSpeedup)
+		{
+			Features.m_SpeedupForce = m_pSpeedup[i].m_Force;
+			Features.m_SpeedupMaxSpeed = m_pSpeedup[i].m_MaxSpeed;
+			Features.m_SpeedupType = m_pSpeedup[i].m_Type;
+			Features.m_SpeedupAngle = m_pSpeedup[i].m_Angle;
+			if(Features.m_SpeedupForce > 0)
+				Features.m_Flags |= CTileFeatures::FLAG_EXISTS;
+		}
+		if(m_pSwitch && m_pSwitch[i].m_Type > 0)
+		{
+			Features.m_SwitchType = m_pSwitch[i].m_Type;
+			Features.m_SwitchNumber = m_pSwitch[i].m_Number;
+			Features.m_SwitchDelay = m_pSwitch[i].m_Delay;
+			Features.m_Flags |= CTileFeatures::FLAG_EXISTS;
+		}
+		if(m_pTune && m_pTune[i].m_Type)
+		{
+			Features.m_TuneZone = m_pTune[i].m_Number;
+			Features.m_Flags |= CTileFeatures::FLAG_EXISTS;
+		}
+	}
+}
+
 void CCollision::Unload()
 {
 	m_pTiles = nullptr;
@@ -167,6 +211,7 @@ void CCollision::Unload()
 	m_pFront = nullptr;
 	m_pSwitch = nullptr;
 	m_pTune = nullptr;
+	m_vTileFeatures.clear();
 	delete[] m_pDoor;
 	m_pDoor = nullptr;
 }
@@ -647,84 +692,62 @@ int CCollision::IsFrontNoLaser(int x, int y) const
 
 int CCollision::IsTeleport(int Index) const
 {
-	if(Index < 0 || !m_pTele)
-		return 0;
-
-	if(m_pTele[Index].m_Type == TILE_TELEIN)
-		return m_pTele[Index].m_Number;
+	const CTileFeatures &Features = GetTileFeatures(Index);
+	if(Features.m_TeleType == TILE_TELEIN)
+		return Features.m_TeleNumber;
 
 	return 0;
 }
 
 int CCollision::IsEvilTeleport(int Index) const
 {
-	if(Index < 0)
-		return 0;
-	if(!m_pTele)
-		return 0;
-
-	if(m_pTele[Index].m_Type == TILE_TELEINEVIL)
-		return m_pTele[Index].m_Number;
+	const CTileFeatures &Features = GetTileFeatures(Index);
+	if(Features.m_TeleType == TILE_TELEINEVIL)
+		return Features.m_TeleNumber;
 
 	return 0;
 }
 
 bool CCollision::IsCheckTeleport(int Index) const
 {
-	if(Index < 0 || !m_pTele)
-		return false;
-	return m_pTele[Index].m_Type == TILE_TELECHECKIN;
+	return GetTileFeatures(Index).m_TeleType == TILE_TELECHECKIN;
 }
 
 bool CCollision::IsCheckEvilTeleport(int Index) const
 {
-	if(Index < 0 || !m_pTele)
-		return false;
-	return m_pTele[Index].m_Type == TILE_TELECHECKINEVIL;
+	return GetTileFeatures(Index).m_TeleType == TILE_TELECHECKINEVIL;
 }
 
 int CCollision::IsTeleCheckpoint(int Index) const
 {
-	if(Index < 0)
-		return 0;
-
-	if(!m_pTele)
-		return 0;
-
-	if(m_pTele[Index].m_Type == TILE_TELECHECK)
-		return m_pTele[Index].m_Number;
+	const CTileFeatures &Features = GetTileFeatures(Index);
+	if(Features.m_TeleType == TILE_TELECHECK)
+		return Features.m_TeleNumber;
 
 	return 0;
 }
 
 int CCollision::IsTeleportWeapon(int Index) const
 {
-	if(Index < 0 || !m_pTele)
-		return 0;
-
-	if(m_pTele[Index].m_Type == TILE_TELEINWEAPON)
-		return m_pTele[Index].m_Number;
+	const CTileFeatures &Features = GetTileFeatures(Index);
+	if(Features.m_TeleType == TILE_TELEINWEAPON)
+		return Features.m_TeleNumber;
 
 	return 0;
 }
 
 int CCollision::IsTeleportHook(int Index) const
 {
-	if(Index < 0 || !m_pTele)
-		return 0;
-
-	if(m_pTele[Index].m_Type == TILE_TELEINHOOK)
-		return m_pTele[Index].m_Number;
+	const CTileFeatures &Features = GetTileFeatures(Index);
+	if(Features.m_TeleType == TILE_TELEINHOOK)
+		return Features.m_TeleNumber;
 
 	return 0;
 }
 
 int CCollision::IsSpeedup(int Index) const
 {
-	if(Index < 0 || !m_pSpeedup)
-		return 0;
-
-	if(m_pSpeedup[Index].m_Force > 0)
+	if(GetTileFeatures(Index).m_SpeedupForce > 0)
 		return Index;
 
 	return 0;
@@ -732,58 +755,35 @@ int CCollision::IsSpeedup(int Index) const
 
 int CCollision::IsTune(int Index) const
 {
-	if(Index < 0 || !m_pTune)
-		return 0;
-
-	if(m_pTune[Index].m_Type)
-		return m_pTune[Index].m_Number;
-
-	return 0;
+	return GetTileFeatures(Index).m_TuneZone;
 }
 
 void CCollision::GetSpeedup(int Index, vec2 *pDir, int *pForce, int *pMaxSpeed, int *pType) const
 {
 	if(Index < 0 || !m_pSpeedup)
 		return;
-	float Angle = m_pSpeedup[Index].m_Angle * (pi / 180.0f);
-	*pForce = m_pSpeedup[Index].m_Force;
-	*pType = m_pSpeedup[Index].m_Type;
+	const CTileFeatures &Features = GetTileFeatures(Index);
+	float Angle = Features.m_SpeedupAngle * (pi / 180.0f);
+	*pForce = Features.m_SpeedupForce;
+	*pType = Features.m_SpeedupType;
 	*pDir = direction(Angle);
 	if(pMaxSpeed)
-		*pMaxSpeed = m_pSpeedup[Index].m_MaxSpeed;
+		*pMaxSpeed = Features.m_SpeedupMaxSpeed;
 }
 
 int CCollision::GetSwitchType(int Index) const
 {
-	if(Index < 0 || !m_pSwitch)
-		return 0;
-
-	if(m_pSwitch[Index].m_Type > 0)
-		return m_pSwitch[Index].m_Type;
-
-	return 0;
+	return GetTileFeatures(Index).m_SwitchType;
 }
 
 int CCollision::GetSwitchNumber(int Index) const
 {
-	if(Index < 0 || !m_pSwitch)
-		return 0;
-
-	if(m_pSwitch[Index].m_Type > 0 && m_pSwitch[Index].m_Number > 0)
-		return m_pSwitch[Index].m_Number;
-
-	return 0;
+	return GetTileFeatures(Index).m_SwitchNumber;
 }
 
 int CCollision::GetSwitchDelay(int Index) const
 {
-	if(Index < 0 || !m_pSwitch)
-		return 0;
-
-	if(m_pSwitch[Index].m_Type > 0)
-		return m_pSwitch[Index].m_Delay;
-
-	return 0;
+	return GetTileFeatures(Index).m_SwitchDelay;
 }
 
 int CCollision::MoverSpeed(int x, int y, vec2 *pSpeed) const
@@ -844,16 +844,10 @@ bool CCollision::TileExists(int Index) const
 		return true;
 	if(m_pFront && ((m_pFront[Index].m_Index >= TILE_FREEZE && m_pFront[Index].m_Index <= TILE_TELE_LASER_DISABLE) || (m_pFront[Index].m_Index >= TILE_LFREEZE && m_pFront[Index].m_Index <= TILE_LUNFREEZE)))
 		return true;
-	if(m_pTele && (m_pTele[Index].m_Type == TILE_TELEIN || m_pTele[Index].m_Type == TILE_TELEINEVIL || m_pTele[Index].m_Type == TILE_TELECHECKINEVIL || m_pTele[Index].m_Type == TILE_TELECHECK || m_pTele[Index].m_Type == TILE_TELECHECKIN))
-		return true;
-	if(m_pSpeedup && m_pSpeedup[Index].m_Force > 0)
+	if(GetTileFeatures(Index).m_Flags & CTileFeatures::FLAG_EXISTS)
 		return true;
 	if(m_pDoor && m_pDoor[Index].m_Index)
 		return true;
-	if(m_pSwitch && m_pSwitch[Index].m_Type)
-		return true;
-	if(m_pTune && m_pTune[Index].m_Type)
-		return true;
 	return TileExistsNext(Index);
 }
 
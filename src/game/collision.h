@@ -31,6 +31,35 @@ vec2 ClampVel(int MoveRestriction, vec2 Vel);
 typedef bool (*CALLBACK_SWITCHACTIVE)(int Number, void *pUser);
 struct CAntibotMapData;
 
+/**
+ * Tele, speedup, switch and tune data of one tile, compiled from the
+ * separate layers when the map is loaded, so that a tile is handled with
+ * a single lookup instead of one per layer.
+ */
+class CTileFeatures
+{
+public:
+	enum
+	{
+		// The tile has any tele, speedup, switch or tune data that makes it exist for GetMapIndices
+		FLAG_EXISTS = 1 << 0,
+	};
+
+	unsigned char m_Flags;
+	unsigned char m_TeleType;
+	unsigned char m_TeleNumber;
+	// The switch number and delay are only set if the switch type is set
+	unsigned char m_SwitchType;
+	unsigned char m_SwitchNumber;
+	unsigned char m_SwitchDelay;
+	// Zero if the tune tile has no type
+	unsigned char m_TuneZone;
+	unsigned char m_SpeedupForce;
+	unsigned char m_SpeedupMaxSpeed;
+	unsigned char m_SpeedupType;
+	short m_SpeedupAngle;
+};
+
 class CCollision
 {
 public:
@@ -98,6 +127,14 @@ public:
 	int GetSwitchType(int Index) const;
 	int GetSwitchNumber(int Index) const;
 	int GetSwitchDelay(int Index) const;
+	/**
+	 * @return The compiled data of the tile, all zero for tiles outside
+	 *         the map and maps without tele, speedup, switch or tune layer.
+	 */
+	const CTileFeatures &GetTileFeatures(int Index) const
+	{
+		return Index < 0 || m_vTileFeatures.empty() ? ms_EmptyTileFeatures : m_vTileFeatures[Index];
+	}
 
 	int IsSolid(int x, int y) const;
 	bool IsThrough(int x, int y, int OffsetX, int OffsetY, vec2 Pos0, vec2 Pos1) const;
@@ -158,6 +195,10 @@ private:
 	CTuneTile *m_pTune;
 	CDoorTile *m_pDoor;
 
+	std::vector<CTileFeatures> m_vTileFeatures;
+	static const CTileFeatures ms_EmptyTileFeatures;
+	void CompileTileFeatures();
+
 	// TILE_TELEIN
 	std::map<int, std::vector<vec2>> m_TeleIns;
 	// TILE_TELEOUT
@@ -0,0 +1,717 @@
+#include "auto_map_rules.h"
+
+#include <base/system.h>
+#include <base/tl/threading.h>
+
+#include <engine/engine.h>
+#include <engine/shared/jobs.h>
+#include <engine/shared/linereader.h>
+
+#include <game/editor/enums.h>
+#include <game/mapitems.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio> // sscanf
+#include <memory>
+#include <thread>
+
+// Based on triple32inc from https://github.com/skeeto/hash-prospector/tree/79a6074062a84907df6e45b756134b74e2956760
+static uint32_t HashUInt32(uint32_t Num)
+{
+	Num++;
+	Num ^= Num >> 17;
+	Num *= 0xed5ad4bbu;
+	Num ^= Num >> 11;
+	Num *= 0xac4c1b51u;
+	Num ^= Num >> 15;
+	Num *= 0x31848babu;
+	Num ^= Num >> 14;
+	return Num;
+}
+
+#define HASH_MAX 65536
+
+static int HashLocation(uint32_t Seed, uint32_t Run, uint32_t Rule, uint32_t X, uint32_t Y)
+{
+	const uint32_t Prime = 31;
+	uint32_t Hash = 1;
+	Hash = Hash * Prime + HashUInt32(Seed);
+	Hash = Hash * Prime + HashUInt32(Run);
+	Hash = Hash * Prime + HashUInt32(Rule);
+	Hash = Hash * Prime + HashUInt32(X);
+	Hash = Hash * Prime + HashUInt32(Y);
+	Hash = HashUInt32(Hash * Prime); // Just to double-check that values are well-distributed
+	return Hash % HASH_MAX;
+}
+
+void CAutoMapRules::LoadRules(CLineReader &LineReader)
+{
+	CConfiguration *pCurrentConf = nullptr;
+	CRun *pCurrentRun = nullptr;
+	CIndexRule *pCurrentIndex = nullptr;
+
+	// read each line
+	while(const char *pLine = LineReader.Get())
+	{
+		// skip blank/empty lines as well as comments
+		if(str_length(pLine) > 0 && pLine[0] != '#' && pLine[0] != '\n' && pLine[0] != '\r' && pLine[0] != '\t' && pLine[0] != '\v' && pLine[0] != ' ')
+		{
+			if(pLine[0] == '[')
+			{
+				// new configuration, get the name
+				pLine++;
+				CConfiguration NewConf;
+				NewConf.m_aName[0] = '\0';
+				NewConf.m_StartX = 0;
+				NewConf.m_StartY = 0;
+				NewConf.m_EndX = 0;
+				NewConf.m_EndY = 0;
+				m_vConfigs.push_back(NewConf);
+				int ConfigurationId = m_vConfigs.size() - 1;
+				pCurrentConf = &m_vConfigs[ConfigurationId];
+				str_copy(pCurrentConf->m_aName, pLine, minimum<int>(sizeof(pCurrentConf->m_aName), str_length(pLine)));
+
+				// add start run
+				CRun NewRun;
+				NewRun.m_AutomapCopy = true;
+				pCurrentConf->m_vRuns.push_back(NewRun);
+				int RunId = pCurrentConf->m_vRuns.size() - 1;
+				pCurrentRun = &pCurrentConf->m_vRuns[RunId];
+			}
+			else if(str_startswith(pLine, "NewRun") && pCurrentConf)
+			{
+				// add new run
+				CRun NewRun;
+				NewRun.m_AutomapCopy = true;
+				pCurrentConf->m_vRuns.push_back(NewRun);
+				int RunId = pCurrentConf->m_vRuns.size() - 1;
+				pCurrentRun = &pCurrentConf->m_vRuns[RunId];
+			}
+			else if(str_startswith(pLine, "Index") && pCurrentRun)
+			{
+				// new index
+				CIndexRule NewIndexRule;
+
+				char aOrientation1[128] = "";
+				char aOrientation2[128] = "";
+				char aOrientation3[128] = "";
+
+				sscanf(pLine, "Index %d %127s %127s %127s", &NewIndexRule.m_Id, aOrientation1, aOrientation2, aOrientation3);
+
+				NewIndexRule.m_Flag = 0;
+				NewIndexRule.m_RandomProbability = 1.0f;
+				NewIndexRule.m_DefaultRule = true;
+				NewIndexRule.m_SkipEmpty = false;
+				NewIndexRule.m_SkipFull = false;
+
+				if(str_length(aOrientation1) > 0)
+					NewIndexRule.m_Flag = CheckIndexFlag(NewIndexRule.m_Flag, aOrientation1, false);
+
+				if(str_length(aOrientation2) > 0)
+					NewIndexRule.m_Flag = CheckIndexFlag(NewIndexRule.m_Flag, aOrientation2, false);
+
+				if(str_length(aOrientation3) > 0)
+					NewIndexRule.m_Flag = CheckIndexFlag(NewIndexRule.m_Flag, aOrientation3, false);
+
+				// add the index rule object and make it current
+				pCurrentRun->m_vIndexRules.push_back(NewIndexRule);
+				int IndexRuleId = pCurrentRun->m_vIndexRules.size() - 1;
+				pCurrentIndex = &pCurrentRun->m_vIndexRules[IndexRuleId];
+			}
+			else if(str_startswith(pLine, "Pos") && pCurrentIndex)
+			{
+				int x = 0, y = 0;
+				char aValue[128];
+				int Value = CPosRule::NORULE;
+				std::vector<CIndexInfo> vNewIndexList;
+
+				sscanf(pLine, "Pos %d %d %127s", &x, &y, aValue);
+
+				if(!str_comp(aValue, "EMPTY"))
+				{
+					Value = CPosRule::INDEX;
+					CIndexInfo NewIndexInfo = {0, 0, false};
+					vNewIndexList.push_back(NewIndexInfo);
+				}
+				else if(!str_comp(aValue, "FULL"))
+				{
+					Value = CPosRule::NOTINDEX;
+					CIndexInfo NewIndexInfo1 = {0, 0, false};
+					// CIndexInfo NewIndexInfo2 = {-1, 0};
+					vNewIndexList.push_back(NewIndexInfo1);
+					// vNewIndexList.push_back(NewIndexInfo2);
+				}
+				else if(!str_comp(aValue, "INDEX") || !str_comp(aValue, "NOTINDEX"))
+				{
+					if(!str_comp(aValue, "INDEX"))
+						Value = CPosRule::INDEX;
+					else
+						Value = CPosRule::NOTINDEX;
+
+					int pWord = 4;
+					while(true)
+					{
+						CIndexInfo NewIndexInfo;
+
+						char aOrientation1[128] = "";
+						char aOrientation2[128] = "";
+						char aOrientation3[128] = "";
+						char aOrientation4[128] = "";
+						sscanf(str_trim_words(pLine, pWord), "%d %127s %127s %127s %127s", &NewIndexInfo.m_Id, aOrientation1, aOrientation2, aOrientation3, aOrientation4);
+
+						NewIndexInfo.m_Flag = 0;
+						NewIndexInfo.m_TestFlag = false;
+
+						if(!str_comp(aOrientation1, "OR"))
+						{
+							vNewIndexList.push_back(NewIndexInfo);
+							pWord += 2;
+							continue;
+						}
+						else if(str_length(aOrientation1) > 0)
+						{
+							NewIndexInfo.m_Flag = CheckIndexFlag(NewIndexInfo.m_Flag, aOrientation1, true);
+							NewIndexInfo.m_TestFlag = !(NewIndexInfo.m_Flag == 0 && str_comp(aOrientation1, "NONE"));
+						}
+						else
+						{
+							vNewIndexList.push_back(NewIndexInfo);
+							break;
+						}
+
+						if(!str_comp(aOrientation2, "OR"))
+						{
+							vNewIndexList.push_back(NewIndexInfo);
+							pWord += 3;
+							continue;
+						}
+						else if(str_length(aOrientation2) > 0 && NewIndexInfo.m_Flag != 0)
+						{
+							NewIndexInfo.m_Flag = CheckIndexFlag(NewIndexInfo.m_Flag, aOrientation2, false);
+						}
+						else
+						{
+							vNewIndexList.push_back(NewIndexInfo);
+							break;
+						}
+
+						if(!str_comp(aOrientation3, "OR"))
+						{
+							vNewIndexList.push_back(NewIndexInfo);
+							pWord += 4;
+							continue;
+						}
+						else if(str_length(aOrientation3) > 0 && NewIndexInfo.m_Flag != 0)
+						{
+							NewIndexInfo.m_Flag = CheckIndexFlag(NewIndexInfo.m_Flag, aOrientation3, false);
+						}
+						else
+						{
+							vNewIndexList.push_back(NewIndexInfo);
+							break;
+						}
+
+						if(!str_comp(aOrientation4, "OR"))
+						{
+							vNewIndexList.push_back(NewIndexInfo);
+							pWord += 5;
+							continue;
+						}
+						else
+						{
+							vNewIndexList.push_back(NewIndexInfo);
+							break;
+						}
+					}
+				}
+
+				if(Value != CPosRule::NORULE)
+				{
+					CPosRule NewPosRule = {x, y, Value, vNewIndexList};
+					pCurrentIndex->m_vRules.push_back(NewPosRule);
+
+					pCurrentConf->m_StartX = minimum(pCurrentConf->m_StartX, NewPosRule.m_X);
+					pCurrentConf->m_StartY = minimum(pCurrentConf->m_StartY, NewPosRule.m_Y);
+					pCurrentConf->m_EndX = maximum(pCurrentConf->m_EndX, NewPosRule.m_X);
+					pCurrentConf->m_EndY = maximum(pCurrentConf->m_EndY, NewPosRule.m_Y);
+
+					if(x == 0 && y == 0)
+					{
+						for(const auto &Index : vNewIndexList)
+						{
+							if(Index.m_Id == 0 && Value == CPosRule::INDEX)
+							{
+								// Skip full tiles if we have a rule "POS 0 0 INDEX 0"
+								// because that forces the tile to be empty
+								pCurrentIndex->m_SkipFull = true;
+							}
+							else if((Index.m_Id > 0 && Value == CPosRule::INDEX) || (Index.m_Id == 0 && Value == CPosRule::NOTINDEX))
+							{
+								// Skip empty tiles if we have a rule "POS 0 0 INDEX i" where i > 0
+								// or if we have a rule "POS 0 0 NOTINDEX 0"
+								pCurrentIndex->m_SkipEmpty = true;
+							}
+						}
+					}
+				}
+			}
+			else if(str_startswith(pLine, "Random") && pCurrentIndex)
+			{
+				float Value;
+				char Specifier = ' ';
+				sscanf(pLine, "Random %f%c", &Value, &Specifier);
+				if(Specifier == '%')
+				{
+					pCurrentIndex->m_RandomProbability = Value / 100.0f;
+				}
+				else
+				{
+					pCurrentIndex->m_RandomProbability = 1.0f / Value;
+				}
+			}
+			else if(str_startswith(pLine, "Modulo") && pCurrentIndex)
+			{
+				CModuloRule NewModuloRule;
+				sscanf(pLine, "Modulo %d %d %d %d", &NewModuloRule.m_ModX, &NewModuloRule.m_ModY, &NewModuloRule.m_OffsetX, &NewModuloRule.m_OffsetY);
+				if(NewModuloRule.m_ModX == 0)
+					NewModuloRule.m_ModX = 1;
+				if(NewModuloRule.m_ModY == 0)
+					NewModuloRule.m_ModY = 1;
+				pCurrentIndex->m_vModuloRules.push_back(NewModuloRule);
+			}
+			else if(str_startswith(pLine, "NoDefaultRule") && pCurrentIndex)
+			{
+				pCurrentIndex->m_DefaultRule = false;
+			}
+			else if(str_startswith(pLine, "NoLayerCopy") && pCurrentRun)
+			{
+				pCurrentRun->m_AutomapCopy = false;
+			}
+		}
+	}
+
+	// add default rule for Pos 0 0 if there is none
+	for(auto &Config : m_vConfigs)
+	{
+		for(auto &Run : Config.m_vRuns)
+		{
+			for(auto &IndexRule : Run.m_vIndexRules)
+			{
+				bool Found = false;
+
+				// Search for the exact rule "POS 0 0 INDEX 0" which corresponds to the default rule
+				for(const auto &Rule : IndexRule.m_vRules)
+				{
+					if(Rule.m_X == 0 && Rule.m_Y == 0 && Rule.m_Value == CPosRule::INDEX)
+					{
+						for(const auto &Index : Rule.m_vIndexList)
+						{
+							if(Index.m_Id == 0)
+								Found = true;
+						}
+						break;
+					}
+
+					if(Found)
+						break;
+				}
+
+				// If the default rule was not found, and we require it, then add it
+				if(!Found && IndexRule.m_DefaultRule)
+				{
+					std::vector<CIndexInfo> vNewIndexList;
+					CIndexInfo NewIndexInfo = {0, 0, false};
+					vNewIndexList.push_back(NewIndexInfo);
+					CPosRule NewPosRule = {0, 0, CPosRule::NOTINDEX, vNewIndexList};
+					IndexRule.m_vRules.push_back(NewPosRule);
+
+					IndexRule.m_SkipEmpty = true;
+					IndexRule.m_SkipFull = false;
+				}
+
+				if(IndexRule.m_SkipEmpty && IndexRule.m_SkipFull)
+				{
+					IndexRule.m_SkipEmpty = false;
+					IndexRule.m_SkipFull = false;
+				}
+			}
+		}
+	}
+
+	m_FileLoaded = true;
+}
+
+void CAutoMapRules::Unload()
+{
+	m_FileLoaded = false;
+	m_vConfigs.clear();
+}
+
+int CAutoMapRules::CheckIndexFlag(int Flag, const char *pFlag, bool CheckNone) const
+{
+	if(!str_comp(pFlag, "XFLIP"))
+		Flag |= TILEFLAG_XFLIP;
+	else if(!str_comp(pFlag, "YFLIP"))
+		Flag |= TILEFLAG_YFLIP;
+	else if(!str_comp(pFlag, "ROTATE"))
+		Flag |= TILEFLAG_ROTATE;
+	else if(!str_comp(pFlag, "NONE") && CheckNone)
+		Flag = 0;
+
+	return Flag;
+}
+
+const char *CAutoMapRules::GetConfigName(int Index) const
+{
+	if(Index < 0 || Index >= (int)m_vConfigs.size())
+	{
+		return "(unknown)";
+	}
+	return m_vConfigs[Index].m_aName;
+}
+
+void CAutoMapRules::ProceedTilesLocalized(CTile *pTiles, int LayerWidth, int LayerHeight, CTile *pGameTiles, int GameWidth, int ReferenceId, int ConfigId, int Seed, int X, int Y, int Width, int Height, IEngine *pEngine, const TRecordChangeFunc &RecordChange, const TRecordChangeFunc &RecordGameChange) const
+{
+	if(!m_FileLoaded || ConfigId < 0 || ConfigId >= (int)m_vConfigs.size())
+		return;
+
+	if(Width < 0)
+		Width = LayerWidth;
+
+	if(Height < 0)
+		Height = LayerHeight;
+
+	const CConfiguration *pConf = &m_vConfigs[ConfigId];
+	const int NumRuns = pConf->m_vRuns.size();
+
+	int CommitFromX = std::clamp(X + pConf->m_StartX, 0, LayerWidth);
+	int CommitFromY = std::clamp(Y + pConf->m_StartY, 0, LayerHeight);
+	int CommitToX = std::clamp(X + Width + pConf->m_EndX, 0, LayerWidth);
+	int CommitToY = std::clamp(Y + Height + pConf->m_EndY, 0, LayerHeight);
+
+	// the first run reads one neighborhood further than the region it has
+	// to update for the following runs
+	int UpdateFromX = std::clamp(X + (NumRuns + 1) * pConf->m_StartX, 0, LayerWidth);
+	int UpdateFromY = std::clamp(Y + (NumRuns + 1) * pConf->m_StartY, 0, LayerHeight);
+	int UpdateToX = std::clamp(X + Width + (NumRuns + 1) * pConf->m_EndX, 0, LayerWidth);
+	int UpdateToY = std::clamp(Y + Height + (NumRuns + 1) * pConf->m_EndY, 0, LayerHeight);
+
+	const int UpdateWidth = UpdateToX - UpdateFromX;
+	const int UpdateHeight = UpdateToY - UpdateFromY;
+	std::vector<CTile> vUpdateLayer(UpdateWidth * UpdateHeight);
+	std::vector<CTile> vUpdateGame(UpdateWidth * UpdateHeight);
+
+	for(int y = UpdateFromY; y < UpdateToY; y++)
+	{
+		for(int x = UpdateFromX; x < UpdateToX; x++)
+		{
+			const CTile *pInLayer = &pTiles[y * LayerWidth + x];
+			CTile *pOutLayer = &vUpdateLayer[(y - UpdateFromY) * UpdateWidth + x - UpdateFromX];
+			pOutLayer->m_Index = pInLayer->m_Index;
+			pOutLayer->m_Flags = pInLayer->m_Flags;
+
+			const CTile *pInGame = &pGameTiles[y * GameWidth + x];
+			CTile *pOutGame = &vUpdateGame[(y - UpdateFromY) * UpdateWidth + x - UpdateFromX];
+			pOutGame->m_Index = pInGame->m_Index;
+			pOutGame->m_Flags = pInGame->m_Flags;
+		}
+	}
+
+	ProceedRegion(vUpdateLayer.data(), UpdateWidth, UpdateHeight, vUpdateGame.data(), UpdateWidth, UpdateHeight, ReferenceId, ConfigId, Seed, UpdateFromX, UpdateFromY, CommitFromX - UpdateFromX, CommitFromY - UpdateFromY, CommitToX - UpdateFromX, CommitToY - UpdateFromY, pEngine, [](int, int, const CTile &, const CTile &) {});
+
+	for(int y = CommitFromY; y < CommitToY; y++)
+	{
+		for(int x = CommitFromX; x < CommitToX; x++)
+		{
+			const CTile *pInLayer = &vUpdateLayer[(y - UpdateFromY) * UpdateWidth + x - UpdateFromX];
+			CTile *pOutLayer = &pTiles[y * LayerWidth + x];
+			CTile PreviousLayer = *pOutLayer;
+			pOutLayer->m_Index = pInLayer->m_Index;
+			pOutLayer->m_Flags = pInLayer->m_Flags;
+			RecordChange(x, y, PreviousLayer, *pOutLayer);
+
+			const CTile *pInGame = &vUpdateGame[(y - UpdateFromY) * UpdateWidth + x - UpdateFromX];
+			CTile *pOutGame = &pGameTiles[y * GameWidth + x];
+			CTile PreviousGame = *pOutGame;
+			pOutGame->m_Index = pInGame->m_Index;
+			pOutGame->m_Flags = pInGame->m_Flags;
+			RecordGameChange(x, y, PreviousGame, *pOutGame);
+		}
+	}
+}
+
+class CAutoMapRules::CRunState
+{
+public:
+	const CRun *m_pRun;
+	int m_RunId;
+	bool m_IsFilterable;
+	int m_Seed;
+	int m_SeedOffsetX;
+	int m_SeedOffsetY;
+
+	int m_Width;
+	int m_Height;
+	CTile *m_pTiles;
+	const CTile *m_pReadTiles;
+	// Set for every tile a rule was applied to, the history is recorded afterwards
+	unsigned char *m_pChanged;
+
+	int m_FromX;
+	int m_ToX;
+	int m_ToY;
+	std::atomic<int> m_NextRow;
+	std::atomic<int> m_RowsLeft;
+	// Signaled once by whoever finishes the last row
+	CSemaphore m_Done;
+};
+
+class CAutoMapRules::CRowJob : public IJob
+{
+	std::shared_ptr<CRunState> m_pState;
+
+	void Run() override
+	{
+		ProceedRows(m_pState.get());
+	}
+
+public:
+	CRowJob(std::shared_ptr<CRunState> pState) :
+		m_pState(std::move(pState))
+	{
+	}
+};
+
+void CAutoMapRules::ProceedRows(CRunState *pState)
+{
+	int y;
+	while((y = pState->m_NextRow.fetch_add(1)) < pState->m_ToY)
+	{
+		ProceedRow(pState, y);
+		if(pState->m_RowsLeft.fetch_sub(1) == 1)
+			pState->m_Done.Signal();
+	}
+}
+
+void CAutoMapRules::ProceedRow(const CRunState *pState, int y)
+{
+	const CRun *pRun = pState->m_pRun;
+	const int LayerWidth = pState->m_Width;
+	const int LayerHeight = pState->m_Height;
+
+	for(int x = pState->m_FromX; x < pState->m_ToX; x++)
+	{
+		CTile *pTile = &pState->m_pTiles[y * LayerWidth + x];
+		const CTile *pReadTile = &pState->m_pReadTiles[y * LayerWidth + x];
+
+		for(size_t i = 0; i < pRun->m_vIndexRules.size(); ++i)
+		{
+			const CIndexRule *pIndexRule = &pRun->m_vIndexRules[i];
+			if(pReadTile->m_Index == 0)
+			{
+				if(pTile->m_Index != 0 && pState->m_IsFilterable) // TODO: This is a lazy workaround
+				{
+					pTile->m_Index = 0;
+					pTile->m_Flags = pIndexRule->m_Flag;
+					pState->m_pChanged[y * LayerWidth + x] = 1;
+					continue;
+				}
+
+				if(pIndexRule->m_SkipEmpty) // skip empty tiles
+					continue;
+			}
+			if(pIndexRule->m_SkipFull && pReadTile->m_Index != 0) // skip full tiles
+				continue;
+
+			bool RespectRules = true;
+			for(size_t j = 0; j < pIndexRule->m_vRules.size() && RespectRules; ++j)
+			{
+				const CPosRule *pRule = &pIndexRule->m_vRules[j];
+
+				int CheckIndex, CheckFlags;
+				int CheckX = x + pRule->m_X;
+				int CheckY = y + pRule->m_Y;
+				if(CheckX >= 0 && CheckX < LayerWidth && CheckY >= 0 && CheckY < LayerHeight)
+				{
+					int CheckTile = CheckY * LayerWidth + CheckX;
+					CheckIndex = pState->m_pReadTiles[CheckTile].m_Index;
+					CheckFlags = pState->m_pReadTiles[CheckTile].m_Flags & (TILEFLAG_ROTATE | TILEFLAG_XFLIP | TILEFLAG_YFLIP);
+				}
+				else
+				{
+					CheckIndex = -1;
+					CheckFlags = 0;
+				}
+
+				if(pRule->m_Value == CPosRule::INDEX)
+				{
+					RespectRules = false;
+					for(const auto &Index : pRule->m_vIndexList)
+					{
+						if(CheckIndex == Index.m_Id && (!Index.m_TestFlag || CheckFlags == Index.m_Flag))
+						{
+							RespectRules = true;
+							break;
+						}
+					}
+				}
+				else if(pRule->m_Value == CPosRule::NOTINDEX)
+				{
+					for(const auto &Index : pRule->m_vIndexList)
+					{
+						if(CheckIndex == Index.m_Id && (!Index.m_TestFlag || CheckFlags == Index.m_Flag))
+						{
+							RespectRules = false;
+							break;
+						}
+					}
+				}
+			}
+
+			bool PassesModuloCheck;
+			if(pIndexRule->m_vModuloRules.empty())
+				PassesModuloCheck = true;
+			else
+				PassesModuloCheck = std::any_of(pIndexRule->m_vModuloRules.cbegin(), pIndexRule->m_vModuloRules.cend(), [&](const CModuloRule &ModuloRule) {
+					return (x + pState->m_SeedOffsetX + ModuloRule.m_OffsetX) % ModuloRule.m_ModX == 0 && (y + pState->m_SeedOffsetY + ModuloRule.m_OffsetY) % ModuloRule.m_ModY == 0;
+				});
+
+			if(RespectRules && PassesModuloCheck &&
+				(pIndexRule->m_RandomProbability >= 1.0f || HashLocation(pState->m_Seed, pState->m_RunId, i, x + pState->m_SeedOffsetX, y + pState->m_SeedOffsetY) < HASH_MAX * pIndexRule->m_RandomProbability))
+			{
+				pTile->m_Index = pIndexRule->m_Id;
+				pTile->m_Flags = pIndexRule->m_Flag;
+				pState->m_pChanged[y * LayerWidth + x] = 1;
+			}
+		}
+	}
+}
+
+void CAutoMapRules::ProceedTiles(CTile *pTiles, int Width, int Height, const CTile *pGameTiles, int GameWidth, int GameHeight, int ReferenceId, int ConfigId, int Seed, int SeedOffsetX, int SeedOffsetY, IEngine *pEngine, const TRecordChangeFunc &RecordChange) const
+{
+	ProceedRegion(pTiles, Width, Height, pGameTiles, GameWidth, GameHeight, ReferenceId, ConfigId, Seed, SeedOffsetX, SeedOffsetY, 0, 0, Width, Height, pEngine, RecordChange);
+}
+
+void CAutoMapRules::ProceedRegion(CTile *pTiles, int LayerWidth, int LayerHeight, const CTile *pGameTiles, int GameWidth, int GameHeight, int ReferenceId, int ConfigId, int Seed, int SeedOffsetX, int SeedOffsetY, int CommitFromX, int CommitFromY, int CommitToX, int CommitToY, IEngine *pEngine, const TRecordChangeFunc &RecordChange) const
+{
+	if(!m_FileLoaded || ConfigId < 0 || ConfigId >= (int)m_vConfigs.size() || LayerWidth <= 0 || LayerHeight <= 0)
+		return;
+
+	const CConfiguration *pConf = &m_vConfigs[ConfigId];
+
+	static const int s_aTileIndex[] = {TILE_SOLID, TILE_DEATH, TILE_NOHOOK, TILE_FREEZE, TILE_UNFREEZE, TILE_DFREEZE, TILE_DUNFREEZE, TILE_LFREEZE, TILE_LUNFREEZE};
+
+	static_assert(std::size(AUTOMAP_REFERENCE_NAMES) == std::size(s_aTileIndex) + 1, "AUTOMAP_REFERENCE_NAMES and s_aTileIndex must include the same items");
+
+	std::vector<CTile> vReadTiles;
+	std::vector<CTile> vPreviousTiles;
+	std::vector<unsigned char> vChanged(LayerWidth * LayerHeight);
+
+	// for every run: copy tiles, automap, overwrite tiles
+	const int NumRuns = pConf->m_vRuns.size();
+	for(int h = 0; h < NumRuns; ++h)
+	{
+		const CRun *pRun = &pConf->m_vRuns[h];
+		bool IsFilterable = h == 0 && ReferenceId >= 0;
+
+		// every run reads the tiles around the ones it changes, so earlier
+		// runs have to cover a larger region than the later ones
+		const int Expand = NumRuns - 1 - h;
+		const int FromX = std::clamp(CommitFromX + Expand * pConf->m_StartX, 0, LayerWidth);
+		const int FromY = std::clamp(CommitFromY + Expand * pConf->m_StartY, 0, LayerHeight);
+		const int ToX = std::clamp(CommitToX + Expand * pConf->m_EndX, 0, LayerWidth);
+		const int ToY = std::clamp(CommitToY + Expand * pConf->m_EndY, 0, LayerHeight);
+		if(FromX >= ToX || FromY >= ToY)
+			continue;
+
+		// don't make copy if it's requested
+		const CTile *pReadTiles;
+		const CTile *pBuffer = IsFilterable ? pGameTiles : pTiles;
+		const int BufferWidth = IsFilterable ? GameWidth : LayerWidth;
+		if(pRun->m_AutomapCopy)
+		{
+			vReadTiles.assign(LayerWidth * LayerHeight, CTile{});
+
+			const int ReadFromX = std::clamp(FromX + pConf->m_StartX, 0, LayerWidth);
+			const int ReadFromY = std::clamp(FromY + pConf->m_StartY, 0, LayerHeight);
+			const int ReadToX = std::min(std::clamp(ToX + pConf->m_EndX, 0, LayerWidth), IsFilterable ? GameWidth : LayerWidth);
+			const int ReadToY = std::min(std::clamp(ToY + pConf->m_EndY, 0, LayerHeight), IsFilterable ? GameHeight : LayerHeight);
+
+			for(int y = ReadFromY; y < ReadToY; y++)
+			{
+				for(int x = ReadFromX; x < ReadToX; x++)
+				{
+					const CTile *pIn = &pBuffer[y * BufferWidth + x];
+					CTile *pOut = &vReadTiles[y * LayerWidth + x];
+					if(h == 0 && ReferenceId >= 1 && pIn->m_Index != s_aTileIndex[ReferenceId - 1])
+						pOut->m_Index = 0;
+					else
+						pOut->m_Index = pIn->m_Index;
+					pOut->m_Flags = pIn->m_Flags;
+				}
+			}
+			pReadTiles = vReadTiles.data();
+		}
+		else
+		{
+			pReadTiles = pBuffer;
+		}
+
+		// only the region of the run can change
+		const int RegionWidth = ToX - FromX;
+		vPreviousTiles.resize(RegionWidth * (ToY - FromY));
+		for(int y = FromY; y < ToY; y++)
+		{
+			std::copy_n(&pTiles[y * LayerWidth + FromX], RegionWidth, &vPreviousTiles[(y - FromY) * RegionWidth]);
+			std::fill_n(&vChanged[y * LayerWidth + FromX], RegionWidth, 0);
+		}
+
+		std::shared_ptr<CRunState> pState = std::make_shared<CRunState>();
+		pState->m_pRun = pRun;
+		pState->m_RunId = h;
+		pState->m_IsFilterable = IsFilterable;
+		pState->m_Seed = Seed;
+		pState->m_SeedOffsetX = SeedOffsetX;
+		pState->m_SeedOffsetY = SeedOffsetY;
+		pState->m_Width = LayerWidth;
+		pState->m_Height = LayerHeight;
+		pState->m_pTiles = pTiles;
+		pState->m_pReadTiles = pReadTiles;
+		pState->m_pChanged = vChanged.data();
+		pState->m_FromX = FromX;
+		pState->m_ToX = ToX;
+		pState->m_ToY = ToY;
+		pState->m_NextRow = FromY;
+		pState->m_RowsLeft = ToY - FromY;
+
+		// auto map, rows only depend on each other if the run writes to the
+		// tiles it reads from. The result does not depend on the order the
+		// rows are processed in, as random rules are seeded by location.
+		if(pEngine && pReadTiles != pTiles && (ToX - FromX) * (ToY - FromY) >= PARALLEL_MIN_TILES)
+		{
+			const int NumJobs = std::min(std::max(1, (int)std::thread::hardware_concurrency() - 1), ToY - FromY - 1);
+			for(int i = 0; i < NumJobs; i++)
+				pEngine->AddJob(std::make_shared<CRowJob>(pState));
+
+			// Jobs which only start after all rows have been taken do not
+			// access the layer anymore, so there is no need to wait for them
+			ProceedRows(pState.get());
+			pState->m_Done.Wait();
+		}
+		else
+		{
+			ProceedRows(pState.get());
+		}
+
+		for(int y = FromY; y < ToY; y++)
+		{
+			for(int x = FromX; x < ToX; x++)
+			{
+				if(vChanged[y * LayerWidth + x])
+					RecordChange(x, y, vPreviousTiles[(y - FromY) * RegionWidth + x - FromX], pTiles[y * LayerWidth + x]);
+			}
+		}
+	}
+}
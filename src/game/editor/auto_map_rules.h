@@ -0,0 +1,127 @@
+#ifndef GAME_EDITOR_AUTO_MAP_RULES_H
+#define GAME_EDITOR_AUTO_MAP_RULES_H
+
+#include <functional>
+#include <vector>
+
+class CLineReader;
+class CTile;
+class IEngine;
+
+/**
+ * The rules of an automapper file and automapping plain tile buffers with
+ * them, independent of the editor layers.
+ */
+class CAutoMapRules
+{
+	class CIndexInfo
+	{
+	public:
+		int m_Id;
+		int m_Flag;
+		bool m_TestFlag;
+	};
+
+	class CPosRule
+	{
+	public:
+		int m_X;
+		int m_Y;
+		int m_Value;
+		std::vector<CIndexInfo> m_vIndexList;
+		bool m_IsGuide;
+
+		enum
+		{
+			NORULE = 0,
+			INDEX,
+			NOTINDEX
+		};
+	};
+
+	class CModuloRule
+	{
+	public:
+		int m_ModX;
+		int m_ModY;
+		int m_OffsetX;
+		int m_OffsetY;
+	};
+
+	class CIndexRule
+	{
+	public:
+		int m_Id;
+		std::vector<CPosRule> m_vRules;
+		int m_Flag;
+		float m_RandomProbability;
+		std::vector<CModuloRule> m_vModuloRules;
+		bool m_DefaultRule;
+		bool m_SkipEmpty;
+		bool m_SkipFull;
+	};
+	class CRun
+	{
+	public:
+		std::vector<CIndexRule> m_vIndexRules;
+		bool m_AutomapCopy;
+	};
+
+	class CConfiguration
+	{
+	public:
+		std::vector<CRun> m_vRuns;
+		char m_aName[128];
+		int m_StartX;
+		int m_StartY;
+		int m_EndX;
+		int m_EndY;
+	};
+
+public:
+	// Called for every tile that was changed, with the tile before and after
+	typedef std::function<void(int x, int y, const CTile &Previous, const CTile &Current)> TRecordChangeFunc;
+
+	void LoadRules(CLineReader &LineReader);
+	void Unload();
+	int CheckIndexFlag(int Flag, const char *pFlag, bool CheckNone) const;
+	int ConfigNamesNum() const { return m_vConfigs.size(); }
+	const char *GetConfigName(int Index) const;
+
+	bool IsLoaded() const { return m_FileLoaded; }
+
+	/**
+	 * Automaps all tiles. Rows are automapped on the job pool of the
+	 * engine if it is given and the layer is large enough.
+	 */
+	void ProceedTiles(CTile *pTiles, int Width, int Height, const CTile *pGameTiles, int GameWidth, int GameHeight, int ReferenceId, int ConfigId, int Seed, int SeedOffsetX, int SeedOffsetY, IEngine *pEngine, const TRecordChangeFunc &RecordChange) const;
+	/**
+	 * Automaps the tiles around the given area which are affected by a
+	 * change of the area. Both the tiles and the game tiles are written
+	 * back.
+	 */
+	void ProceedTilesLocalized(CTile *pTiles, int LayerWidth, int LayerHeight, CTile *pGameTiles, int GameWidth, int ReferenceId, int ConfigId, int Seed, int X, int Y, int Width, int Height, IEngine *pEngine, const TRecordChangeFunc &RecordChange, const TRecordChangeFunc &RecordGameChange) const;
+
+private:
+	enum
+	{
+		// Runs over fewer tiles are not split across the job pool
+		PARALLEL_MIN_TILES = 128 * 128,
+	};
+
+	class CRunState;
+	class CRowJob;
+
+	/**
+	 * Automaps the tiles in the commit region, and as much of the layer
+	 * around it as the later runs read.
+	 */
+	void ProceedRegion(CTile *pTiles, int LayerWidth, int LayerHeight, const CTile *pGameTiles, int GameWidth, int GameHeight, int ReferenceId, int ConfigId, int Seed, int SeedOffsetX, int SeedOffsetY, int CommitFromX, int CommitFromY, int CommitToX, int CommitToY, IEngine *pEngine, const TRecordChangeFunc &RecordChange) const;
+	static void ProceedRows(CRunState *pState);
+	static void ProceedRow(const CRunState *pState, int y);
+
+	std::vector<CConfiguration> m_vConfigs;
+	bool m_FileLoaded = false;
+};
+
+#endif
@@ -10,6 +10,7 @@
 
 #include <engine/shared/config.h>
 
+#include <algorithm>
 #include <limits>
 
 const char *CTuningParams::ms_apNames[] =
@@ -346,10 +347,11 @@ void CCharacterCore::Tick(bool UseInput, bool DoDeferredTick)
 		if(!m_HookHitDisabled && m_pWorld && m_Tuning.m_PlayerHooking && (m_HookState == HOOK_FLYING || !m_NewHook))
 		{
 			float Distance = 0.0f;
-			for(int i = 0; i < MAX_CLIENTS; i++)
+			for(int Index = 0; Index < m_pWorld->NumCharacters(); Index++)
 			{
-				CCharacterCore *pCharCore = m_pWorld->m_apCharacters[i];
-				if(!pCharCore || pCharCore == this || (!(m_Super || pCharCore->m_Super) && ((m_Id != -1 && !m_pTeams->CanCollide(i, m_Id)) || pCharCore->m_Solo || m_Solo)))
+				const int i = m_pWorld->CharacterId(Index);
+				CCharacterCore *pCharCore = m_pWorld->Character(i);
+				if(pCharCore == this || (!(m_Super || pCharCore->m_Super) && ((m_Id != -1 && !m_pTeams->CanCollide(i, m_Id)) || pCharCore->m_Solo || m_Solo)))
 					continue;
 
 				vec2 ClosestPoint;
@@ -405,7 +407,7 @@ void CCharacterCore::Tick(bool UseInput, bool DoDeferredTick)
 	{
 		if(m_HookedPlayer != -1 && m_pWorld)
 		{
-			CCharacterCore *pCharCore = m_pWorld->m_apCharacters[m_HookedPlayer];
+			CCharacterCore *pCharCore = m_pWorld->Character(m_HookedPlayer);
 			if(pCharCore && m_Id != -1 && m_pTeams->CanKeepHook(m_Id, pCharCore->m_Id))
 				m_HookPos = pCharCore->m_Pos;
 			else
@@ -443,7 +445,7 @@ void CCharacterCore::Tick(bool UseInput, bool DoDeferredTick)
 
 		// release hook (max default hook time is 1.25 s)
 		m_HookTick++;
-		if(m_HookedPlayer != -1 && (m_HookTick > SERVER_TICK_SPEED + SERVER_TICK_SPEED / 5 || (m_pWorld && !m_pWorld->m_apCharacters[m_HookedPlayer])))
+		if(m_HookedPlayer != -1 && (m_HookTick > SERVER_TICK_SPEED + SERVER_TICK_SPEED / 5 || (m_pWorld && !m_pWorld->Character(m_HookedPlayer))))
 		{
 			SetHookedPlayer(-1);
 			m_HookState = HOOK_RETRACTED;
@@ -459,12 +461,10 @@ void CCharacterCore::TickDeferred()
 {
 	if(m_pWorld)
 	{
-		for(int i = 0; i < MAX_CLIENTS; i++)
+		for(int Index = 0; Index < m_pWorld->NumCharacters(); Index++)
 		{
-			CCharacterCore *pCharCore = m_pWorld->m_apCharacters[i];
-			if(!pCharCore)
-				continue;
-
+			const int i = m_pWorld->CharacterId(Index);
+			CCharacterCore *pCharCore = m_pWorld->Character(i);
 			if(pCharCore == this || (m_Id != -1 && !m_pTeams->CanCollide(m_Id, i)))
 				continue; // make sure that we don't nudge our self
 
@@ -572,10 +572,11 @@ void CCharacterCore::Move()
 			{
 				float a = i / Distance;
 				vec2 Pos = mix(m_Pos, NewPos, a);
-				for(int p = 0; p < MAX_CLIENTS; p++)
+				for(int Index = 0; Index < m_pWorld->NumCharacters(); Index++)
 				{
-					CCharacterCore *pCharCore = m_pWorld->m_apCharacters[p];
-					if(!pCharCore || pCharCore == this)
+					const int p = m_pWorld->CharacterId(Index);
+					CCharacterCore *pCharCore = m_pWorld->Character(p);
+					if(pCharCore == this)
 						continue;
 					if((!(pCharCore->m_Super || m_Super) && (m_Solo || pCharCore->m_Solo || pCharCore->m_CollisionDisabled || (m_Id != -1 && !m_pTeams->CanCollide(m_Id, p)))))
 						continue;
@@ -703,7 +704,7 @@ void CCharacterCore::SetHookedPlayer(int HookedPlayer)
 	{
 		if(m_HookedPlayer != -1 && m_Id != -1 && m_pWorld)
 		{
-			CCharacterCore *pCharCore = m_pWorld->m_apCharacters[m_HookedPlayer];
+			CCharacterCore *pCharCore = m_pWorld->Character(m_HookedPlayer);
 			if(pCharCore)
 			{
 				pCharCore->m_AttachedPlayers.erase(m_Id);
@@ -711,7 +712,7 @@ void CCharacterCore::SetHookedPlayer(int HookedPlayer)
 		}
 		if(HookedPlayer != -1 && m_Id != -1 && m_pWorld)
 		{
-			CCharacterCore *pCharCore = m_pWorld->m_apCharacters[HookedPlayer];
+			CCharacterCore *pCharCore = m_pWorld->Character(HookedPlayer);
 			if(pCharCore)
 			{
 				pCharCore->m_AttachedPlayers.insert(m_Id);
@@ -737,6 +738,29 @@ bool CCharacterCore::IsSwitchActiveCb(int Number, void *pUser)
 	return false;
 }
 
+void CWorldCore::SetCharacter(int ClientId, CCharacterCore *pCharacter)
+{
+	dbg_assert(ClientId >= 0 && ClientId < MAX_CLIENTS, "invalid client id %d", ClientId);
+	const bool WasActive = m_apCharacters[ClientId] != nullptr;
+	m_apCharacters[ClientId] = pCharacter;
+	if(WasActive == (pCharacter != nullptr))
+		return;
+
+	int *pEnd = m_aCharacterIds + m_NumCharacters;
+	int *pPos = std::lower_bound(m_aCharacterIds, pEnd, ClientId);
+	if(pCharacter)
+	{
+		std::copy_backward(pPos, pEnd, pEnd + 1);
+		*pPos = ClientId;
+		m_NumCharacters++;
+	}
+	else
+	{
+		std::copy(pPos + 1, pEnd, pPos);
+		m_NumCharacters--;
+	}
+}
+
 void CWorldCore::InitSwitchers(int HighestSwitchNumber)
 {
 	if(HighestSwitchNumber > 0)
@@ -153,6 +153,7 @@ public:
 		{
 			pCharacter = nullptr;
 		}
+		m_NumCharacters = 0;
 		m_pPrng = nullptr;
 	}
 
@@ -168,11 +169,23 @@ public:
 		return m_pPrng->RandomBits() % BelowThis;
 	}
 
-	class CCharacterCore *m_apCharacters[MAX_CLIENTS];
+	class CCharacterCore *Character(int ClientId) const { return m_apCharacters[ClientId]; }
+	void SetCharacter(int ClientId, class CCharacterCore *pCharacter);
+
+	// The client ids of all characters in ascending order, the cores
+	// iterate over each other in this order
+	int NumCharacters() const { return m_NumCharacters; }
+	int CharacterId(int Index) const { return m_aCharacterIds[Index]; }
+
 	CPrng *m_pPrng;
 
 	void InitSwitchers(int HighestSwitchNumber);
 	std::vector<SSwitchers> m_vSwitchers;
+
+private:
+	class CCharacterCore *m_apCharacters[MAX_CLIENTS];
+	int m_aCharacterIds[MAX_CLIENTS];
+	int m_NumCharacters;
 };
 
 class CCharacterCore
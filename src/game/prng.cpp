@@ -40,6 +40,33 @@ void CPrng::Seed(uint64_t aSeed[2])
 	RandomBits();
 }
 
+bool CPrng::SeedFromDescription(const char *pDescription)
+{
+	const char *pSeed = str_startswith(pDescription, NAME ":");
+	if(!pSeed || str_length(pSeed) != 16 + 1 + 16 || pSeed[16] != ':')
+	{
+		return false;
+	}
+
+	char aHex[16 + 16 + 1];
+	str_copy(aHex, pSeed, 16 + 1);
+	str_append(aHex, pSeed + 16 + 1);
+	unsigned char aBytes[16];
+	if(str_hex_decode(aBytes, sizeof(aBytes), aHex) != 0)
+	{
+		return false;
+	}
+
+	uint64_t aSeed[2] = {0, 0};
+	for(int i = 0; i < 8; i++)
+	{
+		aSeed[0] = (aSeed[0] << 8) | aBytes[i];
+		aSeed[1] = (aSeed[1] << 8) | aBytes[8 + i];
+	}
+	Seed(aSeed);
+	return true;
+}
+
 unsigned int CPrng::RandomBits()
 {
 	dbg_assert(m_Seeded, "prng needs to be seeded before it can generate random numbers");
@@ -17,6 +17,12 @@ public:
 	// to be the same for the same seed.
 	void Seed(uint64_t aSeed[2]);
 
+	// Seeds the random number generator with the seed contained in a
+	// string returned by `Description()`, e.g. to reproduce the random
+	// sequence of a recorded game. Returns `false` if the description
+	// cannot be parsed.
+	bool SeedFromDescription(const char *pDescription);
+
 	// Generates 32 random bits. `Seed()` must be called before calling
 	// this function.
 	unsigned int RandomBits();
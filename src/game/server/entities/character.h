@@ -39,6 +39,10 @@ public:
 	void PreTick();
 	void Tick() override;
 	void TickDeferred() override;
+	// Split of TickDeferred(): the move only touches this character and the
+	// cores it can collide with, the events touch the rest of the game
+	void TickDeferredMove();
+	void TickDeferredEvents();
 	void TickPaused() override;
 	void Snap(int SnappingClient) override;
 	void SwapClients(int Client1, int Client2) override;
@@ -166,6 +170,13 @@ private:
 	CCharacterCore m_SendCore; // core that we should send
 	CCharacterCore m_ReckoningCore; // the dead reckoning core
 
+	// state of the last TickDeferredMove() for TickDeferredEvents()
+	vec2 m_DeferredStartPos;
+	vec2 m_DeferredStartVel;
+	bool m_DeferredStuckBefore;
+	bool m_DeferredStuckAfterMove;
+	bool m_DeferredStuckAfterQuant;
+
 	// DDRace
 
 	void SnapCharacter(int SnappingClient, int Id);
@@ -10,6 +10,8 @@
 #include <game/server/player.h>
 #include <game/teamscore.h>
 
+MACRO_ALLOC_POOL_IMPL(CDoor, 64)
+
 CDoor::CDoor(CGameWorld *pGameWorld, vec2 Pos, float Rotation, int Length,
 	int Number) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
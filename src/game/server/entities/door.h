@@ -8,6 +8,8 @@ class CGameWorld;
 
 class CDoor : public CEntity
 {
+	MACRO_ALLOC_POOL()
+
 	vec2 m_To;
 	void ResetCollision();
 	int m_Length;
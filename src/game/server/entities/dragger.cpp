@@ -14,6 +14,8 @@
 #include <game/server/player.h>
 #include <game/server/teams.h>
 
+MACRO_ALLOC_POOL_IMPL(CDragger, 32)
+
 CDragger::CDragger(CGameWorld *pGameWorld, vec2 Pos, float Strength, bool IgnoreWalls, int Layer, int Number) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
 {
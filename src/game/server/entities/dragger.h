@@ -21,6 +21,8 @@ class CDraggerBeam;
  */
 class CDragger : public CEntity
 {
+	MACRO_ALLOC_POOL()
+
 	// m_Core is the direction vector by which a dragger is shifted at each movement tick (every 150ms)
 	vec2 m_Core;
 	float m_Strength;
@@ -14,6 +14,8 @@
 #include <game/server/player.h>
 #include <game/server/teams.h>
 
+MACRO_ALLOC_POOL_IMPL(CGun, 32)
+
 CGun::CGun(CGameWorld *pGameWorld, vec2 Pos, bool Freeze, bool Explosive, int Layer, int Number) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
 {
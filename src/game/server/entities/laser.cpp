@@ -12,6 +12,8 @@
 #include <game/server/gamecontext.h>
 #include <game/server/gamemodes/ddnet.h>
 
+MACRO_ALLOC_POOL_IMPL(CLaser, 64)
+
 CLaser::CLaser(CGameWorld *pGameWorld, vec2 Pos, vec2 Direction, float StartEnergy, int Owner, int Type) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
 {
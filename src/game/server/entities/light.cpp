@@ -12,6 +12,8 @@
 #include <game/server/player.h>
 #include <game/teamscore.h>
 
+MACRO_ALLOC_POOL_IMPL(CLight, 32)
+
 CLight::CLight(CGameWorld *pGameWorld, vec2 Pos, float Rotation, int Length,
 	int Layer, int Number) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
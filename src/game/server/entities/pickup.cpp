@@ -11,6 +11,8 @@
 #include <game/server/player.h>
 #include <game/teamscore.h>
 
+MACRO_ALLOC_POOL_IMPL(CPickup, 64)
+
 static constexpr int gs_PickupPhysSize = 14;
 
 CPickup::CPickup(CGameWorld *pGameWorld, int Type, int SubType, int Layer, int Number, int Flags) :
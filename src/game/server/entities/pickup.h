@@ -7,6 +7,8 @@
 
 class CPickup : public CEntity
 {
+	MACRO_ALLOC_POOL()
+
 public:
 	static const int ms_CollisionExtraSize = 6;
 
@@ -10,6 +10,8 @@
 #include <game/server/gamecontext.h>
 #include <game/teamscore.h>
 
+MACRO_ALLOC_POOL_IMPL(CPlasma, 32)
+
 const float PLASMA_ACCEL = 1.1f;
 
 CPlasma::CPlasma(CGameWorld *pGameWorld, vec2 Pos, vec2 Dir, bool Freeze,
@@ -12,6 +12,8 @@
 #include <game/server/gamecontext.h>
 #include <game/server/gamemodes/ddnet.h>
 
+MACRO_ALLOC_POOL_IMPL(CProjectile, 128)
+
 CProjectile::CProjectile(
 	CGameWorld *pGameWorld,
 	int Type,
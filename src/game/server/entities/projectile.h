@@ -7,6 +7,8 @@
 
 class CProjectile : public CEntity
 {
+	MACRO_ALLOC_POOL()
+
 public:
 	CProjectile(
 		CGameWorld *pGameWorld,
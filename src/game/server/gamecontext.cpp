@@ -32,6 +32,7 @@
 #include <generated/protocol7.h>
 #include <generated/protocolglue.h>
 
+#include <game/alloc.h>
 #include <game/collision.h>
 #include <game/gamecore.h>
 #include <game/mapitems.h>
@@ -174,7 +175,10 @@ void CGameContext::Clear()
 void CGameContext::TeeHistorianWrite(const void *pData, int DataSize, void *pUser)
 {
 	CGameContext *pSelf = (CGameContext *)pUser;
-	aio_write(pSelf->m_pTeeHistorianFile, pData, DataSize);
+	if(pSelf->m_TeeHistorianBlocks.IsOpen())
+		pSelf->m_TeeHistorianBlocks.Write(pData, DataSize);
+	else
+		aio_write(pSelf->m_pTeeHistorianFile, pData, DataSize);
 }
 
 void CGameContext::CommandCallback(int ClientId, int FlagMask, const char *pCmd, IConsole::IResult *pResult, void *pUser)
@@ -1092,7 +1096,7 @@ void CGameContext::OnTick()
 
 	if(m_TeeHistorianActive)
 	{
-		int Error = aio_error(m_pTeeHistorianFile);
+		int Error = m_TeeHistorianBlocks.IsOpen() ? m_TeeHistorianBlocks.Error() : aio_error(m_pTeeHistorianFile);
 		if(Error)
 		{
 			dbg_msg("teehistorian", "error writing to file, err=%d", Error);
@@ -1104,6 +1108,11 @@ void CGameContext::OnTick()
 			m_TeeHistorian.EndInputs();
 			m_TeeHistorian.EndTick();
 		}
+		if(m_TeeHistorianBlocks.IsOpen() && m_TeeHistorianBlocks.BlockFull())
+		{
+			m_TeeHistorianBlocks.EndBlock(m_TeeHistorian.LastWrittenTick());
+			m_TeeHistorian.Keyframe();
+		}
 		m_TeeHistorian.BeginTick(Server()->Tick());
 		m_TeeHistorian.BeginPlayers();
 	}
@@ -1941,6 +1950,17 @@ void CGameContext::TeehistorianRecordAuthLogin(int ClientId, int Level, const ch
 	}
 }
 
+uint64_t CGameContext::TeehistorianQueuedBytes()
+{
+	if(!m_TeeHistorianActive)
+		return 0;
+	if(m_TeeHistorianBlocks.IsOpen())
+		return m_TeeHistorianBlocks.QueuedBytes();
+	ASYNCIO_STATS Stats;
+	aio_stats(m_pTeeHistorianFile, &Stats);
+	return Stats.queued;
+}
+
 bool CGameContext::OnClientDDNetVersionKnown(int ClientId)
 {
 	IServer::CClientInfo Info;
@@ -2852,7 +2872,7 @@ void CGameContext::OnChangeInfoNetMessage(const CNetMsg_Cl_ChangeInfo *pMsg, int
 		SendSkinChange7(ClientId);
 	}
 
-	Server()->ExpireServerInfo();
+	Server()->ExpireServerInfoClients();
 }
 
 void CGameContext::OnEmoticonNetMessage(const CNetMsg_Cl_Emoticon *pMsg, int ClientId)
@@ -3792,6 +3812,23 @@ void CGameContext::ConVotes(IConsole::IResult *pResult, void *pUserData)
 	pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "votes", aBuf);
 }
 
+void CGameContext::ConEntityPools(IConsole::IResult *pResult, void *pUserData)
+{
+	CGameContext *pSelf = (CGameContext *)pUserData;
+
+	char aBuf[256];
+	for(const CPoolAllocator *pPool = CPoolAllocator::First(); pPool; pPool = pPool->Next())
+	{
+		pPool->Describe(aBuf, sizeof(aBuf));
+		pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "pools", aBuf);
+	}
+
+	int NumAllocated, NumTimed;
+	pSelf->Server()->SnapIdUsage(&NumAllocated, &NumTimed);
+	str_format(aBuf, sizeof(aBuf), "snap ids: allocated=%d timed=%d", NumAllocated, NumTimed);
+	pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "pools", aBuf);
+}
+
 void CGameContext::ConchainSpecialMotdupdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
 {
 	pfnCallback(pResult, pCallbackUserData);
@@ -3886,6 +3923,7 @@ void CGameContext::OnConsoleInit()
 	Console()->Register("add_map_votes", "?s[directory]", CFGFLAG_SERVER, ConAddMapVotes, this, "Automatically adds voting options for all maps");
 	Console()->Register("vote", "r['yes'|'no']", CFGFLAG_SERVER, ConVote, this, "Force a vote to yes/no");
 	Console()->Register("votes", "?i[page]", CFGFLAG_SERVER, ConVotes, this, "Show all votes (page 0 by default, 20 entries per page)");
+	Console()->Register("entity_pools", "", CFGFLAG_SERVER, ConEntityPools, this, "Shows the usage of the entity allocators and snap ids");
 	Console()->Register("dump_antibot", "", CFGFLAG_SERVER | CFGFLAG_STORE, ConDumpAntibot, this, "Dumps the antibot status");
 	Console()->Register("antibot", "r[command]", CFGFLAG_SERVER | CFGFLAG_STORE, ConAntibot, this, "Sends a command to the antibot");
 
@@ -4204,7 +4242,7 @@ void CGameContext::OnInit(const void *pPersistentData)
 		FormatUuid(m_GameUuid, aGameUuid, sizeof(aGameUuid));
 
 		char aFilename[IO_MAX_PATH_LENGTH];
-		str_format(aFilename, sizeof(aFilename), "teehistorian/%s.teehistorian", aGameUuid);
+		str_format(aFilename, sizeof(aFilename), "teehistorian/%s.teehistorian%s", aGameUuid, g_Config.m_SvTeeHistorianCompress ? ".z" : "");
 
 		IOHANDLE THFile = Storage()->OpenFile(aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
 		if(!THFile)
@@ -4217,7 +4255,16 @@ void CGameContext::OnInit(const void *pPersistentData)
 		{
 			dbg_msg("teehistorian", "recording to '%s'", aFilename);
 		}
-		m_pTeeHistorianFile = aio_new(THFile);
+		if(g_Config.m_SvTeeHistorianCompress)
+		{
+			m_pTeeHistorianFile = nullptr;
+			m_TeeHistorianBlocks.Open(THFile);
+		}
+		else
+		{
+			// the game thread should not wait for slow disks, leave room for bursts
+			m_pTeeHistorianFile = aio_new(THFile, 1024 * 1024);
+		}
 
 		char aVersion[128];
 		if(GIT_SHORTREV_HASH)
@@ -4529,15 +4576,30 @@ void CGameContext::OnShutdown(void *pPersistentData)
 	if(m_TeeHistorianActive)
 	{
 		m_TeeHistorian.Finish();
-		aio_close(m_pTeeHistorianFile);
-		aio_wait(m_pTeeHistorianFile);
-		int Error = aio_error(m_pTeeHistorianFile);
+		int Error;
+		if(m_TeeHistorianBlocks.IsOpen())
+		{
+			m_TeeHistorianBlocks.Close();
+			Error = m_TeeHistorianBlocks.Error();
+		}
+		else
+		{
+			aio_close(m_pTeeHistorianFile);
+			aio_wait(m_pTeeHistorianFile);
+			Error = aio_error(m_pTeeHistorianFile);
+			ASYNCIO_STATS Stats;
+			aio_stats(m_pTeeHistorianFile, &Stats);
+			if(Stats.stalls)
+			{
+				dbg_msg("teehistorian", "writing stalled %" PRIu64 " times for %.2fms in total", Stats.stalls, Stats.stall_time * 1000.0 / time_freq());
+			}
+			aio_free(m_pTeeHistorianFile);
+		}
 		if(Error)
 		{
 			dbg_msg("teehistorian", "error closing file, err=%d", Error);
 			Server()->SetErrorShutdown("teehistorian close error");
 		}
-		aio_free(m_pTeeHistorianFile);
 	}
 
 	// Stop any demos being recorded.
@@ -4633,6 +4695,60 @@ void CGameContext::OnPostGlobalSnap()
 	m_Events.Clear();
 }
 
+float CGameContext::SnapItemDistance(int ClientId, int Type, const void *pData, int Size)
+{
+	const CPlayer *pPlayer = m_apPlayers[ClientId];
+	if(!pPlayer)
+		return -1.0f;
+
+	// events are only sent once, so only objects can be deferred
+	const int *pInts = static_cast<const int *>(pData);
+	int PosIndex = 0;
+	float Scale = 1.0f;
+	if(Server()->IsSixup(ClientId))
+	{
+		switch(Type)
+		{
+		case protocol7::NETOBJTYPE_PROJECTILE:
+		case protocol7::NETOBJTYPE_LASER:
+		case protocol7::NETOBJTYPE_PICKUP:
+		case protocol7::NETOBJTYPE_FLAG:
+			break;
+		case protocol7::NETOBJTYPE_CHARACTER:
+			PosIndex = 1; // after m_Tick
+			break;
+		default:
+			return -1.0f;
+		}
+	}
+	else
+	{
+		switch(Type)
+		{
+		case NETOBJTYPE_PROJECTILE:
+		case NETOBJTYPE_LASER:
+		case NETOBJTYPE_PICKUP:
+		case NETOBJTYPE_FLAG:
+		case NETOBJTYPE_DDNETLASER:
+		case NETOBJTYPE_DDNETPICKUP:
+			break;
+		case NETOBJTYPE_DDNETPROJECTILE:
+			Scale = 0.01f;
+			break;
+		case NETOBJTYPE_CHARACTER:
+			PosIndex = 1; // after m_Tick
+			break;
+		default:
+			return -1.0f;
+		}
+	}
+	if(Size < (PosIndex + 2) * (int)sizeof(int32_t))
+		return -1.0f;
+
+	const vec2 Pos = vec2(pInts[PosIndex], pInts[PosIndex + 1]) * Scale;
+	return distance(pPlayer->m_ViewPos, Pos);
+}
+
 void CGameContext::UpdatePlayerMaps()
 {
 	const auto DistCompare = [](std::pair<float, int> a, std::pair<float, int> b) -> bool {
@@ -6,6 +6,7 @@
 #include "eventhandler.h"
 #include "gameworld.h"
 #include "teehistorian.h"
+#include "teehistorian_blocks.h"
 
 #include <engine/console.h>
 #include <engine/server.h>
@@ -123,6 +124,7 @@ class CGameContext : public IGameServer
 	bool m_TeeHistorianActive;
 	CTeeHistorian m_TeeHistorian;
 	ASYNCIO *m_pTeeHistorianFile;
+	CTeeHistorianBlockWriter m_TeeHistorianBlocks;
 	CUuid m_GameUuid;
 	CMapBugs m_MapBugs;
 	CPrng m_Prng;
@@ -162,6 +164,7 @@ class CGameContext : public IGameServer
 	static void ConAddMapVotes(IConsole::IResult *pResult, void *pUserData);
 	static void ConVote(IConsole::IResult *pResult, void *pUserData);
 	static void ConVotes(IConsole::IResult *pResult, void *pUserData);
+	static void ConEntityPools(IConsole::IResult *pResult, void *pUserData);
 	static void ConVoteNo(IConsole::IResult *pResult, void *pUserData);
 	static void ConDrySave(IConsole::IResult *pResult, void *pUserData);
 	static void ConDumpAntibot(IConsole::IResult *pResult, void *pUserData);
@@ -329,6 +332,7 @@ public:
 	void OnTick() override;
 	void OnSnap(int ClientId, bool GlobalSnap) override;
 	void OnPostGlobalSnap() override;
+	float SnapItemDistance(int ClientId, int Type, const void *pData, int Size) override;
 
 	void UpdatePlayerMaps();
 
@@ -370,6 +374,7 @@ public:
 	void TeehistorianRecordPlayerFinish(int ClientId, int TimeTicks) override;
 	void TeehistorianRecordTeamFinish(int TeamId, int TimeTicks) override;
 	void TeehistorianRecordAuthLogin(int ClientId, int Level, const char *pAuthName) override;
+	uint64_t TeehistorianQueuedBytes() override;
 
 	bool IsClientReady(int ClientId) const override;
 	bool IsClientPlayer(int ClientId) const override;
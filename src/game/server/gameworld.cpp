@@ -8,11 +8,18 @@
 #include "gamecontext.h"
 #include "gamecontroller.h"
 
+#include <base/tl/threading.h>
+
+#include <engine/engine.h>
 #include <engine/shared/config.h>
+#include <engine/shared/jobs.h>
 
 #include <game/collision.h>
+#include <game/teamscore.h>
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include <utility>
 
 //////////////////////////////////////////////////
@@ -36,6 +43,10 @@ CGameWorld::~CGameWorld()
 	for(auto &pFirstEntityType : m_apFirstEntityTypes)
 		while(pFirstEntityType)
 			delete pFirstEntityType; // NOLINT(clang-analyzer-cplusplus.NewDelete)
+
+	// return the ids no entity used
+	for(int i = m_NextSnapId; i < m_NumSnapIds; i++)
+		Server()->SnapFreeId(m_aSnapIds[i]);
 }
 
 void CGameWorld::SetGameServer(CGameContext *pGameServer)
@@ -77,6 +88,18 @@ int CGameWorld::FindEntities(vec2 Pos, float Radius, CEntity **ppEnts, int Max,
 	return Num;
 }
 
+int CGameWorld::NewSnapId()
+{
+	if(m_NextSnapId == m_NumSnapIds)
+	{
+		m_NumSnapIds = Server()->SnapNewIds(m_aSnapIds, SNAP_ID_BATCH);
+		m_NextSnapId = 0;
+		if(m_NumSnapIds == 0)
+			return -1;
+	}
+	return m_aSnapIds[m_NextSnapId++];
+}
+
 void CGameWorld::InsertEntity(CEntity *pEnt)
 {
 #ifdef CONF_DEBUG
@@ -232,13 +255,31 @@ void CGameWorld::Tick()
 			}
 		}
 
-		for(auto *pEnt : m_apFirstEntityTypes)
-			for(; pEnt;)
-			{
-				m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
-				pEnt->TickDeferred();
-				pEnt = m_pNextTraverseEntity;
-			}
+		if(Config()->m_SvParallelTeams && TickDeferredMoveParallel())
+		{
+			// The characters have already been moved, the rest of their
+			// deferred tick creates events and must happen in entity order
+			for(int i = 0; i < NUM_ENTTYPES; i++)
+				for(auto *pEnt = m_apFirstEntityTypes[i]; pEnt;)
+				{
+					m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
+					if(i == ENTTYPE_CHARACTER)
+						((CCharacter *)pEnt)->TickDeferredEvents();
+					else
+						pEnt->TickDeferred();
+					pEnt = m_pNextTraverseEntity;
+				}
+		}
+		else
+		{
+			for(auto *pEnt : m_apFirstEntityTypes)
+				for(; pEnt;)
+				{
+					m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
+					pEnt->TickDeferred();
+					pEnt = m_pNextTraverseEntity;
+				}
+		}
 	}
 	else
 	{
@@ -263,6 +304,94 @@ void CGameWorld::Tick()
 	}
 }
 
+class CGameWorld::CDeferredMoveState
+{
+public:
+	// Characters grouped by partition, in entity order within a partition
+	std::vector<CCharacter *> m_vpCharacters;
+	// Index of the first character of every partition, and the end
+	std::vector<int> m_vPartitionStart;
+	std::atomic<int> m_NextPartition = 0;
+	std::atomic<int> m_PartitionsLeft = 0;
+	// Signaled once by whoever moves the last partition
+	CSemaphore m_Done;
+};
+
+class CGameWorld::CDeferredMoveJob : public IJob
+{
+	std::shared_ptr<CDeferredMoveState> m_pState;
+
+	void Run() override
+	{
+		ProceedDeferredMoves(m_pState.get());
+	}
+
+public:
+	CDeferredMoveJob(std::shared_ptr<CDeferredMoveState> pState) :
+		m_pState(std::move(pState))
+	{
+	}
+};
+
+void CGameWorld::ProceedDeferredMoves(CDeferredMoveState *pState)
+{
+	const int NumPartitions = (int)pState->m_vPartitionStart.size() - 1;
+	int Partition;
+	while((Partition = pState->m_NextPartition.fetch_add(1)) < NumPartitions)
+	{
+		for(int i = pState->m_vPartitionStart[Partition]; i < pState->m_vPartitionStart[Partition + 1]; i++)
+			pState->m_vpCharacters[i]->TickDeferredMove();
+		if(pState->m_PartitionsLeft.fetch_sub(1) == 1)
+			pState->m_Done.Signal();
+	}
+}
+
+bool CGameWorld::TickDeferredMoveParallel()
+{
+	// Moving a character only reads the cores it can collide with, which
+	// are the ones of its own team. Super characters collide with everyone.
+	int aTeamPartition[NUM_DDRACE_TEAMS];
+	std::fill(std::begin(aTeamPartition), std::end(aTeamPartition), -1);
+	std::vector<int> vPartitionSize;
+	int NumCharacters = 0;
+	for(CCharacter *pChr = (CCharacter *)FindFirst(ENTTYPE_CHARACTER); pChr; pChr = (CCharacter *)pChr->TypeNext())
+	{
+		const int Team = pChr->Team();
+		if(pChr->IsSuper() || Team == TEAM_SUPER || (pChr->Teams()->m_Core.m_IsDDRace16 && Team == VANILLA_TEAM_SUPER))
+			return false;
+		if(aTeamPartition[Team] < 0)
+		{
+			aTeamPartition[Team] = vPartitionSize.size();
+			vPartitionSize.push_back(0);
+		}
+		vPartitionSize[aTeamPartition[Team]]++;
+		NumCharacters++;
+	}
+	const int NumPartitions = vPartitionSize.size();
+	if(NumPartitions < 2)
+		return false;
+
+	std::shared_ptr<CDeferredMoveState> pState = std::make_shared<CDeferredMoveState>();
+	pState->m_vpCharacters.resize(NumCharacters);
+	pState->m_vPartitionStart.resize(NumPartitions + 1);
+	pState->m_PartitionsLeft = NumPartitions;
+	pState->m_vPartitionStart[0] = 0;
+	for(int i = 0; i < NumPartitions; i++)
+		pState->m_vPartitionStart[i + 1] = pState->m_vPartitionStart[i] + vPartitionSize[i];
+	std::vector<int> vNext(pState->m_vPartitionStart.begin(), pState->m_vPartitionStart.end() - 1);
+	for(CCharacter *pChr = (CCharacter *)FindFirst(ENTTYPE_CHARACTER); pChr; pChr = (CCharacter *)pChr->TypeNext())
+		pState->m_vpCharacters[vNext[aTeamPartition[pChr->Team()]]++] = pChr;
+
+	// Jobs which only start after all partitions have been taken do not
+	// access the world anymore, so there is no need to wait for them
+	const int NumJobs = std::min(std::max(1, (int)std::thread::hardware_concurrency() - 1), NumPartitions - 1);
+	for(int i = 0; i < NumJobs; i++)
+		GameServer()->Engine()->AddJob(std::make_shared<CDeferredMoveJob>(pState));
+	ProceedDeferredMoves(pState.get());
+	pState->m_Done.Wait();
+	return true;
+}
+
 ESaveResult CGameWorld::BlocksSave(int ClientId)
 {
 	// check all objects
@@ -35,9 +35,33 @@ private:
 	void Reset();
 	void RemoveEntities();
 
+	class CDeferredMoveState;
+	class CDeferredMoveJob;
+	static void ProceedDeferredMoves(CDeferredMoveState *pState);
+	/*
+		Function: TickDeferredMoveParallel
+			Moves the characters of each team on a worker thread, see
+			sv_parallel_teams. The characters of a team are moved in entity
+			order, like in the serial tick.
+
+		Returns:
+			False if the characters could not be partitioned and nothing
+			was moved.
+	*/
+	bool TickDeferredMoveParallel();
+
 	CEntity *m_pNextTraverseEntity = nullptr;
 	CEntity *m_apFirstEntityTypes[NUM_ENTTYPES];
 
+	enum
+	{
+		SNAP_ID_BATCH = 64,
+	};
+	// snap ids fetched from the server that no entity uses yet
+	int m_aSnapIds[SNAP_ID_BATCH];
+	int m_NumSnapIds = 0;
+	int m_NextSnapId = 0;
+
 	class CGameContext *m_pGameServer;
 	class CConfig *m_pConfig;
 	class IServer *m_pServer;
@@ -144,6 +168,17 @@ public:
 	*/
 	void RemoveEntity(CEntity *pEntity);
 
+	/*
+		Function: NewSnapId
+			Returns a snap id for a new entity. The ids are fetched
+			from the server in batches, they are freed with
+			IServer::SnapFreeId.
+
+		Returns:
+			The id or -1 if the server ran out of ids.
+	*/
+	int NewSnapId();
+
 	void RemoveEntitiesFromPlayer(int PlayerId);
 	void RemoveEntitiesFromPlayers(int PlayerIds[], int NumPlayers);
 
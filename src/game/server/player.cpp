@@ -753,7 +753,7 @@ void CPlayer::SetAfk(bool Afk)
 {
 	if(m_Afk != Afk)
 	{
-		Server()->ExpireServerInfo();
+		Server()->ExpireServerInfoClients();
 		m_Afk = Afk;
 	}
 }
@@ -970,7 +970,7 @@ void CPlayer::ProcessScoreResult(CScorePlayerResult &Result)
 				GameServer()->Score()->PlayerData(m_ClientId)->Set(Result.m_Data.m_Info.m_Time.value(), Result.m_Data.m_Info.m_aTimeCp);
 				Server()->SetClientScore(m_ClientId, Result.m_Data.m_Info.m_Time.value());
 			}
-			Server()->ExpireServerInfo();
+			Server()->ExpireServerInfoClients();
 			int Birthday = Result.m_Data.m_Info.m_Birthday;
 			if(Birthday != 0 && !m_BirthdayAnnounced && GetCharacter())
 			{
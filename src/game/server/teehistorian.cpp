@@ -22,7 +22,7 @@ private:
 };
 
 static const char TEEHISTORIAN_NAME[] = "teehistorian@ddnet.tw";
-static const CUuid TEEHISTORIAN_UUID = CalculateUuid(TEEHISTORIAN_NAME);
+const CUuid TEEHISTORIAN_UUID = CalculateUuid(TEEHISTORIAN_NAME);
 static const char TEEHISTORIAN_VERSION[] = "2";
 static const char TEEHISTORIAN_VERSION_MINOR[] = "18";
 
@@ -30,22 +30,6 @@ static const char TEEHISTORIAN_VERSION_MINOR[] = "18";
 #include <engine/shared/teehistorian_ex_chunks.h>
 #undef UUID
 
-enum
-{
-	TEEHISTORIAN_NONE,
-	TEEHISTORIAN_FINISH,
-	TEEHISTORIAN_TICK_SKIP,
-	TEEHISTORIAN_PLAYER_NEW,
-	TEEHISTORIAN_PLAYER_OLD,
-	TEEHISTORIAN_INPUT_DIFF,
-	TEEHISTORIAN_INPUT_NEW,
-	TEEHISTORIAN_MESSAGE,
-	TEEHISTORIAN_JOIN,
-	TEEHISTORIAN_DROP,
-	TEEHISTORIAN_CONSOLE_COMMAND,
-	TEEHISTORIAN_EX,
-};
-
 CTeeHistorian::CTeeHistorian()
 {
 	m_State = STATE_START;
@@ -66,6 +50,17 @@ void CTeeHistorian::Reset(const CGameInfo *pGameInfo, WRITE_CALLBACK pfnWriteCal
 	m_MaxClientId = MAX_CLIENTS;
 
 	// `m_PrevMaxClientId` is initialized in `BeginPlayers`
+	ResetPrevState();
+	m_pfnWriteCallback = pfnWriteCallback;
+	m_pWriteCallbackUserdata = pUser;
+
+	WriteHeader(pGameInfo);
+
+	m_State = STATE_START;
+}
+
+void CTeeHistorian::ResetPrevState()
+{
 	for(auto &PrevPlayer : m_aPrevPlayers)
 	{
 		PrevPlayer.m_Alive = false;
@@ -77,12 +72,21 @@ void CTeeHistorian::Reset(const CGameInfo *pGameInfo, WRITE_CALLBACK pfnWriteCal
 	{
 		PrevTeam.m_Practice = false;
 	}
-	m_pfnWriteCallback = pfnWriteCallback;
-	m_pWriteCallbackUserdata = pUser;
+}
 
-	WriteHeader(pGameInfo);
+void CTeeHistorian::Keyframe()
+{
+	dbg_assert(m_State == STATE_START || m_State == STATE_BEFORE_TICK, "invalid teehistorian state");
 
-	m_State = STATE_START;
+	// Readers starting here assume the initial state as well, every player
+	// and input is written in full again as soon as it is recorded
+	ResetPrevState();
+	m_MaxClientId = MAX_CLIENTS;
+
+	if(m_Debug)
+	{
+		dbg_msg("teehistorian", "keyframe last_written_tick=%d", m_LastWrittenTick);
+	}
 }
 
 void CTeeHistorian::WriteHeader(const CGameInfo *pGameInfo)
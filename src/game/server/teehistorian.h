@@ -14,6 +14,26 @@ class CConfig;
 class CTuningParams;
 class CUuidManager;
 
+extern const CUuid TEEHISTORIAN_UUID;
+
+// Item types, written negated in front of the item. Player position diffs
+// have no type, they start with the non-negative client id instead.
+enum
+{
+	TEEHISTORIAN_NONE,
+	TEEHISTORIAN_FINISH,
+	TEEHISTORIAN_TICK_SKIP,
+	TEEHISTORIAN_PLAYER_NEW,
+	TEEHISTORIAN_PLAYER_OLD,
+	TEEHISTORIAN_INPUT_DIFF,
+	TEEHISTORIAN_INPUT_NEW,
+	TEEHISTORIAN_MESSAGE,
+	TEEHISTORIAN_JOIN,
+	TEEHISTORIAN_DROP,
+	TEEHISTORIAN_CONSOLE_COMMAND,
+	TEEHISTORIAN_EX,
+};
+
 class CTeeHistorian
 {
 public:
@@ -55,6 +75,11 @@ public:
 	void Finish();
 
 	bool Starting() const { return m_State == STATE_START; }
+	int LastWrittenTick() const { return m_LastWrittenTick; }
+
+	// Forget the state that following items are encoded against, so they can
+	// be decoded without knowing the preceding data. Only valid between ticks.
+	void Keyframe();
 
 	void BeginTick(int Tick);
 
@@ -99,6 +124,7 @@ public:
 	int m_Debug; // Possible values: 0, 1, 2.
 
 private:
+	void ResetPrevState();
 	void WriteHeader(const CGameInfo *pGameInfo);
 	void WriteExtra(CUuid Uuid, const void *pData, int DataSize);
 	void EnsureTickWrittenPlayerData(int ClientId);
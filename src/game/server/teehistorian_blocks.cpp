@@ -0,0 +1,156 @@
+#include "teehistorian_blocks.h"
+
+#include <zlib.h>
+
+const CUuid TEEHISTORIAN_BLOCKS_UUID = CalculateUuid("teehistorian-blocks@ddnet.org");
+
+CTeeHistorianBlockWriter::~CTeeHistorianBlockWriter()
+{
+	if(IsOpen())
+		Close();
+}
+
+void CTeeHistorianBlockWriter::Open(IOHANDLE File)
+{
+	dbg_assert(!IsOpen(), "teehistorian block writer already open");
+	m_File = File;
+	m_Error = 0;
+	m_Offset = 0;
+	m_vIndex.clear();
+	m_vBlock.clear();
+	m_vBlock.reserve(2 * BLOCK_SIZE);
+	m_BlockTick = 0;
+	m_Finish = false;
+
+	WriteFile(&TEEHISTORIAN_BLOCKS_UUID, sizeof(TEEHISTORIAN_BLOCKS_UUID));
+
+	sphore_init(&m_Semaphore);
+	m_pThread = thread_init(Thread, this, "teehistorian");
+}
+
+void CTeeHistorianBlockWriter::Close()
+{
+	dbg_assert(IsOpen(), "teehistorian block writer not open");
+	EndBlock(m_BlockTick);
+	{
+		const CLockScope LockScope(m_Lock);
+		m_Finish = true;
+	}
+	sphore_signal(&m_Semaphore);
+	thread_wait(m_pThread);
+	m_pThread = nullptr;
+	sphore_destroy(&m_Semaphore);
+
+	if(io_close(m_File) != 0)
+		m_Error = 1;
+	m_File = nullptr;
+}
+
+void CTeeHistorianBlockWriter::Write(const void *pData, int DataSize)
+{
+	const unsigned char *pBytes = static_cast<const unsigned char *>(pData);
+	m_vBlock.insert(m_vBlock.end(), pBytes, pBytes + DataSize);
+}
+
+void CTeeHistorianBlockWriter::EndBlock(int Tick)
+{
+	if(!m_vBlock.empty())
+	{
+		SBlock Block;
+		Block.m_Tick = m_BlockTick;
+		Block.m_vData.reserve(2 * BLOCK_SIZE);
+		std::swap(Block.m_vData, m_vBlock);
+		{
+			const CLockScope LockScope(m_Lock);
+			m_Queue.push_back(std::move(Block));
+		}
+		sphore_signal(&m_Semaphore);
+	}
+	m_BlockTick = Tick;
+}
+
+uint64_t CTeeHistorianBlockWriter::QueuedBytes()
+{
+	const CLockScope LockScope(m_Lock);
+	uint64_t Bytes = 0;
+	for(const SBlock &Block : m_Queue)
+		Bytes += Block.m_vData.size();
+	return Bytes;
+}
+
+void CTeeHistorianBlockWriter::Thread(void *pUser)
+{
+	static_cast<CTeeHistorianBlockWriter *>(pUser)->RunLoop();
+}
+
+void CTeeHistorianBlockWriter::RunLoop()
+{
+	while(true)
+	{
+		sphore_wait(&m_Semaphore);
+
+		SBlock Block;
+		{
+			const CLockScope LockScope(m_Lock);
+			if(m_Queue.empty())
+			{
+				if(m_Finish)
+					break;
+				continue;
+			}
+			Block = std::move(m_Queue.front());
+			m_Queue.pop_front();
+		}
+		WriteBlock(Block);
+	}
+	WriteIndex();
+}
+
+void CTeeHistorianBlockWriter::WriteFile(const void *pData, unsigned Size)
+{
+	if(io_write(m_File, pData, Size) != Size)
+		m_Error = 1;
+	m_Offset += Size;
+}
+
+void CTeeHistorianBlockWriter::WriteBlock(const SBlock &Block)
+{
+	uLongf CompressedSize = compressBound(Block.m_vData.size());
+	m_vCompressed.resize(TEEHISTORIAN_BLOCK_HEADER_SIZE + CompressedSize);
+	const int Result = compress2(m_vCompressed.data() + TEEHISTORIAN_BLOCK_HEADER_SIZE, &CompressedSize, Block.m_vData.data(), Block.m_vData.size(), Z_DEFAULT_COMPRESSION);
+	if(Result != Z_OK)
+	{
+		dbg_msg("teehistorian", "failed to compress block, result=%d", Result);
+		m_Error = 1;
+		return;
+	}
+	uint_to_bytes_be(&m_vCompressed[0], CompressedSize);
+	uint_to_bytes_be(&m_vCompressed[4], Block.m_vData.size());
+
+	m_vIndex.push_back({Block.m_Tick, m_Offset});
+	WriteFile(m_vCompressed.data(), TEEHISTORIAN_BLOCK_HEADER_SIZE + CompressedSize);
+}
+
+void CTeeHistorianBlockWriter::WriteIndex()
+{
+	unsigned char aEnd[TEEHISTORIAN_BLOCK_HEADER_SIZE] = {0};
+	WriteFile(aEnd, sizeof(aEnd));
+
+	const uint64_t IndexOffset = m_Offset;
+	std::vector<unsigned char> vIndex(4 + m_vIndex.size() * TEEHISTORIAN_BLOCK_INDEX_ENTRY_SIZE);
+	uint_to_bytes_be(&vIndex[0], m_vIndex.size());
+	for(size_t i = 0; i < m_vIndex.size(); i++)
+	{
+		unsigned char *pEntry = &vIndex[4 + i * TEEHISTORIAN_BLOCK_INDEX_ENTRY_SIZE];
+		uint_to_bytes_be(&pEntry[0], m_vIndex[i].m_Tick);
+		uint_to_bytes_be(&pEntry[4], m_vIndex[i].m_Offset >> 32);
+		uint_to_bytes_be(&pEntry[8], m_vIndex[i].m_Offset & 0xffffffff);
+	}
+	WriteFile(vIndex.data(), vIndex.size());
+
+	unsigned char aTrailer[TEEHISTORIAN_BLOCK_TRAILER_SIZE];
+	uint_to_bytes_be(&aTrailer[0], IndexOffset >> 32);
+	uint_to_bytes_be(&aTrailer[4], IndexOffset & 0xffffffff);
+	mem_copy(&aTrailer[8], &TEEHISTORIAN_BLOCKS_UUID, sizeof(TEEHISTORIAN_BLOCKS_UUID));
+	WriteFile(aTrailer, sizeof(aTrailer));
+}
@@ -0,0 +1,133 @@
+#ifndef GAME_SERVER_TEEHISTORIAN_BLOCKS_H
+#define GAME_SERVER_TEEHISTORIAN_BLOCKS_H
+
+#include <base/lock.h>
+#include <base/system.h>
+
+#include <engine/shared/uuid_manager.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/*
+	Block-compressed teehistorian container
+
+	The teehistorian stream is split at tick boundaries into blocks which
+	are zlib-compressed independently. The writer forgets its delta state
+	at the start of every block (see @link CTeeHistorian::Keyframe @endlink),
+	so each block can be decoded without the preceding ones.
+
+	All integers are big-endian.
+
+	file    := TEEHISTORIAN_BLOCKS_UUID block* end index trailer
+	block   := compressed_size:u32 uncompressed_size:u32 zlib_data
+	end     := 0:u32 0:u32
+	index   := num_blocks:u32 (tick:u32 offset:u64)*
+	trailer := index_offset:u64 TEEHISTORIAN_BLOCKS_UUID
+
+	`tick` is the last tick written before the block, `offset` the file
+	offset of the block. The index and trailer are missing if the server
+	did not shut down properly, the blocks can still be read in order.
+*/
+
+extern const CUuid TEEHISTORIAN_BLOCKS_UUID;
+
+enum
+{
+	TEEHISTORIAN_BLOCK_HEADER_SIZE = 8,
+	TEEHISTORIAN_BLOCK_INDEX_ENTRY_SIZE = 12,
+	TEEHISTORIAN_BLOCK_TRAILER_SIZE = 8 + sizeof(CUuid),
+	// Upper bound to reject corrupt blocks before allocating memory for them
+	TEEHISTORIAN_BLOCK_MAX_SIZE = 64 * 1024 * 1024,
+};
+
+/**
+ * Writes a block-compressed teehistorian container.
+ *
+ * Data is collected on the calling thread, compressing and writing the
+ * blocks happens on a separate thread, similar to @link ASYNCIO @endlink.
+ */
+class CTeeHistorianBlockWriter
+{
+public:
+	enum
+	{
+		// Blocks are ended at the next tick after reaching this size
+		BLOCK_SIZE = 256 * 1024,
+	};
+
+	CTeeHistorianBlockWriter() = default;
+	~CTeeHistorianBlockWriter();
+	CTeeHistorianBlockWriter(const CTeeHistorianBlockWriter &Other) = delete;
+	CTeeHistorianBlockWriter &operator=(const CTeeHistorianBlockWriter &Other) = delete;
+
+	/**
+	 * Starts writing to the file. The writer takes ownership of the handle.
+	 */
+	void Open(IOHANDLE File);
+	/**
+	 * Writes the remaining data and the index, then closes the file.
+	 * Blocks until everything has been written.
+	 */
+	void Close();
+	bool IsOpen() const { return m_pThread != nullptr; }
+
+	void Write(const void *pData, int DataSize);
+
+	bool BlockFull() const { return m_vBlock.size() >= BLOCK_SIZE; }
+	/**
+	 * Ends the current block and starts a new one.
+	 *
+	 * @param Tick Last tick written before the new block.
+	 */
+	void EndBlock(int Tick);
+
+	/**
+	 * @return `0` if no error occurred, non-zero otherwise.
+	 */
+	int Error() const { return m_Error.load(); }
+	/**
+	 * @return Bytes of ended blocks that are not compressed and written yet.
+	 */
+	uint64_t QueuedBytes();
+
+private:
+	struct SBlock
+	{
+		int m_Tick;
+		std::vector<unsigned char> m_vData;
+	};
+	struct SIndexEntry
+	{
+		int m_Tick;
+		uint64_t m_Offset;
+	};
+
+	static void Thread(void *pUser);
+	void RunLoop();
+	void WriteFile(const void *pData, unsigned Size);
+	void WriteBlock(const SBlock &Block);
+	void WriteIndex();
+
+	IOHANDLE m_File = nullptr;
+	void *m_pThread = nullptr;
+	SEMAPHORE m_Semaphore;
+	std::atomic<int> m_Error = 0;
+
+	// Only accessed by the calling thread
+	std::vector<unsigned char> m_vBlock;
+	int m_BlockTick = 0;
+
+	CLock m_Lock;
+	std::deque<SBlock> m_Queue GUARDED_BY(m_Lock);
+	bool m_Finish GUARDED_BY(m_Lock) = false;
+
+	// Only accessed by the writer thread
+	uint64_t m_Offset = 0;
+	std::vector<SIndexEntry> m_vIndex;
+	std::vector<unsigned char> m_vCompressed;
+};
+
+#endif
@@ -0,0 +1,482 @@
+#include "teehistorian_reader.h"
+
+#include "teehistorian.h"
+#include "teehistorian_blocks.h"
+
+#include <engine/shared/compression.h>
+#include <engine/shared/json.h>
+
+#include <zlib.h>
+
+int CTeeHistorianReader::CCursor::GetInt()
+{
+	if(m_Result != PARSE_OK)
+		return 0;
+	int Value;
+	const unsigned char *pNext = m_pCurrent < m_pEnd ? CVariableInt::Unpack(m_pCurrent, &Value, m_pEnd - m_pCurrent) : nullptr;
+	if(!pNext)
+	{
+		m_Result = PARSE_SHORT;
+		return 0;
+	}
+	m_pCurrent = pNext;
+	return Value;
+}
+
+const char *CTeeHistorianReader::CCursor::GetString()
+{
+	if(m_Result != PARSE_OK)
+		return "";
+	const unsigned char *pTerminator = static_cast<const unsigned char *>(memchr(m_pCurrent, 0, m_pEnd - m_pCurrent));
+	if(!pTerminator)
+	{
+		m_Result = PARSE_SHORT;
+		return "";
+	}
+	const char *pString = (const char *)m_pCurrent;
+	m_pCurrent = pTerminator + 1;
+	return pString;
+}
+
+const unsigned char *CTeeHistorianReader::CCursor::GetRaw(int Size)
+{
+	if(m_Result != PARSE_OK)
+		return nullptr;
+	if(Size < 0)
+	{
+		m_Result = PARSE_INVALID;
+		return nullptr;
+	}
+	if(m_pEnd - m_pCurrent < Size)
+	{
+		m_Result = PARSE_SHORT;
+		return nullptr;
+	}
+	const unsigned char *pRaw = m_pCurrent;
+	m_pCurrent += Size;
+	return pRaw;
+}
+
+CTeeHistorianReader::~CTeeHistorianReader()
+{
+	Close();
+}
+
+bool CTeeHistorianReader::Open(IOHANDLE File)
+{
+	Close();
+	m_File = File;
+
+	CUuid Magic;
+	const unsigned MagicSize = io_read(m_File, &Magic, sizeof(Magic));
+	if(MagicSize == sizeof(Magic) && Magic == TEEHISTORIAN_BLOCKS_UUID)
+	{
+		m_Blocks = true;
+		// Files of servers that did not shut down properly have no index
+		if(!ReadBlockIndex())
+			m_vBlockIndex.clear();
+		if(io_seek(m_File, sizeof(Magic), IOSEEK_START) != 0 || !ReadBlock())
+		{
+			m_Error = true;
+			return false;
+		}
+		if(!ReadHeader())
+			return false;
+		m_FirstItemOffset = m_Offset;
+		return true;
+	}
+
+	m_vBuffer.resize(4 * READ_CHUNK_SIZE);
+	mem_copy(m_vBuffer.data(), &Magic, MagicSize);
+	m_pData = m_vBuffer.data();
+	m_DataSize = MagicSize;
+	m_Eof = MagicSize < sizeof(Magic);
+	return ReadHeader();
+}
+
+bool CTeeHistorianReader::OpenMemory(const void *pData, size_t DataSize)
+{
+	Close();
+	m_pData = static_cast<const unsigned char *>(pData);
+	m_DataSize = DataSize;
+	return ReadHeader();
+}
+
+void CTeeHistorianReader::Close()
+{
+	if(m_File)
+	{
+		io_close(m_File);
+		m_File = nullptr;
+	}
+	if(m_pHeader)
+	{
+		json_value_free(m_pHeader);
+		m_pHeader = nullptr;
+	}
+	m_vBuffer.clear();
+	m_pData = nullptr;
+	m_DataSize = 0;
+	m_Offset = 0;
+	m_Eof = true;
+	m_Blocks = false;
+	m_FirstItemOffset = 0;
+	m_vCompressed.clear();
+	m_vBlockIndex.clear();
+	m_vHeaderString.clear();
+	m_pHeaderString = "";
+	m_Tick = 0;
+	m_Finished = false;
+	m_Error = false;
+	ResetState();
+}
+
+void CTeeHistorianReader::ResetState()
+{
+	// Tick 0 is implicit at the start, the first player data starts tick 1
+	m_LastPlayerClientId = MAX_CLIENTS;
+	for(auto &Player : m_aPlayers)
+	{
+		Player = {};
+	}
+}
+
+bool CTeeHistorianReader::ReadBlockIndex()
+{
+	const int64_t Length = io_length(m_File);
+	unsigned char aTrailer[TEEHISTORIAN_BLOCK_TRAILER_SIZE];
+	if(Length < (int64_t)(sizeof(CUuid) + sizeof(aTrailer)) ||
+		io_seek(m_File, Length - sizeof(aTrailer), IOSEEK_START) != 0 ||
+		io_read(m_File, aTrailer, sizeof(aTrailer)) != sizeof(aTrailer) ||
+		mem_comp(&aTrailer[8], &TEEHISTORIAN_BLOCKS_UUID, sizeof(TEEHISTORIAN_BLOCKS_UUID)) != 0)
+	{
+		return false;
+	}
+
+	const int64_t IndexOffset = ((int64_t)bytes_be_to_uint(&aTrailer[0]) << 32) | bytes_be_to_uint(&aTrailer[4]);
+	unsigned char aNumBlocks[4];
+	if(IndexOffset < (int64_t)sizeof(CUuid) || IndexOffset > Length ||
+		io_seek(m_File, IndexOffset, IOSEEK_START) != 0 ||
+		io_read(m_File, aNumBlocks, sizeof(aNumBlocks)) != sizeof(aNumBlocks))
+	{
+		return false;
+	}
+	const unsigned NumBlocks = bytes_be_to_uint(aNumBlocks);
+	if(NumBlocks > (Length - IndexOffset) / TEEHISTORIAN_BLOCK_INDEX_ENTRY_SIZE)
+		return false;
+
+	std::vector<unsigned char> vEntries(NumBlocks * TEEHISTORIAN_BLOCK_INDEX_ENTRY_SIZE);
+	if(io_read(m_File, vEntries.data(), vEntries.size()) != vEntries.size())
+		return false;
+	m_vBlockIndex.resize(NumBlocks);
+	for(unsigned i = 0; i < NumBlocks; i++)
+	{
+		const unsigned char *pEntry = &vEntries[i * TEEHISTORIAN_BLOCK_INDEX_ENTRY_SIZE];
+		m_vBlockIndex[i].m_Tick = bytes_be_to_uint(&pEntry[0]);
+		m_vBlockIndex[i].m_Offset = ((int64_t)bytes_be_to_uint(&pEntry[4]) << 32) | bytes_be_to_uint(&pEntry[8]);
+	}
+	return true;
+}
+
+bool CTeeHistorianReader::ReadBlock()
+{
+	// A missing or partial block means the stream was cut off
+	unsigned char aHeader[TEEHISTORIAN_BLOCK_HEADER_SIZE];
+	if(io_read(m_File, aHeader, sizeof(aHeader)) != sizeof(aHeader))
+		return false;
+	const unsigned CompressedSize = bytes_be_to_uint(&aHeader[0]);
+	const unsigned UncompressedSize = bytes_be_to_uint(&aHeader[4]);
+	if(CompressedSize == 0 && UncompressedSize == 0)
+		return false;
+	if(CompressedSize > TEEHISTORIAN_BLOCK_MAX_SIZE || UncompressedSize > TEEHISTORIAN_BLOCK_MAX_SIZE)
+	{
+		m_Error = true;
+		return false;
+	}
+
+	m_vCompressed.resize(CompressedSize);
+	if(io_read(m_File, m_vCompressed.data(), CompressedSize) != CompressedSize)
+		return false;
+	m_vBuffer.resize(UncompressedSize);
+	uLongf Size = UncompressedSize;
+	if(uncompress(m_vBuffer.data(), &Size, m_vCompressed.data(), CompressedSize) != Z_OK || Size != UncompressedSize)
+	{
+		m_Error = true;
+		return false;
+	}
+
+	m_pData = m_vBuffer.data();
+	m_DataSize = Size;
+	m_Offset = 0;
+	// The writer forgets its state at the start of every block
+	ResetState();
+	return true;
+}
+
+bool CTeeHistorianReader::SeekTick(int Tick)
+{
+	if(!m_Blocks || m_vBlockIndex.empty())
+		return false;
+
+	size_t Block = 0;
+	while(Block + 1 < m_vBlockIndex.size() && m_vBlockIndex[Block + 1].m_Tick < Tick)
+		Block++;
+
+	m_Finished = false;
+	m_Error = false;
+	if(io_seek(m_File, m_vBlockIndex[Block].m_Offset, IOSEEK_START) != 0 || !ReadBlock())
+	{
+		m_Error = true;
+		return false;
+	}
+	if(Block == 0)
+		m_Offset = m_FirstItemOffset;
+	m_Tick = m_vBlockIndex[Block].m_Tick;
+	return true;
+}
+
+bool CTeeHistorianReader::Fill(size_t MinSize)
+{
+	if(m_DataSize - m_Offset >= MinSize)
+		return true;
+	if(m_Eof)
+		return false;
+
+	const size_t Remaining = m_DataSize - m_Offset;
+	mem_move(m_vBuffer.data(), m_vBuffer.data() + m_Offset, Remaining);
+	m_DataSize = Remaining;
+	m_Offset = 0;
+	if(m_vBuffer.size() < MinSize)
+		m_vBuffer.resize(2 * MinSize);
+	m_pData = m_vBuffer.data();
+
+	while(m_DataSize < m_vBuffer.size())
+	{
+		const size_t Wanted = minimum<size_t>(m_vBuffer.size() - m_DataSize, READ_CHUNK_SIZE);
+		const unsigned Read = io_read(m_File, m_vBuffer.data() + m_DataSize, Wanted);
+		m_DataSize += Read;
+		if(Read < Wanted)
+		{
+			m_Eof = true;
+			break;
+		}
+	}
+	return m_DataSize >= MinSize;
+}
+
+bool CTeeHistorianReader::ReadHeader()
+{
+	if(!Fill(sizeof(TEEHISTORIAN_UUID)) || mem_comp(m_pData, &TEEHISTORIAN_UUID, sizeof(TEEHISTORIAN_UUID)) != 0)
+	{
+		m_Error = true;
+		return false;
+	}
+	m_Offset += sizeof(TEEHISTORIAN_UUID);
+
+	size_t Length = 0;
+	while(true)
+	{
+		const unsigned char *pTerminator = static_cast<const unsigned char *>(memchr(m_pData + m_Offset + Length, 0, m_DataSize - m_Offset - Length));
+		if(pTerminator)
+		{
+			Length = pTerminator - (m_pData + m_Offset);
+			break;
+		}
+		Length = m_DataSize - m_Offset;
+		if(!Fill(Length + 1))
+		{
+			m_Error = true;
+			return false;
+		}
+	}
+
+	m_vHeaderString.assign(m_pData + m_Offset, m_pData + m_Offset + Length + 1);
+	m_pHeaderString = m_vHeaderString.data();
+	m_pHeader = json_parse(m_pHeaderString, Length);
+	m_Offset += Length + 1;
+	return true;
+}
+
+void CTeeHistorianReader::ParseItem(CCursor *pCursor, CItem *pItem, int *pType)
+{
+	const int First = pCursor->GetInt();
+	const int Type = First >= 0 ? TEEHISTORIAN_NONE : -First;
+	*pType = Type;
+	const int NumInputInts = sizeof(CNetObj_PlayerInput) / sizeof(int32_t);
+
+	pItem->m_ClientId = -1;
+	switch(Type)
+	{
+	case TEEHISTORIAN_NONE:
+		pItem->m_Type = EItem::PLAYER_DIFF;
+		pItem->m_ClientId = First;
+		pItem->m_X = pCursor->GetInt();
+		pItem->m_Y = pCursor->GetInt();
+		break;
+	case TEEHISTORIAN_FINISH:
+		break;
+	case TEEHISTORIAN_TICK_SKIP:
+		// Stored in `m_X` until it is applied in `Read`
+		pItem->m_X = pCursor->GetInt();
+		break;
+	case TEEHISTORIAN_PLAYER_NEW:
+		pItem->m_Type = EItem::PLAYER_NEW;
+		pItem->m_ClientId = pCursor->GetInt();
+		pItem->m_X = pCursor->GetInt();
+		pItem->m_Y = pCursor->GetInt();
+		break;
+	case TEEHISTORIAN_PLAYER_OLD:
+		pItem->m_Type = EItem::PLAYER_OLD;
+		pItem->m_ClientId = pCursor->GetInt();
+		break;
+	case TEEHISTORIAN_INPUT_DIFF:
+	case TEEHISTORIAN_INPUT_NEW:
+		pItem->m_Type = Type == TEEHISTORIAN_INPUT_DIFF ? EItem::INPUT_DIFF : EItem::INPUT_NEW;
+		pItem->m_ClientId = pCursor->GetInt();
+		for(int i = 0; i < NumInputInts; i++)
+		{
+			((int *)&pItem->m_Input)[i] = pCursor->GetInt();
+		}
+		break;
+	case TEEHISTORIAN_MESSAGE:
+		pItem->m_Type = EItem::MESSAGE;
+		pItem->m_ClientId = pCursor->GetInt();
+		pItem->m_DataSize = pCursor->GetInt();
+		pItem->m_pData = pCursor->GetRaw(pItem->m_DataSize);
+		break;
+	case TEEHISTORIAN_JOIN:
+		pItem->m_Type = EItem::JOIN;
+		pItem->m_ClientId = pCursor->GetInt();
+		break;
+	case TEEHISTORIAN_DROP:
+		pItem->m_Type = EItem::DROP;
+		pItem->m_ClientId = pCursor->GetInt();
+		pItem->m_pString = pCursor->GetString();
+		break;
+	case TEEHISTORIAN_CONSOLE_COMMAND:
+	{
+		pItem->m_Type = EItem::CONSOLE_COMMAND;
+		pItem->m_ClientId = pCursor->GetInt();
+		pItem->m_FlagMask = pCursor->GetInt();
+		pItem->m_pString = pCursor->GetString();
+		const int NumArguments = pCursor->GetInt();
+		pItem->m_vpArguments.clear();
+		for(int i = 0; i < NumArguments && pCursor->m_Result == PARSE_OK; i++)
+		{
+			pItem->m_vpArguments.push_back(pCursor->GetString());
+		}
+		break;
+	}
+	case TEEHISTORIAN_EX:
+	{
+		pItem->m_Type = EItem::EX;
+		const unsigned char *pUuid = pCursor->GetRaw(sizeof(pItem->m_Uuid));
+		if(pUuid)
+			mem_copy(&pItem->m_Uuid, pUuid, sizeof(pItem->m_Uuid));
+		pItem->m_DataSize = pCursor->GetInt();
+		pItem->m_pData = pCursor->GetRaw(pItem->m_DataSize);
+		break;
+	}
+	default:
+		pCursor->m_Result = PARSE_INVALID;
+		break;
+	}
+}
+
+bool CTeeHistorianReader::Read(CItem *pItem)
+{
+	while(!m_Finished && !m_Error)
+	{
+		CCursor Cursor = {m_pData + m_Offset, m_pData + m_DataSize, PARSE_OK};
+		int Type;
+		ParseItem(&Cursor, pItem, &Type);
+		if(Cursor.m_Result == PARSE_SHORT)
+		{
+			// Either the item continues beyond the buffered data or the stream is truncated
+			const size_t Remaining = m_DataSize - m_Offset;
+			if(Fill(Remaining + 1))
+				continue;
+			// Items never cross block boundaries
+			if(m_Blocks && Remaining == 0 && ReadBlock())
+				continue;
+			if(Remaining > 0)
+				m_Error = true;
+			return false;
+		}
+		if(Cursor.m_Result == PARSE_INVALID)
+		{
+			m_Error = true;
+			return false;
+		}
+		m_Offset = Cursor.m_pCurrent - m_pData;
+
+		if(Type == TEEHISTORIAN_FINISH)
+		{
+			m_Finished = true;
+			return false;
+		}
+		if(Type == TEEHISTORIAN_TICK_SKIP)
+		{
+			if(pItem->m_X < 0)
+			{
+				m_Error = true;
+				return false;
+			}
+			m_Tick += pItem->m_X + 1;
+			m_LastPlayerClientId = -1;
+			continue;
+		}
+
+		const bool PlayerItem = pItem->m_Type == EItem::PLAYER_DIFF || pItem->m_Type == EItem::PLAYER_NEW || pItem->m_Type == EItem::PLAYER_OLD;
+		const bool InputItem = pItem->m_Type == EItem::INPUT_DIFF || pItem->m_Type == EItem::INPUT_NEW;
+		if((PlayerItem || InputItem || pItem->m_Type == EItem::JOIN) && (pItem->m_ClientId < 0 || pItem->m_ClientId >= MAX_CLIENTS))
+		{
+			m_Error = true;
+			return false;
+		}
+
+		if(PlayerItem)
+		{
+			// Player data is written in ascending client id order, a smaller
+			// or equal client id starts a new tick unless it was skipped to explicitly
+			if(pItem->m_ClientId <= m_LastPlayerClientId)
+				m_Tick++;
+			m_LastPlayerClientId = pItem->m_ClientId;
+
+			CPlayer &Player = m_aPlayers[pItem->m_ClientId];
+			if(pItem->m_Type == EItem::PLAYER_DIFF)
+			{
+				if(!Player.m_Alive)
+				{
+					m_Error = true;
+					return false;
+				}
+				pItem->m_X += Player.m_X;
+				pItem->m_Y += Player.m_Y;
+			}
+			Player.m_Alive = pItem->m_Type != EItem::PLAYER_OLD;
+			if(Player.m_Alive)
+			{
+				Player.m_X = pItem->m_X;
+				Player.m_Y = pItem->m_Y;
+			}
+		}
+		else if(InputItem)
+		{
+			CPlayer &Player = m_aPlayers[pItem->m_ClientId];
+			// The writer diffs against a zeroed input before the first one
+			if(pItem->m_Type == EItem::INPUT_DIFF)
+			{
+				for(size_t i = 0; i < sizeof(CNetObj_PlayerInput) / sizeof(int32_t); i++)
+				{
+					((int *)&pItem->m_Input)[i] += ((const int *)&Player.m_Input)[i];
+				}
+			}
+			Player.m_Input = pItem->m_Input;
+		}
+
+		pItem->m_Tick = m_Tick;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,200 @@
+#ifndef GAME_SERVER_TEEHISTORIAN_READER_H
+#define GAME_SERVER_TEEHISTORIAN_READER_H
+
+#include <base/system.h>
+
+#include <engine/shared/protocol.h>
+#include <engine/shared/uuid_manager.h>
+
+#include <generated/protocol.h>
+
+#include <vector>
+
+typedef struct _json_value json_value;
+
+/**
+ * Streaming reader for files written by @link CTeeHistorian @endlink.
+ *
+ * Items are decoded directly from the read buffer: strings and raw data of
+ * an item point into the buffer and are only valid until the next call to
+ * @link Read @endlink. Implicit ticks, position diffs and input diffs are
+ * resolved by the reader, so every item carries absolute values.
+ *
+ * Block-compressed files (see @link CTeeHistorianBlockWriter @endlink) are
+ * detected and decompressed transparently.
+ */
+class CTeeHistorianReader
+{
+public:
+	enum class EItem
+	{
+		PLAYER_DIFF,
+		PLAYER_NEW,
+		PLAYER_OLD,
+		INPUT_DIFF,
+		INPUT_NEW,
+		MESSAGE,
+		JOIN,
+		DROP,
+		CONSOLE_COMMAND,
+		EX,
+	};
+
+	class CItem
+	{
+	public:
+		EItem m_Type;
+		// Tick the item was recorded in. Player items describe the state at
+		// the end of that tick, all other items happened after it.
+		int m_Tick;
+		int m_ClientId;
+
+		// PLAYER_DIFF, PLAYER_NEW
+		int m_X;
+		int m_Y;
+
+		// INPUT_DIFF, INPUT_NEW
+		CNetObj_PlayerInput m_Input;
+
+		// MESSAGE, EX
+		const void *m_pData;
+		int m_DataSize;
+
+		// EX
+		CUuid m_Uuid;
+
+		// DROP: the reason, CONSOLE_COMMAND: the command name
+		const char *m_pString;
+
+		// CONSOLE_COMMAND
+		int m_FlagMask;
+		std::vector<const char *> m_vpArguments;
+	};
+
+	CTeeHistorianReader() = default;
+	~CTeeHistorianReader();
+	CTeeHistorianReader(const CTeeHistorianReader &Other) = delete;
+	CTeeHistorianReader &operator=(const CTeeHistorianReader &Other) = delete;
+
+	/**
+	 * Starts reading from a file. The reader takes ownership of the handle.
+	 *
+	 * @return `false` if the file does not start with a valid header.
+	 */
+	bool Open(IOHANDLE File);
+	/**
+	 * Starts reading from memory. The data is not copied and must stay valid
+	 * while the reader is used.
+	 *
+	 * @return `false` if the data does not start with a valid header.
+	 */
+	bool OpenMemory(const void *pData, size_t DataSize);
+	void Close();
+
+	/**
+	 * @return The JSON header, `nullptr` if it is not valid JSON.
+	 */
+	const json_value *Header() const { return m_pHeader; }
+	const char *HeaderString() const { return m_pHeaderString; }
+
+	/**
+	 * Continues reading at the start of the block that contains the given
+	 * tick, or the last block before it. Items of earlier ticks in that
+	 * block are returned as well and must be skipped by the caller.
+	 *
+	 * @return `false` if the file has no block index.
+	 */
+	bool SeekTick(int Tick);
+	bool CanSeek() const { return !m_vBlockIndex.empty(); }
+
+	/**
+	 * Reads the next item.
+	 *
+	 * @return `false` at the end of the stream or on error.
+	 */
+	bool Read(CItem *pItem);
+
+	/**
+	 * @return Whether the stream was properly finished by the server.
+	 */
+	bool Finished() const { return m_Finished; }
+	/**
+	 * @return Whether the stream contained malformed data.
+	 */
+	bool Error() const { return m_Error; }
+	/**
+	 * @return Tick of the last item read, or of the end of the stream.
+	 */
+	int Tick() const { return m_Tick; }
+
+private:
+	enum
+	{
+		READ_CHUNK_SIZE = 64 * 1024,
+	};
+
+	enum
+	{
+		PARSE_OK,
+		PARSE_SHORT,
+		PARSE_INVALID,
+	};
+
+	class CCursor
+	{
+	public:
+		const unsigned char *m_pCurrent;
+		const unsigned char *m_pEnd;
+		int m_Result;
+
+		int GetInt();
+		const char *GetString();
+		const unsigned char *GetRaw(int Size);
+	};
+
+	struct SBlockIndexEntry
+	{
+		int m_Tick;
+		int64_t m_Offset;
+	};
+
+	bool ReadHeader();
+	bool ReadBlockIndex();
+	bool ReadBlock();
+	void ResetState();
+	bool Fill(size_t MinSize);
+	void ParseItem(CCursor *pCursor, CItem *pItem, int *pType);
+
+	struct CPlayer
+	{
+		bool m_Alive;
+		int m_X;
+		int m_Y;
+		CNetObj_PlayerInput m_Input;
+	};
+
+	IOHANDLE m_File = nullptr;
+	std::vector<unsigned char> m_vBuffer;
+	const unsigned char *m_pData = nullptr;
+	size_t m_DataSize = 0;
+	size_t m_Offset = 0;
+	bool m_Eof = true;
+
+	// Block-compressed files only
+	bool m_Blocks = false;
+	size_t m_FirstItemOffset = 0;
+	std::vector<unsigned char> m_vCompressed;
+	std::vector<SBlockIndexEntry> m_vBlockIndex;
+
+	std::vector<char> m_vHeaderString;
+	const char *m_pHeaderString = "";
+	json_value *m_pHeader = nullptr;
+
+	int m_Tick = 0;
+	int m_LastPlayerClientId = MAX_CLIENTS;
+	bool m_Finished = false;
+	bool m_Error = false;
+	CPlayer m_aPlayers[MAX_CLIENTS] = {};
+};
+
+#endif
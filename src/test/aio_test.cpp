@@ -4,6 +4,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 static const int BUF_SIZE = 64 * 1024;
 
 class Async : public ::testing::Test
@@ -29,6 +31,16 @@ protected:
 		}
 	}
 
+	void Reopen(unsigned BufferSize)
+	{
+		aio_close(m_pAio);
+		aio_wait(m_pAio);
+		aio_free(m_pAio);
+		IOHANDLE File = io_open(m_Info.m_aFilename, IOFLAG_WRITE);
+		ASSERT_TRUE(File);
+		m_pAio = aio_new(File, BufferSize);
+	}
+
 	void Write(const char *pText)
 	{
 		aio_write(m_pAio, pText, str_length(pText));
@@ -50,6 +62,8 @@ protected:
 		ASSERT_TRUE(mem_comp(aBuf, pOutput, Read) == 0);
 		Delete = true;
 	}
+
+	void ExpectMultipleWriters();
 };
 
 TEST_F(Async, Empty)
@@ -145,3 +159,149 @@ TEST_F(Async, Transaction)
 	}
 	Expect(aText);
 }
+
+struct SAsyncWriter
+{
+	ASYNCIO *m_pAio;
+	char m_Letter;
+};
+
+static void AsyncWriterThread(void *pUser)
+{
+	const SAsyncWriter *pWriter = static_cast<SAsyncWriter *>(pUser);
+	char aLine[] = "?????????\n";
+	for(int i = 0; i < BUF_SIZE / 4; i++)
+	{
+		for(unsigned j = 0; j < sizeof(aLine) - 2; j++)
+		{
+			aLine[j] = pWriter->m_Letter;
+		}
+		aio_write(pWriter->m_pAio, aLine, sizeof(aLine) - 1);
+	}
+}
+
+void Async::ExpectMultipleWriters()
+{
+	static const int NUM_WRITERS = 4;
+	SAsyncWriter aWriters[NUM_WRITERS];
+	void *apThreads[NUM_WRITERS];
+	for(int i = 0; i < NUM_WRITERS; i++)
+	{
+		aWriters[i] = {m_pAio, (char)('a' + i)};
+		apThreads[i] = thread_init(AsyncWriterThread, &aWriters[i], "aio_test");
+	}
+	for(auto *pThread : apThreads)
+	{
+		thread_wait(pThread);
+	}
+
+	ASYNCIO_STATS Stats;
+	aio_stats(m_pAio, &Stats);
+	EXPECT_EQ(Stats.writes, (uint64_t)NUM_WRITERS * BUF_SIZE / 4);
+	EXPECT_EQ(Stats.bytes, (uint64_t)NUM_WRITERS * BUF_SIZE / 4 * 10);
+	aio_close(m_pAio);
+	aio_wait(m_pAio);
+	aio_stats(m_pAio, &Stats);
+	EXPECT_GE(Stats.flushes, 1u);
+	aio_free(m_pAio);
+
+	// Lines of different writers must not be interleaved
+	IOHANDLE File = io_open(m_Info.m_aFilename, IOFLAG_READ);
+	ASSERT_TRUE(File);
+	char *pData = io_read_all_str(File);
+	io_close(File);
+	ASSERT_TRUE(pData);
+	int aNumLines[NUM_WRITERS] = {0};
+	for(const char *pLine = pData; *pLine; pLine += 10)
+	{
+		ASSERT_EQ(pLine[9], '\n');
+		ASSERT_GE(pLine[0], 'a');
+		ASSERT_LT(pLine[0], 'a' + NUM_WRITERS);
+		for(int j = 1; j < 9; j++)
+		{
+			ASSERT_EQ(pLine[j], pLine[0]);
+		}
+		aNumLines[pLine[0] - 'a']++;
+	}
+	free(pData);
+	for(int NumLines : aNumLines)
+	{
+		EXPECT_EQ(NumLines, BUF_SIZE / 4);
+	}
+	Delete = true;
+}
+
+TEST_F(Async, MultipleWriters)
+{
+	ExpectMultipleWriters();
+}
+
+TEST_F(Async, MultipleWritersSmallBuffer)
+{
+	// Writers wait for space most of the time
+	Reopen(64);
+	ExpectMultipleWriters();
+}
+
+TEST_F(Async, SmallBuffer)
+{
+	Reopen(64);
+	static const int NUM_LETTERS = 13;
+	static const int SIZE = BUF_SIZE / NUM_LETTERS * NUM_LETTERS;
+	char aText[SIZE + 1];
+	for(unsigned i = 0; i < sizeof(aText) - 1; i++)
+	{
+		aText[i] = 'a' + i % NUM_LETTERS;
+	}
+	aText[sizeof(aText) - 1] = 0;
+	for(unsigned i = 0; i < (sizeof(aText) - 1) / NUM_LETTERS; i++)
+	{
+		Write("abcdefghijklm");
+	}
+	ASYNCIO_STATS Stats;
+	aio_stats(m_pAio, &Stats);
+	EXPECT_GT(Stats.stalls, 0u);
+	Expect(aText);
+}
+
+TEST_F(Async, WriteError)
+{
+	// Writing to a file opened for reading fails
+	aio_close(m_pAio);
+	aio_wait(m_pAio);
+	aio_free(m_pAio);
+	IOHANDLE File = io_open(m_Info.m_aFilename, IOFLAG_READ);
+	ASSERT_TRUE(File);
+	m_pAio = aio_new(File);
+	Write("a\n");
+	aio_close(m_pAio);
+	aio_wait(m_pAio);
+	EXPECT_NE(aio_error(m_pAio), 0);
+	aio_free(m_pAio);
+	Delete = true;
+}
+
+TEST_F(Async, LongerThanBuffer)
+{
+	// Larger than the internal buffer, queued in several parts
+	std::vector<char> vText(3 * 1024 * 1024 + 7);
+	for(size_t i = 0; i < vText.size(); i++)
+	{
+		vText[i] = 'a' + i % 26;
+	}
+	aio_write(m_pAio, vText.data(), vText.size());
+	aio_close(m_pAio);
+	aio_wait(m_pAio);
+	aio_free(m_pAio);
+
+	IOHANDLE File = io_open(m_Info.m_aFilename, IOFLAG_READ);
+	ASSERT_TRUE(File);
+	void *pData;
+	unsigned DataSize;
+	ASSERT_TRUE(io_read_all(File, &pData, &DataSize));
+	io_close(File);
+	ASSERT_EQ(DataSize, vText.size());
+	EXPECT_TRUE(mem_comp(pData, vText.data(), DataSize) == 0);
+	free(pData);
+	Delete = true;
+}
@@ -0,0 +1,54 @@
+#include <game/alloc.h>
+
+#include <gtest/gtest.h>
+
+TEST(PoolAllocator, ReusesFreedObjects)
+{
+	CPoolAllocator Pool("test", 24, 4);
+	EXPECT_EQ(Pool.Capacity(), 0);
+
+	void *pA = Pool.Allocate();
+	void *pB = Pool.Allocate();
+	EXPECT_NE(pA, pB);
+	EXPECT_EQ(Pool.NumUsed(), 2);
+	EXPECT_EQ(Pool.Capacity(), 4);
+
+	Pool.Free(pA);
+	EXPECT_EQ(Pool.NumUsed(), 1);
+	EXPECT_EQ(Pool.Allocate(), pA);
+	EXPECT_EQ(Pool.PeakUsed(), 2);
+	EXPECT_EQ(Pool.NumAllocations(), 3u);
+
+	Pool.Free(pA);
+	Pool.Free(pB);
+	EXPECT_EQ(Pool.NumUsed(), 0);
+}
+
+TEST(PoolAllocator, SlabsAreContiguous)
+{
+	CPoolAllocator Pool("test", 20, 8);
+	EXPECT_EQ(Pool.ObjectSize(), 24u);
+
+	char *apObjs[9];
+	for(auto &pObj : apObjs)
+		pObj = static_cast<char *>(Pool.Allocate());
+	for(int i = 1; i < 8; i++)
+		EXPECT_EQ(apObjs[i], apObjs[0] + i * Pool.ObjectSize());
+	EXPECT_EQ(Pool.Capacity(), 16);
+
+	for(auto *pObj : apObjs)
+		Pool.Free(pObj);
+}
+
+TEST(PoolAllocator, Registry)
+{
+	bool Found = false;
+	{
+		CPoolAllocator Pool("registry_test", 16, 1);
+		for(const CPoolAllocator *pPool = CPoolAllocator::First(); pPool; pPool = pPool->Next())
+			Found = Found || pPool == &Pool;
+	}
+	EXPECT_TRUE(Found);
+	for(const CPoolAllocator *pPool = CPoolAllocator::First(); pPool; pPool = pPool->Next())
+		EXPECT_STRNE(pPool->Name(), "registry_test");
+}
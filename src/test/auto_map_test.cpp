@@ -0,0 +1,159 @@
+#include <base/system.h>
+
+#include <engine/engine.h>
+#include <engine/shared/linereader.h>
+
+#include <game/editor/auto_map_rules.h>
+#include <game/mapitems.h>
+#include <game/version.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// Three runs: the second one reads the output of the first one, the third
+// one works in place
+static const char RULES[] =
+	"[Test]\n"
+	"Index 1\n"
+	"NoDefaultRule\n"
+	"Pos 0 0 FULL\n"
+	"Index 2\n"
+	"Pos 0 -1 EMPTY\n"
+	"Index 3 XFLIP\n"
+	"Pos 0 1 EMPTY\n"
+	"Random 50%\n"
+	"\n"
+	"NewRun\n"
+	"Index 4\n"
+	"Pos 0 0 INDEX 2\n"
+	"Pos -1 0 INDEX 1 OR 3\n"
+	"Index 5 ROTATE\n"
+	"Pos 0 0 INDEX 1\n"
+	"Pos 1 1 NOTINDEX 0\n"
+	"Modulo 1 2 0 1\n"
+	"\n"
+	"NewRun\n"
+	"NoLayerCopy\n"
+	"Index 6\n"
+	"Pos 0 0 INDEX 5 ROTATE\n"
+	"Pos 1 0 INDEX 5 ROTATE\n";
+
+static const int WIDTH = 160;
+static const int HEIGHT = 140;
+static const int SEED = 1234;
+
+class AutoMap : public ::testing::Test
+{
+protected:
+	CAutoMapRules m_Rules;
+	std::vector<CTile> m_vInput;
+	std::vector<CTile> m_vGame;
+
+	void SetUp() override
+	{
+		char *pRules = (char *)malloc(sizeof(RULES));
+		str_copy(pRules, RULES, sizeof(RULES));
+		CLineReader LineReader;
+		LineReader.OpenBuffer(pRules);
+		m_Rules.LoadRules(LineReader);
+		ASSERT_TRUE(m_Rules.IsLoaded());
+		ASSERT_EQ(m_Rules.ConfigNamesNum(), 1);
+
+		unsigned Random = 1;
+		m_vInput.resize(WIDTH * HEIGHT);
+		for(CTile &Tile : m_vInput)
+		{
+			Random = Random * 1103515245 + 12345;
+			Tile.m_Index = (Random >> 16) % 5 < 2 ? 1 : 0;
+		}
+		m_vGame.resize(WIDTH * HEIGHT);
+	}
+
+	std::vector<CTile> Proceed(IEngine *pEngine, int *pNumChanges = nullptr)
+	{
+		std::vector<CTile> vTiles = m_vInput;
+		int NumChanges = 0;
+		m_Rules.ProceedTiles(vTiles.data(), WIDTH, HEIGHT, m_vGame.data(), WIDTH, HEIGHT, -1, 0, SEED, 0, 0, pEngine, [&](int, int, const CTile &, const CTile &) { NumChanges++; });
+		if(pNumChanges)
+			*pNumChanges = NumChanges;
+		return vTiles;
+	}
+};
+
+static void ExpectSameTiles(const std::vector<CTile> &vExpected, const std::vector<CTile> &vActual)
+{
+	ASSERT_EQ(vExpected.size(), vActual.size());
+	for(size_t i = 0; i < vExpected.size(); i++)
+	{
+		ASSERT_EQ(vExpected[i].m_Index, vActual[i].m_Index) << "x=" << i % WIDTH << " y=" << i / WIDTH;
+		ASSERT_EQ(vExpected[i].m_Flags, vActual[i].m_Flags) << "x=" << i % WIDTH << " y=" << i / WIDTH;
+	}
+}
+
+TEST_F(AutoMap, ParallelMatchesSerial)
+{
+	int NumChanges;
+	const std::vector<CTile> vSerial = Proceed(nullptr, &NumChanges);
+	EXPECT_GT(NumChanges, 0);
+
+	std::unique_ptr<IEngine> pEngine(CreateTestEngine(GAME_NAME));
+	const std::vector<CTile> vParallel = Proceed(pEngine.get());
+	pEngine->ShutdownJobs();
+
+	ExpectSameTiles(vSerial, vParallel);
+	for(int i : {1, 2, 3, 4, 5, 6})
+	{
+		EXPECT_TRUE(std::any_of(vSerial.begin(), vSerial.end(), [i](const CTile &Tile) { return Tile.m_Index == i; })) << "index " << i;
+	}
+}
+
+TEST_F(AutoMap, LocalizedMatchesFull)
+{
+	const std::vector<CTile> vInput = m_vInput;
+	unsigned Random = 7;
+	const auto &&Next = [&Random](int Below) {
+		Random = Random * 1103515245 + 12345;
+		return (int)((Random >> 16) % Below);
+	};
+	for(int i = 0; i < 50; i++)
+	{
+		// draw some tiles, also at the borders of the layer
+		const int Width = 1 + Next(12);
+		const int Height = 1 + Next(12);
+		const int X = i % 5 == 0 ? 0 : i % 5 == 1 ? WIDTH - Width : Next(WIDTH - Width);
+		const int Y = i % 7 == 0 ? 0 : i % 7 == 1 ? HEIGHT - Height : Next(HEIGHT - Height);
+		m_vInput = vInput;
+		for(int y = Y; y < Y + Height; y++)
+		{
+			for(int x = X; x < X + Width; x++)
+				m_vInput[y * WIDTH + x].m_Index = Next(3) == 0;
+		}
+		const std::vector<CTile> vFull = Proceed(nullptr);
+
+		// the tiles the rules of the drawn tiles reach are updated like in
+		// a full run, the rest stays untouched
+		std::vector<CTile> vExpected = m_vInput;
+		int NumCommitted = 0;
+		for(int y = std::max(Y - 1, 0); y < std::min(Y + Height + 1, HEIGHT); y++)
+		{
+			for(int x = std::max(X - 1, 0); x < std::min(X + Width + 1, WIDTH); x++)
+			{
+				vExpected[y * WIDTH + x] = vFull[y * WIDTH + x];
+				NumCommitted++;
+			}
+		}
+
+		std::vector<CTile> vLocalized = m_vInput;
+		std::vector<CTile> vGame = m_vGame;
+		int NumChanges = 0;
+		m_Rules.ProceedTilesLocalized(vLocalized.data(), WIDTH, HEIGHT, vGame.data(), WIDTH, -1, 0, SEED, X, Y, Width, Height, nullptr, [&](int, int, const CTile &, const CTile &) { NumChanges++; }, [](int, int, const CTile &, const CTile &) {});
+		EXPECT_EQ(NumChanges, NumCommitted);
+		ExpectSameTiles(vExpected, vLocalized);
+		ExpectSameTiles(m_vGame, vGame);
+		if(HasFatalFailure())
+			return;
+	}
+}
@@ -0,0 +1,188 @@
+#include "test.h"
+
+#include <base/system.h>
+
+#include <engine/kernel.h>
+#include <engine/map.h>
+#include <engine/storage.h>
+
+#include <game/collision.h>
+#include <game/layers.h>
+#include <game/mapitems.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+// A map loaded into the collision, with the raw tele, speedup, switch and
+// tune layers next to it
+class CCollisionMap
+{
+public:
+	CTestInfo m_TestInfo;
+	std::unique_ptr<IStorage> m_pStorage;
+	std::unique_ptr<IKernel> m_pKernel;
+	IEngineMap *m_pMap = nullptr;
+	CLayers m_Layers;
+	CCollision m_Collision;
+
+	const CTile *m_pFront = nullptr;
+	const CTeleTile *m_pTele = nullptr;
+	const CSpeedupTile *m_pSpeedup = nullptr;
+	const CSwitchTile *m_pSwitch = nullptr;
+	const CTuneTile *m_pTune = nullptr;
+
+	bool Load(const char *pMapName)
+	{
+		m_TestInfo.m_DeleteTestStorageFilesOnSuccess = true;
+		m_pStorage = m_TestInfo.CreateTestStorage();
+		if(!m_pStorage)
+			return false;
+		m_pKernel = std::unique_ptr<IKernel>(IKernel::Create());
+		m_pKernel->RegisterInterface(m_pStorage.get(), false);
+		m_pMap = CreateEngineMap();
+		m_pKernel->RegisterInterface(m_pMap);
+		if(!m_pMap->Load(pMapName, IStorage::TYPE_ALL))
+			return false;
+		m_Layers.Init(m_pMap, false);
+		m_Collision.Init(&m_Layers);
+
+		// the collision normalizes the switch layer in place, so this is
+		// read after loading it
+		if(m_Layers.FrontLayer())
+			m_pFront = static_cast<CTile *>(m_pMap->GetData(m_Layers.FrontLayer()->m_Front));
+		if(m_Layers.TeleLayer())
+			m_pTele = static_cast<CTeleTile *>(m_pMap->GetData(m_Layers.TeleLayer()->m_Tele));
+		if(m_Layers.SpeedupLayer())
+			m_pSpeedup = static_cast<CSpeedupTile *>(m_pMap->GetData(m_Layers.SpeedupLayer()->m_Speedup));
+		if(m_Layers.SwitchLayer())
+			m_pSwitch = static_cast<CSwitchTile *>(m_pMap->GetData(m_Layers.SwitchLayer()->m_Switch));
+		if(m_Layers.TuneLayer())
+			m_pTune = static_cast<CTuneTile *>(m_pMap->GetData(m_Layers.TuneLayer()->m_Tune));
+		return true;
+	}
+
+	// TileExists as it was implemented on the separate layers
+	bool RawTileExists(int Index) const
+	{
+		const auto &&IsExistingTile = [](int TileIndex) {
+			return (TileIndex >= TILE_FREEZE && TileIndex <= TILE_TELE_LASER_DISABLE) || (TileIndex >= TILE_LFREEZE && TileIndex <= TILE_LUNFREEZE);
+		};
+		if(IsExistingTile(m_Collision.GetTileIndex(Index)))
+			return true;
+		if(m_pFront && IsExistingTile(m_pFront[Index].m_Index))
+			return true;
+		if(m_pTele && (m_pTele[Index].m_Type == TILE_TELEIN || m_pTele[Index].m_Type == TILE_TELEINEVIL || m_pTele[Index].m_Type == TILE_TELECHECKINEVIL || m_pTele[Index].m_Type == TILE_TELECHECK || m_pTele[Index].m_Type == TILE_TELECHECKIN))
+			return true;
+		if(m_pSpeedup && m_pSpeedup[Index].m_Force > 0)
+			return true;
+		CDoorTile Door;
+		m_Collision.GetDoorTile(Index, &Door);
+		if(Door.m_Index)
+			return true;
+		if(m_pSwitch && m_pSwitch[Index].m_Type)
+			return true;
+		if(m_pTune && m_pTune[Index].m_Type)
+			return true;
+		return m_Collision.TileExistsNext(Index);
+	}
+
+	void ExpectFeaturesMatchLayers() const
+	{
+		for(int i = 0; i < m_Collision.GetWidth() * m_Collision.GetHeight(); i++)
+		{
+			const CTileFeatures &Features = m_Collision.GetTileFeatures(i);
+			const CTeleTile Tele = m_pTele ? m_pTele[i] : CTeleTile{};
+			const CSpeedupTile Speedup = m_pSpeedup ? m_pSpeedup[i] : CSpeedupTile{};
+			const CSwitchTile Switch = m_pSwitch ? m_pSwitch[i] : CSwitchTile{};
+			const CTuneTile Tune = m_pTune ? m_pTune[i] : CTuneTile{};
+
+			EXPECT_EQ(Features.m_TeleType, Tele.m_Type) << "tile " << i;
+			EXPECT_EQ(Features.m_TeleNumber, Tele.m_Number) << "tile " << i;
+			EXPECT_EQ(Features.m_SpeedupForce, Speedup.m_Force) << "tile " << i;
+			EXPECT_EQ(Features.m_SpeedupMaxSpeed, Speedup.m_MaxSpeed) << "tile " << i;
+			EXPECT_EQ(Features.m_SpeedupType, Speedup.m_Type) << "tile " << i;
+			EXPECT_EQ(Features.m_SpeedupAngle, Speedup.m_Angle) << "tile " << i;
+			EXPECT_EQ(Features.m_SwitchType, Switch.m_Type) << "tile " << i;
+			EXPECT_EQ(Features.m_SwitchNumber, Switch.m_Type ? Switch.m_Number : 0) << "tile " << i;
+			EXPECT_EQ(Features.m_SwitchDelay, Switch.m_Type ? Switch.m_Delay : 0) << "tile " << i;
+			EXPECT_EQ(Features.m_TuneZone, Tune.m_Type ? Tune.m_Number : 0) << "tile " << i;
+			const bool Exists = Tele.m_Type == TILE_TELEIN || Tele.m_Type == TILE_TELEINEVIL || Tele.m_Type == TILE_TELECHECKINEVIL || Tele.m_Type == TILE_TELECHECK || Tele.m_Type == TILE_TELECHECKIN ||
+					    Speedup.m_Force > 0 || Switch.m_Type || Tune.m_Type;
+			EXPECT_EQ((Features.m_Flags & CTileFeatures::FLAG_EXISTS) != 0, Exists) << "tile " << i;
+			EXPECT_EQ(m_Collision.TileExists(i), RawTileExists(i)) << "tile " << i;
+
+			// the getters read the features
+			EXPECT_EQ(m_Collision.IsTeleport(i), Tele.m_Type == TILE_TELEIN ? Tele.m_Number : 0) << "tile " << i;
+			EXPECT_EQ(m_Collision.IsEvilTeleport(i), Tele.m_Type == TILE_TELEINEVIL ? Tele.m_Number : 0) << "tile " << i;
+			EXPECT_EQ(m_Collision.IsCheckTeleport(i), Tele.m_Type == TILE_TELECHECKIN) << "tile " << i;
+			EXPECT_EQ(m_Collision.IsCheckEvilTeleport(i), Tele.m_Type == TILE_TELECHECKINEVIL) << "tile " << i;
+			EXPECT_EQ(m_Collision.IsTeleCheckpoint(i), Tele.m_Type == TILE_TELECHECK ? Tele.m_Number : 0) << "tile " << i;
+			EXPECT_EQ(m_Collision.IsTeleportWeapon(i), Tele.m_Type == TILE_TELEINWEAPON ? Tele.m_Number : 0) << "tile " << i;
+			EXPECT_EQ(m_Collision.IsTeleportHook(i), Tele.m_Type == TILE_TELEINHOOK ? Tele.m_Number : 0) << "tile " << i;
+			EXPECT_EQ(m_Collision.IsSpeedup(i), Speedup.m_Force > 0 ? i : 0) << "tile " << i;
+			EXPECT_EQ(m_Collision.IsTune(i), Tune.m_Type ? Tune.m_Number : 0) << "tile " << i;
+			EXPECT_EQ(m_Collision.GetSwitchType(i), Switch.m_Type) << "tile " << i;
+			EXPECT_EQ(m_Collision.GetSwitchNumber(i), Switch.m_Type ? Switch.m_Number : 0) << "tile " << i;
+			EXPECT_EQ(m_Collision.GetSwitchDelay(i), Switch.m_Type ? Switch.m_Delay : 0) << "tile " << i;
+			if(m_pSpeedup)
+			{
+				vec2 Dir;
+				int Force, MaxSpeed, Type;
+				m_Collision.GetSpeedup(i, &Dir, &Force, &MaxSpeed, &Type);
+				EXPECT_EQ(Force, Speedup.m_Force) << "tile " << i;
+				EXPECT_EQ(MaxSpeed, Speedup.m_MaxSpeed) << "tile " << i;
+				EXPECT_EQ(Type, Speedup.m_Type) << "tile " << i;
+				EXPECT_EQ(Dir, direction(Speedup.m_Angle * (pi / 180.0f))) << "tile " << i;
+			}
+			if(::testing::Test::HasFailure())
+				return;
+		}
+
+		const CTileFeatures &Outside = m_Collision.GetTileFeatures(-1);
+		EXPECT_EQ(Outside.m_Flags, 0);
+		EXPECT_EQ(Outside.m_TeleType, 0);
+		EXPECT_EQ(Outside.m_SwitchType, 0);
+		EXPECT_EQ(Outside.m_TuneZone, 0);
+		EXPECT_EQ(Outside.m_SpeedupForce, 0);
+		EXPECT_FALSE(m_Collision.TileExists(-1));
+	}
+};
+
+TEST(Collision, TileFeaturesMatchLayers)
+{
+	CCollisionMap Map;
+	ASSERT_TRUE(Map.Load("maps/coverage.map"));
+	ASSERT_TRUE(Map.m_pTele);
+	ASSERT_TRUE(Map.m_pSpeedup);
+	ASSERT_TRUE(Map.m_pSwitch);
+	ASSERT_TRUE(Map.m_pTune);
+
+	// the map has tiles of each kind
+	int NumTele = 0, NumSpeedup = 0, NumSwitch = 0, NumTune = 0;
+	for(int i = 0; i < Map.m_Collision.GetWidth() * Map.m_Collision.GetHeight(); i++)
+	{
+		NumTele += Map.m_pTele[i].m_Type != 0;
+		NumSpeedup += Map.m_pSpeedup[i].m_Force > 0;
+		NumSwitch += Map.m_pSwitch[i].m_Type != 0;
+		NumTune += Map.m_pTune[i].m_Type != 0;
+	}
+	EXPECT_GT(NumTele, 0);
+	EXPECT_GT(NumSpeedup, 0);
+	EXPECT_GT(NumSwitch, 0);
+	EXPECT_GT(NumTune, 0);
+
+	Map.ExpectFeaturesMatchLayers();
+}
+
+TEST(Collision, TileFeaturesWithoutLayers)
+{
+	CCollisionMap Map;
+	ASSERT_TRUE(Map.Load("maps/ctf1.map"));
+	ASSERT_FALSE(Map.m_pTele);
+	ASSERT_FALSE(Map.m_pSpeedup);
+	ASSERT_FALSE(Map.m_pSwitch);
+	ASSERT_FALSE(Map.m_pTune);
+
+	Map.ExpectFeaturesMatchLayers();
+}
@@ -18,6 +18,14 @@ TEST(CVariableInt, RoundtripPackUnpack)
 	}
 }
 
+TEST(CVariableInt, PackedSize)
+{
+	for(int i = 0; i < NUM; i++)
+	{
+		EXPECT_EQ(CVariableInt::PackedSize(DATA[i]), SIZES[i]);
+	}
+}
+
 TEST(CVariableInt, UnpackInvalid)
 {
 	unsigned char aPacked[CVariableInt::MAX_BYTES_PACKED];
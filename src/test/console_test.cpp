@@ -0,0 +1,114 @@
+#include <base/system.h>
+
+#include <engine/console.h>
+#include <engine/shared/config.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class Console : public ::testing::Test
+{
+protected:
+	std::unique_ptr<IConsole> m_pConsole = CreateConsole(CFGFLAG_SERVER);
+	std::vector<std::string> m_vCalls;
+
+	static void ConRecord(IConsole::IResult *pResult, void *pUserData)
+	{
+		Console *pSelf = static_cast<Console *>(pUserData);
+		std::string Call;
+		for(int i = 0; i < pResult->NumArguments(); i++)
+		{
+			if(i > 0)
+				Call += ",";
+			Call += pResult->GetString(i);
+		}
+		pSelf->m_vCalls.push_back(Call);
+	}
+};
+
+TEST_F(Console, ExecuteCaseInsensitive)
+{
+	m_pConsole->Register("test_cmd", "i[number] ?s[text]", CFGFLAG_SERVER, ConRecord, this, "");
+	m_pConsole->ExecuteLine("TEST_CMD 5 abc", IConsole::CLIENT_ID_UNSPECIFIED);
+	m_pConsole->ExecuteLine("test_cmd 6", IConsole::CLIENT_ID_UNSPECIFIED);
+	ASSERT_EQ(m_vCalls.size(), 2u);
+	EXPECT_EQ(m_vCalls[0], "5,abc");
+	EXPECT_EQ(m_vCalls[1], "6");
+}
+
+TEST_F(Console, ExecuteInvalidArguments)
+{
+	m_pConsole->Register("test_cmd", "i[number] f[decimal]", CFGFLAG_SERVER, ConRecord, this, "");
+	m_pConsole->ExecuteLine("test_cmd", IConsole::CLIENT_ID_UNSPECIFIED);
+	m_pConsole->ExecuteLine("test_cmd abc 1.5", IConsole::CLIENT_ID_UNSPECIFIED);
+	m_pConsole->ExecuteLine("test_cmd 1 abc", IConsole::CLIENT_ID_UNSPECIFIED);
+	EXPECT_TRUE(m_vCalls.empty());
+	m_pConsole->ExecuteLine("test_cmd 1 1.5", IConsole::CLIENT_ID_UNSPECIFIED);
+	EXPECT_EQ(m_vCalls.size(), 1u);
+}
+
+TEST_F(Console, ExecuteRestOfLine)
+{
+	m_pConsole->Register("test_cmd", "s[name] r[text]", CFGFLAG_SERVER, ConRecord, this, "");
+	m_pConsole->ExecuteLine("test_cmd \"a b\" c d", IConsole::CLIENT_ID_UNSPECIFIED);
+	ASSERT_EQ(m_vCalls.size(), 1u);
+	EXPECT_EQ(m_vCalls[0], "a b,c d");
+}
+
+TEST_F(Console, SameNameDifferentFlags)
+{
+	static int s_Client = 0;
+	m_pConsole->Register("test_cmd", "", CFGFLAG_CLIENT, [](IConsole::IResult *, void *) { s_Client++; }, nullptr, "");
+	m_pConsole->Register("test_cmd", "s[text]", CFGFLAG_SERVER, ConRecord, this, "");
+	m_pConsole->ExecuteLine("test_cmd x", IConsole::CLIENT_ID_UNSPECIFIED);
+	EXPECT_EQ(s_Client, 0);
+	ASSERT_EQ(m_vCalls.size(), 1u);
+	EXPECT_EQ(m_vCalls[0], "x");
+	ASSERT_NE(m_pConsole->GetCommandInfo("test_cmd", CFGFLAG_CLIENT, false), nullptr);
+	EXPECT_STREQ(m_pConsole->GetCommandInfo("test_cmd", CFGFLAG_CLIENT, false)->Params(), "");
+	EXPECT_STREQ(m_pConsole->GetCommandInfo("test_cmd", CFGFLAG_SERVER, false)->Params(), "s[text]");
+}
+
+TEST_F(Console, ManyCommands)
+{
+	// command names are not copied
+	std::vector<std::string> vNames;
+	vNames.reserve(1000);
+	for(int i = 0; i < 1000; i++)
+	{
+		vNames.push_back("test_cmd_" + std::to_string(i));
+		m_pConsole->Register(vNames.back().c_str(), "", CFGFLAG_SERVER, ConRecord, this, "");
+	}
+	char aName[32];
+	for(int i = 0; i < 1000; i++)
+	{
+		str_format(aName, sizeof(aName), "Test_Cmd_%d", i);
+		EXPECT_NE(m_pConsole->GetCommandInfo(aName, CFGFLAG_SERVER, false), nullptr) << aName;
+	}
+	EXPECT_EQ(m_pConsole->GetCommandInfo("test_cmd_1000", CFGFLAG_SERVER, false), nullptr);
+}
+
+TEST_F(Console, TempCommands)
+{
+	m_pConsole->RegisterTemp("temp_a", "s[text]", CFGFLAG_SERVER, "");
+	m_pConsole->RegisterTemp("temp_b", "", CFGFLAG_SERVER, "");
+	EXPECT_NE(m_pConsole->GetCommandInfo("TEMP_A", CFGFLAG_SERVER, true), nullptr);
+	EXPECT_EQ(m_pConsole->GetCommandInfo("temp_a", CFGFLAG_SERVER, false), nullptr);
+
+	m_pConsole->DeregisterTemp("temp_a");
+	EXPECT_EQ(m_pConsole->GetCommandInfo("temp_a", CFGFLAG_SERVER, true), nullptr);
+	EXPECT_NE(m_pConsole->GetCommandInfo("temp_b", CFGFLAG_SERVER, true), nullptr);
+
+	// reuses the removed command
+	m_pConsole->RegisterTemp("temp_c", "i[number]", CFGFLAG_SERVER, "");
+	ASSERT_NE(m_pConsole->GetCommandInfo("temp_c", CFGFLAG_SERVER, true), nullptr);
+	EXPECT_STREQ(m_pConsole->GetCommandInfo("temp_c", CFGFLAG_SERVER, true)->Params(), "i[number]");
+
+	m_pConsole->DeregisterTempAll();
+	EXPECT_EQ(m_pConsole->GetCommandInfo("temp_b", CFGFLAG_SERVER, true), nullptr);
+	EXPECT_EQ(m_pConsole->GetCommandInfo("temp_c", CFGFLAG_SERVER, true), nullptr);
+	EXPECT_NE(m_pConsole->GetCommandInfo("echo", CFGFLAG_SERVER, false), nullptr);
+}
@@ -0,0 +1,224 @@
+#include "test.h"
+
+#include <base/system.h>
+
+#include <engine/shared/demo.h>
+#include <engine/shared/snapshot.h>
+#include <engine/storage.h>
+
+#include <generated/protocol.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+static void RecordDemo(IStorage *pStorage, const char *pFilename, CSnapshotDelta *pDelta, CDemoEncoder *pEncoder)
+{
+	CDemoRecorder Recorder(pDelta, false, pEncoder);
+	unsigned char aMapData[4] = {0};
+	SHA256_DIGEST Sha256 = {};
+	ASSERT_EQ(Recorder.Start(pStorage, nullptr, pFilename, "0.6 test", "test", Sha256, 0, "server", sizeof(aMapData), aMapData, nullptr, nullptr, nullptr), 0);
+
+	char aData[CSnapshot::MAX_SIZE];
+	for(int Tick = 100; Tick < 1100; Tick++)
+	{
+		CSnapshotBuilder Builder;
+		Builder.Init();
+		for(int i = 0; i < 8; i++)
+		{
+			CNetObj_Projectile *pProjectile = static_cast<CNetObj_Projectile *>(Builder.NewItem(NETOBJTYPE_PROJECTILE, i, sizeof(CNetObj_Projectile)));
+			ASSERT_TRUE(pProjectile);
+			mem_zero(pProjectile, sizeof(*pProjectile));
+			pProjectile->m_X = Tick * i;
+			pProjectile->m_Y = (Tick / 10) * i;
+		}
+		const int Size = Builder.Finish(aData);
+		// skip ticks now and then to get uncompressed tick markers
+		if(Tick % 97 != 0)
+			Recorder.RecordSnapshot(Tick, aData, Size);
+		if(Tick % 13 == 0)
+			Recorder.RecordMessage(&Tick, sizeof(Tick));
+	}
+	EXPECT_EQ(Recorder.Length(), 19);
+	EXPECT_EQ(Recorder.Stop(IDemoRecorder::EStopMode::KEEP_FILE), 0);
+}
+
+TEST(Demo, EncoderWritesSameDemo)
+{
+	CTestInfo Info;
+	Info.m_DeleteTestStorageFilesOnSuccess = true;
+	std::unique_ptr<IStorage> pStorage = Info.CreateTestStorage();
+	ASSERT_TRUE(pStorage);
+
+	CSnapshotDelta Delta;
+	Delta.SetStaticsize(NETOBJTYPE_PROJECTILE, sizeof(CNetObj_Projectile));
+	RecordDemo(pStorage.get(), "sync.demo", &Delta, nullptr);
+
+	CDemoEncoder Encoder;
+	RecordDemo(pStorage.get(), "async.demo", &Delta, &Encoder);
+	Encoder.Shutdown();
+	const CDemoEncoder::CStats Stats = Encoder.Stats();
+	EXPECT_EQ(Stats.m_NumDropped, 0);
+	EXPECT_EQ(Stats.m_QueuedBytes, 0u);
+	EXPECT_GT(Stats.m_NumEncoded, 0);
+
+	void *apData[2];
+	unsigned aSize[2];
+	ASSERT_TRUE(pStorage->ReadFile("sync.demo", IStorage::TYPE_SAVE, &apData[0], &aSize[0]));
+	ASSERT_TRUE(pStorage->ReadFile("async.demo", IStorage::TYPE_SAVE, &apData[1], &aSize[1]));
+	ASSERT_EQ(aSize[0], aSize[1]);
+	ASSERT_GT(aSize[0], sizeof(CDemoHeader));
+	for(void *pData : apData)
+		mem_zero(static_cast<char *>(pData) + offsetof(CDemoHeader, m_aTimestamp), sizeof(CDemoHeader::m_aTimestamp));
+	EXPECT_EQ(mem_comp(apData[0], apData[1], aSize[0]), 0);
+	free(apData[0]);
+	free(apData[1]);
+}
+
+static void WriteFile(IStorage *pStorage, const char *pFilename, const void *pData, unsigned Size)
+{
+	IOHANDLE File = pStorage->OpenFile(pFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	ASSERT_TRUE(File);
+	EXPECT_EQ(io_write(File, pData, Size), Size);
+	EXPECT_EQ(io_close(File), 0);
+}
+
+static bool LoadIndex(IStorage *pStorage, const char *pDemoFilename, CDemoKeyFrameIndex *pIndex)
+{
+	IOHANDLE DemoFile = pStorage->OpenFile(pDemoFilename, IOFLAG_READ, IStorage::TYPE_SAVE);
+	if(!DemoFile)
+		return false;
+	const bool Result = pIndex->Load(pStorage, pDemoFilename, DemoFile);
+	io_close(DemoFile);
+	return Result;
+}
+
+TEST(Demo, KeyFrameIndexRoundTrip)
+{
+	CTestInfo Info;
+	Info.m_DeleteTestStorageFilesOnSuccess = true;
+	std::unique_ptr<IStorage> pStorage = Info.CreateTestStorage();
+	ASSERT_TRUE(pStorage);
+
+	CSnapshotDelta Delta;
+	Delta.SetStaticsize(NETOBJTYPE_PROJECTILE, sizeof(CNetObj_Projectile));
+	RecordDemo(pStorage.get(), "index.demo", &Delta, nullptr);
+
+	CDemoKeyFrameIndex Index;
+	ASSERT_TRUE(LoadIndex(pStorage.get(), "index.demo", &Index));
+	EXPECT_EQ(Index.m_FirstTick, 100);
+	EXPECT_EQ(Index.m_LastTick, 1099);
+	ASSERT_FALSE(Index.m_vKeyFrames.empty());
+	EXPECT_EQ(Index.m_vKeyFrames.front().m_Tick, 100);
+
+	// saving the loaded index writes the same file
+	void *apData[2];
+	unsigned aSize[2];
+	ASSERT_TRUE(pStorage->ReadFile("index.demo.idx", IStorage::TYPE_SAVE, &apData[0], &aSize[0]));
+	IOHANDLE DemoFile = pStorage->OpenFile("index.demo", IOFLAG_READ, IStorage::TYPE_SAVE);
+	ASSERT_TRUE(DemoFile);
+	EXPECT_TRUE(Index.Save(pStorage.get(), "index.demo", DemoFile));
+	io_close(DemoFile);
+	ASSERT_TRUE(pStorage->ReadFile("index.demo.idx", IStorage::TYPE_SAVE, &apData[1], &aSize[1]));
+	ASSERT_EQ(aSize[0], aSize[1]);
+	EXPECT_EQ(mem_comp(apData[0], apData[1], aSize[0]), 0);
+	free(apData[0]);
+	free(apData[1]);
+}
+
+TEST(Demo, KeyFrameIndexFallsBackToScan)
+{
+	CTestInfo Info;
+	Info.m_DeleteTestStorageFilesOnSuccess = true;
+	std::unique_ptr<IStorage> pStorage = Info.CreateTestStorage();
+	ASSERT_TRUE(pStorage);
+
+	CSnapshotDelta Delta;
+	Delta.SetStaticsize(NETOBJTYPE_PROJECTILE, sizeof(CNetObj_Projectile));
+	RecordDemo(pStorage.get(), "scan.demo", &Delta, nullptr);
+
+	void *pRecorded;
+	unsigned RecordedSize;
+	ASSERT_TRUE(pStorage->ReadFile("scan.demo.idx", IStorage::TYPE_SAVE, &pRecorded, &RecordedSize));
+	ASSERT_TRUE(pStorage->RemoveFile("scan.demo.idx", IStorage::TYPE_SAVE));
+
+	// without an index the player scans the demo and writes the index again
+	{
+		CDemoPlayer Player(&Delta, false);
+		ASSERT_EQ(Player.Load(pStorage.get(), nullptr, "scan.demo", IStorage::TYPE_SAVE), 0) << Player.ErrorMessage();
+		EXPECT_EQ(Player.BaseInfo()->m_FirstTick, 100);
+		EXPECT_EQ(Player.BaseInfo()->m_LastTick, 1099);
+		Player.Stop();
+	}
+
+	void *pScanned;
+	unsigned ScannedSize;
+	ASSERT_TRUE(pStorage->ReadFile("scan.demo.idx", IStorage::TYPE_SAVE, &pScanned, &ScannedSize));
+	ASSERT_EQ(RecordedSize, ScannedSize);
+	EXPECT_EQ(mem_comp(pRecorded, pScanned, RecordedSize), 0);
+	free(pRecorded);
+	free(pScanned);
+}
+
+TEST(Demo, KeyFrameIndexRejectsMismatch)
+{
+	CTestInfo Info;
+	Info.m_DeleteTestStorageFilesOnSuccess = true;
+	std::unique_ptr<IStorage> pStorage = Info.CreateTestStorage();
+	ASSERT_TRUE(pStorage);
+
+	CSnapshotDelta Delta;
+	Delta.SetStaticsize(NETOBJTYPE_PROJECTILE, sizeof(CNetObj_Projectile));
+	RecordDemo(pStorage.get(), "stale.demo", &Delta, nullptr);
+
+	void *pDemo;
+	unsigned DemoSize;
+	ASSERT_TRUE(pStorage->ReadFile("stale.demo", IStorage::TYPE_SAVE, &pDemo, &DemoSize));
+	void *pIndexData;
+	unsigned IndexSize;
+	ASSERT_TRUE(pStorage->ReadFile("stale.demo.idx", IStorage::TYPE_SAVE, &pIndexData, &IndexSize));
+	std::vector<unsigned char> vDemo(static_cast<unsigned char *>(pDemo), static_cast<unsigned char *>(pDemo) + DemoSize);
+	std::vector<unsigned char> vIndex(static_cast<unsigned char *>(pIndexData), static_cast<unsigned char *>(pIndexData) + IndexSize);
+	free(pDemo);
+	free(pIndexData);
+
+	CDemoKeyFrameIndex Index;
+	EXPECT_TRUE(LoadIndex(pStorage.get(), "stale.demo", &Index));
+
+	// the demo changed at the end, same size
+	std::vector<unsigned char> vChanged = vDemo;
+	vChanged.back() ^= 0xff;
+	WriteFile(pStorage.get(), "stale.demo", vChanged.data(), vChanged.size());
+	EXPECT_FALSE(LoadIndex(pStorage.get(), "stale.demo", &Index));
+	EXPECT_TRUE(Index.m_vKeyFrames.empty());
+
+	// the demo grew
+	std::vector<unsigned char> vGrown = vDemo;
+	vGrown.insert(vGrown.end(), 16, 0);
+	WriteFile(pStorage.get(), "stale.demo", vGrown.data(), vGrown.size());
+	EXPECT_FALSE(LoadIndex(pStorage.get(), "stale.demo", &Index));
+
+	// the index is truncated or has another version
+	WriteFile(pStorage.get(), "stale.demo", vDemo.data(), vDemo.size());
+	WriteFile(pStorage.get(), "stale.demo.idx", vIndex.data(), vIndex.size() - 1);
+	EXPECT_FALSE(LoadIndex(pStorage.get(), "stale.demo", &Index));
+	std::vector<unsigned char> vOtherVersion = vIndex;
+	vOtherVersion[8]++;
+	WriteFile(pStorage.get(), "stale.demo.idx", vOtherVersion.data(), vOtherVersion.size());
+	EXPECT_FALSE(LoadIndex(pStorage.get(), "stale.demo", &Index));
+
+	// the player doesn't use a rejected index but writes a valid one
+	{
+		CDemoPlayer Player(&Delta, false);
+		ASSERT_EQ(Player.Load(pStorage.get(), nullptr, "stale.demo", IStorage::TYPE_SAVE), 0) << Player.ErrorMessage();
+		EXPECT_EQ(Player.BaseInfo()->m_LastTick, 1099);
+		Player.Stop();
+	}
+	void *pRewritten;
+	unsigned RewrittenSize;
+	ASSERT_TRUE(pStorage->ReadFile("stale.demo.idx", IStorage::TYPE_SAVE, &pRewritten, &RewrittenSize));
+	ASSERT_EQ(RewrittenSize, vIndex.size());
+	EXPECT_EQ(mem_comp(pRewritten, vIndex.data(), RewrittenSize), 0);
+	free(pRewritten);
+	EXPECT_TRUE(LoadIndex(pStorage.get(), "stale.demo", &Index));
+}
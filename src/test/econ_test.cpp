@@ -0,0 +1,276 @@
+#include <base/system.h>
+
+#include <engine/console.h>
+#include <engine/shared/config.h>
+#include <engine/shared/econ.h>
+#include <engine/shared/network.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+// Listens on a free port on the loopback interface
+static NETSOCKET ListenLocal(NETADDR *pAddr)
+{
+	for(int i = 0; i < 100; i++)
+	{
+		if(net_addr_from_str(pAddr, "127.0.0.1") != 0)
+			return nullptr;
+		pAddr->port = 20000 + secure_rand_below(40000);
+		NETSOCKET Socket = net_tcp_create(*pAddr);
+		if(!Socket)
+			continue;
+		if(net_tcp_listen(Socket, 4) == 0)
+			return Socket;
+		net_tcp_close(Socket);
+	}
+	return nullptr;
+}
+
+static NETSOCKET Connect(const NETADDR &Addr)
+{
+	NETADDR BindAddr = NETADDR_ZEROED;
+	BindAddr.type = NETTYPE_IPV4;
+	NETSOCKET Socket = net_tcp_create(BindAddr);
+	if(Socket && net_tcp_connect(Socket, &Addr) != 0)
+	{
+		net_tcp_close(Socket);
+		return nullptr;
+	}
+	return Socket;
+}
+
+// Appends everything that can be read without blocking
+static void ReadAvailable(NETSOCKET Socket, std::string &Received)
+{
+	char aBuf[16 * 1024];
+	int Bytes;
+	while((Bytes = net_tcp_recv(Socket, aBuf, sizeof(aBuf))) > 0)
+		Received.append(aBuf, Bytes);
+}
+
+// Lines end with the line ending and null bytes
+static std::vector<std::string> SplitLines(const std::string &Received)
+{
+	std::vector<std::string> vLines;
+	std::string Line;
+	for(char c : Received)
+	{
+		if(c == '\n')
+		{
+			vLines.push_back(Line);
+			Line.clear();
+		}
+		else if(c != '\0' && c != '\r')
+			Line += c;
+	}
+	return vLines;
+}
+
+class EconConnection : public ::testing::Test
+{
+protected:
+	NETSOCKET m_Listener = nullptr;
+	NETSOCKET m_Peer = nullptr;
+	CConsoleNetConnection m_Connection;
+	char m_aLine[1000];
+
+	void SetUp() override
+	{
+		m_Connection.Reset();
+		std::fill(std::begin(m_aLine), std::end(m_aLine) - 1, 'x');
+		m_aLine[sizeof(m_aLine) - 1] = '\0';
+
+		NETADDR Addr;
+		m_Listener = ListenLocal(&Addr);
+		ASSERT_TRUE(m_Listener);
+		m_Peer = Connect(Addr);
+		ASSERT_TRUE(m_Peer);
+
+		NETSOCKET Socket;
+		NETADDR PeerAddr;
+		ASSERT_GE(net_tcp_accept(m_Listener, &Socket, &PeerAddr), 0);
+		ASSERT_EQ(m_Connection.Init(Socket, &PeerAddr), 0);
+		ASSERT_EQ(net_set_non_blocking(m_Peer), 0);
+	}
+
+	void TearDown() override
+	{
+		m_Connection.Disconnect(nullptr);
+		if(m_Peer)
+			net_tcp_close(m_Peer);
+		if(m_Listener)
+			net_tcp_close(m_Listener);
+	}
+};
+
+TEST_F(EconConnection, SendIsBuffered)
+{
+	EXPECT_EQ(m_Connection.Send("first"), 0);
+	EXPECT_EQ(m_Connection.Send("second"), 0);
+	EXPECT_EQ(m_Connection.PendingSendSize(), (size_t)(2 * 3 + str_length("first") + str_length("second")));
+
+	std::string Received;
+	ReadAvailable(m_Peer, Received);
+	EXPECT_EQ(Received, "");
+
+	EXPECT_EQ(m_Connection.Flush(), 0);
+	EXPECT_EQ(m_Connection.PendingSendSize(), 0u);
+	const int64_t Timeout = time_get_impl() + 5 * time_freq();
+	while(SplitLines(Received).size() < 2 && time_get_impl() < Timeout)
+	{
+		std::this_thread::sleep_for(1ms);
+		ReadAvailable(m_Peer, Received);
+	}
+	EXPECT_EQ(SplitLines(Received), (std::vector<std::string>{"first", "second"}));
+}
+
+TEST_F(EconConnection, BackpressurePausesReading)
+{
+	// fill the socket buffers while the peer doesn't read, until they
+	// don't take any more data
+	size_t Queued = 0;
+	const auto &&FillUntilStalled = [&]() {
+		int RoundsWithoutProgress = 0;
+		while(RoundsWithoutProgress < 10)
+		{
+			while(m_Connection.PendingSendSize() < 4 * CConsoleNetConnection::SEND_BUFFER_BACKPRESSURE_SIZE)
+			{
+				ASSERT_EQ(m_Connection.Send(m_aLine), 0);
+				Queued += str_length(m_aLine) + 3;
+			}
+			const size_t Pending = m_Connection.PendingSendSize();
+			ASSERT_EQ(m_Connection.Flush(), 0);
+			RoundsWithoutProgress = m_Connection.PendingSendSize() == Pending ? RoundsWithoutProgress + 1 : 0;
+			std::this_thread::sleep_for(1ms);
+		}
+	};
+	FillUntilStalled();
+	// a part was sent, the rest is kept
+	EXPECT_LT(m_Connection.PendingSendSize(), Queued);
+
+	const char *pCommand = "status\n";
+	ASSERT_EQ(net_tcp_send(m_Peer, pCommand, str_length(pCommand)), str_length(pCommand));
+	std::this_thread::sleep_for(10ms);
+	FillUntilStalled();
+
+	char aLine[64];
+	for(int i = 0; i < 10; i++)
+	{
+		EXPECT_EQ(m_Connection.Update(), 0);
+		EXPECT_GE(m_Connection.PendingSendSize(), (size_t)CConsoleNetConnection::SEND_BUFFER_BACKPRESSURE_SIZE);
+		EXPECT_EQ(m_Connection.Recv(aLine, sizeof(aLine)), 0);
+		std::this_thread::sleep_for(1ms);
+	}
+
+	// reading resumes once the peer has caught up with the output
+	std::string Received;
+	const int64_t Timeout = time_get_impl() + 10 * time_freq();
+	bool GotLine = false;
+	while(!GotLine && time_get_impl() < Timeout)
+	{
+		ReadAvailable(m_Peer, Received);
+		ASSERT_EQ(m_Connection.Update(), 0);
+		GotLine = m_Connection.Recv(aLine, sizeof(aLine)) != 0;
+	}
+	ASSERT_TRUE(GotLine);
+	EXPECT_STREQ(aLine, "status");
+	EXPECT_LT(m_Connection.PendingSendSize(), (size_t)CConsoleNetConnection::SEND_BUFFER_BACKPRESSURE_SIZE);
+
+	while(m_Connection.PendingSendSize() > 0 && time_get_impl() < Timeout)
+	{
+		ASSERT_EQ(m_Connection.Flush(), 0);
+		ReadAvailable(m_Peer, Received);
+	}
+	while(Received.size() < Queued && time_get_impl() < Timeout)
+		ReadAvailable(m_Peer, Received);
+	ASSERT_EQ(Received.size(), Queued);
+	const std::vector<std::string> vLines = SplitLines(Received);
+	ASSERT_EQ(vLines.size(), Queued / (str_length(m_aLine) + 3));
+	EXPECT_EQ(vLines.front(), m_aLine);
+	EXPECT_EQ(vLines.back(), m_aLine);
+}
+
+TEST_F(EconConnection, DropsWhenSendBufferOverflows)
+{
+	int Result = 0;
+	size_t Queued = 0;
+	while(Result == 0 && Queued <= (size_t)CConsoleNetConnection::MAX_SEND_BUFFER_SIZE + sizeof(m_aLine) + 3)
+	{
+		Result = m_Connection.Send(m_aLine);
+		Queued += str_length(m_aLine) + 3;
+	}
+	EXPECT_EQ(Result, -1);
+	EXPECT_EQ(m_Connection.State(), CConsoleNetConnection::EState::ERROR);
+	EXPECT_STREQ(m_Connection.ErrorString(), "too weak connection (out of send buffer)");
+	EXPECT_EQ(m_Connection.Update(), -1);
+}
+
+static void ConTestOutput(IConsole::IResult *pResult, void *pUserData)
+{
+	static_cast<CEcon *>(pUserData)->Send(-1, pResult->GetString(0));
+}
+
+TEST(Econ, BatchEndMarkers)
+{
+	NETADDR Addr;
+	NETSOCKET Probe = ListenLocal(&Addr);
+	ASSERT_TRUE(Probe);
+	net_tcp_close(Probe);
+
+	const CConfig OldConfig = g_Config;
+	str_copy(g_Config.m_EcBindaddr, "127.0.0.1");
+	g_Config.m_EcPort = Addr.port;
+	str_copy(g_Config.m_EcPassword, "secret");
+
+	std::unique_ptr<IConsole> pConsole = CreateConsole(CFGFLAG_SERVER | CFGFLAG_ECON);
+	CEcon Econ;
+	Econ.Init(&g_Config, pConsole.get(), nullptr);
+	pConsole->Register("test_output", "s[text]", CFGFLAG_SERVER, ConTestOutput, &Econ, "");
+
+	NETSOCKET Peer = Connect(Addr);
+	ASSERT_TRUE(Peer);
+	ASSERT_EQ(net_set_non_blocking(Peer), 0);
+
+	// pipelined, the commands are read in one go
+	const char *pCommands = "secret\nbatch\ntest_output a\ntest_output b\nbatch 0\ntest_output c\n";
+	ASSERT_EQ(net_tcp_send(Peer, pCommands, str_length(pCommands)), str_length(pCommands));
+
+	std::string Received;
+	const int64_t Timeout = time_get_impl() + 5 * time_freq();
+	while((SplitLines(Received).empty() || SplitLines(Received).back() != "c") && time_get_impl() < Timeout)
+	{
+		Econ.Update();
+		std::this_thread::sleep_for(1ms);
+		ReadAvailable(Peer, Received);
+	}
+
+	const std::vector<std::string> vExpected = {
+		"Enter password:",
+		"Authentication successful. External console access granted.",
+		"@end 0",
+		"a",
+		"@end 1",
+		"b",
+		"@end 2",
+		"c",
+	};
+	std::vector<std::string> vLines;
+	for(const std::string &Line : SplitLines(Received))
+	{
+		if(!Line.empty())
+			vLines.push_back(Line);
+	}
+	EXPECT_EQ(vLines, vExpected);
+
+	Econ.Shutdown();
+	net_tcp_close(Peer);
+	g_Config = OldConfig;
+}
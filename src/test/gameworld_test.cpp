@@ -25,8 +25,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
 #include <thread>
+#include <vector>
 
 bool IsInterrupted()
 {
@@ -39,7 +41,8 @@ std::vector<std::string> FetchAndroidServerCommandQueue()
 	return FakeQueue;
 }
 
-class CTestGameWorld : public ::testing::Test
+// A server with the game server loaded on the coverage map
+class CTestGameServer
 {
 public:
 	IGameServer *m_pGameServer = nullptr;
@@ -53,7 +56,7 @@ public:
 		return (CGameContext *)m_pGameServer;
 	}
 
-	CTestGameWorld()
+	CTestGameServer()
 	{
 		CServer *pServer = CreateServer();
 		m_pServer = pServer;
@@ -129,7 +132,7 @@ public:
 		pServer->InitMaplist();
 	}
 
-	~CTestGameWorld() override
+	~CTestGameServer()
 	{
 		m_pServer->m_Econ.Shutdown();
 		m_pServer->m_Fifo.Shutdown();
@@ -139,6 +142,10 @@ public:
 	}
 };
 
+class CTestGameWorld : public ::testing::Test, public CTestGameServer
+{
+};
+
 TEST_F(CTestGameWorld, ClosestCharacter)
 {
 	CNetObj_PlayerInput Input = {};
@@ -310,3 +317,120 @@ TEST_F(CTestGameWorld, CharacterEmote)
 	pChr->Freeze(10);
 	ASSERT_EQ(pChr->DetermineEyeEmote(), EMOTE_ANGRY);
 }
+
+// Ticks 16 players in 4 teams with pseudo-random inputs and returns the
+// character cores after every tick
+static std::vector<CNetObj_CharacterCore> TickTeams(bool ParallelTeams, int *pMaxTeamsAlive)
+{
+	std::vector<CNetObj_CharacterCore> vCores;
+	CTestGameServer Server;
+	CServer *pServer = Server.m_pServer;
+	CGameContext *pGameServer = Server.GameServer();
+	pServer->Config()->m_SvParallelTeams = ParallelTeams;
+
+	const int NumPlayers = 16;
+	for(int i = 0; i < NumPlayers; i++)
+	{
+		pServer->SimulateClientJoin(i, false);
+		pServer->SimulateClientEnter(i);
+	}
+
+	unsigned Seed = 12345;
+	const auto &&Random = [&Seed](int Below) {
+		Seed = Seed * 1103515245 + 12345;
+		return (int)((Seed >> 16) % Below);
+	};
+	CNetObj_PlayerInput aInputs[MAX_CLIENTS] = {};
+	const void *apInputs[MAX_CLIENTS];
+	for(int i = 0; i < MAX_CLIENTS; i++)
+		apInputs[i] = &aInputs[i];
+
+	*pMaxTeamsAlive = 0;
+	for(int Tick = 0; Tick < 1000; Tick++)
+	{
+		if(Tick == 10)
+		{
+			for(int i = 0; i < NumPlayers; i++)
+			{
+				char aCmd[64];
+				str_format(aCmd, sizeof(aCmd), "set_team_ddr %d %d", i, 1 + i % 4);
+				pGameServer->Console()->ExecuteLine(aCmd, IConsole::CLIENT_ID_UNSPECIFIED);
+			}
+		}
+		for(int i = 0; i < NumPlayers; i++)
+		{
+			if(Random(8) != 0)
+				continue;
+			aInputs[i].m_Direction = Random(3) - 1;
+			aInputs[i].m_Jump = Random(4) == 0;
+			aInputs[i].m_Hook = Random(3) == 0;
+			aInputs[i].m_Fire += Random(4) == 0;
+			aInputs[i].m_TargetX = Random(400) - 200;
+			aInputs[i].m_TargetY = Random(400) - 200;
+			aInputs[i].m_WantedWeapon = Random(3);
+			pGameServer->OnClientDirectInput(i, &aInputs[i]);
+		}
+		pServer->SimulateTick(apInputs);
+
+		bool aTeamAlive[NUM_DDRACE_TEAMS] = {};
+		for(int i = 0; i < NumPlayers; i++)
+		{
+			CNetObj_CharacterCore Core = {};
+			CCharacter *pChr = pGameServer->GetPlayerChar(i);
+			if(pChr)
+			{
+				pChr->GetCore().Write(&Core);
+				aTeamAlive[pChr->Team()] = true;
+			}
+			vCores.push_back(Core);
+		}
+		*pMaxTeamsAlive = std::max(*pMaxTeamsAlive, (int)std::count(std::begin(aTeamAlive), std::end(aTeamAlive), true));
+	}
+	return vCores;
+}
+
+TEST(GameWorld, ParallelTeamsMatchSerialTick)
+{
+	const CConfig OldConfig = g_Config;
+	int MaxTeamsSerial, MaxTeamsParallel;
+	const std::vector<CNetObj_CharacterCore> vSerial = TickTeams(false, &MaxTeamsSerial);
+	const std::vector<CNetObj_CharacterCore> vParallel = TickTeams(true, &MaxTeamsParallel);
+	g_Config = OldConfig;
+
+	// otherwise the parallel tick falls back to the serial one
+	EXPECT_GE(MaxTeamsParallel, 2);
+	EXPECT_EQ(MaxTeamsSerial, MaxTeamsParallel);
+	ASSERT_EQ(vSerial.size(), vParallel.size());
+	for(size_t i = 0; i < vSerial.size(); i++)
+	{
+		ASSERT_EQ(mem_comp(&vSerial[i], &vParallel[i], sizeof(vSerial[i])), 0) << "tick " << i / 16 << ", player " << i % 16;
+	}
+}
+
+TEST(WorldCore, CharacterIdsSorted)
+{
+	CWorldCore World;
+	CCharacterCore aCores[4];
+	EXPECT_EQ(World.NumCharacters(), 0);
+
+	World.SetCharacter(5, &aCores[0]);
+	World.SetCharacter(2, &aCores[1]);
+	World.SetCharacter(MAX_CLIENTS - 1, &aCores[2]);
+	World.SetCharacter(0, &aCores[3]);
+	// replacing a character does not add its id again
+	World.SetCharacter(2, &aCores[0]);
+	ASSERT_EQ(World.NumCharacters(), 4);
+	EXPECT_EQ(World.CharacterId(0), 0);
+	EXPECT_EQ(World.CharacterId(1), 2);
+	EXPECT_EQ(World.CharacterId(2), 5);
+	EXPECT_EQ(World.CharacterId(3), MAX_CLIENTS - 1);
+	EXPECT_EQ(World.Character(2), &aCores[0]);
+
+	World.SetCharacter(2, nullptr);
+	World.SetCharacter(3, nullptr);
+	ASSERT_EQ(World.NumCharacters(), 3);
+	EXPECT_EQ(World.CharacterId(0), 0);
+	EXPECT_EQ(World.CharacterId(1), 5);
+	EXPECT_EQ(World.CharacterId(2), MAX_CLIENTS - 1);
+	EXPECT_EQ(World.Character(2), nullptr);
+}
@@ -0,0 +1,259 @@
+#include "test.h"
+
+#include <base/math.h>
+#include <base/system.h>
+
+#include <engine/client/glyph_cache.h>
+#include <engine/storage.h>
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <memory>
+#include <vector>
+
+static const int FREETYPE_VERSION = (2 << 16) | (13 << 8) | 2;
+
+static SCachedGlyph MakeGlyph(uint64_t FaceHash, int Chr, int FontSize, int Width, int Height)
+{
+	SCachedGlyph Glyph;
+	Glyph.m_FaceHash = FaceHash;
+	Glyph.m_Chr = Chr;
+	Glyph.m_FontSize = FontSize;
+	Glyph.m_GlyphIndex = Chr * 3 + 1;
+	Glyph.m_Width = Width;
+	Glyph.m_Height = Height;
+	Glyph.m_CharWidth = maximum(Width - 4, 0);
+	Glyph.m_CharHeight = maximum(Height - 4, 0);
+	Glyph.m_OffsetX = -Chr % 3;
+	Glyph.m_OffsetY = -FontSize / 4;
+	Glyph.m_AdvanceX = Width + 1;
+	for(int i = 0; i < Width * Height; i++)
+	{
+		Glyph.m_vFill.push_back(i * 7 + Chr);
+		Glyph.m_vOutline.push_back(i * 13 + FontSize);
+	}
+	return Glyph;
+}
+
+static void ExpectSameGlyph(const SCachedGlyph &Expected, const SCachedGlyph &Actual)
+{
+	EXPECT_EQ(Expected.m_FaceHash, Actual.m_FaceHash);
+	EXPECT_EQ(Expected.m_Chr, Actual.m_Chr);
+	EXPECT_EQ(Expected.m_FontSize, Actual.m_FontSize);
+	EXPECT_EQ(Expected.m_GlyphIndex, Actual.m_GlyphIndex);
+	EXPECT_EQ(Expected.m_Width, Actual.m_Width);
+	EXPECT_EQ(Expected.m_Height, Actual.m_Height);
+	EXPECT_EQ(Expected.m_CharWidth, Actual.m_CharWidth);
+	EXPECT_EQ(Expected.m_CharHeight, Actual.m_CharHeight);
+	EXPECT_EQ(Expected.m_OffsetX, Actual.m_OffsetX);
+	EXPECT_EQ(Expected.m_OffsetY, Actual.m_OffsetY);
+	EXPECT_EQ(Expected.m_AdvanceX, Actual.m_AdvanceX);
+	EXPECT_EQ(Expected.m_vFill, Actual.m_vFill);
+	EXPECT_EQ(Expected.m_vOutline, Actual.m_vOutline);
+}
+
+static void WriteFile(IStorage *pStorage, const char *pFilename, const std::vector<unsigned char> &vData)
+{
+	IOHANDLE File = pStorage->OpenFile(pFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	ASSERT_TRUE(File);
+	EXPECT_EQ(io_write(File, vData.data(), vData.size()), vData.size());
+	EXPECT_EQ(io_close(File), 0);
+}
+
+static std::vector<unsigned char> ReadFile(IStorage *pStorage, const char *pFilename)
+{
+	void *pData;
+	unsigned Size;
+	if(!pStorage->ReadFile(pFilename, IStorage::TYPE_SAVE, &pData, &Size))
+		return {};
+	std::vector<unsigned char> vData(static_cast<unsigned char *>(pData), static_cast<unsigned char *>(pData) + Size);
+	free(pData);
+	return vData;
+}
+
+class GlyphCache : public ::testing::Test
+{
+protected:
+	CTestInfo m_TestInfo;
+	std::unique_ptr<IStorage> m_pStorage;
+	std::vector<SCachedGlyph> m_vGlyphs;
+	std::vector<unsigned char> m_vFile;
+
+	void SetUp() override
+	{
+		m_TestInfo.m_DeleteTestStorageFilesOnSuccess = true;
+		m_pStorage = m_TestInfo.CreateTestStorage();
+		ASSERT_TRUE(m_pStorage);
+
+		// glyphs of two faces, also empty ones like spaces
+		CGlyphCache Cache;
+		for(int Chr = 32; Chr < 48; Chr++)
+		{
+			const int Size = Chr == 32 ? 0 : 6 + Chr % 5;
+			m_vGlyphs.push_back(MakeGlyph(0x0123456789abcdefull, Chr, 12 + Chr % 3, Size, Size + 2));
+			m_vGlyphs.push_back(MakeGlyph(0xfedcba9876543210ull, Chr, 20, Size, Size));
+		}
+		for(SCachedGlyph Glyph : m_vGlyphs)
+			ASSERT_TRUE(Cache.Add(std::move(Glyph)));
+		EXPECT_TRUE(Cache.IsDirty());
+		ASSERT_TRUE(Cache.Save(m_pStorage.get(), "glyphs.dat", FREETYPE_VERSION));
+		EXPECT_FALSE(Cache.IsDirty());
+		m_vFile = ReadFile(m_pStorage.get(), "glyphs.dat");
+		ASSERT_FALSE(m_vFile.empty());
+	}
+
+	CGlyphCache::ELoadResult LoadFile(const std::vector<unsigned char> &vData, CGlyphCache &Cache)
+	{
+		WriteFile(m_pStorage.get(), "glyphs.dat", vData);
+		return Cache.Load(m_pStorage.get(), "glyphs.dat", FREETYPE_VERSION);
+	}
+};
+
+TEST_F(GlyphCache, RoundTrip)
+{
+	CGlyphCache Cache;
+	ASSERT_EQ(Cache.Load(m_pStorage.get(), "glyphs.dat", FREETYPE_VERSION), CGlyphCache::ELoadResult::LOADED);
+	EXPECT_FALSE(Cache.IsDirty());
+	ASSERT_EQ(Cache.Size(), m_vGlyphs.size());
+	for(const SCachedGlyph &Glyph : m_vGlyphs)
+	{
+		const SCachedGlyph *pLoaded = Cache.Find(Glyph.m_FaceHash, Glyph.m_Chr, Glyph.m_FontSize);
+		ASSERT_TRUE(pLoaded) << "chr " << Glyph.m_Chr;
+		ExpectSameGlyph(Glyph, *pLoaded);
+	}
+	EXPECT_FALSE(Cache.Find(0x0123456789abcdefull, 48, 12));
+	EXPECT_FALSE(Cache.Find(0x0123456789abcdefull, 33, 20));
+
+	// an unchanged cache is not written again, a changed one the same way
+	ASSERT_TRUE(m_pStorage->RemoveFile("glyphs.dat", IStorage::TYPE_SAVE));
+	EXPECT_TRUE(Cache.Save(m_pStorage.get(), "glyphs.dat", FREETYPE_VERSION));
+	EXPECT_TRUE(ReadFile(m_pStorage.get(), "glyphs.dat").empty());
+	SCachedGlyph Added = MakeGlyph(0x0123456789abcdefull, 0x25a1, 16, 9, 11);
+	const SCachedGlyph AddedCopy = Added;
+	ASSERT_TRUE(Cache.Add(std::move(Added)));
+	ASSERT_TRUE(Cache.Save(m_pStorage.get(), "glyphs.dat", FREETYPE_VERSION));
+	CGlyphCache Reloaded;
+	ASSERT_EQ(Reloaded.Load(m_pStorage.get(), "glyphs.dat", FREETYPE_VERSION), CGlyphCache::ELoadResult::LOADED);
+	EXPECT_EQ(Reloaded.Size(), m_vGlyphs.size() + 1);
+	const SCachedGlyph *pAdded = Reloaded.Find(AddedCopy.m_FaceHash, AddedCopy.m_Chr, AddedCopy.m_FontSize);
+	ASSERT_TRUE(pAdded);
+	ExpectSameGlyph(AddedCopy, *pAdded);
+}
+
+TEST_F(GlyphCache, Missing)
+{
+	CGlyphCache Cache;
+	EXPECT_EQ(Cache.Load(m_pStorage.get(), "missing.dat", FREETYPE_VERSION), CGlyphCache::ELoadResult::MISSING);
+	EXPECT_EQ(Cache.Size(), 0u);
+}
+
+TEST_F(GlyphCache, Outdated)
+{
+	// another rasterizer
+	CGlyphCache Cache;
+	EXPECT_EQ(Cache.Load(m_pStorage.get(), "glyphs.dat", FREETYPE_VERSION + 1), CGlyphCache::ELoadResult::OUTDATED);
+	EXPECT_EQ(Cache.Size(), 0u);
+
+	// another file version, marker is 8 bytes
+	std::vector<unsigned char> vOtherVersion = m_vFile;
+	vOtherVersion[8 + 3]++;
+	EXPECT_EQ(LoadFile(vOtherVersion, Cache), CGlyphCache::ELoadResult::OUTDATED);
+	EXPECT_EQ(Cache.Size(), 0u);
+
+	// not a glyph cache
+	std::vector<unsigned char> vOtherMarker = m_vFile;
+	vOtherMarker[0] ^= 0xff;
+	EXPECT_EQ(LoadFile(vOtherMarker, Cache), CGlyphCache::ELoadResult::OUTDATED);
+	EXPECT_EQ(Cache.Size(), 0u);
+}
+
+TEST_F(GlyphCache, Corrupted)
+{
+	// loading a corrupted file leaves no glyphs of an earlier load behind
+	CGlyphCache Cache;
+	ASSERT_EQ(Cache.Load(m_pStorage.get(), "glyphs.dat", FREETYPE_VERSION), CGlyphCache::ELoadResult::LOADED);
+
+	// truncated anywhere, only the count missing from the header is corruption
+	const size_t HeaderSize = 8 + 3 * sizeof(int32_t);
+	for(size_t Size = 0; Size < m_vFile.size(); Size++)
+	{
+		const std::vector<unsigned char> vTruncated(m_vFile.begin(), m_vFile.begin() + Size);
+		const CGlyphCache::ELoadResult Result = LoadFile(vTruncated, Cache);
+		EXPECT_EQ(Result, Size < HeaderSize - sizeof(int32_t) ? CGlyphCache::ELoadResult::OUTDATED : CGlyphCache::ELoadResult::CORRUPTED) << "size " << Size;
+		EXPECT_EQ(Cache.Size(), 0u) << "size " << Size;
+		ASSERT_EQ(LoadFile(m_vFile, Cache), CGlyphCache::ELoadResult::LOADED);
+	}
+
+	// trailing data
+	std::vector<unsigned char> vTrailing = m_vFile;
+	vTrailing.push_back(0);
+	EXPECT_EQ(LoadFile(vTrailing, Cache), CGlyphCache::ELoadResult::CORRUPTED);
+	EXPECT_EQ(Cache.Size(), 0u);
+
+	// more glyphs than allowed
+	std::vector<unsigned char> vTooMany = m_vFile;
+	uint_to_bytes_be(&vTooMany[HeaderSize - sizeof(int32_t)], CGlyphCache::MAX_GLYPHS + 1);
+	EXPECT_EQ(LoadFile(vTooMany, Cache), CGlyphCache::ELoadResult::CORRUPTED);
+	uint_to_bytes_be(&vTooMany[HeaderSize - sizeof(int32_t)], -1);
+	EXPECT_EQ(LoadFile(vTooMany, Cache), CGlyphCache::ELoadResult::CORRUPTED);
+	EXPECT_EQ(Cache.Size(), 0u);
+
+	// the width and height of the first glyph are the 6th and 7th int
+	for(int Field : {5, 6})
+	{
+		for(int Dimension : {-1, CGlyphCache::MAX_GLYPH_DIMENSION + 1, 0x7fffffff})
+		{
+			std::vector<unsigned char> vDimension = m_vFile;
+			uint_to_bytes_be(&vDimension[HeaderSize + Field * sizeof(int32_t)], Dimension);
+			EXPECT_EQ(LoadFile(vDimension, Cache), CGlyphCache::ELoadResult::CORRUPTED) << "field " << Field << " dimension " << Dimension;
+			EXPECT_EQ(Cache.Size(), 0u);
+		}
+	}
+
+	// a single oversized glyph with all of its bitmap data
+	for(int Width : {CGlyphCache::MAX_GLYPH_DIMENSION, CGlyphCache::MAX_GLYPH_DIMENSION + 1})
+	{
+		for(bool Vertical : {false, true})
+		{
+			std::vector<unsigned char> vOversized(m_vFile.begin(), m_vFile.begin() + HeaderSize);
+			const auto &&WriteInt = [&vOversized](int Value) {
+				unsigned char aBuf[sizeof(int32_t)];
+				uint_to_bytes_be(aBuf, Value);
+				vOversized.insert(vOversized.end(), std::begin(aBuf), std::end(aBuf));
+			};
+			uint_to_bytes_be(&vOversized[HeaderSize - sizeof(int32_t)], 1);
+			const int aGlyph[] = {0, 1, 'a', 10, 1, Vertical ? 1 : Width, Vertical ? Width : 1, 1, 1, 0, 0, 1};
+			for(int Value : aGlyph)
+				WriteInt(Value);
+			vOversized.resize(vOversized.size() + 2 * Width, 0x80);
+			const bool Valid = Width <= CGlyphCache::MAX_GLYPH_DIMENSION;
+			EXPECT_EQ(LoadFile(vOversized, Cache), Valid ? CGlyphCache::ELoadResult::LOADED : CGlyphCache::ELoadResult::CORRUPTED) << "width " << Width << " vertical " << Vertical;
+			EXPECT_EQ(Cache.Size(), Valid ? 1u : 0u);
+		}
+	}
+}
+
+TEST_F(GlyphCache, Limits)
+{
+	CGlyphCache Cache;
+	for(size_t i = 0; i < CGlyphCache::MAX_GLYPHS; i++)
+		ASSERT_TRUE(Cache.Add(MakeGlyph(1, i, 10, 0, 0)));
+	EXPECT_FALSE(Cache.Add(MakeGlyph(1, CGlyphCache::MAX_GLYPHS, 10, 0, 0)));
+	EXPECT_EQ(Cache.Size(), CGlyphCache::MAX_GLYPHS);
+
+	// a full cache is written and read again
+	ASSERT_TRUE(Cache.Save(m_pStorage.get(), "full.dat", FREETYPE_VERSION));
+	CGlyphCache Loaded;
+	EXPECT_EQ(Loaded.Load(m_pStorage.get(), "full.dat", FREETYPE_VERSION), CGlyphCache::ELoadResult::LOADED);
+	EXPECT_EQ(Loaded.Size(), CGlyphCache::MAX_GLYPHS);
+
+	// bitmaps not matching the size of the glyph
+	CGlyphCache Empty;
+	SCachedGlyph Glyph = MakeGlyph(1, 'a', 10, 4, 4);
+	Glyph.m_vOutline.pop_back();
+	EXPECT_FALSE(Empty.Add(std::move(Glyph)));
+	EXPECT_FALSE(Empty.Add(MakeGlyph(1, 'b', 10, CGlyphCache::MAX_GLYPH_DIMENSION + 1, 1)));
+	EXPECT_EQ(Empty.Size(), 0u);
+	EXPECT_FALSE(Empty.IsDirty());
+}
@@ -0,0 +1,121 @@
+#include <base/system.h>
+
+#include <engine/shared/network.h>
+
+#include <gtest/gtest.h>
+
+static const unsigned char s_aConnect[] = {NET_PACKETFLAG_CONTROL << 2, 0, 0, NET_CTRLMSG_CONNECT, 'T', 'K', 'E', 'N'};
+static const unsigned char s_aConnless[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 'g', 'i', 'e', '3'};
+static const unsigned char s_aData[] = {NET_PACKETFLAG_COMPRESSION << 2, 0, 1, 0x12, 0x34};
+
+TEST(NetPreFilter, Classify)
+{
+	EXPECT_EQ(CNetPreFilter::Classify(s_aConnect, sizeof(s_aConnect), false), CNetPreFilter::RESULT_ACCEPTED);
+	EXPECT_EQ(CNetPreFilter::Classify(s_aConnless, sizeof(s_aConnless), false), CNetPreFilter::RESULT_ACCEPTED);
+	EXPECT_EQ(CNetPreFilter::Classify(s_aData, sizeof(s_aData), true), CNetPreFilter::RESULT_ACCEPTED);
+	EXPECT_EQ(CNetPreFilter::Classify(s_aData, sizeof(s_aData), false), CNetPreFilter::RESULT_UNEXPECTED);
+
+	// too short
+	EXPECT_EQ(CNetPreFilter::Classify(s_aConnect, 2, false), CNetPreFilter::RESULT_MALFORMED);
+	EXPECT_EQ(CNetPreFilter::Classify(s_aConnect, 3, false), CNetPreFilter::RESULT_MALFORMED);
+	EXPECT_EQ(CNetPreFilter::Classify(s_aConnless, 5, false), CNetPreFilter::RESULT_MALFORMED);
+
+	// control messages never contain chunks and are never compressed
+	const unsigned char aControlChunks[] = {NET_PACKETFLAG_CONTROL << 2, 0, 1, NET_CTRLMSG_CONNECT};
+	EXPECT_EQ(CNetPreFilter::Classify(aControlChunks, sizeof(aControlChunks), true), CNetPreFilter::RESULT_MALFORMED);
+	const unsigned char aControlCompressed[] = {(NET_PACKETFLAG_CONTROL | NET_PACKETFLAG_COMPRESSION) << 2, 0, 0, NET_CTRLMSG_CONNECT};
+	EXPECT_EQ(CNetPreFilter::Classify(aControlCompressed, sizeof(aControlCompressed), true), CNetPreFilter::RESULT_MALFORMED);
+
+	// data packets without chunks are only valid as resend requests
+	const unsigned char aNoChunks[] = {0, 0, 0};
+	EXPECT_EQ(CNetPreFilter::Classify(aNoChunks, sizeof(aNoChunks), true), CNetPreFilter::RESULT_MALFORMED);
+	const unsigned char aResend[] = {NET_PACKETFLAG_RESEND << 2, 0, 0};
+	EXPECT_EQ(CNetPreFilter::Classify(aResend, sizeof(aResend), true), CNetPreFilter::RESULT_ACCEPTED);
+
+	const unsigned char aMaxChunks[] = {0, 0, NET_MAX_PACKET_CHUNKS, 0x12};
+	EXPECT_EQ(CNetPreFilter::Classify(aMaxChunks, sizeof(aMaxChunks), true), CNetPreFilter::RESULT_ACCEPTED);
+
+	const unsigned char aUnknownFlag[] = {(NET_PACKETFLAG_TOKEN | NET_PACKETFLAG_CONTROL) << 2, 0, 0, NET_CTRLMSG_CONNECT};
+	EXPECT_EQ(CNetPreFilter::Classify(aUnknownFlag, sizeof(aUnknownFlag), true), CNetPreFilter::RESULT_MALFORMED);
+}
+
+TEST(NetPreFilter, RateLimit)
+{
+	CNetPreFilter PreFilter;
+	PreFilter.Init();
+	PreFilter.SetRateLimit(10, 5);
+
+	NETADDR Addr1, Addr2;
+	ASSERT_FALSE(net_addr_from_str(&Addr1, "192.0.2.1:8303"));
+	ASSERT_FALSE(net_addr_from_str(&Addr2, "192.0.2.2:8303"));
+
+	const int64_t Start = time_freq() * 1000;
+	for(int i = 0; i < 5; i++)
+		EXPECT_EQ(PreFilter.Check(Addr1, s_aConnless, sizeof(s_aConnless), false, Start), CNetPreFilter::RESULT_ACCEPTED);
+	EXPECT_EQ(PreFilter.Check(Addr1, s_aConnless, sizeof(s_aConnless), false, Start), CNetPreFilter::RESULT_RATELIMITED);
+	// malformed packets don't use up the rate limit
+	EXPECT_EQ(PreFilter.Check(Addr1, s_aConnless, 2, false, Start), CNetPreFilter::RESULT_MALFORMED);
+
+	// refills after 1/10 s
+	EXPECT_EQ(PreFilter.Check(Addr1, s_aConnless, sizeof(s_aConnless), false, Start + time_freq() / 20), CNetPreFilter::RESULT_RATELIMITED);
+	EXPECT_EQ(PreFilter.Check(Addr1, s_aConnless, sizeof(s_aConnless), false, Start + time_freq() / 10), CNetPreFilter::RESULT_ACCEPTED);
+	EXPECT_EQ(PreFilter.Check(Addr1, s_aConnless, sizeof(s_aConnless), false, Start + time_freq() / 10), CNetPreFilter::RESULT_RATELIMITED);
+
+	// other sources are not affected, unless they happen to share the bucket
+	int Accepted = 0;
+	for(int i = 0; i < 5; i++)
+		Accepted += PreFilter.Check(Addr2, s_aConnless, sizeof(s_aConnless), false, Start) == CNetPreFilter::RESULT_ACCEPTED;
+	EXPECT_GE(Accepted, 4);
+
+	EXPECT_EQ(PreFilter.Count(CNetPreFilter::RESULT_MALFORMED), 1u);
+	EXPECT_EQ(PreFilter.Count(CNetPreFilter::RESULT_RATELIMITED) + PreFilter.Count(CNetPreFilter::RESULT_ACCEPTED), 14u);
+
+	// disabled
+	PreFilter.SetRateLimit(0, 5);
+	for(int i = 0; i < 100; i++)
+		EXPECT_EQ(PreFilter.Check(Addr1, s_aConnless, sizeof(s_aConnless), false, Start), CNetPreFilter::RESULT_ACCEPTED);
+}
+
+TEST(NetPreFilter, Ipv6Prefix)
+{
+	CNetPreFilter PreFilter;
+	PreFilter.Init();
+	PreFilter.SetRateLimit(1, 2);
+
+	// addresses in the same /64 share their limit
+	NETADDR Addr1, Addr2;
+	ASSERT_FALSE(net_addr_from_str(&Addr1, "[2001:db8::1]:8303"));
+	ASSERT_FALSE(net_addr_from_str(&Addr2, "[2001:db8::2]:8303"));
+	const int64_t Start = time_freq() * 1000;
+	EXPECT_EQ(PreFilter.Check(Addr1, s_aConnect, sizeof(s_aConnect), false, Start), CNetPreFilter::RESULT_ACCEPTED);
+	EXPECT_EQ(PreFilter.Check(Addr2, s_aConnect, sizeof(s_aConnect), false, Start), CNetPreFilter::RESULT_ACCEPTED);
+	EXPECT_EQ(PreFilter.Check(Addr1, s_aConnect, sizeof(s_aConnect), false, Start), CNetPreFilter::RESULT_RATELIMITED);
+	EXPECT_EQ(PreFilter.Check(Addr2, s_aConnect, sizeof(s_aConnect), false, Start), CNetPreFilter::RESULT_RATELIMITED);
+}
+
+TEST(NetPreFilter, InfoRequests)
+{
+	CNetPreFilter PreFilter;
+	PreFilter.Init();
+	PreFilter.SetRateLimit(1, 1);
+
+	const unsigned char aGetInfo[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 'g', 'i', 'e', '3', 0x42};
+	const unsigned char aGetInfo64[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 'f', 's', 't', 'd', 0x42};
+	const unsigned char aGetInfoSixup[] = {(NET_PACKETFLAG_CONNLESS << 2) | 1, 1, 2, 3, 4, 5, 6, 7, 8, 0xff, 0xff, 0xff, 0xff, 'g', 'i', 'e', '3', 0x42};
+	EXPECT_TRUE(CNetPreFilter::IsInfoRequest(aGetInfo, sizeof(aGetInfo)));
+	EXPECT_TRUE(CNetPreFilter::IsInfoRequest(aGetInfo64, sizeof(aGetInfo64)));
+	EXPECT_TRUE(CNetPreFilter::IsInfoRequest(aGetInfoSixup, sizeof(aGetInfoSixup)));
+	// the token is missing
+	EXPECT_FALSE(CNetPreFilter::IsInfoRequest(aGetInfo, sizeof(aGetInfo) - 1));
+	EXPECT_FALSE(CNetPreFilter::IsInfoRequest(s_aConnless, sizeof(s_aConnless)));
+	EXPECT_FALSE(CNetPreFilter::IsInfoRequest(s_aConnect, sizeof(s_aConnect)));
+
+	// many browsers behind one address are all answered
+	NETADDR Addr;
+	ASSERT_FALSE(net_addr_from_str(&Addr, "192.0.2.1:8303"));
+	const int64_t Start = time_freq() * 1000;
+	for(int i = 0; i < 100; i++)
+		EXPECT_EQ(PreFilter.Check(Addr, aGetInfo, sizeof(aGetInfo), false, Start), CNetPreFilter::RESULT_ACCEPTED);
+	EXPECT_EQ(PreFilter.Check(Addr, s_aConnless, sizeof(s_aConnless), false, Start), CNetPreFilter::RESULT_ACCEPTED);
+	EXPECT_EQ(PreFilter.Check(Addr, s_aConnless, sizeof(s_aConnless), false, Start), CNetPreFilter::RESULT_RATELIMITED);
+}
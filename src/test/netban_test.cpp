@@ -0,0 +1,142 @@
+#include <base/system.h>
+
+#include <engine/shared/netban.h>
+
+#include <gtest/gtest.h>
+
+static NETADDR Addr(const char *pStr)
+{
+	NETADDR Result;
+	EXPECT_EQ(net_addr_from_str(&Result, pStr), 0) << pStr;
+	return Result;
+}
+
+static int Find(const CNetPrefixTrie &Trie, const char *pStr)
+{
+	const NETADDR Address = Addr(pStr);
+	return Trie.Find(&Address);
+}
+
+TEST(NetPrefixTrie, Empty)
+{
+	CNetPrefixTrie Trie;
+	EXPECT_EQ(Find(Trie, "192.0.2.1"), -1);
+	EXPECT_EQ(Find(Trie, "[2001:db8::1]"), -1);
+	EXPECT_EQ(Trie.NumPrefixes(), 0);
+}
+
+TEST(NetPrefixTrie, Prefix)
+{
+	CNetPrefixTrie Trie;
+	const NETADDR Net = Addr("192.0.2.0");
+	Trie.AddPrefix(&Net, 24, 7);
+	EXPECT_EQ(Find(Trie, "192.0.2.0"), 7);
+	EXPECT_EQ(Find(Trie, "192.0.2.255"), 7);
+	EXPECT_EQ(Find(Trie, "192.0.3.0"), -1);
+	EXPECT_EQ(Find(Trie, "192.0.1.255"), -1);
+	EXPECT_EQ(Trie.NumPrefixes(), 1);
+
+	Trie.Clear();
+	EXPECT_EQ(Find(Trie, "192.0.2.0"), -1);
+	EXPECT_EQ(Trie.NumPrefixes(), 0);
+}
+
+TEST(NetPrefixTrie, LongestMatch)
+{
+	CNetPrefixTrie Trie;
+	const NETADDR Net8 = Addr("10.0.0.0");
+	const NETADDR Net16 = Addr("10.1.0.0");
+	const NETADDR Host = Addr("10.1.2.3");
+	Trie.AddPrefix(&Net16, 16, 2);
+	Trie.AddPrefix(&Host, 32, 3);
+	Trie.AddPrefix(&Net8, 8, 1);
+	EXPECT_EQ(Find(Trie, "10.2.0.0"), 1);
+	EXPECT_EQ(Find(Trie, "10.1.0.0"), 2);
+	EXPECT_EQ(Find(Trie, "10.1.2.4"), 2);
+	EXPECT_EQ(Find(Trie, "10.1.2.3"), 3);
+	EXPECT_EQ(Find(Trie, "11.1.2.3"), -1);
+
+	// the first value added for a prefix is kept
+	Trie.AddPrefix(&Net16, 16, 4);
+	EXPECT_EQ(Find(Trie, "10.1.0.0"), 2);
+	EXPECT_EQ(Trie.NumPrefixes(), 3);
+}
+
+TEST(NetPrefixTrie, Siblings)
+{
+	CNetPrefixTrie Trie;
+	for(int i = 0; i < 256; i++)
+	{
+		char aAddr[NETADDR_MAXSTRSIZE];
+		str_format(aAddr, sizeof(aAddr), "198.51.%d.%d", i, 255 - i);
+		const NETADDR Host = Addr(aAddr);
+		Trie.AddPrefix(&Host, 32, i);
+	}
+	for(int i = 0; i < 256; i++)
+	{
+		char aAddr[NETADDR_MAXSTRSIZE];
+		str_format(aAddr, sizeof(aAddr), "198.51.%d.%d", i, 255 - i);
+		EXPECT_EQ(Find(Trie, aAddr), i);
+		str_format(aAddr, sizeof(aAddr), "198.51.%d.%d", i, (256 - i) % 256);
+		EXPECT_EQ(Find(Trie, aAddr), -1);
+	}
+}
+
+TEST(NetPrefixTrie, Range)
+{
+	CNetPrefixTrie Trie;
+	CNetRange Range;
+	Range.m_LB = Addr("192.0.2.5");
+	Range.m_UB = Addr("192.0.3.17");
+	Trie.AddRange(&Range, 1);
+	EXPECT_EQ(Find(Trie, "192.0.2.4"), -1);
+	EXPECT_EQ(Find(Trie, "192.0.2.5"), 1);
+	EXPECT_EQ(Find(Trie, "192.0.2.6"), 1);
+	EXPECT_EQ(Find(Trie, "192.0.2.255"), 1);
+	EXPECT_EQ(Find(Trie, "192.0.3.0"), 1);
+	EXPECT_EQ(Find(Trie, "192.0.3.17"), 1);
+	EXPECT_EQ(Find(Trie, "192.0.3.18"), -1);
+	// 5/32 6/31 8/29 16/28 32/27 64/26 128/25 on the first, 0/28 16/31 on the second block
+	EXPECT_EQ(Trie.NumPrefixes(), 9);
+
+	Range.m_LB = Addr("0.0.0.0");
+	Range.m_UB = Addr("255.255.255.255");
+	Trie.Clear();
+	Trie.AddRange(&Range, 2);
+	EXPECT_EQ(Find(Trie, "1.2.3.4"), 2);
+	EXPECT_EQ(Find(Trie, "[::1]"), -1);
+	EXPECT_EQ(Trie.NumPrefixes(), 1);
+}
+
+TEST(NetPrefixTrie, Ipv6)
+{
+	CNetPrefixTrie Trie;
+	const NETADDR Net = Addr("[2001:db8::]");
+	Trie.AddPrefix(&Net, 32, 1);
+	CNetRange Range;
+	Range.m_LB = Addr("[2001:db8:1::ff]");
+	Range.m_UB = Addr("[2001:db8:1::1:0]");
+	Trie.AddRange(&Range, 2);
+	EXPECT_EQ(Find(Trie, "[2001:db8::1]"), 1);
+	EXPECT_EQ(Find(Trie, "[2001:db8:1::fe]"), 1);
+	EXPECT_EQ(Find(Trie, "[2001:db8:1::ff]"), 2);
+	EXPECT_EQ(Find(Trie, "[2001:db8:1::abcd]"), 2);
+	EXPECT_EQ(Find(Trie, "[2001:db8:1::1:0]"), 2);
+	EXPECT_EQ(Find(Trie, "[2001:db8:1::1:1]"), 1);
+	EXPECT_EQ(Find(Trie, "[2001:db9::]"), -1);
+}
+
+TEST(NetPrefixTrie, Separate)
+{
+	// IPv4 and IPv6 addresses with the same leading bytes don't match
+	CNetPrefixTrie Trie;
+	const NETADDR Net4 = Addr("32.1.13.184");
+	Trie.AddPrefix(&Net4, 32, 1);
+	EXPECT_EQ(Find(Trie, "[2001:db8::]"), -1);
+
+	const NETADDR Net6 = Addr("[::]");
+	Trie.AddPrefix(&Net6, 0, 2);
+	EXPECT_EQ(Find(Trie, "[2001:db8::]"), 2);
+	EXPECT_EQ(Find(Trie, "32.1.13.184"), 1);
+	EXPECT_EQ(Find(Trie, "32.1.13.185"), -1);
+}
@@ -0,0 +1,273 @@
+#include <test/test.h>
+
+#include <base/system.h>
+
+#include <engine/kernel.h>
+#include <engine/map.h>
+#include <engine/storage.h>
+
+#include <generated/protocol.h>
+
+#include <game/alloc.h>
+#include <game/client/prediction/entities/character.h>
+#include <game/client/prediction/entities/laser.h>
+#include <game/client/prediction/entities/projectile.h>
+#include <game/client/prediction/gameworld.h>
+#include <game/collision.h>
+#include <game/layers.h>
+#include <game/mapbugs.h>
+#include <game/mapitems.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <set>
+#include <vector>
+
+static const int NUM_PLAYERS = 8;
+
+// A prediction world on the coverage map with characters firing grenades
+// and lasers, so projectiles and lasers come and go
+class PredictionWorld : public ::testing::Test
+{
+protected:
+	CTestInfo m_TestInfo;
+	std::unique_ptr<IStorage> m_pStorage;
+	std::unique_ptr<IKernel> m_pKernel;
+	CLayers m_Layers;
+	CCollision m_Collision;
+	CTuningParams m_aTuningList[TuneZone::NUM];
+	CMapBugs m_MapBugs;
+	CGameWorld m_World;
+	unsigned m_aRandom[NUM_PLAYERS];
+	CNetObj_PlayerInput m_aInputs[NUM_PLAYERS];
+
+	void SetUp() override
+	{
+		m_TestInfo.m_DeleteTestStorageFilesOnSuccess = true;
+		m_pStorage = m_TestInfo.CreateTestStorage();
+		ASSERT_TRUE(m_pStorage);
+		m_pKernel = std::unique_ptr<IKernel>(IKernel::Create());
+		m_pKernel->RegisterInterface(m_pStorage.get(), false);
+		IEngineMap *pMap = CreateEngineMap();
+		m_pKernel->RegisterInterface(pMap);
+		ASSERT_TRUE(pMap->Load("maps/coverage.map", IStorage::TYPE_ALL));
+		m_Layers.Init(pMap, false);
+		m_Collision.Init(&m_Layers);
+
+		std::vector<vec2> vSpawns;
+		for(int i = 0; i < m_Collision.GetWidth() * m_Collision.GetHeight(); i++)
+		{
+			if(m_Collision.GameLayer()[i].m_Index == ENTITY_OFFSET + ENTITY_SPAWN)
+				vSpawns.push_back(m_Collision.GetPos(i));
+		}
+		ASSERT_FALSE(vSpawns.empty());
+
+		m_World.Init(&m_Collision, m_aTuningList, &m_MapBugs);
+		m_World.m_WorldConfig = {};
+		m_World.m_WorldConfig.m_IsDDRace = true;
+		m_World.m_WorldConfig.m_InfiniteAmmo = true;
+		m_World.m_WorldConfig.m_PredictTiles = true;
+		m_World.m_WorldConfig.m_PredictWeapons = true;
+		m_World.m_WorldConfig.m_PredictDDRace = true;
+		m_World.m_GameTick = 100;
+
+		m_World.NetObjBegin(CTeamsCore(), 0);
+		for(int i = 0; i < NUM_PLAYERS; i++)
+		{
+			CNetObj_Character Char = {};
+			const vec2 Spawn = vSpawns[i % vSpawns.size()];
+			Char.m_X = round_to_int(Spawn.x) + i * 40;
+			Char.m_Y = round_to_int(Spawn.y);
+			Char.m_Weapon = i % 2 ? WEAPON_GRENADE : WEAPON_LASER;
+			Char.m_AmmoCount = 10;
+			Char.m_Emote = EMOTE_NORMAL;
+			m_World.NetCharAdd(i, &Char, nullptr, 0, i == 0);
+			m_aRandom[i] = 1 + i;
+			m_aInputs[i] = {};
+		}
+		m_World.NetObjEnd();
+		ASSERT_NE(m_World.FindFirst(CGameWorld::ENTTYPE_CHARACTER), nullptr);
+	}
+
+	void TearDown() override
+	{
+		m_World.Clear();
+	}
+
+	// Advances the inputs of the players by one tick
+	void NextInputs()
+	{
+		for(int i = 0; i < NUM_PLAYERS; i++)
+		{
+			unsigned &Random = m_aRandom[i];
+			const auto &&Next = [&Random](int Below) {
+				Random = Random * 1103515245 + 12345;
+				return (int)((Random >> 16) % Below);
+			};
+			CNetObj_PlayerInput &Input = m_aInputs[i];
+			if(Next(10) == 0)
+				Input.m_Direction = Next(3) - 1;
+			Input.m_Jump = Next(20) == 0;
+			if(Next(8) == 0)
+				Input.m_Fire++;
+			if(Next(30) == 0)
+				Input.m_Hook = !Input.m_Hook;
+			Input.m_TargetX = Next(401) - 200;
+			Input.m_TargetY = Next(401) - 200;
+		}
+	}
+
+	// Applies the current inputs to the world and ticks it, like the client
+	// does for predicted ticks
+	void Tick(CGameWorld &World) const
+	{
+		World.m_GameTick++;
+		for(int i = 0; i < NUM_PLAYERS; i++)
+		{
+			if(CCharacter *pChar = World.GetCharacterById(i))
+				pChar->OnDirectInput(&m_aInputs[i]);
+		}
+		for(int i = 0; i < NUM_PLAYERS; i++)
+		{
+			if(CCharacter *pChar = World.GetCharacterById(i))
+				pChar->OnPredictedInput(&m_aInputs[i]);
+		}
+		World.Tick();
+	}
+};
+
+// The state of all entities in the order of the world
+static std::vector<int> WorldState(CGameWorld &World)
+{
+	std::vector<int> vState;
+	const auto &&AddPos = [&vState](vec2 Pos) {
+		vState.push_back(std::round(Pos.x * 100.0f));
+		vState.push_back(std::round(Pos.y * 100.0f));
+	};
+	vState.push_back(World.GameTick());
+	for(int Type = 0; Type < CGameWorld::NUM_ENTTYPES; Type++)
+	{
+		for(CEntity *pEnt = World.FindFirst(Type); pEnt; pEnt = pEnt->TypeNext())
+		{
+			vState.push_back(Type);
+			vState.push_back(pEnt->GetId());
+			AddPos(pEnt->GetPos());
+			if(Type == CGameWorld::ENTTYPE_CHARACTER)
+			{
+				CCharacter *pChar = static_cast<CCharacter *>(pEnt);
+				CNetObj_CharacterCore Core;
+				pChar->GetCore().Write(&Core);
+				const int *pData = reinterpret_cast<const int *>(&Core);
+				vState.insert(vState.end(), pData, pData + sizeof(Core) / sizeof(int));
+				vState.push_back(pChar->m_FreezeTime);
+				vState.push_back(pChar->GetActiveWeapon());
+			}
+			else if(Type == CGameWorld::ENTTYPE_PROJECTILE)
+			{
+				vState.push_back(static_cast<CProjectile *>(pEnt)->GetOwner());
+			}
+			else if(Type == CGameWorld::ENTTYPE_LASER)
+			{
+				vState.push_back(static_cast<CLaser *>(pEnt)->GetOwner());
+				AddPos(static_cast<CLaser *>(pEnt)->GetFrom());
+			}
+		}
+	}
+	return vState;
+}
+
+static uint64_t NumPoolAllocations()
+{
+	uint64_t NumAllocations = 0;
+	for(const CPoolAllocator *pPool = CPoolAllocator::First(); pPool; pPool = pPool->Next())
+		NumAllocations += pPool->NumAllocations();
+	return NumAllocations;
+}
+
+static int NumEntities(CGameWorld &World, int Type)
+{
+	int Num = 0;
+	for(CEntity *pEnt = World.FindFirst(Type); pEnt; pEnt = pEnt->TypeNext())
+		Num++;
+	return Num;
+}
+
+TEST_F(PredictionWorld, CopyWorldReusesEntities)
+{
+	CGameWorld Copy;
+	Copy.CopyWorld(&m_World);
+
+	int NumCopiedProjectiles = 0;
+	int NumCopiedLasers = 0;
+	for(int Round = 0; Round < 40; Round++)
+	{
+		for(int i = 0; i < 5; i++)
+		{
+			NextInputs();
+			Tick(m_World);
+		}
+
+		int aNumPrevious[CGameWorld::NUM_ENTTYPES];
+		int aNumExpected[CGameWorld::NUM_ENTTYPES];
+		std::set<CEntity *> PreviousEntities;
+		int NumMissing = 0;
+		for(int Type = 0; Type < CGameWorld::NUM_ENTTYPES; Type++)
+		{
+			aNumPrevious[Type] = NumEntities(Copy, Type);
+			aNumExpected[Type] = NumEntities(m_World, Type);
+			NumMissing += maximum(aNumExpected[Type] - aNumPrevious[Type], 0);
+			for(CEntity *pEnt = Copy.FindFirst(Type); pEnt; pEnt = pEnt->TypeNext())
+				PreviousEntities.insert(pEnt);
+		}
+
+		// only the entities missing in the copy are allocated
+		const uint64_t NumAllocations = NumPoolAllocations();
+		Copy.CopyWorld(&m_World);
+		EXPECT_EQ(NumPoolAllocations() - NumAllocations, (uint64_t)NumMissing) << "round " << Round;
+		for(int Type = 0; Type < CGameWorld::NUM_ENTTYPES; Type++)
+		{
+			int NumReused = 0;
+			for(CEntity *pEnt = Copy.FindFirst(Type); pEnt; pEnt = pEnt->TypeNext())
+			{
+				NumReused += PreviousEntities.count(pEnt);
+				EXPECT_EQ(pEnt->GameWorld(), &Copy);
+			}
+			EXPECT_EQ(NumEntities(Copy, Type), aNumExpected[Type]) << "round " << Round << " type " << Type;
+			EXPECT_EQ(NumReused, minimum(aNumPrevious[Type], aNumExpected[Type])) << "round " << Round << " type " << Type;
+		}
+		NumCopiedProjectiles += aNumExpected[CGameWorld::ENTTYPE_PROJECTILE];
+		NumCopiedLasers += aNumExpected[CGameWorld::ENTTYPE_LASER];
+
+		// the reused entities hold the same state as the original and
+		// as a copy into an empty world
+		const std::vector<int> vState = WorldState(m_World);
+		EXPECT_EQ(WorldState(Copy), vState) << "round " << Round;
+		CGameWorld Fresh;
+		Fresh.CopyWorld(&m_World);
+		ASSERT_EQ(WorldState(Fresh), vState) << "round " << Round;
+
+		// and they go on the same way
+		{
+			unsigned aSavedRandom[NUM_PLAYERS];
+			CNetObj_PlayerInput aSavedInputs[NUM_PLAYERS];
+			mem_copy(aSavedRandom, m_aRandom, sizeof(aSavedRandom));
+			mem_copy(aSavedInputs, m_aInputs, sizeof(aSavedInputs));
+			for(int i = 0; i < 10; i++)
+			{
+				NextInputs();
+				Tick(Copy);
+				Tick(Fresh);
+				ASSERT_EQ(WorldState(Copy), WorldState(Fresh)) << "round " << Round << " tick " << i;
+			}
+			mem_copy(m_aRandom, aSavedRandom, sizeof(aSavedRandom));
+			mem_copy(m_aInputs, aSavedInputs, sizeof(aSavedInputs));
+		}
+		if(HasFatalFailure())
+			return;
+	}
+	// the world had projectiles and lasers coming and going
+	EXPECT_GT(NumCopiedProjectiles, 0);
+	EXPECT_GT(NumCopiedLasers, 0);
+}
@@ -0,0 +1,56 @@
+#include "test.h"
+
+#include <base/system.h>
+
+#include <engine/shared/server_stats.h>
+
+#include <gtest/gtest.h>
+
+TEST(ServerStats, WriteRead)
+{
+	CTestInfo Info;
+
+	CServerStatsWriter Writer;
+	ASSERT_TRUE(Writer.Open(Info.m_aFilename));
+
+	CServerStatsReader Reader;
+	ASSERT_TRUE(Reader.Open(Info.m_aFilename));
+	EXPECT_EQ(Reader.NumUpdates(), 0u);
+
+	CServerStats Stats = {};
+	Stats.m_Tick = 1234;
+	Stats.m_TickTimeP99 = 567;
+	Stats.m_aClients[3].m_State = 5;
+	Stats.m_aClients[3].m_SentBytes = 0x123456789ull;
+	Writer.Publish(Stats);
+	Stats.m_Tick++;
+	Writer.Publish(Stats);
+
+	CServerStats Read;
+	ASSERT_TRUE(Reader.Read(&Read));
+	EXPECT_EQ(Reader.NumUpdates(), 2u);
+	EXPECT_EQ(Read.m_Tick, 1235);
+	EXPECT_EQ(Read.m_TickTimeP99, 567);
+	EXPECT_EQ(Read.m_aClients[3].m_State, 5);
+	EXPECT_EQ(Read.m_aClients[3].m_SentBytes, 0x123456789ull);
+	EXPECT_EQ(Read.m_aClients[4].m_State, 0);
+
+	Reader.Close();
+	Writer.Close();
+	EXPECT_FALSE(fs_remove(Info.m_aFilename));
+}
+
+TEST(ServerStats, RejectInvalid)
+{
+	CTestInfo Info;
+
+	IOHANDLE File = io_open(Info.m_aFilename, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	const char aGarbage[] = "not a stats file";
+	io_write(File, aGarbage, sizeof(aGarbage));
+	io_close(File);
+
+	CServerStatsReader Reader;
+	EXPECT_FALSE(Reader.Open(Info.m_aFilename));
+	EXPECT_FALSE(fs_remove(Info.m_aFilename));
+}
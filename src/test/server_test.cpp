@@ -1,7 +1,13 @@
 #include <engine/server/server.h>
+#include <engine/shared/masterserver.h>
+#include <engine/shared/network.h>
+#include <engine/shared/packer.h>
 
 #include <gtest/gtest.h>
 
+#include <climits>
+#include <vector>
+
 TEST(Server, StrHideIps)
 {
 	char aLine[512];
@@ -59,3 +65,82 @@ TEST(Server, StrHideIps)
 	EXPECT_STREQ(aLine, "<{<{a}>}>");
 	EXPECT_STREQ(aLineWithoutIps, "XXX}>}>");
 }
+
+TEST(Server, SnapIdPoolBatch)
+{
+	CSnapIdPool *pPool = new CSnapIdPool();
+	int aIds[16];
+	ASSERT_EQ(pPool->NewIds(aIds, 16), 16);
+	for(int i = 1; i < 16; i++)
+		EXPECT_NE(aIds[i], aIds[i - 1]);
+	EXPECT_EQ(pPool->NumAllocated(), 16);
+
+	pPool->FreeId(aIds[0]);
+	EXPECT_EQ(pPool->NumAllocated(), 15);
+	EXPECT_EQ(pPool->NumTimed(), 1);
+
+	// freed ids are only reused after the timeout
+	const int Id = pPool->NewId();
+	EXPECT_NE(Id, aIds[0]);
+	pPool->TimeoutIds();
+	EXPECT_EQ(pPool->NumTimed(), 0);
+	EXPECT_EQ(pPool->NewId(), aIds[0]);
+	delete pPool;
+}
+
+// The server info datagram as it was packed for each request
+static std::vector<unsigned char> PackServerInfo(int Type, int Chunk, int Token, const std::vector<unsigned char> &vChunk)
+{
+	CPacker p;
+	p.Reset();
+	if(Type == SERVERINFO_EXTENDED)
+		p.AddRaw(Chunk == 0 ? SERVERBROWSE_INFO_EXTENDED : SERVERBROWSE_INFO_EXTENDED_MORE, SERVERBROWSE_SIZE);
+	else if(Type == SERVERINFO_64_LEGACY)
+		p.AddRaw(SERVERBROWSE_INFO_64_LEGACY, SERVERBROWSE_SIZE);
+	else
+		p.AddRaw(SERVERBROWSE_INFO, SERVERBROWSE_SIZE);
+	char aBuf[128];
+	str_format(aBuf, sizeof(aBuf), "%d", Token);
+	p.AddString(aBuf, 0);
+	p.AddRaw(vChunk.data(), vChunk.size());
+
+	// connless header of CNetBase::SendPacketConnless
+	std::vector<unsigned char> vDatagram(NET_CONNLESS_HEADER_SIZE, 0xFF);
+	vDatagram.insert(vDatagram.end(), p.Data(), p.Data() + p.Size());
+	return vDatagram;
+}
+
+TEST(Server, ServerInfoDatagramMatchesPacker)
+{
+	std::vector<std::vector<unsigned char>> vvChunks;
+	for(int Size : {1, 37, 255, 1100})
+	{
+		std::vector<unsigned char> vChunk;
+		for(int i = 0; i < Size; i++)
+			vChunk.push_back(i * 31 + Size);
+		vvChunks.push_back(vChunk);
+	}
+
+	// the ingame info is sent from the vanilla cache
+	for(int Type : {SERVERINFO_VANILLA, SERVERINFO_64_LEGACY, SERVERINFO_EXTENDED, SERVERINFO_INGAME})
+	{
+		const int CacheType = Type == SERVERINFO_INGAME ? SERVERINFO_VANILLA : Type;
+		CServer::CCache Cache;
+		for(size_t Chunk = 0; Chunk < vvChunks.size(); Chunk++)
+			Cache.AddDatagram(CServer::ServerInfoChunkType(CacheType, Chunk), vvChunks[Chunk].data(), vvChunks[Chunk].size());
+		ASSERT_EQ(Cache.m_vDatagrams.size(), vvChunks.size());
+
+		// the same datagrams are patched again for every request, shorter
+		// tokens after longer ones
+		for(int Token : {INT_MIN, 0, -1, INT_MAX, 7, 123456, -98765, 42})
+		{
+			for(size_t Chunk = 0; Chunk < vvChunks.size(); Chunk++)
+			{
+				int Size;
+				const unsigned char *pData = Cache.m_vDatagrams[Chunk].Prepare(Token, &Size);
+				const std::vector<unsigned char> vExpected = PackServerInfo(Type, Chunk, Token, vvChunks[Chunk]);
+				ASSERT_EQ(std::vector<unsigned char>(pData, pData + Size), vExpected) << "type " << Type << " token " << Token << " chunk " << Chunk;
+			}
+		}
+	}
+}
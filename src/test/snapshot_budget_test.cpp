@@ -0,0 +1,115 @@
+#include <base/system.h>
+
+#include <engine/server/snapshot_budget.h>
+#include <engine/shared/compression.h>
+#include <engine/shared/snapshot.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+static const int ITEM_TYPE = 1;
+static const int ITEM_INTS = 4;
+
+class SnapshotBudget : public ::testing::Test
+{
+protected:
+	std::unique_ptr<CSnapshotDelta> m_pDelta = std::make_unique<CSnapshotDelta>();
+	std::unique_ptr<CSnapshotBuilder> m_pBuilder = std::make_unique<CSnapshotBuilder>();
+	CSnapshotBudget m_Budget;
+
+	char m_aPast[CSnapshot::MAX_SIZE];
+	char m_aCurrent[CSnapshot::MAX_SIZE];
+	CSnapshot *Past() { return (CSnapshot *)m_aPast; }
+	CSnapshot *Current() { return (CSnapshot *)m_aCurrent; }
+
+	// items with ids `FirstId` to `FirstId + Num - 1`, all ints set to `Value`
+	void Build(int FirstId, int Num, int Value)
+	{
+		m_pBuilder->Init();
+		for(int Id = FirstId; Id < FirstId + Num; Id++)
+		{
+			int *pData = static_cast<int *>(m_pBuilder->NewItem(ITEM_TYPE, Id, ITEM_INTS * sizeof(int32_t)));
+			ASSERT_TRUE(pData != nullptr);
+			for(int i = 0; i < ITEM_INTS; i++)
+				pData[i] = Value;
+		}
+	}
+
+	int Apply(int Budget, int Tick, int MaxWaitTicks)
+	{
+		m_pBuilder->Finish(Current());
+		const int NumDeferred = m_Budget.Apply(m_pBuilder.get(), *m_pDelta, Past(), Current(), Budget, Tick, MaxWaitTicks, [](int Index) {
+			// items with higher ids are further away
+			return (float)Index;
+		});
+		m_pBuilder->Finish(Current());
+		return NumDeferred;
+	}
+
+	int PackedDeltaSize()
+	{
+		char aDelta[CSnapshot::MAX_SIZE];
+		const int DeltaSize = m_pDelta->CreateDelta(Past(), Current(), aDelta);
+		char aPacked[CSnapshot::MAX_SIZE];
+		return CVariableInt::Compress(aDelta, DeltaSize, aPacked, sizeof(aPacked));
+	}
+};
+
+TEST_F(SnapshotBudget, WithinBudget)
+{
+	Build(0, 10, 0);
+	m_pBuilder->Finish(Past());
+	Build(0, 10, 1);
+	EXPECT_EQ(Apply(1000, 0, 50), 0);
+	EXPECT_EQ(Current()->NumItems(), 10);
+}
+
+TEST_F(SnapshotBudget, SmallChangesCount)
+{
+	// every int changes by 1, which packs to a single byte
+	Build(0, 50, 0);
+	m_pBuilder->Finish(Past());
+	Build(0, 50, 1);
+	const int Budget = 100;
+	const int NumDeferred = Apply(Budget, 0, 50);
+	EXPECT_GT(NumDeferred, 0);
+	EXPECT_LE(PackedDeltaSize(), Budget);
+
+	// the far items keep the data the client has
+	ASSERT_EQ(Current()->NumItems(), 50);
+	const int *pNear = static_cast<const int *>(Current()->FindItem(ITEM_TYPE, 0));
+	const int *pFar = static_cast<const int *>(Current()->FindItem(ITEM_TYPE, 49));
+	EXPECT_EQ(pNear[0], 1);
+	EXPECT_EQ(pFar[0], 0);
+}
+
+TEST_F(SnapshotBudget, NewItemsLeftOut)
+{
+	mem_copy(m_aPast, CSnapshot::EmptySnapshot(), sizeof(CSnapshot));
+	Build(0, 50, 1000);
+	const int Budget = 200;
+	const int NumDeferred = Apply(Budget, 0, 50);
+	EXPECT_GT(NumDeferred, 0);
+	EXPECT_EQ(Current()->NumItems(), 50 - NumDeferred);
+	EXPECT_LE(PackedDeltaSize(), Budget);
+	EXPECT_NE(Current()->FindItem(ITEM_TYPE, 0), nullptr);
+	EXPECT_EQ(Current()->FindItem(ITEM_TYPE, 49), nullptr);
+}
+
+TEST_F(SnapshotBudget, EverythingArrives)
+{
+	// the budget is too small for even a single item
+	mem_copy(m_aPast, CSnapshot::EmptySnapshot(), sizeof(CSnapshot));
+	Build(0, 2, 1000);
+	EXPECT_EQ(Apply(5, 0, 3), 2);
+	EXPECT_EQ(Current()->NumItems(), 0);
+
+	Build(0, 2, 1000);
+	EXPECT_EQ(Apply(5, 2, 3), 2);
+	EXPECT_EQ(Current()->NumItems(), 0);
+
+	Build(0, 2, 1000);
+	EXPECT_EQ(Apply(5, 3, 3), 0);
+	EXPECT_EQ(Current()->NumItems(), 2);
+}
@@ -1,5 +1,6 @@
 #include <base/system.h>
 
+#include <engine/shared/compression.h>
 #include <engine/shared/snapshot.h>
 
 #include <generated/protocol.h>
@@ -85,3 +86,175 @@ TEST(Snapshot, CrcOverflow)
 
 	ASSERT_EQ(pSnapshot->Crc(), 1);
 }
+
+TEST(Snapshot, IndexMatchesFindItem)
+{
+	CSnapshotBuilder Builder;
+	Builder.Init();
+
+	const int aFlagIds[] = {7, 2, 5};
+	for(int Id : aFlagIds)
+		ASSERT_TRUE(Builder.NewItem(NETOBJTYPE_FLAG, Id, sizeof(CNetObj_Flag)));
+	const int aCharacterIds[] = {3, 0, 63};
+	for(int Id : aCharacterIds)
+	{
+		ASSERT_TRUE(Builder.NewItem(NETOBJTYPE_CHARACTER, Id, sizeof(CNetObj_Character)));
+		ASSERT_TRUE(Builder.NewItem(NETOBJTYPE_DDNETCHARACTER, Id, sizeof(CNetObj_DDNetCharacter)));
+	}
+
+	char aData[CSnapshot::MAX_SIZE];
+	CSnapshot *pSnapshot = (CSnapshot *)aData;
+	Builder.Finish(pSnapshot);
+
+	CSnapshotIndex Index;
+	Index.Build(pSnapshot);
+	ASSERT_EQ(Index.NumItems(), pSnapshot->NumItems());
+
+	for(int i = 0; i < pSnapshot->NumItems(); i++)
+	{
+		const int Type = pSnapshot->GetItemType(i);
+		const int Id = pSnapshot->GetItem(i)->Id();
+		EXPECT_EQ(Index.ItemType(i), Type);
+		const int Found = Index.FindItemIndex(Type, Id);
+		ASSERT_GE(Found, 0);
+		EXPECT_EQ(pSnapshot->GetItem(Found)->Data(), pSnapshot->FindItem(Type, Id));
+	}
+	EXPECT_EQ(Index.FindItemIndex(NETOBJTYPE_FLAG, 3), -1);
+	EXPECT_EQ(Index.FindItemIndex(NETOBJTYPE_CHARACTER, 1), -1);
+	EXPECT_EQ(Index.FindItemIndex(NETOBJTYPE_PICKUP, 0), -1);
+
+	int Num;
+	const int *pIndices = Index.ItemsOfType(NETOBJTYPE_FLAG, &Num);
+	ASSERT_EQ(Num, 3);
+	EXPECT_EQ(pSnapshot->GetItem(pIndices[0])->Id(), 2);
+	EXPECT_EQ(pSnapshot->GetItem(pIndices[1])->Id(), 5);
+	EXPECT_EQ(pSnapshot->GetItem(pIndices[2])->Id(), 7);
+
+	pIndices = Index.ItemsOfType(NETOBJTYPE_DDNETCHARACTER, &Num);
+	ASSERT_EQ(Num, 3);
+	EXPECT_EQ(pSnapshot->GetItem(pIndices[0])->Id(), 0);
+	EXPECT_EQ(pSnapshot->GetItem(pIndices[2])->Id(), 63);
+
+	Index.ItemsOfType(NETOBJTYPE_PICKUP, &Num);
+	EXPECT_EQ(Num, 0);
+}
+
+TEST(Snapshot, StorageReusesIndices)
+{
+	char aaData[2][CSnapshot::MAX_SIZE];
+	CSnapshot *apSnapshots[2];
+	int aSizes[2];
+	for(int s = 0; s < 2; s++)
+	{
+		CSnapshotBuilder Builder;
+		Builder.Init();
+		for(int Id = 0; Id <= s; Id++)
+			ASSERT_TRUE(Builder.NewItem(NETOBJTYPE_FLAG, Id, sizeof(CNetObj_Flag)));
+		apSnapshots[s] = (CSnapshot *)aaData[s];
+		aSizes[s] = Builder.Finish(apSnapshots[s]);
+	}
+
+	CSnapshotStorage Storage;
+	Storage.Add(1, 0, aSizes[0], apSnapshots[0], aSizes[0], apSnapshots[0]);
+	const CSnapshotIndex *pIndex = Storage.m_pFirst->m_pAltIndex;
+	ASSERT_TRUE(pIndex);
+	EXPECT_EQ(pIndex->NumItems(), 1);
+	Storage.PurgeUntil(2);
+	EXPECT_EQ(Storage.m_pFirst, nullptr);
+
+	// the index of the purged snapshot is rebuilt for the next one
+	Storage.Add(2, 0, aSizes[1], apSnapshots[1], aSizes[1], apSnapshots[1]);
+	EXPECT_EQ(Storage.m_pFirst->m_pAltIndex, pIndex);
+	EXPECT_EQ(pIndex->NumItems(), 2);
+	EXPECT_EQ(pIndex->FindItemIndex(NETOBJTYPE_FLAG, 1), 1);
+
+	// no index without an alternative snapshot
+	Storage.Add(3, 0, aSizes[0], apSnapshots[0], 0, nullptr);
+	EXPECT_EQ(Storage.m_pLast->m_pAltIndex, nullptr);
+}
+
+TEST(Snapshot, CountItemBytes)
+{
+	CSnapshotBuilder Builder;
+	Builder.Init();
+
+	CNetObj_Flag Flag = {1000, -2000, 1};
+	for(int Id = 0; Id < 2; Id++)
+		mem_copy(Builder.NewItem(NETOBJTYPE_FLAG, Id, sizeof(Flag)), &Flag, sizeof(Flag));
+	CNetObj_Pickup Pickup = {12, 34, 0, 0};
+	mem_copy(Builder.NewItem(NETOBJTYPE_PICKUP, 0, sizeof(Pickup)), &Pickup, sizeof(Pickup));
+
+	char aData[CSnapshot::MAX_SIZE];
+	CSnapshot *pSnapshot = (CSnapshot *)aData;
+	Builder.Finish(pSnapshot);
+
+	CSnapshotDelta Delta;
+	Delta.SetStaticsize(NETOBJTYPE_FLAG, sizeof(Flag));
+	char aDelta[CSnapshot::MAX_SIZE];
+	const int DeltaSize = Delta.CreateDelta(CSnapshot::EmptySnapshot(), pSnapshot, aDelta);
+	ASSERT_GT(DeltaSize, 0);
+
+	uint64_t aTypeBytes[NETOBJTYPE_FLAG + 2] = {};
+	Delta.CountItemBytes(aDelta, DeltaSize, aTypeBytes, std::size(aTypeBytes));
+
+	// type, id and data of each flag: 1 + 1 + (2 + 2 + 1)
+	EXPECT_EQ(aTypeBytes[NETOBJTYPE_FLAG], 2u * 7u);
+	// type, id, size and data: 1 + 1 + 1 + (1 + 1 + 1 + 1)
+	EXPECT_EQ(aTypeBytes[NETOBJTYPE_PICKUP], 7u);
+	EXPECT_EQ(aTypeBytes[NETOBJTYPE_FLAG + 1], 0u);
+
+	// the rest is the header of three ints
+	char aPacked[CSnapshot::MAX_SIZE];
+	uint64_t Total = 0;
+	for(uint64_t Bytes : aTypeBytes)
+		Total += Bytes;
+	EXPECT_EQ((uint64_t)CVariableInt::Compress(aDelta, DeltaSize, aPacked, sizeof(aPacked)), Total + 3);
+
+	// types that don't fit are added to the last counter
+	uint64_t aFewTypeBytes[NETOBJTYPE_PICKUP + 1] = {};
+	Delta.CountItemBytes(aDelta, DeltaSize, aFewTypeBytes, std::size(aFewTypeBytes));
+	EXPECT_EQ(aFewTypeBytes[NETOBJTYPE_PICKUP], Total);
+}
+
+TEST(Snapshot, RemoveItems)
+{
+	CSnapshotBuilder Builder;
+	Builder.Init();
+
+	for(int i = 0; i < 4; i++)
+	{
+		CNetObj_Flag *pFlag = static_cast<CNetObj_Flag *>(Builder.NewItem(NETOBJTYPE_FLAG, i, sizeof(CNetObj_Flag)));
+		ASSERT_FALSE(pFlag == nullptr);
+		pFlag->m_X = i;
+		pFlag->m_Y = i * 10;
+		pFlag->m_Team = 0;
+	}
+	CNetObj_Pickup *pPickup = static_cast<CNetObj_Pickup *>(Builder.NewItem(NETOBJTYPE_PICKUP, 7, sizeof(CNetObj_Pickup)));
+	ASSERT_FALSE(pPickup == nullptr);
+	pPickup->m_X = 70;
+	pPickup->m_Y = 700;
+	pPickup->m_Type = 1;
+	pPickup->m_Subtype = 2;
+
+	const bool aRemove[] = {true, false, true, false, false};
+	Builder.RemoveItems(aRemove);
+
+	char aData[CSnapshot::MAX_SIZE];
+	CSnapshot *pSnapshot = (CSnapshot *)aData;
+	const int Size = Builder.Finish(pSnapshot);
+	ASSERT_TRUE(pSnapshot->IsValid(Size));
+	ASSERT_EQ(pSnapshot->NumItems(), 3);
+
+	EXPECT_EQ(pSnapshot->FindItem(NETOBJTYPE_FLAG, 0), nullptr);
+	EXPECT_EQ(pSnapshot->FindItem(NETOBJTYPE_FLAG, 2), nullptr);
+	const CNetObj_Flag *pFlag1 = static_cast<const CNetObj_Flag *>(pSnapshot->FindItem(NETOBJTYPE_FLAG, 1));
+	ASSERT_FALSE(pFlag1 == nullptr);
+	EXPECT_EQ(pFlag1->m_Y, 10);
+	const CNetObj_Flag *pFlag3 = static_cast<const CNetObj_Flag *>(pSnapshot->FindItem(NETOBJTYPE_FLAG, 3));
+	ASSERT_FALSE(pFlag3 == nullptr);
+	EXPECT_EQ(pFlag3->m_Y, 30);
+	const CNetObj_Pickup *pFoundPickup = static_cast<const CNetObj_Pickup *>(pSnapshot->FindItem(NETOBJTYPE_PICKUP, 7));
+	ASSERT_FALSE(pFoundPickup == nullptr);
+	EXPECT_EQ(pFoundPickup->m_Y, 700);
+	EXPECT_EQ(pFoundPickup->m_Subtype, 2);
+}
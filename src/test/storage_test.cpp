@@ -0,0 +1,62 @@
+#include "test.h"
+
+#include <base/system.h>
+
+#include <engine/storage.h>
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+
+static int CollectCallback(const char *pName, int IsDir, int Type, void *pUser)
+{
+	if(str_comp(pName, ".") != 0 && str_comp(pName, "..") != 0)
+		static_cast<std::set<std::string> *>(pUser)->emplace(pName);
+	return 0;
+}
+
+static std::set<std::string> List(IStorage *pStorage, const char *pPath)
+{
+	std::set<std::string> Entries;
+	pStorage->ListDirectory(IStorage::TYPE_SAVE, pPath, CollectCallback, &Entries);
+	return Entries;
+}
+
+TEST(Storage, ListDirectoryReflectsChanges)
+{
+	CTestInfo Info;
+	Info.m_DeleteTestStorageFilesOnSuccess = true;
+	std::unique_ptr<IStorage> pStorage = Info.CreateTestStorage();
+	ASSERT_TRUE(pStorage);
+
+	ASSERT_TRUE(pStorage->CreateFolder("dir", IStorage::TYPE_SAVE));
+	EXPECT_EQ(List(pStorage.get(), "dir"), std::set<std::string>{});
+
+	IOHANDLE File = pStorage->OpenFile("dir/a.txt", IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	ASSERT_TRUE(File);
+	io_close(File);
+	EXPECT_EQ(List(pStorage.get(), "dir"), std::set<std::string>{"a.txt"});
+
+	// changes made without going through the storage must be visible too
+	char aPath[IO_MAX_PATH_LENGTH];
+	str_format(aPath, sizeof(aPath), "%s/dir/b.txt", Info.m_aFilename);
+	File = io_open(aPath, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	io_close(File);
+	EXPECT_EQ(List(pStorage.get(), "dir"), (std::set<std::string>{"a.txt", "b.txt"}));
+
+	char aBuf[IO_MAX_PATH_LENGTH];
+	EXPECT_TRUE(pStorage->FindFile("b.txt", "", IStorage::TYPE_SAVE, aBuf, sizeof(aBuf)));
+	EXPECT_STREQ(aBuf, "/dir/b.txt");
+
+	EXPECT_TRUE(pStorage->RenameFile("dir/a.txt", "dir/c.txt", IStorage::TYPE_SAVE));
+	EXPECT_TRUE(fs_remove(aPath) == 0);
+	EXPECT_EQ(List(pStorage.get(), "dir"), std::set<std::string>{"c.txt"});
+	EXPECT_FALSE(pStorage->FindFile("b.txt", "", IStorage::TYPE_SAVE, aBuf, sizeof(aBuf)));
+
+	EXPECT_TRUE(pStorage->RemoveFile("dir/c.txt", IStorage::TYPE_SAVE));
+	EXPECT_EQ(List(pStorage.get(), "dir"), std::set<std::string>{});
+	EXPECT_TRUE(pStorage->RemoveFolder("dir", IStorage::TYPE_SAVE));
+	EXPECT_EQ(List(pStorage.get(), "dir"), std::set<std::string>{});
+}
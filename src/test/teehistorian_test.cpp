@@ -1,3 +1,5 @@
+#include "test.h"
+
 #include <base/detect.h>
 
 #include <engine/external/json-parser/json.h>
@@ -6,6 +8,8 @@
 
 #include <game/gamecore.h>
 #include <game/server/teehistorian.h>
+#include <game/server/teehistorian_blocks.h>
+#include <game/server/teehistorian_reader.h>
 
 #include <gtest/gtest.h>
 
@@ -106,7 +110,7 @@ protected:
 
 	void Expect(const unsigned char *pOutput, size_t OutputSize)
 	{
-		static CUuid TEEHISTORIAN_UUID = CalculateUuid("teehistorian@ddnet.tw");
+		static CUuid s_Uuid = CalculateUuid("teehistorian@ddnet.tw");
 		static const char PREFIX1[] = "{\"comment\":\"teehistorian@ddnet.tw\",\"version\":\"2\",\"version_minor\":\"18\",\"game_uuid\":\"a1eb7182-796e-3b3e-941d-38ca71b2a4a8\",\"server_version\":\"DDNet test\",\"start_time\":\"";
 		static const char PREFIX2[] = "\",\"server_name\":\"server name\",\"server_port\":\"8303\",\"game_type\":\"game type\",\"map_name\":\"Kobra 3 Solo\",\"map_size\":\"903514\",\"map_sha256\":\"0123456789012345678901234567890123456789012345678901234567890123\",\"map_crc\":\"eceaf25c\",\"prng_description\":\"test-prng:02468ace\",\"config\":{},\"tuning\":{},\"uuids\":[";
 		static const char PREFIX3[] = "]}";
@@ -115,7 +119,7 @@ protected:
 		str_timestamp_ex(m_GameInfo.m_StartTime, aTimeBuf, sizeof(aTimeBuf), "%Y-%m-%dT%H:%M:%S%z");
 
 		std::vector<unsigned char> vBuffer;
-		WriteBuffer(vBuffer, &TEEHISTORIAN_UUID, sizeof(TEEHISTORIAN_UUID));
+		WriteBuffer(vBuffer, &s_Uuid, sizeof(s_Uuid));
 		WriteBuffer(vBuffer, PREFIX1, str_length(PREFIX1));
 		WriteBuffer(vBuffer, aTimeBuf, str_length(aTimeBuf));
 		WriteBuffer(vBuffer, PREFIX2, str_length(PREFIX2));
@@ -906,3 +910,242 @@ TEST_F(TeeHistorian, PrevGameUuid)
 	EXPECT_STREQ(JsonPrevGameUuid, "fe19c218-f555-4002-a273-126c59ccc17a");
 	json_value_free(pJson);
 }
+
+TEST_F(TeeHistorian, Reader)
+{
+	CNetObj_PlayerInput Input;
+	mem_zero(&Input, sizeof(Input));
+
+	Tick(1);
+	Player(0, 10, 20);
+	Player(3, 5, 5);
+	Inputs();
+	Input.m_Direction = 1;
+	m_TH.RecordPlayerInput(0, 1, &Input);
+	m_TH.RecordPlayerJoin(4, CTeeHistorian::PROTOCOL_7);
+	Tick(2);
+	Player(0, 11, 20);
+	DeadPlayer(3);
+	Inputs();
+	Input.m_Jump = 1;
+	m_TH.RecordPlayerInput(0, 1, &Input);
+	m_TH.RecordPlayerDrop(4, "bye");
+	Tick(5);
+	Player(0, 12, 18);
+	Finish();
+
+	CTeeHistorianReader Reader;
+	ASSERT_TRUE(Reader.OpenMemory(m_vBuffer.data(), m_vBuffer.size()));
+	ASSERT_TRUE(Reader.Header());
+	EXPECT_STREQ((*Reader.Header())["map_name"], "Kobra 3 Solo");
+
+	CTeeHistorianReader::CItem Item;
+	using EItem = CTeeHistorianReader::EItem;
+
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Type, EItem::PLAYER_NEW);
+	EXPECT_EQ(Item.m_Tick, 1);
+	EXPECT_EQ(Item.m_ClientId, 0);
+	EXPECT_EQ(Item.m_X, 10);
+	EXPECT_EQ(Item.m_Y, 20);
+
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Type, EItem::PLAYER_NEW);
+	EXPECT_EQ(Item.m_Tick, 1);
+	EXPECT_EQ(Item.m_ClientId, 3);
+
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Type, EItem::INPUT_NEW);
+	EXPECT_EQ(Item.m_Tick, 1);
+	EXPECT_EQ(Item.m_ClientId, 0);
+	EXPECT_EQ(Item.m_Input.m_Direction, 1);
+	EXPECT_EQ(Item.m_Input.m_Jump, 0);
+
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Type, EItem::EX);
+	EXPECT_EQ(Item.m_Uuid, CalculateUuid("teehistorian-joinver7@ddnet.tw"));
+
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Type, EItem::JOIN);
+	EXPECT_EQ(Item.m_Tick, 1);
+	EXPECT_EQ(Item.m_ClientId, 4);
+
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Type, EItem::PLAYER_DIFF);
+	EXPECT_EQ(Item.m_Tick, 2);
+	EXPECT_EQ(Item.m_ClientId, 0);
+	EXPECT_EQ(Item.m_X, 11);
+	EXPECT_EQ(Item.m_Y, 20);
+
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Type, EItem::PLAYER_OLD);
+	EXPECT_EQ(Item.m_Tick, 2);
+	EXPECT_EQ(Item.m_ClientId, 3);
+
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Type, EItem::INPUT_DIFF);
+	EXPECT_EQ(Item.m_Tick, 2);
+	EXPECT_EQ(Item.m_Input.m_Direction, 1);
+	EXPECT_EQ(Item.m_Input.m_Jump, 1);
+
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Type, EItem::DROP);
+	EXPECT_EQ(Item.m_ClientId, 4);
+	EXPECT_STREQ(Item.m_pString, "bye");
+
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Type, EItem::PLAYER_DIFF);
+	EXPECT_EQ(Item.m_Tick, 5);
+	EXPECT_EQ(Item.m_X, 12);
+	EXPECT_EQ(Item.m_Y, 18);
+
+	EXPECT_FALSE(Reader.Read(&Item));
+	EXPECT_TRUE(Reader.Finished());
+	EXPECT_FALSE(Reader.Error());
+}
+
+TEST_F(TeeHistorian, ReaderTruncated)
+{
+	Tick(1);
+	Player(0, 1000, 2000);
+	Finish();
+
+	CTeeHistorianReader Reader;
+	CTeeHistorianReader::CItem Item;
+
+	// Cut off in the middle of the player item
+	ASSERT_TRUE(Reader.OpenMemory(m_vBuffer.data(), m_vBuffer.size() - 2));
+	EXPECT_FALSE(Reader.Read(&Item));
+	EXPECT_FALSE(Reader.Finished());
+	EXPECT_TRUE(Reader.Error());
+
+	// Cut off right before the finish marker
+	ASSERT_TRUE(Reader.OpenMemory(m_vBuffer.data(), m_vBuffer.size() - 1));
+	EXPECT_TRUE(Reader.Read(&Item));
+	EXPECT_FALSE(Reader.Read(&Item));
+	EXPECT_FALSE(Reader.Finished());
+	EXPECT_FALSE(Reader.Error());
+
+	const unsigned char aGarbage[] = {0x01, 0x02, 0x03};
+	EXPECT_FALSE(Reader.OpenMemory(aGarbage, sizeof(aGarbage)));
+}
+
+static void WriteBlocks(const void *pData, int DataSize, void *pUser)
+{
+	static_cast<CTeeHistorianBlockWriter *>(pUser)->Write(pData, DataSize);
+}
+
+TEST_F(TeeHistorian, ReaderBlocks)
+{
+	CTestInfo Info;
+	IOHANDLE File = io_open(Info.m_aFilename, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	CTeeHistorianBlockWriter Writer;
+	Writer.Open(File);
+	m_TH.Reset(&m_GameInfo, WriteBlocks, &Writer);
+
+	// Blocks start at ticks 15 and 21, the first one after skipped ticks
+	for(int Tick = 1; Tick <= 30; Tick++)
+	{
+		if(Tick > 10 && Tick < 15)
+			continue;
+		if(Tick > 1)
+		{
+			m_TH.EndInputs();
+			m_TH.EndTick();
+		}
+		if(Tick == 15 || Tick == 21)
+		{
+			Writer.EndBlock(m_TH.LastWrittenTick());
+			m_TH.Keyframe();
+		}
+		m_TH.BeginTick(Tick);
+		m_TH.BeginPlayers();
+		Player(0, Tick, 100);
+		// Only written when it changes, except after a keyframe
+		if(Tick < 25)
+			Player(1, 5, 5);
+		else
+			DeadPlayer(1);
+		m_TH.EndPlayers();
+		m_TH.BeginInputs();
+	}
+	m_TH.Finish();
+	Writer.Close();
+	EXPECT_EQ(Writer.Error(), 0);
+
+	using EItem = CTeeHistorianReader::EItem;
+	CTeeHistorianReader Reader;
+	CTeeHistorianReader::CItem Item;
+	ASSERT_TRUE(Reader.Open(io_open(Info.m_aFilename, IOFLAG_READ)));
+	ASSERT_TRUE(Reader.Header());
+	EXPECT_STREQ((*Reader.Header())["map_name"], "Kobra 3 Solo");
+	EXPECT_TRUE(Reader.CanSeek());
+
+	int NumPlayer0 = 0;
+	int LastTick = 0;
+	std::vector<int> vPlayer1Ticks;
+	while(Reader.Read(&Item))
+	{
+		ASSERT_TRUE(Item.m_Type == EItem::PLAYER_NEW || Item.m_Type == EItem::PLAYER_DIFF || Item.m_Type == EItem::PLAYER_OLD);
+		EXPECT_GE(Item.m_Tick, LastTick);
+		LastTick = Item.m_Tick;
+		if(Item.m_ClientId == 0)
+		{
+			EXPECT_EQ(Item.m_X, Item.m_Tick);
+			EXPECT_EQ(Item.m_Y, 100);
+			NumPlayer0++;
+		}
+		else
+		{
+			vPlayer1Ticks.push_back(Item.m_Tick);
+		}
+	}
+	EXPECT_TRUE(Reader.Finished());
+	EXPECT_FALSE(Reader.Error());
+	EXPECT_EQ(NumPlayer0, 26);
+	EXPECT_EQ(vPlayer1Ticks, (std::vector<int>{1, 15, 21, 25}));
+
+	ASSERT_TRUE(Reader.SeekTick(23));
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Type, EItem::PLAYER_NEW);
+	EXPECT_EQ(Item.m_Tick, 21);
+	EXPECT_EQ(Item.m_X, 21);
+
+	ASSERT_TRUE(Reader.SeekTick(15));
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Type, EItem::PLAYER_NEW);
+	EXPECT_EQ(Item.m_Tick, 15);
+	EXPECT_EQ(Item.m_X, 15);
+
+	ASSERT_TRUE(Reader.SeekTick(3));
+	ASSERT_TRUE(Reader.Read(&Item));
+	EXPECT_EQ(Item.m_Tick, 1);
+	EXPECT_EQ(Item.m_X, 1);
+	Reader.Close();
+
+	// Without the index the blocks can still be read in order
+	void *pData;
+	unsigned DataSize;
+	File = io_open(Info.m_aFilename, IOFLAG_READ);
+	ASSERT_TRUE(File);
+	ASSERT_TRUE(io_read_all(File, &pData, &DataSize));
+	io_close(File);
+	File = io_open(Info.m_aFilename, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	io_write(File, pData, DataSize - TEEHISTORIAN_BLOCK_TRAILER_SIZE);
+	io_close(File);
+	free(pData);
+
+	ASSERT_TRUE(Reader.Open(io_open(Info.m_aFilename, IOFLAG_READ)));
+	EXPECT_FALSE(Reader.CanSeek());
+	EXPECT_FALSE(Reader.SeekTick(23));
+	int NumItems = 0;
+	while(Reader.Read(&Item))
+		NumItems++;
+	EXPECT_EQ(NumItems, 26 + 4);
+	EXPECT_TRUE(Reader.Finished());
+	Reader.Close();
+
+	fs_remove(Info.m_aFilename);
+}
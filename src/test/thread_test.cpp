@@ -96,3 +96,44 @@ TEST(Thread, Lock)
 	Lock.unlock();
 	thread_wait(pThread);
 }
+
+TEST(Thread, SpscQueueSingleThreaded)
+{
+	CSpscQueue<int, 4> Queue;
+	int Value;
+	EXPECT_FALSE(Queue.TryPop(Value));
+	for(int i = 0; i < 4; i++)
+		EXPECT_TRUE(Queue.TryPush(i));
+	EXPECT_FALSE(Queue.TryPush(4));
+	EXPECT_EQ(Queue.ApproximateSize(), 4u);
+	for(int i = 0; i < 4; i++)
+	{
+		EXPECT_TRUE(Queue.TryPop(Value));
+		EXPECT_EQ(Value, i);
+	}
+	EXPECT_FALSE(Queue.TryPop(Value));
+}
+
+static void SpscQueueProducer(void *pUser)
+{
+	CSpscQueue<int, 16> *pQueue = (CSpscQueue<int, 16> *)pUser;
+	for(int i = 0; i < 10000; i++)
+	{
+		while(!pQueue->TryPush(i))
+			thread_yield();
+	}
+}
+
+TEST(Thread, SpscQueueMultiThreaded)
+{
+	CSpscQueue<int, 16> Queue;
+	void *pThread = thread_init(SpscQueueProducer, &Queue, "spsc_queue");
+	for(int i = 0; i < 10000; i++)
+	{
+		int Value;
+		while(!Queue.TryPop(Value))
+			thread_yield();
+		ASSERT_EQ(Value, i);
+	}
+	thread_wait(pThread);
+}
@@ -0,0 +1,65 @@
+#include <base/logger.h>
+#include <base/system.h>
+
+#include <engine/shared/server_stats.h>
+
+#include <chrono>
+#include <thread>
+
+static void PrintStats(const CServerStats &Stats)
+{
+	log_info("stats_reader", "tick=%d clients=%d/%d players=%d tick_us p50=%d p90=%d p99=%d max=%d db_queue=%d aio_queue=%" PRIu64 " sent=%" PRIu64 "p/%" PRIu64 "B recv=%" PRIu64 "p/%" PRIu64 "B",
+		Stats.m_Tick, Stats.m_NumClients, Stats.m_MaxClients, Stats.m_NumPlayers,
+		Stats.m_TickTimeP50, Stats.m_TickTimeP90, Stats.m_TickTimeP99, Stats.m_TickTimeMax,
+		Stats.m_DbQueuedQueries, Stats.m_AioQueuedBytes,
+		Stats.m_SentPackets, Stats.m_SentBytes, Stats.m_RecvPackets, Stats.m_RecvBytes);
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		const CServerStats::CClient &Client = Stats.m_aClients[i];
+		if(Client.m_State == 0)
+			continue;
+		log_info("stats_reader", "  id=%d state=%d latency=%d snap=%dB sent=%" PRIu64 "p/%" PRIu64 "B recv=%" PRIu64 "p/%" PRIu64 "B resent=%" PRIu64 " snap_packed=%" PRIu64 "/%" PRIu64 "B",
+			i, Client.m_State, Client.m_Latency, Client.m_SnapshotSize,
+			Client.m_SentPackets, Client.m_SentBytes, Client.m_RecvPackets, Client.m_RecvBytes,
+			Client.m_ResentChunks, Client.m_SnapPackedBytes, Client.m_SnapFullBytes);
+	}
+}
+
+int main(int argc, const char **argv)
+{
+	CCmdlineFix CmdlineFix(&argc, &argv);
+	log_set_global_logger_default();
+
+	if(argc != 2 && argc != 3)
+	{
+		log_error("stats_reader", "usage: %s <stats file> [interval in ms, 0 to print once]", argv[0]);
+		return -1;
+	}
+	const int Interval = argc == 3 ? str_toint(argv[2]) : 0;
+
+	CServerStatsReader Reader;
+	if(!Reader.Open(argv[1]))
+	{
+		log_error("stats_reader", "failed to open stats file '%s'", argv[1]);
+		return -1;
+	}
+
+	uint32_t LastUpdate = 0;
+	while(true)
+	{
+		const uint32_t Update = Reader.NumUpdates();
+		if(Update != LastUpdate || Interval <= 0)
+		{
+			CServerStats Stats;
+			if(Reader.Read(&Stats))
+				PrintStats(Stats);
+			else
+				log_error("stats_reader", "stats kept changing while reading");
+			LastUpdate = Update;
+		}
+		if(Interval <= 0)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(Interval));
+	}
+	return 0;
+}
@@ -0,0 +1,440 @@
+#include <base/logger.h>
+#include <base/system.h>
+
+#include <engine/console.h>
+#include <engine/engine.h>
+#include <engine/map.h>
+#include <engine/server/antibot.h>
+#include <engine/server/databases/connection_pool.h>
+#include <engine/server/server.h>
+#include <engine/shared/config.h>
+#include <engine/shared/json.h>
+#include <engine/shared/packer.h>
+#include <engine/storage.h>
+
+#include <game/server/entities/character.h>
+#include <game/server/gamecontext.h>
+#include <game/server/player.h>
+#include <game/server/teehistorian_reader.h>
+#include <game/version.h>
+
+#include <memory>
+
+static const char *TOOL_NAME = "teehistorian_replay";
+
+#define UUID(id, name) static const CUuid UUID_##id = CalculateUuid(name);
+#include <engine/shared/teehistorian_ex_chunks.h>
+#undef UUID
+
+bool IsInterrupted()
+{
+	return false;
+}
+
+class CReplay
+{
+public:
+	enum
+	{
+		MAX_REPORTED_MISMATCHES = 32,
+	};
+
+	CServer *m_pServer = nullptr;
+	CGameContext *m_pGameServer = nullptr;
+	IConsole *m_pConsole = nullptr;
+	CTeeHistorianReader m_Reader;
+	bool m_Resync = true;
+	// Compares the team-parallel tick with the serial one of the recording
+	bool m_ParallelTeams = false;
+
+	struct SExpectedPlayer
+	{
+		bool m_Alive;
+		int m_X;
+		int m_Y;
+	};
+	SExpectedPlayer m_aExpected[MAX_CLIENTS] = {};
+	bool m_aHasInput[MAX_CLIENTS] = {};
+	CNetObj_PlayerInput m_aInputs[MAX_CLIENTS] = {};
+	bool m_aSixup[MAX_CLIENTS] = {};
+
+	bool m_Verified = true;
+	int m_NumTicks = 0;
+	int64_t m_NumChecks = 0;
+	int64_t m_NumMismatches = 0;
+
+	void ApplyHeader();
+	void Run();
+
+private:
+	void Step();
+	void Verify();
+	void Resync(int ClientId);
+	void OnItem(const CTeeHistorianReader::CItem &Item);
+	void OnExItem(const CTeeHistorianReader::CItem &Item);
+};
+
+void CReplay::ApplyHeader()
+{
+	char aLine[IConsole::CMDLINE_LENGTH];
+	char aEscaped[IConsole::CMDLINE_LENGTH];
+
+	// Only settings that differ from the defaults are recorded
+	const json_value &Config = (*m_Reader.Header())["config"];
+	if(Config.type == json_object)
+	{
+		for(unsigned i = 0; i < Config.u.object.length; i++)
+		{
+			const json_value &Value = *Config.u.object.values[i].value;
+			if(Value.type != json_string)
+				continue;
+			char *pDst = aEscaped;
+			str_escape(&pDst, Value.u.string.ptr, aEscaped + sizeof(aEscaped));
+			str_format(aLine, sizeof(aLine), "%s \"%s\"", Config.u.object.values[i].name, aEscaped);
+			m_pConsole->ExecuteLine(aLine, IConsole::CLIENT_ID_UNSPECIFIED);
+		}
+	}
+
+	// The replay must not write or touch anything outside of the process
+	m_pServer->Config()->m_SvTeeHistorian = 0;
+	m_pServer->Config()->m_SvUseSql = 0;
+	m_pServer->Config()->m_SvParallelTeams = m_ParallelTeams;
+}
+
+void CReplay::Step()
+{
+	if(!m_Verified)
+		Verify();
+
+	const void *apInputs[MAX_CLIENTS];
+	for(int ClientId = 0; ClientId < MAX_CLIENTS; ClientId++)
+	{
+		apInputs[ClientId] = m_aHasInput[ClientId] ? &m_aInputs[ClientId] : nullptr;
+	}
+	m_pServer->SimulateTick(apInputs);
+	m_NumTicks++;
+	m_Verified = false;
+}
+
+void CReplay::Verify()
+{
+	m_Verified = true;
+	for(int ClientId = 0; ClientId < MAX_CLIENTS; ClientId++)
+	{
+		const SExpectedPlayer &Expected = m_aExpected[ClientId];
+		CPlayer *pPlayer = m_pGameServer->m_apPlayers[ClientId];
+		CCharacter *pCharacter = pPlayer ? pPlayer->GetCharacter() : nullptr;
+		if(!Expected.m_Alive && !pCharacter)
+			continue;
+
+		m_NumChecks++;
+		CNetObj_CharacterCore Core = {};
+		if(pCharacter)
+		{
+			pCharacter->GetCore().Write(&Core);
+			if(Expected.m_Alive && Core.m_X == Expected.m_X && Core.m_Y == Expected.m_Y)
+				continue;
+		}
+
+		m_NumMismatches++;
+		if(m_NumMismatches <= MAX_REPORTED_MISMATCHES)
+		{
+			if(!pCharacter)
+				log_warn(TOOL_NAME, "tick=%d cid=%d expected x=%d y=%d, character is dead", m_pServer->Tick(), ClientId, Expected.m_X, Expected.m_Y);
+			else if(!Expected.m_Alive)
+				log_warn(TOOL_NAME, "tick=%d cid=%d expected dead, character is at x=%d y=%d", m_pServer->Tick(), ClientId, Core.m_X, Core.m_Y);
+			else
+				log_warn(TOOL_NAME, "tick=%d cid=%d expected x=%d y=%d, character is at x=%d y=%d", m_pServer->Tick(), ClientId, Expected.m_X, Expected.m_Y, Core.m_X, Core.m_Y);
+		}
+		if(m_Resync)
+			Resync(ClientId);
+	}
+}
+
+void CReplay::Resync(int ClientId)
+{
+	// Only positions are recorded, velocities and other state cannot be restored
+	CPlayer *pPlayer = m_pGameServer->m_apPlayers[ClientId];
+	if(!pPlayer)
+		return;
+	const SExpectedPlayer &Expected = m_aExpected[ClientId];
+	CCharacter *pCharacter = pPlayer->GetCharacter();
+	if(!Expected.m_Alive)
+		pPlayer->KillCharacter(WEAPON_GAME, false);
+	else if(pCharacter)
+		pCharacter->SetPosition(vec2(Expected.m_X, Expected.m_Y));
+	else
+		pPlayer->ForceSpawn(vec2(Expected.m_X, Expected.m_Y));
+}
+
+void CReplay::OnItem(const CTeeHistorianReader::CItem &Item)
+{
+	using EItem = CTeeHistorianReader::EItem;
+
+	while(m_pServer->Tick() < Item.m_Tick)
+		Step();
+
+	switch(Item.m_Type)
+	{
+	case EItem::PLAYER_DIFF:
+	case EItem::PLAYER_NEW:
+		m_aExpected[Item.m_ClientId] = {true, Item.m_X, Item.m_Y};
+		break;
+	case EItem::PLAYER_OLD:
+		m_aExpected[Item.m_ClientId].m_Alive = false;
+		break;
+	case EItem::INPUT_DIFF:
+	case EItem::INPUT_NEW:
+		m_aInputs[Item.m_ClientId] = Item.m_Input;
+		m_aHasInput[Item.m_ClientId] = true;
+		if(m_pServer->ClientIngame(Item.m_ClientId))
+			m_pGameServer->OnClientDirectInput(Item.m_ClientId, &m_aInputs[Item.m_ClientId]);
+		break;
+	case EItem::MESSAGE:
+		if(Item.m_ClientId >= 0 && Item.m_ClientId < MAX_CLIENTS)
+			m_pServer->SimulateClientMessage(Item.m_ClientId, Item.m_pData, Item.m_DataSize);
+		break;
+	case EItem::JOIN:
+		m_pServer->SimulateClientJoin(Item.m_ClientId, m_aSixup[Item.m_ClientId]);
+		break;
+	case EItem::DROP:
+		if(Item.m_ClientId >= 0 && Item.m_ClientId < MAX_CLIENTS)
+		{
+			m_pServer->SimulateClientDrop(Item.m_ClientId, Item.m_pString);
+			m_aHasInput[Item.m_ClientId] = false;
+		}
+		break;
+	case EItem::CONSOLE_COMMAND:
+	{
+		// Chat commands are replayed by their chat messages
+		if(Item.m_FlagMask & CFGFLAG_CHAT)
+			break;
+		char aLine[IConsole::CMDLINE_LENGTH];
+		str_copy(aLine, Item.m_pString);
+		for(const char *pArgument : Item.m_vpArguments)
+		{
+			char aEscaped[IConsole::CMDLINE_LENGTH];
+			char *pDst = aEscaped;
+			str_escape(&pDst, pArgument, aEscaped + sizeof(aEscaped));
+			str_append(aLine, " \"");
+			str_append(aLine, aEscaped);
+			str_append(aLine, "\"");
+		}
+		m_pConsole->ExecuteLineFlag(aLine, Item.m_FlagMask, IConsole::CLIENT_ID_UNSPECIFIED, false);
+		break;
+	}
+	case EItem::EX:
+		OnExItem(Item);
+		break;
+	}
+}
+
+void CReplay::OnExItem(const CTeeHistorianReader::CItem &Item)
+{
+	CUnpacker Unpacker;
+	Unpacker.Reset(Item.m_pData, Item.m_DataSize);
+	const int ClientId = Unpacker.GetInt();
+	if(Unpacker.Error() || ClientId < 0 || ClientId >= MAX_CLIENTS)
+		return;
+
+	if(Item.m_Uuid == UUID_TEEHISTORIAN_JOINVER6 || Item.m_Uuid == UUID_TEEHISTORIAN_JOINVER7)
+	{
+		m_aSixup[ClientId] = Item.m_Uuid == UUID_TEEHISTORIAN_JOINVER7;
+	}
+	else if(Item.m_Uuid == UUID_TEEHISTORIAN_PLAYER_READY)
+	{
+		m_pServer->SimulateClientEnter(ClientId);
+	}
+	else if(Item.m_Uuid == UUID_TEEHISTORIAN_DDNETVER || Item.m_Uuid == UUID_TEEHISTORIAN_DDNETVER_OLD)
+	{
+		if(Item.m_Uuid == UUID_TEEHISTORIAN_DDNETVER)
+			Unpacker.GetRaw(sizeof(CUuid));
+		const int DDNetVersion = Unpacker.GetInt();
+		if(!Unpacker.Error())
+			m_pServer->SetClientDDNetVersion(ClientId, DDNetVersion);
+	}
+}
+
+void CReplay::Run()
+{
+	CTeeHistorianReader::CItem Item;
+	while(m_Reader.Read(&Item))
+	{
+		OnItem(Item);
+	}
+	while(m_pServer->Tick() < m_Reader.Tick())
+		Step();
+	if(!m_Verified)
+		Verify();
+}
+
+int main(int argc, const char **argv)
+{
+	CCmdlineFix CmdlineFix(&argc, &argv);
+
+	std::shared_ptr<ILogger> pStdoutLogger = std::shared_ptr<ILogger>(log_logger_stdout());
+	log_set_global_logger(log_logger_collection({pStdoutLogger}).release());
+
+	bool Verbose = false;
+	bool Resync = true;
+	bool ParallelTeams = false;
+	const char *pFilename = nullptr;
+	int NumFilenames = 0;
+	for(int i = 1; i < argc; i++)
+	{
+		if(str_comp(argv[i], "-v") == 0)
+			Verbose = true;
+		else if(str_comp(argv[i], "--no-resync") == 0)
+			Resync = false;
+		else if(str_comp(argv[i], "--parallel-teams") == 0)
+			ParallelTeams = true;
+		else
+		{
+			pFilename = argv[i];
+			NumFilenames++;
+		}
+	}
+	if(NumFilenames != 1)
+	{
+		log_error(TOOL_NAME, "Usage: %s [-v] [--no-resync] [--parallel-teams] <teehistorian_file>", TOOL_NAME);
+		log_error(TOOL_NAME, "The map of the recording must be available in the maps folder of the storage.");
+		return -1;
+	}
+
+	std::unique_ptr<CReplay> pReplay = std::make_unique<CReplay>();
+	pReplay->m_Resync = Resync;
+	pReplay->m_ParallelTeams = ParallelTeams;
+	IOHANDLE File = io_open(pFilename, IOFLAG_READ);
+	if(!File)
+	{
+		log_error(TOOL_NAME, "Failed to open '%s'", pFilename);
+		return -1;
+	}
+	if(!pReplay->m_Reader.Open(File) || !pReplay->m_Reader.Header())
+	{
+		log_error(TOOL_NAME, "'%s' is not a valid teehistorian file", pFilename);
+		return -1;
+	}
+	const json_value &Header = *pReplay->m_Reader.Header();
+	const char *pMapName = Header["map_name"];
+	const char *pMapSha256 = Header["map_sha256"];
+	const char *pPrngDescription = Header["prng_description"];
+	if(Header["map_name"].type != json_string)
+	{
+		log_error(TOOL_NAME, "Header of '%s' does not contain a map", pFilename);
+		return -1;
+	}
+
+	CServer *pServer = CreateServer();
+	std::unique_ptr<IKernel> pKernel = std::unique_ptr<IKernel>(IKernel::Create());
+	pKernel->RegisterInterface(pServer);
+
+	IEngine *pEngine = CreateTestEngine(GAME_NAME);
+	pKernel->RegisterInterface(pEngine);
+
+	IStorage *pStorage = CreateStorage(IStorage::EInitializationType::SERVER, argc, argv);
+	if(!pStorage)
+	{
+		log_error(TOOL_NAME, "Failed to initialize storage");
+		return -1;
+	}
+	pKernel->RegisterInterface(pStorage);
+
+	IConsole *pConsole = CreateConsole(CFGFLAG_SERVER | CFGFLAG_ECON).release();
+	pKernel->RegisterInterface(pConsole);
+
+	IConfigManager *pConfigManager = CreateConfigManager();
+	pKernel->RegisterInterface(pConfigManager);
+
+	IEngineMap *pEngineMap = CreateEngineMap();
+	pKernel->RegisterInterface(pEngineMap);
+	pKernel->RegisterInterface(static_cast<IMap *>(pEngineMap), false);
+
+	IEngineAntibot *pEngineAntibot = CreateEngineAntibot();
+	pKernel->RegisterInterface(pEngineAntibot);
+	pKernel->RegisterInterface(static_cast<IAntibot *>(pEngineAntibot), false);
+
+	IGameServer *pGameServer = CreateGameServer();
+	pKernel->RegisterInterface(pGameServer);
+
+	pEngine->Init();
+	pConsole->Init();
+	pConfigManager->Init();
+	pServer->RegisterCommands();
+
+	pReplay->m_pServer = pServer;
+	pReplay->m_pGameServer = static_cast<CGameContext *>(pGameServer);
+	pReplay->m_pConsole = pConsole;
+
+	if(!Verbose)
+	{
+		// The game is very chatty about every player event
+		pStdoutLogger->SetFilter(CLogFilter{LEVEL_WARN});
+	}
+
+	pReplay->ApplyHeader();
+	if(!pServer->LoadMap(pMapName))
+	{
+		log_error(TOOL_NAME, "Failed to load map '%s'", pMapName);
+		return -1;
+	}
+	char aSha256[SHA256_MAXSTRSIZE];
+	sha256_str(pServer->m_aCurrentMapSha256[CServer::MAP_TYPE_SIX], aSha256, sizeof(aSha256));
+	if(Header["map_sha256"].type == json_string && str_comp(aSha256, pMapSha256) != 0)
+	{
+		log_warn(TOOL_NAME, "Map '%s' differs from the recorded one, sha256 %s instead of %s", pMapName, aSha256, pMapSha256);
+	}
+
+	pServer->m_RunServer = CServer::RUNNING;
+	pServer->m_AuthManager.Init();
+	{
+		const int Size = pGameServer->PersistentClientDataSize();
+		for(auto &Client : pServer->m_aClients)
+		{
+			Client.m_HasPersistentData = false;
+			Client.m_pPersistentData = malloc(Size);
+		}
+	}
+	pServer->m_pPersistentData = malloc(pGameServer->PersistentDataSize());
+	pGameServer->OnInit(nullptr);
+
+	// Tunings are recorded after the map config was applied
+	const json_value &Tuning = Header["tuning"];
+	if(Tuning.type == json_object)
+	{
+		for(unsigned i = 0; i < Tuning.u.object.length; i++)
+		{
+			const json_value &Value = *Tuning.u.object.values[i].value;
+			if(Value.type != json_string)
+				continue;
+			char aLine[IConsole::CMDLINE_LENGTH];
+			str_format(aLine, sizeof(aLine), "tune %s %.2f", Tuning.u.object.values[i].name, str_toint(Value.u.string.ptr) / 100.0f);
+			pConsole->ExecuteLine(aLine, IConsole::CLIENT_ID_UNSPECIFIED);
+		}
+	}
+
+	if(Header["prng_description"].type == json_string && !pReplay->m_pGameServer->m_World.m_Core.m_pPrng->SeedFromDescription(pPrngDescription))
+	{
+		log_warn(TOOL_NAME, "Unknown random number generator '%s', random events will differ", pPrngDescription);
+	}
+
+	const int64_t StartTime = time_get();
+	pReplay->Run();
+	const double Seconds = (time_get() - StartTime) / (double)time_freq();
+
+	pStdoutLogger->SetFilter(CLogFilter{LEVEL_INFO});
+	if(pReplay->m_Reader.Error())
+		log_error(TOOL_NAME, "Stream is malformed after tick %d", pReplay->m_Reader.Tick());
+	else if(!pReplay->m_Reader.Finished())
+		log_warn(TOOL_NAME, "Stream is truncated after tick %d", pReplay->m_Reader.Tick());
+	log_info(TOOL_NAME, "Replayed %d ticks in %.3fs, %.0f ticks/s (%.1fx real time)",
+		pReplay->m_NumTicks, Seconds, pReplay->m_NumTicks / maximum(Seconds, 1e-9), pReplay->m_NumTicks / (double)SERVER_TICK_SPEED / maximum(Seconds, 1e-9));
+	log_info(TOOL_NAME, "%" PRId64 " of %" PRId64 " player states differed from the recording", pReplay->m_NumMismatches, pReplay->m_NumChecks);
+
+	pGameServer->OnShutdown(nullptr);
+	pServer->m_pMap->Unload();
+	pServer->DbPool()->OnShutdown();
+	const bool Success = !pReplay->m_Reader.Error() && pReplay->m_NumMismatches == 0;
+	pReplay.reset();
+	return Success ? 0 : 1;
+}